@@ -0,0 +1,69 @@
+#include "benchmark/benchmark.h"
+#include <ncine/AudioMixer.h>
+#include <ncine/IAudioSink.h>
+#include <nctl/UniquePtr.h>
+
+const int Frequency = 44100;
+const unsigned int NumFrames = 1024;
+const unsigned int SoundFrames = 22050;
+
+static nctl::UniquePtr<int16_t[]> createSamples(unsigned int numChannels)
+{
+	nctl::UniquePtr<int16_t[]> samples = nctl::makeUnique<int16_t[]>(SoundFrames * numChannels);
+	for (unsigned int i = 0; i < SoundFrames * numChannels; i++)
+		samples[i] = static_cast<int16_t>(static_cast<int>((i * 37) % 65536) - 32768);
+	return samples;
+}
+
+static void BM_MixMono(benchmark::State &state)
+{
+	nctl::UniquePtr<int16_t[]> samples = createSamples(1);
+	ncine::AudioMixer::Sound sound(samples.get(), SoundFrames, 1, Frequency);
+	ncine::AudioMixer mixer(Frequency, state.range(0));
+	ncine::NullAudioSink sink;
+
+	for (int i = 0; i < state.range(0); i++)
+		mixer.play(sound, 0, 0.5f, 1.0f, (i % 3) - 1.0f, true);
+
+	for (auto _ : state)
+		mixer.render(sink, NumFrames);
+
+	state.SetItemsProcessed(state.iterations() * state.range(0) * NumFrames);
+}
+BENCHMARK(BM_MixMono)->Arg(16)->Arg(64)->Arg(256);
+
+static void BM_MixStereo(benchmark::State &state)
+{
+	nctl::UniquePtr<int16_t[]> samples = createSamples(2);
+	ncine::AudioMixer::Sound sound(samples.get(), SoundFrames, 2, Frequency);
+	ncine::AudioMixer mixer(Frequency, state.range(0));
+	ncine::NullAudioSink sink;
+
+	for (int i = 0; i < state.range(0); i++)
+		mixer.play(sound, i % ncine::AudioMixer::NumGroups, 0.5f, 1.0f, 0.0f, true);
+
+	for (auto _ : state)
+		mixer.render(sink, NumFrames);
+
+	state.SetItemsProcessed(state.iterations() * state.range(0) * NumFrames);
+}
+BENCHMARK(BM_MixStereo)->Arg(16)->Arg(64)->Arg(256);
+
+static void BM_MixResampled(benchmark::State &state)
+{
+	nctl::UniquePtr<int16_t[]> samples = createSamples(1);
+	ncine::AudioMixer::Sound sound(samples.get(), SoundFrames, 1, Frequency / 2);
+	ncine::AudioMixer mixer(Frequency, state.range(0));
+	ncine::NullAudioSink sink;
+
+	for (int i = 0; i < state.range(0); i++)
+		mixer.play(sound, 0, 0.5f, 1.0f + (i % 8) * 0.1f, 0.0f, true);
+
+	for (auto _ : state)
+		mixer.render(sink, NumFrames);
+
+	state.SetItemsProcessed(state.iterations() * state.range(0) * NumFrames);
+}
+BENCHMARK(BM_MixResampled)->Arg(16)->Arg(64)->Arg(256);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,34 @@
+#include "benchmark/benchmark.h"
+#include <ncine/FrameProfiler.h>
+
+// Measures the cost of a zone of the built-in frame profiler, which is always compiled in
+
+const int MaxThreads = 8;
+
+static void BM_ScopedZoneDisabled(benchmark::State &state)
+{
+	ncine::FrameProfiler::setEnabled(false);
+	for (auto _ : state)
+		ncine::FrameProfiler::ScopedZone zone("Disabled");
+	ncine::FrameProfiler::setEnabled(true);
+}
+BENCHMARK(BM_ScopedZoneDisabled);
+
+static void BM_ScopedZone(benchmark::State &state)
+{
+	for (auto _ : state)
+		ncine::FrameProfiler::ScopedZone zone("Enabled");
+}
+BENCHMARK(BM_ScopedZone)->ThreadRange(1, MaxThreads)->UseRealTime();
+
+static void BM_NestedScopedZones(benchmark::State &state)
+{
+	for (auto _ : state)
+	{
+		ncine::FrameProfiler::ScopedZone outerZone("Outer");
+		ncine::FrameProfiler::ScopedZone innerZone("Inner");
+	}
+}
+BENCHMARK(BM_NestedScopedZones);
+
+BENCHMARK_MAIN();
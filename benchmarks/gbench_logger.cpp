@@ -0,0 +1,55 @@
+#include "benchmark/benchmark.h"
+#include <ncine/FileLogger.h>
+
+// Measures log calls per second from multiple threads writing to the same file
+
+const char *LogFilename = "gbench_logger.txt";
+const int MaxThreads = 8;
+
+static ncine::FileLogger *logger = nullptr;
+
+static void createLogger(bool asynchronous)
+{
+	logger = new ncine::FileLogger(ncine::ILogger::LogLevel::OFF, ncine::ILogger::LogLevel::INFO, LogFilename);
+	logger->setAsynchronous(asynchronous);
+}
+
+static void destroyLogger(benchmark::State &state)
+{
+	logger->flush();
+	state.counters["Dropped"] = logger->numDroppedEntries();
+	delete logger;
+	logger = nullptr;
+}
+
+static void BM_LogSynchronous(benchmark::State &state)
+{
+	if (state.thread_index == 0)
+		createLogger(false);
+
+	int i = 0;
+	for (auto _ : state)
+		logger->write(ncine::ILogger::LogLevel::INFO, "Entry %d from thread %d", i++, state.thread_index);
+	state.SetItemsProcessed(state.iterations());
+
+	if (state.thread_index == 0)
+		destroyLogger(state);
+}
+BENCHMARK(BM_LogSynchronous)->ThreadRange(1, MaxThreads)->UseRealTime();
+
+static void BM_LogAsynchronous(benchmark::State &state)
+{
+	if (state.thread_index == 0)
+		createLogger(true);
+
+	int i = 0;
+	for (auto _ : state)
+		logger->write(ncine::ILogger::LogLevel::INFO, "Entry %d from thread %d", i++, state.thread_index);
+	state.SetItemsProcessed(state.iterations());
+
+	if (state.thread_index == 0)
+		destroyLogger(state);
+}
+BENCHMARK(BM_LogAsynchronous)->ThreadRange(1, MaxThreads)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,65 @@
+#include "benchmark/benchmark.h"
+#include <ncine/LuaStateManager.h>
+#include <ncine/FileSystem.h>
+#include <nctl/String.h>
+
+// Compares compiling a big script from source with loading its cached bytecode
+
+const unsigned int NumFunctions = 2000;
+const char *ScriptName = "gbench_luaload.lua";
+const char *CacheDirectory = "gbench_luacache";
+
+static nctl::String createScript()
+{
+	nctl::String script(NumFunctions * 192);
+	nctl::String function(192);
+
+	script = "local M = {}\n";
+	for (unsigned int i = 0; i < NumFunctions; i++)
+	{
+		function.format("function M.func%u(a, b)\n\tlocal t = {}\n\tfor i = 1, a do t[i] = i * b + %u end\n\treturn #t, t[1]\nend\n", i, i);
+		script.append(function);
+	}
+	script.append("bench_module = M\n");
+
+	return script;
+}
+
+static void BM_LuaLoadSource(benchmark::State &state)
+{
+	const nctl::String script = createScript();
+	ncine::LuaStateManager luaManager(ncine::LuaStateManager::ApiType::NONE,
+	                               ncine::LuaStateManager::StatisticsTracking::DISABLED,
+	                               ncine::LuaStateManager::StandardLibraries::NOT_LOADED);
+
+	for (auto _ : state)
+	{
+		const bool succeeded = luaManager.runFromMemory(script.data(), script.length(), ScriptName);
+		benchmark::DoNotOptimize(succeeded);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * script.length());
+}
+BENCHMARK(BM_LuaLoadSource);
+
+static void BM_LuaLoadCached(benchmark::State &state)
+{
+	const nctl::String script = createScript();
+	ncine::LuaStateManager luaManager(ncine::LuaStateManager::ApiType::NONE,
+	                               ncine::LuaStateManager::StatisticsTracking::DISABLED,
+	                               ncine::LuaStateManager::StandardLibraries::NOT_LOADED);
+	luaManager.setBytecodeCachePath(ncine::fs::joinPath(ncine::fs::currentDir(), CacheDirectory).data());
+	luaManager.setBytecodeCacheEnabled(true);
+
+	// The first run compiles the script and writes the cache file
+	luaManager.runFromMemory(script.data(), script.length(), ScriptName);
+
+	for (auto _ : state)
+	{
+		const bool succeeded = luaManager.runFromMemory(script.data(), script.length(), ScriptName);
+		benchmark::DoNotOptimize(succeeded);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * script.length());
+}
+BENCHMARK(BM_LuaLoadCached);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,219 @@
+#include "benchmark/benchmark.h"
+#include <cstdint>
+#include <nctl/Array.h>
+#include <nctl/HashMap.h>
+#include <nctl/String.h>
+#include <nctl/Utf8.h>
+
+// The layout loop mirrors `TextNode::calculateBoundaries()` on a synthetic glyph set,
+// as a `Font` cannot be created without a texture and a rendering context.
+
+const unsigned int NumLatinGlyphs = 96;
+const unsigned int NumCjkGlyphs = 20000;
+const unsigned int FirstCjkCodePoint = 0x4E00;
+const unsigned int NumKernings = 512;
+const unsigned int LineLength = 64;
+const unsigned int NumLines = 256;
+const int LineHeight = 32;
+
+struct Glyph
+{
+	int xAdvance = 0;
+};
+
+struct Kerning
+{
+	unsigned int first;
+	unsigned int second;
+	int amount;
+};
+
+nctl::HashMap<unsigned int, Glyph> glyphs(2 * (NumLatinGlyphs + NumCjkGlyphs));
+nctl::HashMap<uint64_t, int> kernings(2 * NumKernings);
+nctl::Array<Kerning> kerningArray(NumKernings);
+nctl::Array<float> lineLengths(NumLines);
+
+inline uint64_t kerningKey(unsigned int first, unsigned int second)
+{
+	return (static_cast<uint64_t>(first) << 32) | second;
+}
+
+void initGlyphs()
+{
+	if (glyphs.isEmpty() == false)
+		return;
+
+	for (unsigned int i = 0; i < NumLatinGlyphs; i++)
+		glyphs[32 + i].xAdvance = 8 + i % 8;
+	for (unsigned int i = 0; i < NumCjkGlyphs; i++)
+		glyphs[FirstCjkCodePoint + i].xAdvance = 16;
+
+	for (unsigned int i = 0; i < NumKernings; i++)
+	{
+		const unsigned int first = 65 + i % 26;
+		const unsigned int second = 97 + (i / 26) % 26;
+		if (kernings.find(kerningKey(first, second)) == nullptr)
+		{
+			kernings[kerningKey(first, second)] = -1 - static_cast<int>(i % 3);
+			kerningArray.pushBack({ first, second, kernings[kerningKey(first, second)] });
+		}
+	}
+}
+
+/// Creates a multi-line string where one character every `cjkRatio` is a CJK ideograph
+nctl::String createText(unsigned int cjkRatio)
+{
+	nctl::String text(NumLines * (LineLength * nctl::Utf8::MaxCodeUnits + 1) + 1);
+	char sequence[nctl::Utf8::MaxCodeUnits + 1];
+
+	for (unsigned int line = 0; line < NumLines; line++)
+	{
+		for (unsigned int i = 0; i < LineLength; i++)
+		{
+			const unsigned int index = line * LineLength + i;
+			const unsigned int codePoint = (cjkRatio > 0 && index % cjkRatio == 0)
+			                                   ? FirstCjkCodePoint + (index * 7919) % NumCjkGlyphs
+			                                   : 65 + (index * 31) % 58;
+			const unsigned int numCodeUnits = nctl::Utf8::encode(codePoint, sequence);
+			sequence[numCodeUnits] = '\0';
+			text.append(sequence);
+		}
+		text.append("\n");
+	}
+
+	return text;
+}
+
+float layoutHashedKerning(const nctl::String &text)
+{
+	lineLengths.clear();
+	float xAdvance = 0.0f;
+	float yAdvance = 0.0f;
+
+	const char *data = text.data();
+	const unsigned int length = text.length();
+	unsigned int position = 0;
+	while (position < length)
+	{
+		unsigned int codePoint = 0;
+		const unsigned int nextPosition = position + nctl::Utf8::decode(data + position, length - position, codePoint);
+
+		if (codePoint == '\n')
+		{
+			lineLengths.pushBack(xAdvance);
+			xAdvance = 0.0f;
+			yAdvance += LineHeight;
+		}
+		else
+		{
+			const Glyph *glyph = glyphs.find(codePoint);
+			if (glyph)
+			{
+				xAdvance += glyph->xAdvance;
+				if (nextPosition < length)
+				{
+					unsigned int nextCodePoint = 0;
+					nctl::Utf8::decode(data + nextPosition, length - nextPosition, nextCodePoint);
+					const int *amount = kernings.find(kerningKey(codePoint, nextCodePoint));
+					if (amount)
+						xAdvance += *amount;
+				}
+			}
+		}
+
+		position = nextPosition;
+	}
+
+	return yAdvance;
+}
+
+float layoutLinearKerning(const nctl::String &text)
+{
+	lineLengths.clear();
+	float xAdvance = 0.0f;
+	float yAdvance = 0.0f;
+
+	const char *data = text.data();
+	const unsigned int length = text.length();
+	unsigned int position = 0;
+	while (position < length)
+	{
+		unsigned int codePoint = 0;
+		const unsigned int nextPosition = position + nctl::Utf8::decode(data + position, length - position, codePoint);
+
+		if (codePoint == '\n')
+		{
+			lineLengths.pushBack(xAdvance);
+			xAdvance = 0.0f;
+			yAdvance += LineHeight;
+		}
+		else
+		{
+			const Glyph *glyph = glyphs.find(codePoint);
+			if (glyph)
+			{
+				xAdvance += glyph->xAdvance;
+				if (nextPosition < length)
+				{
+					unsigned int nextCodePoint = 0;
+					nctl::Utf8::decode(data + nextPosition, length - nextPosition, nextCodePoint);
+					for (const Kerning &kerning : kerningArray)
+					{
+						if (kerning.first == codePoint && kerning.second == nextCodePoint)
+						{
+							xAdvance += kerning.amount;
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		position = nextPosition;
+	}
+
+	return yAdvance;
+}
+
+static void BM_LayoutHashedKerning(benchmark::State &state)
+{
+	initGlyphs();
+	const nctl::String text = createText(state.range(0));
+
+	for (auto _ : state)
+	{
+		const float height = layoutHashedKerning(text);
+		benchmark::DoNotOptimize(height);
+	}
+	state.SetItemsProcessed(state.iterations() * NumLines * LineLength);
+}
+BENCHMARK(BM_LayoutHashedKerning)->Arg(0)->Arg(8)->Arg(1);
+
+static void BM_LayoutLinearKerning(benchmark::State &state)
+{
+	initGlyphs();
+	const nctl::String text = createText(state.range(0));
+
+	for (auto _ : state)
+	{
+		const float height = layoutLinearKerning(text);
+		benchmark::DoNotOptimize(height);
+	}
+	state.SetItemsProcessed(state.iterations() * NumLines * LineLength);
+}
+BENCHMARK(BM_LayoutLinearKerning)->Arg(0)->Arg(8)->Arg(1);
+
+static void BM_Utf8Decode(benchmark::State &state)
+{
+	const nctl::String text = createText(state.range(0));
+
+	for (auto _ : state)
+	{
+		const unsigned int numCodePoints = nctl::Utf8::numCodePoints(text.data(), text.length());
+		benchmark::DoNotOptimize(numCodePoints);
+	}
+	state.SetBytesProcessed(state.iterations() * text.length());
+}
+BENCHMARK(BM_Utf8Decode)->Arg(0)->Arg(8)->Arg(1);
+
+BENCHMARK_MAIN();
@@ -54,6 +54,9 @@ if(NCINE_BUILD_TESTS)
 		install(FILES cmake/ncine_devdist_tests.cmake DESTINATION ${TEST_SOURCES_INSTALL_DESTINATION} RENAME CMakeLists.txt COMPONENT devsupport)
 	endif()
 
+	if(NCINE_BUILD_APPTEST_BENCHMARKS AND NOT EMSCRIPTEN)
+		enable_testing()
+	endif()
 	add_subdirectory(tests)
 	if(NOT NCINE_DYNAMIC_LIBRARY)
 		add_subdirectory(src/tests)
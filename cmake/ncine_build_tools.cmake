@@ -0,0 +1,10 @@
+if(NCINE_BUILD_TOOLS)
+	# Tools use private engine classes that are not exported by the dynamic library
+	if(NCINE_DYNAMIC_LIBRARY)
+		message(WARNING "Offline tools can only be built with the static version of the library")
+	elseif(NOT PNG_FOUND)
+		message(WARNING "Offline tools need PNG support to read and write font atlases")
+	else()
+		add_subdirectory(tools)
+	endif()
+endif()
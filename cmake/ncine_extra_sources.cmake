@@ -96,10 +96,16 @@ if(OPENAL_FOUND)
 		${NCINE_ROOT}/include/ncine/IAudioPlayer.h
 		${NCINE_ROOT}/include/ncine/AudioBufferPlayer.h
 		${NCINE_ROOT}/include/ncine/AudioStreamPlayer.h
+		${NCINE_ROOT}/include/ncine/AudioBufferCache.h
+		${NCINE_ROOT}/include/ncine/AudioVoicePool.h
+		${NCINE_ROOT}/include/ncine/AudioMixer.h
+		${NCINE_ROOT}/include/ncine/IAudioSink.h
+		${NCINE_ROOT}/include/ncine/WavAudioSink.h
 	)
 
 	list(APPEND PRIVATE_HEADERS
 		${NCINE_ROOT}/src/include/ALAudioDevice.h
+		${NCINE_ROOT}/src/include/ALAudioSink.h
 		${NCINE_ROOT}/src/include/AudioLoaderWav.h
 	)
 
@@ -112,6 +118,11 @@ if(OPENAL_FOUND)
 		${NCINE_ROOT}/src/audio/IAudioPlayer.cpp
 		${NCINE_ROOT}/src/audio/AudioBufferPlayer.cpp
 		${NCINE_ROOT}/src/audio/AudioStreamPlayer.cpp
+		${NCINE_ROOT}/src/audio/AudioBufferCache.cpp
+		${NCINE_ROOT}/src/audio/AudioVoicePool.cpp
+		${NCINE_ROOT}/src/audio/AudioMixer.cpp
+		${NCINE_ROOT}/src/audio/ALAudioSink.cpp
+		${NCINE_ROOT}/src/audio/WavAudioSink.cpp
 	)
 
 	if(VORBIS_FOUND)
@@ -170,6 +181,8 @@ if(Threads_FOUND)
 	list(APPEND PRIVATE_HEADERS ${NCINE_ROOT}/src/include/ThreadPool.h)
 	list(APPEND SOURCES ${NCINE_ROOT}/src/threading/ThreadPool.cpp)
 	list(APPEND PRIVATE_HEADERS ${NCINE_ROOT}/src/include/ThreadCommands.h)
+	list(APPEND PRIVATE_HEADERS ${NCINE_ROOT}/src/include/ParallelVisit.h)
+	list(APPEND SOURCES ${NCINE_ROOT}/src/graphics/ParallelVisit.cpp)
 endif()
 
 if(LUA_FOUND)
@@ -179,6 +192,7 @@ if(LUA_FOUND)
 	list(APPEND HEADERS
 		${NCINE_ROOT}/include/ncine/LuaTypes.h
 		${NCINE_ROOT}/include/ncine/LuaStateManager.h
+		${NCINE_ROOT}/include/ncine/LuaUserDataPool.h
 		${NCINE_ROOT}/include/ncine/LuaClassWrapper.h
 		${NCINE_ROOT}/include/ncine/LuaUtils.h
 		${NCINE_ROOT}/include/ncine/LuaDebug.h
@@ -193,6 +207,8 @@ if(LUA_FOUND)
 	list(APPEND PRIVATE_HEADERS
 		${NCINE_ROOT}/src/include/LuaClassTracker.h
 		${NCINE_ROOT}/src/include/LuaStatistics.h
+		${NCINE_ROOT}/src/include/LuaProfiler.h
+		${NCINE_ROOT}/src/include/LuaMemoryPool.h
 		${NCINE_ROOT}/src/include/LuaNames.h
 		${NCINE_ROOT}/src/include/LuaILogger.h
 		${NCINE_ROOT}/src/include/LuaRect.h
@@ -223,9 +239,12 @@ if(LUA_FOUND)
 
 	list(APPEND SOURCES
 		${NCINE_ROOT}/src/scripting/LuaStateManager.cpp
+		${NCINE_ROOT}/src/scripting/LuaUserDataPool.cpp
 		${NCINE_ROOT}/src/scripting/LuaUtils.cpp
 		${NCINE_ROOT}/src/scripting/LuaDebug.cpp
 		${NCINE_ROOT}/src/scripting/LuaStatistics.cpp
+		${NCINE_ROOT}/src/scripting/LuaProfiler.cpp
+		${NCINE_ROOT}/src/scripting/LuaMemoryPool.cpp
 		${NCINE_ROOT}/src/scripting/LuaIAppEventHandler.cpp
 		${NCINE_ROOT}/src/scripting/LuaILogger.cpp
 		${NCINE_ROOT}/src/scripting/LuaColor.cpp
@@ -391,10 +410,26 @@ if(NCINE_WITH_TRACY)
 		${NCINE_ROOT}/include/ncine/tracy_opengl.h
 	)
 
-	list(APPEND SOURCES
-		${NCINE_ROOT}/src/tracy_memory.cpp
-		${TRACY_SOURCE_DIR}/TracyClient.cpp
-	)
+	list(APPEND SOURCES ${TRACY_SOURCE_DIR}/TracyClient.cpp)
+	# The operators replaced for memory tags also forward allocations to Tracy
+	if(NOT NCINE_WITH_MEMORY_TAGS)
+		list(APPEND SOURCES ${NCINE_ROOT}/src/tracy_memory.cpp)
+	endif()
+elseif(NCINE_WITH_FRAME_PROFILER)
+	target_compile_definitions(ncine PRIVATE "WITH_FRAME_PROFILER")
+endif()
+
+if(NCINE_WITH_MEMORY_TAGS)
+	# Every block carries a header written by the replaced operators, so every module has to allocate through them.
+	# Windows DLLs and macOS two-level namespaces would keep the replacement inside the engine library.
+	if(NCINE_DYNAMIC_LIBRARY AND (WIN32 OR APPLE))
+		message(FATAL_ERROR "Memory tags need the static version of the library on this platform, turn off NCINE_DYNAMIC_LIBRARY or NCINE_WITH_MEMORY_TAGS")
+	endif()
+
+	target_compile_definitions(ncine PRIVATE "WITH_MEMORY_TAGS")
+	# The nctl containers in the public headers only tag their allocations when the operators account them
+	target_compile_definitions(ncine PUBLIC "NCINE_WITH_MEMORY_TAGS")
+	list(APPEND SOURCES ${NCINE_ROOT}/src/memory_tags.cpp)
 endif()
 
 if(NCINE_WITH_RENDERDOC AND NOT APPLE)
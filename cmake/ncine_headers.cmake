@@ -21,6 +21,7 @@ set(HEADERS
 	${NCINE_ROOT}/include/ncine/Quaternion.h
 	${NCINE_ROOT}/include/ncine/IIndexer.h
 	${NCINE_ROOT}/include/ncine/ILogger.h
+	${NCINE_ROOT}/include/ncine/FileLogger.h
 	${NCINE_ROOT}/include/ncine/IAudioDevice.h
 	${NCINE_ROOT}/include/ncine/IThreadPool.h
 	${NCINE_ROOT}/include/ncine/IThreadCommand.h
@@ -29,6 +30,10 @@ set(HEADERS
 	${NCINE_ROOT}/include/ncine/DisplayMode.h
 	${NCINE_ROOT}/include/ncine/TimeStamp.h
 	${NCINE_ROOT}/include/ncine/Timer.h
+	${NCINE_ROOT}/include/ncine/FramePacer.h
+	${NCINE_ROOT}/include/ncine/FrameProfiler.h
+	${NCINE_ROOT}/include/ncine/FrameReplay.h
+	${NCINE_ROOT}/include/ncine/MemoryStatistics.h
 	${NCINE_ROOT}/include/ncine/Font.h
 	${NCINE_ROOT}/include/ncine/FileSystem.h
 	${NCINE_ROOT}/include/ncine/IFile.h
@@ -55,6 +60,7 @@ set(NCTL_HEADERS
 	${NCINE_ROOT}/include/nctl/iterator.h
 	${NCINE_ROOT}/include/nctl/type_traits.h
 	${NCINE_ROOT}/include/nctl/utility.h
+	${NCINE_ROOT}/include/nctl/memory_tags.h
 	${NCINE_ROOT}/include/nctl/Array.h
 	${NCINE_ROOT}/include/nctl/ArrayIterator.h
 	${NCINE_ROOT}/include/nctl/StaticArray.h
@@ -62,6 +68,7 @@ set(NCTL_HEADERS
 	${NCINE_ROOT}/include/nctl/ListIterator.h
 	${NCINE_ROOT}/include/nctl/String.h
 	${NCINE_ROOT}/include/nctl/StringIterator.h
+	${NCINE_ROOT}/include/nctl/Utf8.h
 	${NCINE_ROOT}/include/nctl/HashFunctions.h
 	${NCINE_ROOT}/include/nctl/HashMap.h
 	${NCINE_ROOT}/include/nctl/HashMapIterator.h
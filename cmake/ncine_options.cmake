@@ -1,6 +1,8 @@
 option(NCINE_BUILD_TESTS "Build the engine test programs" ON)
 option(NCINE_BUILD_UNIT_TESTS "Build the engine unit tests" OFF)
 option(NCINE_BUILD_BENCHMARKS "Build the engine micro benchmarks" OFF)
+option(NCINE_BUILD_APPTEST_BENCHMARKS "Register the test programs as headless benchmarks to be run by CTest" OFF)
+option(NCINE_BUILD_TOOLS "Build the engine offline tools" OFF)
 option(NCINE_INSTALL_DEV_SUPPORT "Install files to support development" ON)
 option(NCINE_LINKTIME_OPTIMIZATION "Compile the engine with link time optimization when in release" OFF)
 option(NCINE_AUTOVECTORIZATION_REPORT "Enable report generation from compiler auto-vectorization" OFF)
@@ -33,6 +35,8 @@ option(NCINE_WITH_LUA "Enable Lua scripting integration" ON)
 option(NCINE_WITH_IMGUI "Enable the integration with Dear ImGui" ON)
 option(NCINE_WITH_NUKLEAR "Enable the integration with Nuklear" OFF)
 option(NCINE_WITH_TRACY "Enable the integration with the Tracy frame profiler" OFF)
+option(NCINE_WITH_FRAME_PROFILER "Enable the built-in frame profiler zones when Tracy is not used" ON)
+option(NCINE_WITH_MEMORY_TAGS "Enable the accounting of allocations per subsystem in the global new and delete operators (static library only on Windows and macOS)" OFF)
 option(NCINE_WITH_RENDERDOC "Enable the integration with RenderDoc" OFF)
 
 if(EMSCRIPTEN)
@@ -41,6 +45,7 @@ endif()
 
 set(NCINE_DATA_DIR "${PARENT_SOURCE_DIR}/nCine-data" CACHE PATH "Set the path to the engine data directory")
 set(NCINE_TESTS_DATA_DIR "" CACHE STRING "Set the path to the data directory that will be embedded in test executables")
+set(NCINE_APPTEST_BENCHMARK_FRAMES 600 CACHE STRING "Set the number of frames rendered by each test program when run as a benchmark")
 # The external Android dir is set regardless of the status of build Android flag, so that presets work even when the flag is off
 set(EXTERNAL_ANDROID_DIR "${PARENT_SOURCE_DIR}/nCine-android-external" CACHE PATH "Set the path to the Android libraries directory")
 
@@ -3,14 +3,16 @@ set(PRIVATE_HEADERS
 	${NCINE_ROOT}/src/include/Clock.h
 	${NCINE_ROOT}/src/include/ArrayIndexer.h
 	${NCINE_ROOT}/src/include/FrameTimer.h
+	${NCINE_ROOT}/src/include/FrameBenchmark.h
 	${NCINE_ROOT}/src/include/StandardFile.h
-	${NCINE_ROOT}/src/include/FileLogger.h
+	${NCINE_ROOT}/src/include/MemoryFile.h
 	${NCINE_ROOT}/src/include/JoyMapping.h
 	${NCINE_ROOT}/src/input/JoyMappingDb.h
 	${NCINE_ROOT}/src/include/FntParser.h
 	${NCINE_ROOT}/src/include/FontGlyph.h
 	${NCINE_ROOT}/src/include/GfxCapabilities.h
 	${NCINE_ROOT}/src/include/RenderResources.h
+	${NCINE_ROOT}/src/include/BinaryShaderCache.h
 	${NCINE_ROOT}/src/include/RenderCommand.h
 	${NCINE_ROOT}/src/include/RenderQueue.h
 	${NCINE_ROOT}/src/include/Material.h
@@ -47,6 +49,7 @@ set(PRIVATE_HEADERS
 	${NCINE_ROOT}/src/include/RenderBatcher.h
 	${NCINE_ROOT}/src/include/GLDebug.h
 	${NCINE_ROOT}/src/include/RenderStatistics.h
+	${NCINE_ROOT}/src/include/RenderTimerQueries.h
 	${NCINE_ROOT}/src/include/GLVertexFormat.h
 	${NCINE_ROOT}/src/include/RenderVaoPool.h
 )
@@ -2,6 +2,7 @@ set(SOURCES
 	${NCINE_ROOT}/src/base/Random.cpp
 	${NCINE_ROOT}/src/base/Object.cpp
 	${NCINE_ROOT}/src/base/String.cpp
+	${NCINE_ROOT}/src/base/Utf8.cpp
 	${NCINE_ROOT}/src/base/Clock.cpp
 	${NCINE_ROOT}/src/ServiceLocator.cpp
 	${NCINE_ROOT}/src/FileLogger.cpp
@@ -9,12 +10,18 @@ set(SOURCES
 	${NCINE_ROOT}/src/TimeStamp.cpp
 	${NCINE_ROOT}/src/Timer.cpp
 	${NCINE_ROOT}/src/FrameTimer.cpp
+	${NCINE_ROOT}/src/FramePacer.cpp
+	${NCINE_ROOT}/src/FrameProfiler.cpp
+	${NCINE_ROOT}/src/MemoryStatistics.cpp
+	${NCINE_ROOT}/src/FrameBenchmark.cpp
+	${NCINE_ROOT}/src/FrameReplay.cpp
 	${NCINE_ROOT}/src/Font.cpp
 	${NCINE_ROOT}/src/FntParser.cpp
 	${NCINE_ROOT}/src/FontGlyph.cpp
 	${NCINE_ROOT}/src/FileSystem.cpp
 	${NCINE_ROOT}/src/IFile.cpp
 	${NCINE_ROOT}/src/StandardFile.cpp
+	${NCINE_ROOT}/src/MemoryFile.cpp
 	${NCINE_ROOT}/src/input/IInputManager.cpp
 	${NCINE_ROOT}/src/input/JoyMapping.cpp
 	${NCINE_ROOT}/src/graphics/Color.cpp
@@ -23,6 +30,7 @@ set(SOURCES
 	${NCINE_ROOT}/src/graphics/IGfxDevice.cpp
 	${NCINE_ROOT}/src/graphics/GfxCapabilities.cpp
 	${NCINE_ROOT}/src/graphics/RenderResources.cpp
+	${NCINE_ROOT}/src/graphics/BinaryShaderCache.cpp
 	${NCINE_ROOT}/src/graphics/RenderCommand.cpp
 	${NCINE_ROOT}/src/graphics/RenderQueue.cpp
 	${NCINE_ROOT}/src/graphics/Material.cpp
@@ -70,6 +78,7 @@ set(SOURCES
 	${NCINE_ROOT}/src/graphics/RenderBatcher.cpp
 	${NCINE_ROOT}/src/graphics/opengl/GLDebug.cpp
 	${NCINE_ROOT}/src/graphics/RenderStatistics.cpp
+	${NCINE_ROOT}/src/graphics/RenderTimerQueries.cpp
 	${NCINE_ROOT}/src/graphics/opengl/GLVertexFormat.cpp
 	${NCINE_ROOT}/src/graphics/RenderVaoPool.cpp
 )
@@ -4,6 +4,7 @@
 #include <nctl/String.h>
 #include "ILogger.h"
 #include "Vector2.h"
+#include "Keys.h"
 
 namespace ncine {
 
@@ -24,6 +25,11 @@ class DLL_PUBLIC AppConfiguration
 	ILogger::LogLevel fileLogLevel;
 	/// The interval for frame timer accumulation average and log
 	float frameTimerLogInterval;
+	/// The flag is `true` if log entries are written by a dedicated thread
+	/*! \note The value is only taken into account when threads support has been compiled in */
+	bool withAsyncLogging;
+	/// The key that exports the last frames recorded by the frame profiler, `KeySym::UNKNOWN` to disable it
+	KeySym frameCaptureKey;
 
 	/// The screen resolution
 	/*! \note If either `x` or `y` are zero then the screen resolution will not be changed. */
@@ -34,6 +40,21 @@ class DLL_PUBLIC AppConfiguration
 	bool isResizable;
 	/// The maximum number of frames to render per second or 0 for no limit
 	unsigned int frameLimit;
+	/// The flag is `true` if the rendering occurs offscreen, without showing a window
+	/*! \note The value is not taken into account by the Qt5 backend, use `QT_QPA_PLATFORM=offscreen` instead */
+	bool isHeadless;
+	/// The time in seconds passed to every update instead of the measured one, or 0 to use the real frame time
+	float fixedTimestep;
+	/// The number of frames after which the application quits, or 0 to run until it is closed
+	/*! \note The timings and the rendering statistics of every frame are written in the benchmark file */
+	unsigned int benchmarkFrames;
+	/// The name of the CSV file where the statistics of every frame are written in benchmark mode
+	nctl::String benchmarkFile;
+	/// The name of the file where frame intervals, input events and random seeds are recorded, or empty to disable it
+	nctl::String replayRecordFile;
+	/// The name of a recorded replay file to play back instead of the real input and time, or empty to disable it
+	/*! \note The application quits after the last recorded frame. It takes precedence over recording. */
+	nctl::String replayPlaybackFile;
 
 	/// The window title
 	nctl::String windowTitle;
@@ -45,6 +66,11 @@ class DLL_PUBLIC AppConfiguration
 	/// The flag is `true` when error checking and introspection of shader programs are deferred to first use
 	/*! \note The value is only taken into account when the scenegraph is being used */
 	bool deferShaderQueries;
+	/// The flag is `true` if linked shader program binaries are stored on disk to speed up the next launches
+	/*! \note The value is only taken into account when the scenegraph is being used */
+	bool useBinaryShaderCache;
+	/// The name of the directory inside the save path that contains the binary shader cache
+	nctl::String shaderCacheDirname;
 	/// Fixed size of render commands to be collected for batching on Emscripten and ANGLE
 	/*! \note Increasing this value too much might negatively affect batching shaders compilation time.
 	A value of zero restores the default behavior of non fixed size for batches. */
@@ -55,6 +81,12 @@ class DLL_PUBLIC AppConfiguration
 	unsigned long iboSize;
 	/// The maximum size for the pool of VAOs
 	unsigned int vaoPoolSize;
+	/// The number of buffers used by every audio stream
+	unsigned int audioStreamNumBuffers;
+	/// The size in bytes of each audio stream buffer
+	unsigned long audioStreamBufferSize;
+	/// The number of voices of the software audio mixer, zero to disable it
+	unsigned int audioMixerVoices;
 
 	/// The flag is `true` if the debug overlay is enabled
 	bool withDebugOverlay;
@@ -62,6 +94,9 @@ class DLL_PUBLIC AppConfiguration
 	bool withAudio;
 	/// The flag is `true` if the threading subsystem is enabled
 	bool withThreads;
+	/// The flag is `true` if audio streams are decoded by a dedicated thread
+	/*! \note The value is only taken into account when threads support has been compiled in */
+	bool withAudioStreamThread;
 	/// The flag is `true` if the scenegraph based rendering is enabled
 	bool withScenegraph;
 	/// The flag is `true` if the vertical synchronization is enabled
@@ -10,8 +10,12 @@
 namespace ncine {
 
 class FrameTimer;
+class FramePacer;
+class FrameBenchmark;
+class FrameReplay;
 class SceneNode;
 class RenderQueue;
+class ParallelVisit;
 class IInputManager;
 class IAppEventHandler;
 class ImGuiDrawing;
@@ -25,15 +29,30 @@ class DLL_PUBLIC Application
 	struct RenderingSettings
 	{
 		RenderingSettings()
-		    : batchingEnabled(true), batchingWithIndices(false),
-		      cullingEnabled(true), minBatchSize(4), maxBatchSize(500) {}
+		    : batchingEnabled(true), batchingWithIndices(false), batchingWithInstancing(false), batchingWithReordering(false),
+		      cullingEnabled(true), parallelVisit(false), gpuTimingEnabled(false), gpuTimingPerCommandType(false),
+		      minBatchSize(4), maxBatchSize(500) {}
 
 		/// True if batching is enabled
 		bool batchingEnabled;
 		/// True if using indices for vertex batching
 		bool batchingWithIndices;
+		/// True if sprites are batched with hardware instancing instead of uniform blocks
+		/*! \note Instanced batches are only limited by the VBO size and not by the maximum batch size, they need OpenGL 4.2 or `GL_ARB_base_instance` */
+		bool batchingWithInstancing;
+		/// True if transparent commands that don't overlap are reordered to batch them across layers
+		/*! \note Overlaps are tested with the same bounding boxes used for culling */
+		bool batchingWithReordering;
 		/// True if node culling is enabled
 		bool cullingEnabled;
+		/// True if the scenegraph visit is split among the thread pool workers
+		/*! \note It requires the threading subsystem and nodes that don't access shared state when drawing */
+		bool parallelVisit;
+		/// True if the GPU time of the rendering phases is measured with timer queries
+		/*! \note Results are available some frames later and only if the device supports timer queries */
+		bool gpuTimingEnabled;
+		/// True if the GPU time is also measured for every command type, with one timer query per draw command
+		bool gpuTimingPerCommandType;
 		/// Minimum size for a batch to be collected
 		unsigned int minBatchSize;
 		/// Maximum size for a batch before a forced split
@@ -46,6 +65,7 @@ class DLL_PUBLIC Application
 		{
 			PRE_INIT,
 			INIT_COMMON,
+			RENDER_RESOURCES,
 			APP_INIT,
 			FRAME_START,
 			UPDATE_VISIT_DRAW,
@@ -83,7 +103,16 @@ class DLL_PUBLIC Application
 	/// Returns the total number of frames already rendered
 	unsigned long int numFrames() const;
 	/// Returns the elapsed time since the end of the previous frame in milliseconds
+	/*! \note It returns the recorded interval when playing back a replay, or the fixed timestep if one has been set */
 	float interval() const;
+	/// Returns the standard deviation of the frame time in seconds, calculated over the FPS averaging interval
+	float intervalDeviation() const;
+	/// Returns the longest frame time in seconds during the FPS averaging interval
+	float maxInterval() const;
+	/// Returns the frame pacer, or `nullptr` if the frame rate is not limited
+	inline const FramePacer *framePacer() const { return framePacer_.get(); }
+	/// Exports the last frames recorded by the frame profiler as a Chrome trace in the save path
+	bool exportFrameCapture();
 
 	/// Returns the screen width as a float number
 	inline float width() const { return static_cast<float>(gfxDevice_->width()); }
@@ -123,6 +152,7 @@ class DLL_PUBLIC Application
 	bool autoSuspension_;
 	bool hasFocus_;
 	bool shouldQuit_;
+	bool frameCaptureKeyDown_;
 	const AppConfiguration appCfg_;
 	RenderingSettings renderingSettings_;
 	float timings_[Timings::COUNT];
@@ -130,8 +160,14 @@ class DLL_PUBLIC Application
 
 	TimeStamp profileStartTime_;
 	nctl::UniquePtr<FrameTimer> frameTimer_;
+	nctl::UniquePtr<FramePacer> framePacer_;
+	nctl::UniquePtr<FrameBenchmark> frameBenchmark_;
+	nctl::UniquePtr<FrameReplay> frameReplay_;
 	nctl::UniquePtr<IGfxDevice> gfxDevice_;
 	nctl::UniquePtr<RenderQueue> renderQueue_;
+#ifdef WITH_THREADS
+	nctl::UniquePtr<ParallelVisit> parallelVisit_;
+#endif
 	nctl::UniquePtr<SceneNode> rootNode_;
 	nctl::UniquePtr<IDebugOverlay> debugOverlay_;
 	nctl::UniquePtr<IInputManager> inputManager_;
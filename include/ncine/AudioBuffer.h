@@ -16,6 +16,9 @@ class DLL_PUBLIC AudioBuffer : public Object
 	AudioBuffer();
 	/// A constructor creating a buffer from a file
 	explicit AudioBuffer(const char *filename);
+	/// A constructor creating a buffer from a file already loaded in memory
+	/*! \param bufferName The name of the buffer, its extension selects the decoder */
+	AudioBuffer(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize);
 	~AudioBuffer() override;
 
 	/// Returns the OpenAL buffer id
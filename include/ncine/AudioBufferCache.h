@@ -0,0 +1,100 @@
+#ifndef CLASS_NCINE_AUDIOBUFFERCACHE
+#define CLASS_NCINE_AUDIOBUFFERCACHE
+
+#include <cstdint>
+#include "common_defines.h"
+#include <nctl/HashMap.h>
+#include <nctl/String.h>
+#include <nctl/UniquePtr.h>
+
+namespace ncine {
+
+class AudioBuffer;
+
+/// A cache of decoded audio buffers shared through reference counting
+/*! Buffers are addressed by the hash of their file content, so the same sound loaded
+ *  from different paths is decoded only once. A file is read once, the same bytes are hashed
+ *  and then decoded from memory. Unreferenced buffers are kept in memory
+ *  and evicted from the least recently released one when the memory budget is exceeded. */
+class DLL_PUBLIC AudioBufferCache
+{
+  public:
+	/// Creates a cache with the specified memory budget in bytes for decoded samples
+	explicit AudioBufferCache(unsigned long memoryBudget);
+	~AudioBufferCache();
+
+	/// Returns the buffer decoded from the specified file and increases its reference count
+	/*! \return A `nullptr` if the file cannot be read */
+	AudioBuffer *acquire(const char *filename);
+	/// Decreases the reference count of a buffer acquired from the cache
+	void release(AudioBuffer *audioBuffer);
+	/// Decodes a file in advance without acquiring its buffer
+	bool preload(const char *filename);
+
+	/// Returns the memory budget in bytes
+	inline unsigned long memoryBudget() const { return memoryBudget_; }
+	/// Sets a new memory budget in bytes and evicts unreferenced buffers to respect it
+	void setMemoryBudget(unsigned long memoryBudget);
+	/// Returns the memory in bytes used by decoded samples
+	inline unsigned long memoryUsed() const { return memoryUsed_; }
+
+	/// Returns the number of cached buffers
+	inline unsigned int numBuffers() const { return buffers_.size(); }
+	/// Returns the number of acquisitions that did not need to decode a file
+	inline unsigned int numHits() const { return numHits_; }
+	/// Returns the number of acquisitions that needed to decode a file
+	inline unsigned int numMisses() const { return numMisses_; }
+	/// Returns the number of buffers evicted to respect the memory budget
+	inline unsigned int numEvictions() const { return numEvictions_; }
+
+	/// Evicts every unreferenced buffer
+	void clear();
+
+  private:
+	/// The cache entry for a decoded buffer
+	struct Entry
+	{
+		Entry()
+		    : contentLength(0), contentDigest(0), refCount(0), releaseStamp(0) {}
+
+		nctl::UniquePtr<AudioBuffer> audioBuffer;
+		/// The length and a 64 bit hash of the file content, to tell apart files whose 32 bit hashes collide
+		unsigned int contentLength;
+		uint64_t contentDigest;
+		unsigned int refCount;
+		/// The value of the release counter when the reference count has dropped to zero
+		unsigned long releaseStamp;
+	};
+
+	static const unsigned int InitialCapacity = 32;
+
+	unsigned long memoryBudget_;
+	unsigned long memoryUsed_;
+	unsigned long releaseCounter_;
+	unsigned int numHits_;
+	unsigned int numMisses_;
+	unsigned int numEvictions_;
+
+	/// Cache entries indexed by the hash of the file content, probing the next values when different contents collide
+	nctl::HashMap<nctl::hash_t, Entry, nctl::FNV1aHashFunc<nctl::hash_t>> buffers_;
+	/// Content hashes indexed by filename, to avoid reading the same file again
+	nctl::StringHashMap<nctl::hash_t> contentHashes_;
+	/// Content hashes indexed by the decoded buffer, to release it without searching
+	nctl::HashMap<const AudioBuffer *, nctl::hash_t> bufferHashes_;
+
+	/// Returns the entry for the specified file, decoding it if needed
+	Entry *retrieveEntry(const char *filename);
+	/// Evicts the least recently released buffers until the memory used is within the budget
+	void evict(unsigned long memoryLimit);
+	/// Removes the entry with the specified content hash and every filename pointing to it
+	void removeEntry(nctl::hash_t contentHash);
+
+	/// Deleted copy constructor
+	AudioBufferCache(const AudioBufferCache &) = delete;
+	/// Deleted assignment operator
+	AudioBufferCache &operator=(const AudioBufferCache &) = delete;
+};
+
+}
+
+#endif
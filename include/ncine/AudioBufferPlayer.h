@@ -12,6 +12,8 @@ class AudioBuffer;
 class DLL_PUBLIC AudioBufferPlayer : public IAudioPlayer
 {
   public:
+	/// A constructor creating a player without an associated buffer
+	AudioBufferPlayer();
 	/// A constructor creating a player from a shared buffer
 	explicit AudioBufferPlayer(AudioBuffer *audioBuffer);
 	~AudioBufferPlayer() override { stop(); }
@@ -21,6 +23,11 @@ class DLL_PUBLIC AudioBufferPlayer : public IAudioPlayer
 	int frequency() const override;
 	unsigned long bufferSize() const override;
 
+	/// Returns the shared buffer played by the player
+	inline const AudioBuffer *audioBuffer() const { return audioBuffer_; }
+	/// Sets a new shared buffer to play, stopping the player first
+	void setAudioBuffer(AudioBuffer *audioBuffer);
+
 	void play() override;
 	void pause() override;
 	void stop() override;
@@ -0,0 +1,146 @@
+#ifndef CLASS_NCINE_AUDIOMIXER
+#define CLASS_NCINE_AUDIOMIXER
+
+#include "common_defines.h"
+#include <nctl/Array.h>
+#include <nctl/UniquePtr.h>
+#include <cstdint>
+
+namespace ncine {
+
+class IAudioSink;
+
+/// A software mixer of many voices into a single stereo stream
+/*! Voices are mixed on a floating point bus with their own gain, pitch and pan,
+ *  then scaled by the gain of their group and by the master gain. */
+class DLL_PUBLIC AudioMixer
+{
+  public:
+	/// Sixteen bit samples decoded in memory that can be played by many voices at once
+	class DLL_PUBLIC Sound
+	{
+	  public:
+		/// Decodes a sound from a file
+		explicit Sound(const char *filename);
+		/// Copies interleaved samples from memory
+		Sound(const int16_t *samples, unsigned long numFrames, int numChannels, int frequency);
+
+		/// Returns the interleaved samples
+		inline const int16_t *samples() const { return samples_.get(); }
+		/// Returns the number of frames, samples for every channel
+		inline unsigned long numFrames() const { return numFrames_; }
+		/// Returns the number of channels
+		inline int numChannels() const { return numChannels_; }
+		/// Returns the samples frequency
+		inline int frequency() const { return frequency_; }
+
+	  private:
+		nctl::UniquePtr<int16_t[]> samples_;
+		unsigned long numFrames_;
+		int numChannels_;
+		int frequency_;
+	};
+
+	/// The handle returned when no voice is available
+	static const unsigned int InvalidVoice = ~0U;
+	/// Number of voice groups, every group is a submix with its own gain
+	static const unsigned int NumGroups = 8;
+	/// The minimum pitch of a voice, lower values are clamped
+	static const float MinPitch;
+	/// The maximum pitch of a voice, higher values are clamped
+	static const float MaxPitch;
+
+	/// Creates a mixer with the specified output frequency and maximum number of voices
+	AudioMixer(int frequency, unsigned int maxVoices);
+
+	/// Returns the output frequency
+	inline int frequency() const { return frequency_; }
+	/// Returns the maximum number of voices
+	inline unsigned int maxVoices() const { return voices_.size(); }
+	/// Returns the number of voices currently playing
+	inline unsigned int numActiveVoices() const { return numActiveVoices_; }
+
+	/// Returns the master gain
+	inline float masterGain() const { return masterGain_; }
+	/// Sets the master gain
+	inline void setMasterGain(float gain) { masterGain_ = gain; }
+	/// Returns the gain of a group
+	float groupGain(unsigned int group) const;
+	/// Sets the gain of a group
+	void setGroupGain(unsigned int group, float gain);
+
+	/// Starts playing a sound on a free voice of the default group
+	/*! \note The sound should outlive every voice playing it */
+	unsigned int play(const Sound &sound);
+	/// Starts playing a sound on a free voice with the specified parameters
+	/*! \return The handle of the voice or `InvalidVoice` if they are all busy */
+	unsigned int play(const Sound &sound, unsigned int group, float gain, float pitch, float pan, bool looping);
+	/// Stops a voice
+	void stop(unsigned int voice);
+	/// Stops every voice
+	void stopAll();
+	/// Returns true if the voice is still playing
+	bool isPlaying(unsigned int voice) const;
+
+	/// Sets the gain of a voice
+	void setGain(unsigned int voice, float gain);
+	/// Sets the pitch of a voice, which also changes its playback speed
+	/*! \note The pitch is clamped between `MinPitch` and `MaxPitch`, a value that is not a number becomes the minimum */
+	void setPitch(unsigned int voice, float pitch);
+	/// Sets the pan of a voice, from -1.0 (left) to 1.0 (right)
+	void setPan(unsigned int voice, float pan);
+
+	/// Mixes the specified number of frames and writes them to the sink
+	void render(IAudioSink &sink, unsigned int numFrames);
+
+  private:
+	/// Number of frames mixed at once on the bus
+	static const unsigned int ChunkFrames = 256;
+
+	struct Voice
+	{
+		Voice()
+		    : sound(nullptr), position(0.0), gain(1.0f), pitch(1.0f), pan(0.0f),
+		      group(0), generation(0), isLooping(false), isActive(false) {}
+
+		const Sound *sound;
+		/// Current position in frames, with a fractional part when resampling
+		double position;
+		float gain;
+		float pitch;
+		float pan;
+		unsigned int group;
+		/// Incremented every time the voice is reused, to invalidate old handles, it wraps around after 65536 uses
+		unsigned int generation;
+		bool isLooping;
+		bool isActive;
+	};
+
+	int frequency_;
+	float masterGain_;
+	float groupGains_[NumGroups];
+	unsigned int numActiveVoices_;
+	nctl::Array<Voice> voices_;
+
+	/// Left and right channels of the bus
+	float busLeft_[ChunkFrames];
+	float busRight_[ChunkFrames];
+	/// Interleaved output frames
+	int16_t output_[ChunkFrames * 2];
+
+	/// Returns the voice associated to a handle, or `nullptr` if the handle is stale
+	Voice *retrieveVoice(unsigned int handle);
+	/// Returns the voice associated to a handle, or `nullptr` if the handle is stale (read-only)
+	const Voice *retrieveVoice(unsigned int handle) const;
+	/// Adds the samples of a voice to the bus
+	void mixVoice(Voice &voice, unsigned int numFrames);
+
+	/// Deleted copy constructor
+	AudioMixer(const AudioMixer &) = delete;
+	/// Deleted assignment operator
+	AudioMixer &operator=(const AudioMixer &) = delete;
+};
+
+}
+
+#endif
@@ -2,11 +2,16 @@
 #define CLASS_NCINE_AUDIOSTREAM
 
 #include "IAudioLoader.h"
-#include <nctl/StaticArray.h>
+#include <nctl/Atomic.h>
 
 namespace ncine {
 
+class Mutex;
+class CondVariable;
+
 /// Audio stream class
+/*! Decoded data is handed over to OpenAL through a single producer, single consumer ring of buffers.
+ *  The decoding side can run on a dedicated thread while the OpenAL side always runs on the main one. */
 class DLL_PUBLIC AudioStream
 {
   public:
@@ -19,8 +24,16 @@ class DLL_PUBLIC AudioStream
 	/// Returns the samples frequency
 	inline int frequency() const { return frequency_; }
 	/// Returns the size of the buffer in bytes
-	inline unsigned long bufferSize() const { return BufferSize; }
+	inline unsigned long bufferSize() const { return bufferSize_; }
+	/// Returns the number of streaming buffers
+	inline unsigned int numBuffers() const { return numBuffers_; }
+	/// Returns the number of times the source has run out of queued buffers while playing
+	inline unsigned int numUnderruns() const { return numUnderruns_; }
+	/// Returns the number of decoded buffers waiting to be enqueued
+	unsigned int numDecodedBuffers() const;
 
+	/// Decodes data into every free buffer of the ring
+	bool decode();
 	/// Enqueues new buffers and unqueues processed ones
 	bool enqueue(unsigned int source, bool looping);
 	/// Unqueues any left buffer and rewinds the loader
@@ -28,16 +41,37 @@ class DLL_PUBLIC AudioStream
 
   private:
 	/// Number of buffers for streaming
-	static const int NumBuffers = 3;
+	unsigned int numBuffers_;
 	/// OpenAL buffer queue for streaming
-	nctl::StaticArray<unsigned int, NumBuffers> buffersIds_;
+	nctl::UniquePtr<unsigned int[]> buffersIds_;
 	/// Index of the next available OpenAL buffer
-	int nextAvailableBufferIndex_;
+	unsigned int nextAvailableBufferIndex_;
 
 	/// Size in bytes of each streaming buffer
-	static const int BufferSize = 16 * 1024;
-	/// Memory buffer to feed OpenAL ones
+	unsigned long bufferSize_;
+	/// Memory for the ring of decoded buffers that feed OpenAL ones
 	nctl::UniquePtr<char[]> memBuffer_;
+	/// Number of decoded bytes in each buffer of the ring
+	nctl::UniquePtr<unsigned long[]> decodedBytes_;
+	/// Number of buffers decoded so far, only written by the decoding side
+	mutable nctl::Atomic32 writeCount_;
+	/// Number of buffers enqueued so far, only written by the OpenAL side
+	mutable nctl::Atomic32 readCount_;
+	/// Protects the decoding flag and the loader rewind, created only when threads are enabled
+	nctl::UniquePtr<Mutex> decodeMutex_;
+	/// Signalled by the decoding side when it stops accessing the loader
+	nctl::UniquePtr<CondVariable> decodeCondVar_;
+	/// Set by the decoding side while it is accessing the loader
+	bool isDecoding_;
+	/// Set when looping, read by the decoding side
+	nctl::Atomic32 isLooping_;
+	/// Set by the decoding side when there is no more data to decode
+	nctl::Atomic32 hasReachedEnd_;
+
+	/// The flag is `true` if the source has started to play the queued buffers
+	bool isSourceStarted_;
+	/// Number of times the source has run out of queued buffers while playing
+	unsigned int numUnderruns_;
 
 	/// OpenAL id of the currently playing buffer, or 0 if not
 	unsigned int currentBufferId_;
@@ -57,6 +91,15 @@ class DLL_PUBLIC AudioStream
 	/// Deleted assignment operator
 	AudioStream &operator=(const AudioStream &) = delete;
 
+	/// Sets the looping flag read by the decoding side
+	void setLooping(bool looping);
+	/// Unqueues the buffers already processed by the source
+	void unqueueProcessed(unsigned int source);
+	/// Marks the loader as being accessed by the decoding side, waiting if it is being rewound
+	void beginDecoding();
+	/// Releases the loader and wakes up a stop waiting for the decoding side
+	void endDecoding();
+
 	friend class AudioStreamPlayer;
 };
 
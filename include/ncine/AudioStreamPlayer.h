@@ -20,6 +20,13 @@ class DLL_PUBLIC AudioStreamPlayer : public IAudioPlayer
 	inline int frequency() const override { return audioStream_.frequency(); }
 	unsigned long bufferSize() const override { return audioStream_.bufferSize(); }
 
+	/// Returns the number of streaming buffers
+	inline unsigned int numStreamBuffers() const { return audioStream_.numBuffers(); }
+	/// Returns the number of decoded buffers waiting to be enqueued
+	inline unsigned int numDecodedBuffers() const { return audioStream_.numDecodedBuffers(); }
+	/// Returns the number of times the stream has run out of queued buffers while playing
+	inline unsigned int numUnderruns() const { return audioStream_.numUnderruns(); }
+
 	void play() override;
 	void pause() override;
 	void stop() override;
@@ -36,6 +43,8 @@ class DLL_PUBLIC AudioStreamPlayer : public IAudioPlayer
 	AudioStreamPlayer(const AudioStreamPlayer &) = delete;
 	/// Deleted assignment operator
 	AudioStreamPlayer &operator=(const AudioStreamPlayer &) = delete;
+
+	friend class ALAudioDevice;
 };
 
 }
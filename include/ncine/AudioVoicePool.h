@@ -0,0 +1,69 @@
+#ifndef CLASS_NCINE_AUDIOVOICEPOOL
+#define CLASS_NCINE_AUDIOVOICEPOOL
+
+#include "AudioBufferPlayer.h"
+#include <nctl/UniquePtr.h>
+
+namespace ncine {
+
+/// A pool of preallocated buffer players for fire-and-forget sounds
+/*! When every voice is busy, the one with the lowest priority, and then the oldest, is stolen.
+ *  A voice is never stolen by a request with a lower priority than its own. */
+class DLL_PUBLIC AudioVoicePool
+{
+  public:
+	/// Creates a pool with the specified number of voices
+	explicit AudioVoicePool(unsigned int numVoices);
+	~AudioVoicePool();
+
+	/// Plays a shared buffer once on a voice of the pool
+	/*! \return The voice playing the buffer or `nullptr` if no voice could be used */
+	AudioBufferPlayer *play(AudioBuffer *audioBuffer, int priority);
+	/// Plays a shared buffer once on a voice of the pool with the specified gain, pitch and position
+	AudioBufferPlayer *play(AudioBuffer *audioBuffer, int priority, float gain, float pitch, const Vector3f &position);
+
+	/// Stops every voice of the pool
+	void stopAll();
+
+	/// Returns the number of voices in the pool
+	inline unsigned int numVoices() const { return numVoices_; }
+	/// Returns the number of voices currently playing
+	unsigned int numActiveVoices() const;
+	/// Returns the number of voices that have been stolen
+	inline unsigned int numSteals() const { return numSteals_; }
+	/// Returns the number of requests dropped because no voice could be used
+	inline unsigned int numDropped() const { return numDropped_; }
+
+  private:
+	/// A pooled player with the priority of the sound it is playing
+	struct Voice
+	{
+		Voice()
+		    : priority(0), playStamp(0) {}
+
+		AudioBufferPlayer player;
+		int priority;
+		/// The value of the play counter when the voice has started playing
+		unsigned long playStamp;
+	};
+
+	unsigned int numVoices_;
+	nctl::UniquePtr<Voice[]> voices_;
+	unsigned long playCounter_;
+	unsigned int numSteals_;
+	unsigned int numDropped_;
+
+	/// Returns the voice with the lowest priority, and then the oldest one, that can be stolen
+	Voice *findVictim(int priority);
+	/// Starts playing a buffer on the specified voice
+	bool playOnVoice(Voice &voice, AudioBuffer *audioBuffer, int priority, float gain, float pitch, const Vector3f &position);
+
+	/// Deleted copy constructor
+	AudioVoicePool(const AudioVoicePool &) = delete;
+	/// Deleted assignment operator
+	AudioVoicePool &operator=(const AudioVoicePool &) = delete;
+};
+
+}
+
+#endif
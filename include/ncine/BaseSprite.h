@@ -15,9 +15,9 @@ class DLL_PUBLIC BaseSprite : public DrawableNode
 {
   public:
 	/// Sets sprite width
-	inline void setWidth(float width) { width_ = width; }
+	void setWidth(float width);
 	/// Sets sprite height
-	inline void setHeight(float height) { height_ = height; }
+	void setHeight(float height);
 	/// Sets sprite size
 	void setSize(float width, float height);
 	/// Sets sprite size with a `Vector2f`
@@ -26,7 +26,7 @@ class DLL_PUBLIC BaseSprite : public DrawableNode
 	/// Gets the texture object
 	inline const Texture *texture() const { return texture_; }
 	/// Sets the texture object
-	inline void setTexture(Texture *texture) { texture_ = texture; }
+	void setTexture(Texture *texture);
 
 	/// Gets the texture source rectangle for blitting
 	inline Recti texRect() const { return texRect_; }
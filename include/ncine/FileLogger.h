@@ -0,0 +1,95 @@
+#ifndef CLASS_NCINE_FILELOGGER
+#define CLASS_NCINE_FILELOGGER
+
+#include <cstdio>
+#include "ILogger.h"
+#include "IFile.h"
+
+namespace ncine {
+
+/// The standard console and file logger
+/*! \note Entries are formatted in a buffer local to the calling thread.
+ *  In asynchronous mode they are passed through a bounded lock-free queue to a writer thread,
+ *  which writes them in batches. When the queue is full new entries are dropped and counted. */
+class DLL_PUBLIC FileLogger : public ILogger
+{
+  public:
+	/// The maximum length of a log entry, including the timestamp
+	static const unsigned int MaxEntryLength = 512;
+	/// The number of entries that can wait in the asynchronous queue
+	static const unsigned int AsyncQueueSize = 1024;
+
+	explicit FileLogger(LogLevel consoleLevel);
+	FileLogger(LogLevel consoleLevel, LogLevel fileLevel, const char *filename);
+	~FileLogger() override;
+
+	inline void setConsoleLevel(LogLevel consoleLevel) { consoleLevel_ = consoleLevel; }
+	inline void setFileLevel(LogLevel fileLevel) { fileLevel_ = fileLevel; }
+	bool openLogFile(const char *filename);
+
+	unsigned int write(LogLevel level, const char *fmt, ...) override;
+
+	/// Returns true if entries are written by a dedicated thread
+	inline bool isAsynchronous() const { return asyncWriter_ != nullptr; }
+	/// Starts or stops the writer thread, all the queued entries are written before it stops
+	/*! \note It has no effect if threads support has not been compiled in.
+	 *  No other thread should be logging while the mode changes. */
+	void setAsynchronous(bool asynchronous);
+	/// Waits until all the entries in the asynchronous queue have been written
+	void flush();
+	/// Returns the number of entries dropped because the asynchronous queue was full
+	unsigned int numDroppedEntries() const;
+
+#ifdef WITH_IMGUI
+	/// Returns a copy of the log string for the ImGui console, to be called from the main thread only
+	/*! \note Entries are appended under a lock by any thread calling `write()`. The copy is updated under the same lock,
+	 *  so the returned pointer stays valid until the next call even if other threads keep logging. */
+	const char *logString() const override;
+	void clearLogString() override;
+	unsigned int logStringLength() const override;
+	inline unsigned int logStringCapacity() const override { return LogStringCapacity; }
+#else
+	inline const char *logString() const override { return nullptr; }
+	inline void clearLogString() override {}
+	inline unsigned int logStringLength() const override { return 0; }
+	inline unsigned int logStringCapacity() const override { return 0; }
+#endif
+
+  private:
+	LogLevel consoleLevel_;
+	LogLevel fileLevel_;
+
+#ifdef WITH_IMGUI
+	static const unsigned int LogStringCapacity = 16 * 1024;
+	/// The log string shown by the ImGui console and the lock that protects it
+	struct LogString;
+	nctl::UniquePtr<LogString> logString_;
+#endif
+
+	/// The queue and the thread used in asynchronous mode
+	struct AsyncWriter;
+	nctl::UniquePtr<AsyncWriter> asyncWriter_;
+
+	// Declared at the end to prevent a `heap-use-after-free` AddressSanitizer error
+	nctl::UniquePtr<IFile> fileHandle_;
+
+	/// Sends an entry to the console and to the log file, without flushing the file
+	void writeEntry(LogLevel level, const char *logEntry, unsigned int length);
+	/// Appends an entry to the log string shown by the ImGui console
+	void appendToLogString(LogLevel level, const char *logEntry, unsigned int length);
+	/// Adds an entry to the asynchronous queue, returns false if the queue is full
+	bool enqueueEntry(LogLevel level, const char *logEntry, unsigned int length);
+	/// Writes all the entries in the asynchronous queue and returns their number
+	unsigned int writeQueuedEntries();
+
+	static void writerThreadFunction(void *arg);
+
+	/// Deleted copy constructor
+	FileLogger(const FileLogger &) = delete;
+	/// Deleted assignment operator
+	FileLogger &operator=(const FileLogger &) = delete;
+};
+
+}
+
+#endif
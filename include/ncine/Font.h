@@ -1,6 +1,8 @@
 #ifndef CLASS_NCINE_FONT
 #define CLASS_NCINE_FONT
 
+#include <cstdint>
+#include <nctl/HashMap.h>
 #include "Object.h"
 #include "Vector2.h"
 
@@ -18,7 +20,11 @@ class DLL_PUBLIC Font : public Object
 	enum RenderMode
 	{
 		GLYPH_IN_RED,
-		GLYPH_IN_ALPHA
+		GLYPH_IN_ALPHA,
+		/// Signed distance field in the red channel
+		GLYPH_SDF,
+		/// Multi-channel signed distance field in the RGB channels
+		GLYPH_MSDF
 	};
 
 	/// Constructs the object from an AngelCode's `FNT` file
@@ -40,10 +46,16 @@ class DLL_PUBLIC Font : public Object
 	inline unsigned int numGlyphs() const { return numGlyphs_; }
 	/// Returns number of kerning pairs
 	inline unsigned int numKernings() const { return numKernings_; }
-	/// Returns a constant pointer to a glyph
-	const FontGlyph *glyph(unsigned int glyphId) const;
+	/// Returns a constant pointer to the glyph of a Unicode code point, or `nullptr` if the font does not have it
+	const FontGlyph *glyph(unsigned int codePoint) const;
+	/// Returns the kerning amount between two Unicode code points
+	int kerning(unsigned int firstCodePoint, unsigned int secondCodePoint) const;
 
 	inline RenderMode renderMode() const { return renderMode_; }
+	/// Returns true if the glyphs are stored as a signed distance field
+	inline bool hasDistanceField() const { return renderMode_ == RenderMode::GLYPH_SDF || renderMode_ == RenderMode::GLYPH_MSDF; }
+	/// Returns the distance in texels covered by the full range of a distance field atlas
+	inline unsigned int distanceRange() const { return distanceRange_; }
 
 	inline static ObjectType sType() { return ObjectType::FONT; }
 
@@ -66,12 +78,18 @@ class DLL_PUBLIC Font : public Object
 	/// Number of kernings for this font
 	unsigned int numKernings_;
 
-	/// Maximum number of glyphs in a font
-	static const unsigned int MaxGlyphs = 256;
-	/// Array of font glyphs
-	nctl::UniquePtr<FontGlyph[]> glyphs_;
+	/// Number of code points, starting from zero, that are looked up in a direct access table
+	static const unsigned int NumDirectGlyphs = 256;
+	/// Sparse table of font glyphs, indexed by Unicode code point
+	nctl::UniquePtr<nctl::HashMap<unsigned int, FontGlyph>> glyphs_;
+	/// Direct access table of glyph pointers for the first code points
+	const FontGlyph *directGlyphs_[NumDirectGlyphs];
+	/// Kerning amounts indexed by a pair of code points
+	nctl::UniquePtr<nctl::HashMap<uint64_t, int>> kernings_;
 
 	RenderMode renderMode_;
+	/// Distance range of the atlas, zero if the font has no distance field
+	unsigned int distanceRange_;
 
 	/// Deleted copy constructor
 	Font(const Font &) = delete;
@@ -83,6 +101,8 @@ class DLL_PUBLIC Font : public Object
 
 	/// Checks whether the FNT information are compatible with rendering or not
 	void checkFntInformation();
+	/// Calculates the texture quad of every glyph once the texture is loaded
+	void updateGlyphQuads();
 };
 
 }
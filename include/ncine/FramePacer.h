@@ -0,0 +1,112 @@
+#ifndef CLASS_NCINE_FRAMEPACER
+#define CLASS_NCINE_FRAMEPACER
+
+#include <cstdint>
+#include "common_defines.h"
+
+namespace ncine {
+
+/// The interface to the time source used by the frame pacer
+class DLL_PUBLIC IPacingClock
+{
+  public:
+	virtual ~IPacingClock() = 0;
+
+	/// Returns the current time in ticks
+	virtual uint64_t now() const = 0;
+	/// Returns the number of ticks in a second
+	virtual uint32_t frequency() const = 0;
+	/// Suspends the calling thread for at least the specified number of ticks
+	virtual void sleep(uint64_t ticks) = 0;
+};
+
+inline IPacingClock::~IPacingClock() {}
+
+/// The pacing clock based on the system monotonic clock
+class DLL_PUBLIC SystemPacingClock : public IPacingClock
+{
+  public:
+	SystemPacingClock();
+	~SystemPacingClock() override;
+
+	uint64_t now() const override;
+	uint32_t frequency() const override;
+	/// Sleeps with a high resolution timer when the platform provides one
+	void sleep(uint64_t ticks) override;
+
+  private:
+#if defined(_WIN32)
+	/// The handle of the waitable timer
+	void *timerHandle_;
+#endif
+
+	/// Deleted copy constructor
+	SystemPacingClock(const SystemPacingClock &) = delete;
+	/// Deleted assignment operator
+	SystemPacingClock &operator=(const SystemPacingClock &) = delete;
+};
+
+/// A frame limiter that waits for frame deadlines
+/*! \note The thread sleeps until the deadline is near, then spins for the remaining fraction of a millisecond.
+ *  The time that a sleep can last more than requested is estimated after each call and subtracted from the next ones.
+ *  Deadlines are spaced by a frame duration, a frame that ends too late moves them forward instead of being caught up. */
+class DLL_PUBLIC FramePacer
+{
+  public:
+	/// Creates a pacer using the system clock
+	FramePacer();
+	/// Creates a pacer using a custom clock that should outlive it
+	explicit FramePacer(IPacingClock &clock);
+
+	/// Returns the target number of frames per second, zero if frames are not limited
+	inline unsigned int targetFps() const { return targetFps_; }
+	/// Sets the target number of frames per second, zero disables waiting
+	void setTargetFps(unsigned int fps);
+
+	/// Waits until the deadline of the current frame, then sets the next one
+	void wait();
+	/// Discards the current deadline, the next one is set by the next call to `wait()`
+	void reset();
+
+	/// Returns the number of frames that ended after their deadline
+	inline unsigned long int numMissedDeadlines() const { return numMissedDeadlines_; }
+	/// Returns the time spent sleeping during the last wait in seconds
+	float lastSleepTime() const;
+	/// Returns the time spent spinning during the last wait in seconds
+	float lastSpinTime() const;
+	/// Returns the estimated time a sleep can last more than requested in seconds
+	float sleepOvershoot() const;
+
+  private:
+	/// The estimated sleep overshoot when the pacer is created, in seconds
+	static const float InitialSleepOvershoot;
+	/// The time always left to spinning, in seconds
+	static const float MinSpinTime;
+
+	SystemPacingClock systemClock_;
+	IPacingClock &clock_;
+
+	unsigned int targetFps_;
+	uint64_t frameTicks_;
+	bool hasDeadline_;
+	uint64_t deadline_;
+
+	uint64_t sleepOvershoot_;
+	uint64_t minSpinTicks_;
+
+	unsigned long int numMissedDeadlines_;
+	uint64_t lastSleepTicks_;
+	uint64_t lastSpinTicks_;
+
+	/// Updates the estimate of the sleep overshoot with a new measurement
+	void updateSleepOvershoot(uint64_t overshoot);
+
+	/// Deleted copy constructor
+	FramePacer(const FramePacer &) = delete;
+	/// Deleted assignment operator
+	FramePacer &operator=(const FramePacer &) = delete;
+};
+
+}
+
+#endif
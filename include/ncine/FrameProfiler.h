@@ -0,0 +1,116 @@
+#ifndef CLASS_NCINE_FRAMEPROFILER
+#define CLASS_NCINE_FRAMEPROFILER
+
+#include <cstdint>
+#include <nctl/Atomic.h>
+#include <nctl/UniquePtr.h>
+#include "common_defines.h"
+
+namespace ncine {
+
+/// A lightweight CPU profiler that records scoped zones of the last frames
+/*! \note Each thread writes the zones it closes in its own ring buffer, without locks. The buffer is released when the thread exits.
+ *  The buffers can be exported as a Chrome trace at any time, to be opened with `chrome://tracing` or Perfetto.
+ *  When the engine is compiled without Tracy, the `ZoneScoped` macros create the zones of this profiler. */
+class DLL_PUBLIC FrameProfiler
+{
+  public:
+	/// The maximum number of threads that can record zones
+	static const unsigned int MaxThreads = 64;
+	/// The number of zones kept by each thread, older ones are overwritten
+	static const unsigned int MaxZonesPerThread = 8192;
+	/// The number of frames included in an export
+	static const unsigned int MaxFrames = 120;
+	/// The maximum length of a thread name
+	static const unsigned int MaxThreadNameLength = 32;
+
+	/// A zone that is recorded when it goes out of scope
+	class DLL_PUBLIC ScopedZone
+	{
+	  public:
+		/// The name should be a string literal or live as long as the profiler
+		explicit ScopedZone(const char *name);
+		~ScopedZone();
+
+	  private:
+		const char *name_;
+		uint64_t startTicks_;
+		bool isRecording_;
+
+		/// Deleted copy constructor
+		ScopedZone(const ScopedZone &) = delete;
+		/// Deleted assignment operator
+		ScopedZone &operator=(const ScopedZone &) = delete;
+	};
+
+	/// Returns true if zones are being recorded
+	static inline bool isEnabled() { return enabled_; }
+	/// Starts or stops recording zones
+	static inline void setEnabled(bool enabled) { enabled_ = enabled; }
+
+	/// Sets the name shown in the trace for the calling thread
+	static void setThreadName(const char *name);
+	/// Returns the number of running threads that have recorded at least a zone or have been named
+	static unsigned int numThreads();
+	/// Returns the number of zones lost because too many threads were recording at the same time
+	static unsigned int numDroppedZones();
+
+	/// Marks the end of a frame, it should always be called by the same thread
+	static void markFrame();
+	/// Returns the number of frames marked since the start
+	static inline unsigned long int numFrames() { return numFrames_; }
+
+	/// Writes the zones of the last frames of every thread in the Chrome trace event format
+	/*! \note It should be called by the same thread that marks frames */
+	static bool exportChromeTrace(const char *filename);
+
+  private:
+	struct Zone
+	{
+		const char *name;
+		uint64_t startTicks;
+		uint64_t endTicks;
+	};
+
+	/// The ring buffer of a thread, only written by the thread that owns it
+	struct ThreadBuffer
+	{
+		/// Whether the slot is free, owned by a thread or being read by the exporting one
+		nctl::Atomic32 state;
+		/// The number of zones written so far, the ring buffer index is taken modulo its size
+		nctl::Atomic32 numWrittenZones;
+		nctl::UniquePtr<Zone[]> zones;
+		char name[MaxThreadNameLength];
+	};
+
+	static bool enabled_;
+	static ThreadBuffer threadBuffers_[MaxThreads];
+	static nctl::Atomic32 numRegisteredThreads_;
+	static nctl::Atomic32 numDroppedZones_;
+
+	static uint64_t frameEndTicks_[MaxFrames];
+	static unsigned long int numFrames_;
+
+	/// Releases the buffer of a thread when the thread exits
+	struct ThreadBufferOwner;
+	static ThreadBufferOwner &threadBufferOwner();
+
+	/// Returns the buffer of the calling thread, registering it if needed, or `nullptr` if there are too many threads
+	static ThreadBuffer *threadBuffer();
+	/// Reserves a free slot and allocates its zones, returns `nullptr` if there are none
+	static ThreadBuffer *acquireThreadBuffer();
+	/// Frees the zones and makes the slot available to another thread, after the exporting thread has read them
+	static void releaseThreadBuffer(ThreadBuffer *buffer);
+	static void recordZone(const char *name, uint64_t startTicks, uint64_t endTicks);
+
+	/// Static class, deleted constructor
+	FrameProfiler() = delete;
+	/// Static class, deleted copy constructor
+	FrameProfiler(const FrameProfiler &other) = delete;
+	/// Static class, deleted assignement operator
+	FrameProfiler &operator=(const FrameProfiler &other) = delete;
+};
+
+}
+
+#endif
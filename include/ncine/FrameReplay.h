@@ -0,0 +1,140 @@
+#ifndef CLASS_NCINE_FRAMEREPLAY
+#define CLASS_NCINE_FRAMEREPLAY
+
+#include <cstdint>
+#include "common_defines.h"
+#include <nctl/Array.h>
+#include <nctl/UniquePtr.h>
+#include "IInputEventHandler.h"
+
+namespace ncine {
+
+class IFile;
+
+/// A class that records or plays back the frame intervals, the input events and the random seeds of a run
+/*! \note It stands between the input managers and the application handler. When recording, events are written and forwarded.
+ *  When playing back, the events coming from the devices are discarded and the recorded ones are dispatched instead. */
+class DLL_PUBLIC FrameReplay : public IInputEventHandler
+{
+  public:
+	enum class Mode
+	{
+		RECORD,
+		PLAYBACK
+	};
+
+	/// Opens the replay file and installs itself as the input event handler
+	/*! \note The application handler should be retrieved before construction, as the base class replaces it */
+	FrameReplay(Mode mode, const char *filename, IInputEventHandler *appInputHandler);
+	~FrameReplay() override;
+
+	/// Returns true if the file has been opened for recording or loaded for playback
+	inline bool isValid() const { return isValid_; }
+	/// Returns the replay mode
+	inline Mode mode() const { return mode_; }
+	/// Returns true if recorded events are being played back
+	inline bool isPlaying() const { return isValid_ && mode_ == Mode::PLAYBACK; }
+
+	/// Returns the random seeds read from the file in playback mode
+	inline uint64_t randomInitState() const { return randomInitState_; }
+	/// Returns the random sequence read from the file in playback mode
+	inline uint64_t randomInitSequence() const { return randomInitSequence_; }
+	/// Writes the file header with the random seeds in record mode, it should be called before recording any frame
+	void recordRandomSeeds(uint64_t initState, uint64_t initSequence);
+
+	/// Writes the interval and the events received since the previous frame
+	/*! \note It should be called at the end of a frame, so that the events received before and during it are written with its interval */
+	void recordFrame(float interval);
+	/// Reads the next frame and dispatches its events to the application handler
+	/*! \return False when there are no more frames to play back */
+	bool playFrame();
+	/// Returns the interval of the last frame played back
+	inline float interval() const { return interval_; }
+	/// Returns the number of frames recorded or played back so far
+	inline unsigned int numFrames() const { return numFrames_; }
+
+	void onKeyPressed(const KeyboardEvent &event) override;
+	void onKeyReleased(const KeyboardEvent &event) override;
+	void onTouchDown(const TouchEvent &event) override;
+	void onTouchUp(const TouchEvent &event) override;
+	void onTouchMove(const TouchEvent &event) override;
+	void onPointerDown(const TouchEvent &event) override;
+	void onPointerUp(const TouchEvent &event) override;
+#ifdef __ANDROID__
+	void onAcceleration(const AccelerometerEvent &event) override;
+#endif
+	void onMouseButtonPressed(const MouseEvent &event) override;
+	void onMouseButtonReleased(const MouseEvent &event) override;
+	void onMouseMoved(const MouseState &state) override;
+	void onScrollInput(const ScrollEvent &event) override;
+
+	void onJoyButtonPressed(const JoyButtonEvent &event) override;
+	void onJoyButtonReleased(const JoyButtonEvent &event) override;
+	void onJoyHatMoved(const JoyHatEvent &event) override;
+	void onJoyAxisMoved(const JoyAxisEvent &event) override;
+
+	void onJoyMappedButtonPressed(const JoyMappedButtonEvent &event) override;
+	void onJoyMappedButtonReleased(const JoyMappedButtonEvent &event) override;
+	void onJoyMappedAxisMoved(const JoyMappedAxisEvent &event) override;
+
+	void onJoyConnected(const JoyConnectionEvent &event) override;
+	void onJoyDisconnected(const JoyConnectionEvent &event) override;
+
+  private:
+	enum class EventType : uint8_t
+	{
+		KEY_PRESSED,
+		KEY_RELEASED,
+		TOUCH_DOWN,
+		TOUCH_UP,
+		TOUCH_MOVE,
+		POINTER_DOWN,
+		POINTER_UP,
+		ACCELERATION,
+		MOUSE_BUTTON_PRESSED,
+		MOUSE_BUTTON_RELEASED,
+		MOUSE_MOVED,
+		SCROLL_INPUT,
+		JOY_BUTTON_PRESSED,
+		JOY_BUTTON_RELEASED,
+		JOY_HAT_MOVED,
+		JOY_AXIS_MOVED,
+		JOY_MAPPED_BUTTON_PRESSED,
+		JOY_MAPPED_BUTTON_RELEASED,
+		JOY_MAPPED_AXIS_MOVED,
+		JOY_CONNECTED,
+		JOY_DISCONNECTED
+	};
+
+	Mode mode_;
+	bool isValid_;
+	/// The handler that receives the forwarded or the played back events
+	IInputEventHandler *appInputHandler_;
+	nctl::UniquePtr<IFile> fileHandle_;
+
+	uint64_t randomInitState_;
+	uint64_t randomInitSequence_;
+	float interval_;
+	unsigned int numFrames_;
+
+	/// The events received during the current frame when recording, the whole file when playing back
+	nctl::Array<uint8_t> buffer_;
+	/// The position of the next byte to read when playing back
+	unsigned int readOffset_;
+
+	/// Deleted copy constructor
+	FrameReplay(const FrameReplay &) = delete;
+	/// Deleted assignment operator
+	FrameReplay &operator=(const FrameReplay &) = delete;
+
+	bool loadFile();
+	template <class T> void write(const T &value);
+	template <class T> T read();
+	void writeTouchEvent(EventType type, const TouchEvent &event);
+	void readTouchEvent(TouchEvent &event);
+	void dispatchEvent(EventType type);
+};
+
+}
+
+#endif
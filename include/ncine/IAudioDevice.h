@@ -6,6 +6,7 @@
 namespace ncine {
 
 class IAudioPlayer;
+class AudioMixer;
 
 /// Audio device interface class
 class DLL_PUBLIC IAudioDevice
@@ -50,8 +51,13 @@ class DLL_PUBLIC IAudioDevice
 	virtual unsigned int nextAvailableSource() = 0;
 	/// Registers a new stream player for buffer update
 	virtual void registerPlayer(IAudioPlayer *player) = 0;
+	/// Unregisters a player so that it is not updated anymore, like before being destroyed or reused
+	virtual void unregisterPlayer(IAudioPlayer *player) = 0;
 	/// Updates players state (and buffer queue in the case of stream players)
 	virtual void updatePlayers() = 0;
+
+	/// Returns the software mixer, or `nullptr` if it is not enabled
+	virtual AudioMixer *mixer() = 0;
 };
 
 inline IAudioDevice::~IAudioDevice() {}
@@ -78,7 +84,10 @@ class DLL_PUBLIC NullAudioDevice : public IAudioDevice
 
 	unsigned int nextAvailableSource() override { return UnavailableSource; }
 	void registerPlayer(IAudioPlayer *player) override {}
+	void unregisterPlayer(IAudioPlayer *player) override {}
 	void updatePlayers() override {}
+
+	AudioMixer *mixer() override { return nullptr; }
 };
 
 }
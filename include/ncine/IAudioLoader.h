@@ -38,6 +38,9 @@ class DLL_PUBLIC IAudioLoader
 
 	/// Returns the proper audio loader according to the file extension
 	static nctl::UniquePtr<IAudioLoader> createFromFile(const char *filename);
+	/// Returns the proper audio loader for a file already loaded in memory, according to the extension of the buffer name
+	/*! \note The buffer is not copied and should live as long as the loader */
+	static nctl::UniquePtr<IAudioLoader> createFromMemory(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize);
 
   protected:
 	/// Audio file handle
@@ -57,6 +60,9 @@ class DLL_PUBLIC IAudioLoader
 
 	explicit IAudioLoader(const char *filename);
 	explicit IAudioLoader(nctl::UniquePtr<IFile> fileHandle);
+
+  private:
+	static nctl::UniquePtr<IAudioLoader> createLoader(nctl::UniquePtr<IFile> fileHandle, const char *filename);
 };
 
 }
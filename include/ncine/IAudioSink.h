@@ -0,0 +1,42 @@
+#ifndef CLASS_NCINE_IAUDIOSINK
+#define CLASS_NCINE_IAUDIOSINK
+
+#include "common_defines.h"
+#include <cstdint>
+
+namespace ncine {
+
+/// Audio sink interface class, the destination of the software mixer output
+class DLL_PUBLIC IAudioSink
+{
+  public:
+	virtual ~IAudioSink() = 0;
+
+	/// Returns the number of frames the sink can accept without waiting
+	virtual unsigned int numWritableFrames() = 0;
+	/// Writes interleaved 16 bit stereo frames
+	virtual void write(const int16_t *frames, unsigned int numFrames) = 0;
+};
+
+inline IAudioSink::~IAudioSink() {}
+
+/// A fake audio sink which discards everything but counts the frames
+class DLL_PUBLIC NullAudioSink : public IAudioSink
+{
+  public:
+	NullAudioSink()
+	    : numFramesWritten_(0) {}
+
+	unsigned int numWritableFrames() override { return ~0U; }
+	void write(const int16_t *frames, unsigned int numFrames) override { numFramesWritten_ += numFrames; }
+
+	/// Returns the number of frames written so far
+	inline unsigned long numFramesWritten() const { return numFramesWritten_; }
+
+  private:
+	unsigned long numFramesWritten_;
+};
+
+}
+
+#endif
@@ -17,7 +17,8 @@ class DLL_PUBLIC IFile
 	{
 		BASE = 0,
 		STANDARD,
-		ASSET
+		ASSET,
+		MEMORY
 	};
 
 	/// Open mode bitmask
@@ -102,6 +103,8 @@ class DLL_PUBLIC IFile
 
 	/// Returns the proper file handle according to prepended tags
 	static nctl::UniquePtr<IFile> createFileHandle(const char *filename);
+	/// Returns a read-only file handle for a memory buffer, which is not copied
+	static nctl::UniquePtr<IFile> createFromMemory(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize);
 
   protected:
 	/// File type
@@ -55,6 +55,9 @@ class DLL_PUBLIC IGfxCapabilities
 			AMD_COMPRESSED_ATC_TEXTURE,
 			IMG_TEXTURE_COMPRESSION_PVRTC,
 			KHR_TEXTURE_COMPRESSION_ASTC_LDR,
+			ARB_GET_PROGRAM_BINARY,
+			EXT_DISJOINT_TIMER_QUERY,
+			ARB_BASE_INSTANCE,
 
 			COUNT
 		};
@@ -24,14 +24,18 @@ class DLL_PUBLIC IGfxDevice
 	struct WindowMode
 	{
 		WindowMode()
-		    : width(0), height(0), isFullScreen(false), isResizable(false) {}
+		    : width(0), height(0), isFullScreen(false), isResizable(false), isHeadless(false) {}
 		WindowMode(unsigned int w, unsigned int h, bool fullscreen, bool resizable)
-		    : width(w), height(h), isFullScreen(fullscreen), isResizable(resizable) {}
+		    : width(w), height(h), isFullScreen(fullscreen), isResizable(resizable), isHeadless(false) {}
+		WindowMode(unsigned int w, unsigned int h, bool fullscreen, bool resizable, bool headless)
+		    : width(w), height(h), isFullScreen(fullscreen), isResizable(resizable), isHeadless(headless) {}
 
 		unsigned int width;
 		unsigned int height;
 		bool isFullScreen;
 		bool isResizable;
+		/// The window is never shown and the context renders offscreen
+		bool isHeadless;
 	};
 
 	/// A structure representing a supported monitor video mode
@@ -89,6 +93,8 @@ class DLL_PUBLIC IGfxDevice
 
 	/// Returns true if the window is resizable
 	inline bool isResizable() const { return isResizable_; }
+	/// Returns true if the device renders offscreen without showing a window
+	inline bool isHeadless() const { return isHeadless_; }
 
 	/// Sets the application window title
 	virtual void setWindowTitle(const char *windowTitle) = 0;
@@ -141,6 +147,8 @@ class DLL_PUBLIC IGfxDevice
 	bool isFullScreen_;
 	/// Whether the window is resizable
 	bool isResizable_;
+	/// Whether the rendering occurs offscreen
+	bool isHeadless_;
 	/// OpenGL context creation attributes
 	GLContextInfo glContextInfo_;
 	/// Display properties
@@ -151,6 +159,10 @@ class DLL_PUBLIC IGfxDevice
 #else
 	static const int MaxVideoModes = 128;
 #endif
+	/// The width used by a headless device when there is no monitor to query
+	static const int DefaultHeadlessWidth = 1280;
+	/// The height used by a headless device when there is no monitor to query
+	static const int DefaultHeadlessHeight = 720;
 	VideoMode videoModes_[MaxVideoModes];
 	unsigned int numVideoModes_;
 	mutable VideoMode currentVideoMode_;
@@ -30,7 +30,7 @@ class LuaClassWrapper
 	};
 
 	static T *unwrapUserData(lua_State *L, int index, UnwrapType unwrapType);
-	static LuaStateManager::UserDataWrapper &wrapUserData(lua_State *L, T *object);
+	static void *wrapUserData(lua_State *L, T *object);
 };
 
 template <class T>
@@ -39,55 +39,15 @@ T *LuaClassWrapper<T>::unwrapUserData(lua_State *L, int index, UnwrapType unwrap
 	if (unwrapType == UnwrapType::RETURN_NULL && LuaUtils::isNil(L, index))
 		return nullptr;
 
-	LuaStateManager::UserDataWrapper *wrapper = LuaUtils::retrieveUserData<LuaStateManager::UserDataWrapper>(L, index);
+	// A handle to a deleted object is rejected even if its slot has been recycled
+	LuaStateManager::UserDataWrapper *wrapper = LuaStateManager::retrieveUserDataWrapper(L, index);
 
 	T *object = reinterpret_cast<T *>(wrapper->object);
 	FATAL_ASSERT(object);
 
-	switch (wrapper->type)
-	{
-		case LuaTypes::ANIMATED_SPRITE:
-			if (LuaTypes::classToUserDataType(object) != wrapper->type &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::SPRITE &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::BASE_SPRITE &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::DRAWABLENODE &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::SCENENODE)
-				LuaDebug::traceError(L, "Expecting a %s object instead of %s", LuaTypes::classToName(object), LuaTypes::wrapperToName(wrapper->type));
-			break;
-		case LuaTypes::MESH_SPRITE:
-		case LuaTypes::SPRITE:
-			if (LuaTypes::classToUserDataType(object) != wrapper->type &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::BASE_SPRITE &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::DRAWABLENODE &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::SCENENODE)
-				LuaDebug::traceError(L, "Expecting a %s object instead of %s", LuaTypes::classToName(object), LuaTypes::wrapperToName(wrapper->type));
-			break;
-		case LuaTypes::TEXTNODE:
-			if (LuaTypes::classToUserDataType(object) != wrapper->type &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::DRAWABLENODE &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::SCENENODE)
-				LuaDebug::traceError(L, "Expecting a %s object instead of %s", LuaTypes::classToName(object), LuaTypes::wrapperToName(wrapper->type));
-			break;
-		case LuaTypes::PARTICLE_SYSTEM:
-			if (LuaTypes::classToUserDataType(object) != wrapper->type &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::SCENENODE)
-				LuaDebug::traceError(L, "Expecting a %s object instead of %s", LuaTypes::classToName(object), LuaTypes::wrapperToName(wrapper->type));
-			break;
-		case LuaTypes::AUDIOBUFFER_PLAYER:
-			if (LuaTypes::classToUserDataType(object) != wrapper->type &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::IAUDIOPLAYER)
-				LuaDebug::traceError(L, "Expecting a %s object instead of %s", LuaTypes::classToName(object), LuaTypes::wrapperToName(wrapper->type));
-			break;
-		case LuaTypes::AUDIOSTREAM_PLAYER:
-			if (LuaTypes::classToUserDataType(object) != wrapper->type &&
-			    LuaTypes::classToUserDataType(object) != LuaTypes::IAUDIOPLAYER)
-				LuaDebug::traceError(L, "Expecting a %s object instead of %s", LuaTypes::classToName(object), LuaTypes::wrapperToName(wrapper->type));
-			break;
-		default:
-			if (LuaTypes::classToUserDataType(object) != wrapper->type)
-				LuaDebug::traceError(L, "Expecting a %s object instead of %s", LuaTypes::classToName(object), LuaTypes::wrapperToName(wrapper->type));
-			break;
-	}
+	// A single test against the precomputed mask of the wrapped type and its base types
+	if ((wrapper->typeMask & LuaTypes::userDataTypeBit(LuaTypes::classToUserDataType(object))) == 0)
+		LuaDebug::traceError(L, "Expecting a %s object instead of %s", LuaTypes::classToName(object), LuaTypes::wrapperToName(wrapper->type));
 
 	return object;
 }
@@ -95,8 +55,7 @@ T *LuaClassWrapper<T>::unwrapUserData(lua_State *L, int index, UnwrapType unwrap
 template <class T>
 void LuaClassWrapper<T>::pushUntrackedUserData(lua_State *L, T *object)
 {
-	LuaStateManager::UserDataWrapper &wrapper = wrapUserData(L, object);
-	LuaUtils::push(L, reinterpret_cast<void *>(&wrapper));
+	LuaUtils::push(L, wrapUserData(L, object));
 }
 
 template <class T>
@@ -108,8 +67,7 @@ void LuaClassWrapper<T>::pushUntrackedUserData(lua_State *L, const T *object)
 template <class T>
 void LuaClassWrapper<T>::pushFieldUntrackedUserData(lua_State *L, const char *name, T *object)
 {
-	LuaStateManager::UserDataWrapper &wrapper = wrapUserData(L, object);
-	LuaUtils::pushField(L, name, reinterpret_cast<void *>(&wrapper));
+	LuaUtils::pushField(L, name, wrapUserData(L, object));
 }
 
 template <class T>
@@ -119,21 +77,14 @@ void LuaClassWrapper<T>::pushFieldUntrackedUserData(lua_State *L, const char *na
 }
 
 template <class T>
-LuaStateManager::UserDataWrapper &LuaClassWrapper<T>::wrapUserData(lua_State *L, T *object)
+void *LuaClassWrapper<T>::wrapUserData(lua_State *L, T *object)
 {
-	LuaStateManager *stateManager = LuaStateManager::manager(L);
-
-	nctl::Array<LuaStateManager::UserDataWrapper> &array = stateManager->untrackedUserDatas();
-
-	const unsigned int oldSize = array.size();
-	array.setSize(oldSize + 1);
-	LuaStateManager::UserDataWrapper &wrapper = array[oldSize];
+	LuaUserDataPool &pool = LuaStateManager::manager(L)->untrackedUserDatas();
 
-	wrapper.object = object;
-	wrapper.type = LuaTypes::classToUserDataType(object);
-	wrapper.arrayIndex = oldSize;
+	// Pushing the same object again reuses its wrapper instead of growing the pool
+	LuaStateManager::UserDataWrapper &wrapper = pool.acquireShared(object, LuaTypes::classToUserDataType(object));
 
-	return wrapper;
+	return pool.handle(wrapper);
 }
 
 }
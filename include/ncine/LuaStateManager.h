@@ -3,13 +3,18 @@
 
 #include "common_defines.h"
 #include <nctl/Array.h>
+#include <nctl/UniquePtr.h>
+#include <nctl/String.h>
 #include "LuaTypes.h"
+#include "LuaUserDataPool.h"
 
 struct lua_State;
 struct lua_Debug;
 
 namespace ncine {
 
+class LuaMemoryPool;
+
 /// The Lua scripting state manager
 class DLL_PUBLIC LuaStateManager
 {
@@ -45,15 +50,7 @@ class DLL_PUBLIC LuaStateManager
 		LuaStateManager *stateManager;
 	};
 
-	struct UserDataWrapper
-	{
-		UserDataWrapper()
-		    : object(nullptr), type(LuaTypes::UNKNOWN), arrayIndex(0) {}
-
-		void *object;
-		enum LuaTypes::UserDataType type;
-		unsigned int arrayIndex;
-	};
+	using UserDataWrapper = LuaUserDataPool::Wrapper;
 
 	LuaStateManager(ApiType apiType, StatisticsTracking statsTracking, StandardLibraries stdLibraries);
 	LuaStateManager(lua_State *L, ApiType apiType, StatisticsTracking statsTracking, StandardLibraries stdLibraries);
@@ -69,10 +66,36 @@ class DLL_PUBLIC LuaStateManager
 	inline ApiType apiType() const { return apiType_; }
 	inline StatisticsTracking statisticsTracking() const { return statsTracking_; }
 	inline StandardLibraries standardLibraries() const { return stdLibraries_; }
-	inline nctl::Array<UserDataWrapper> &trackedUserDatas() { return trackedUserDatas_; }
-	inline nctl::Array<UserDataWrapper> &untrackedUserDatas() { return untrackedUserDatas_; }
+	inline LuaUserDataPool &trackedUserDatas() { return trackedUserDatas_; }
+	inline LuaUserDataPool &untrackedUserDatas() { return untrackedUserDatas_; }
+	/// Returns the wrapper of a handle pushed to Lua, or `nullptr` if the object has been released since
+	UserDataWrapper *userDataWrapper(const void *handle);
+	/// Retrieves the wrapper of the handle at the specified stack index, raising a Lua error if the object has been released
+	static UserDataWrapper *retrieveUserDataWrapper(lua_State *L, int index);
+
+	inline bool isBytecodeCacheEnabled() const { return bytecodeCacheEnabled_; }
+	/// Enables storing the compiled bytecode of scripts, to load it instead of the source when this is unchanged
+	/*! \note The cache should only be enabled on trusted directories, as loading malicious bytecode can crash the virtual machine. */
+	void setBytecodeCacheEnabled(bool enabled);
+	/// Returns the directory of the bytecode cache, a subdirectory of `FileSystem::savePath()` by default
+	inline const nctl::String &bytecodeCachePath() const { return bytecodeCachePath_; }
+	void setBytecodeCachePath(const char *path);
+
+	/// Returns the time budget in milliseconds to collect garbage at the end of each frame, zero when the collection is automatic
+	inline float gcFrameBudget() const { return gcFrameBudget_; }
+	/// Stops the automatic collector and collects garbage at the end of each frame within a time budget in milliseconds
+	/*! \note A budget of zero restores the automatic collector. */
+	void setGcFrameBudget(float milliseconds);
+	/// Sets the pause and the step multiplier of the incremental collector, as percentages
+	void setGcParameters(int pause, int stepMultiplier);
+	/// Performs incremental collection steps until the frame budget is spent or a cycle completes
+	void stepGarbageCollector();
 
 	static LuaStateManager *manager(lua_State *L);
+	/// Steps the collector of every state with a frame budget, called by the application at the end of each frame
+	static void stepGarbageCollectors();
+	/// Releases the shared wrappers of an object in every state, called when the object is destroyed
+	static void releaseSharedUserData(const void *object);
 
   private:
 	static nctl::Array<StateToManager> managers_;
@@ -81,18 +104,34 @@ class DLL_PUBLIC LuaStateManager
 	ApiType apiType_;
 	StatisticsTracking statsTracking_;
 	StandardLibraries stdLibraries_;
-	nctl::Array<UserDataWrapper> trackedUserDatas_;
-	nctl::Array<UserDataWrapper> untrackedUserDatas_;
+	/// Wrappers of objects owned by Lua
+	LuaUserDataPool trackedUserDatas_;
+	/// Wrappers of engine objects, shared between all the pushes of the same object
+	LuaUserDataPool untrackedUserDatas_;
 	/// True if the Lua state should be closed upon destruction
 	bool closeOnDestruction_;
+	/// The allocator of a state created by the manager
+	nctl::UniquePtr<LuaMemoryPool> memoryPool_;
+	float gcFrameBudget_;
+	/// Memory in use after the last completed collection cycle, in kilobytes
+	int gcMemoryAfterCycle_;
+	bool bytecodeCacheEnabled_;
+	nctl::String bytecodeCachePath_;
+
+	static lua_State *createState(StatisticsTracking statsTracking);
 
 	static void *luaAllocator(void *ud, void *ptr, size_t osize, size_t nsize);
 	static void *luaAllocatorWithStatistics(void *ud, void *ptr, size_t osize, size_t nsize);
-	static void luaCountHook(lua_State *L, lua_Debug *ar);
+	static void luaHook(lua_State *L, lua_Debug *ar);
 
 	void exposeApi();
 	void exposeConstants();
 
+	/// Loads a chunk from the bytecode cache if it is valid, or compiles it from source and stores it in the cache
+	int loadBuffer(const char *buffer, unsigned long size, const char *filename);
+	bool loadCachedBytecode(const char *cacheFilename, uint64_t sourceHash, unsigned long sourceSize, const char *filename);
+	void saveCachedBytecode(const char *cacheFilename, uint64_t sourceHash, unsigned long sourceSize);
+
 	friend class LuaEventHandler;
 	friend class LuaStatistics;
 };
@@ -1,6 +1,7 @@
 #ifndef CLASS_NCINE_LUATYPES
 #define CLASS_NCINE_LUATYPES
 
+#include <cstdint>
 #include "common_defines.h"
 #include <nctl/Array.h>
 
@@ -123,6 +124,31 @@ namespace LuaTypes {
 
 		return "unknown";
 	}
+
+	/// Returns the bit associated with a userdata type
+	inline uint32_t userDataTypeBit(LuaTypes::UserDataType type) { return 1u << type; }
+
+	/// Returns the bit of a userdata type together with the bits of all the types it inherits from
+	inline uint32_t userDataTypeMask(LuaTypes::UserDataType type)
+	{
+		const uint32_t sceneNodeMask = userDataTypeBit(SCENENODE);
+		const uint32_t drawableNodeMask = userDataTypeBit(DRAWABLENODE) | sceneNodeMask;
+		const uint32_t baseSpriteMask = userDataTypeBit(BASE_SPRITE) | drawableNodeMask;
+
+		switch (type)
+		{
+			case LuaTypes::UserDataType::DRAWABLENODE: return drawableNodeMask;
+			case LuaTypes::UserDataType::BASE_SPRITE: return baseSpriteMask;
+			case LuaTypes::UserDataType::SPRITE: return userDataTypeBit(SPRITE) | baseSpriteMask;
+			case LuaTypes::UserDataType::MESH_SPRITE: return userDataTypeBit(MESH_SPRITE) | baseSpriteMask;
+			case LuaTypes::UserDataType::ANIMATED_SPRITE: return userDataTypeBit(ANIMATED_SPRITE) | userDataTypeBit(SPRITE) | baseSpriteMask;
+			case LuaTypes::UserDataType::TEXTNODE: return userDataTypeBit(TEXTNODE) | drawableNodeMask;
+			case LuaTypes::UserDataType::PARTICLE_SYSTEM: return userDataTypeBit(PARTICLE_SYSTEM) | sceneNodeMask;
+			case LuaTypes::UserDataType::AUDIOBUFFER_PLAYER: return userDataTypeBit(AUDIOBUFFER_PLAYER) | userDataTypeBit(IAUDIOPLAYER);
+			case LuaTypes::UserDataType::AUDIOSTREAM_PLAYER: return userDataTypeBit(AUDIOSTREAM_PLAYER) | userDataTypeBit(IAUDIOPLAYER);
+			default: return userDataTypeBit(type);
+		}
+	}
 }
 
 }
@@ -0,0 +1,105 @@
+#ifndef CLASS_NCINE_LUAUSERDATAPOOL
+#define CLASS_NCINE_LUAUSERDATAPOOL
+
+#include <cstdint>
+#include "common_defines.h"
+#include <nctl/Array.h>
+#include <nctl/UniquePtr.h>
+#include <nctl/HashMap.h>
+#include "LuaTypes.h"
+
+namespace ncine {
+
+/// A pool of userdata wrappers with stable addresses, pushed to Lua as light userdata handles
+/*! \note Wrappers are allocated in fixed size chunks that are never moved, so a handle held by Lua stays valid
+ *  when the pool grows. A handle encodes the pool, the slot and its generation, which is incremented every time
+ *  the slot is released, so that a handle to a released or recycled slot is rejected instead of unwrapping another object.
+ *  \note Generations wrap around: a stale handle is accepted again after its slot has been released `GenerationMask` times.
+ *  Free slots are reused in release order, so a slot is only released again after every other free slot has been reused.
+ *  The generation has 31 bits on 64 bit platforms, but only 12 bits on 32 bit ones, where the whole handle fits in 32 bits. */
+class DLL_PUBLIC LuaUserDataPool
+{
+  public:
+	struct Wrapper
+	{
+		Wrapper()
+		    : object(nullptr), type(LuaTypes::UNKNOWN), typeMask(0), slotIndex(0), generation(1) {}
+
+		void *object;
+		enum LuaTypes::UserDataType type;
+		/// The bits of the wrapped type and of all its base types
+		uint32_t typeMask;
+		unsigned int slotIndex;
+		/// Incremented when the slot is released, it is never zero
+		unsigned int generation;
+	};
+
+	/// Number of wrappers in a chunk, must be a power of two
+	static const unsigned int ChunkSize = 64;
+	/// Maximum number of slots that can be addressed by a handle
+	static const unsigned int MaxSlots = 1u << 19;
+
+	/// Creates a pool whose handles are tagged with the specified index, either zero or one
+	explicit LuaUserDataPool(unsigned int poolIndex);
+
+	/// Returns the number of wrappers in use
+	inline unsigned int size() const { return size_; }
+	inline bool isEmpty() const { return size_ == 0; }
+	/// Returns the number of slots ever acquired since the last clear, including released ones
+	inline unsigned int numSlots() const { return numSlots_; }
+
+	inline Wrapper &slot(unsigned int index) { return chunks_[index >> ChunkShift][index & (ChunkSize - 1)]; }
+	inline const Wrapper &slot(unsigned int index) const { return chunks_[index >> ChunkShift][index & (ChunkSize - 1)]; }
+
+	/// Returns the handle to push to Lua for a wrapper of this pool
+	void *handle(const Wrapper &wrapper) const;
+	/// Returns the wrapper of a handle, or `nullptr` if the handle belongs to a released or recycled slot
+	Wrapper *fromHandle(const void *handle);
+	/// Returns the index of the pool that created a handle
+	static inline unsigned int poolIndex(const void *handle) { return static_cast<unsigned int>(reinterpret_cast<uintptr_t>(handle) & PoolIndexMask); }
+
+	/// Returns a new wrapper for the object
+	Wrapper &acquire(void *object, LuaTypes::UserDataType type);
+	/// Returns the wrapper already associated with the object or a new one
+	/*! \note If the object is pushed again as a more derived type, the wrapper is promoted to that type.
+	 *  If it is pushed as an unrelated type, the address belongs to a new object and the old handles are invalidated. */
+	Wrapper &acquireShared(void *object, LuaTypes::UserDataType type);
+	/// Returns the wrapper slot to the pool
+	void release(Wrapper &wrapper);
+	/// Releases the shared wrapper associated with the object, if any
+	bool releaseShared(const void *object);
+	/// Releases all wrappers without freeing the chunks
+	void clear();
+
+  private:
+	static const unsigned int ChunkShift = 6;
+	static_assert((1u << ChunkShift) == ChunkSize, "Chunk shift and size do not match");
+
+	/// A handle is made of the pool index in the lowest bit, then the generation, then the slot index
+	static const unsigned int PoolIndexMask = 1u;
+	static const unsigned int GenerationShift = 1;
+	/// The generation uses all the bits left by the slot index in a pointer sized handle, up to the size of an `unsigned int`
+	static const unsigned int GenerationBits = (sizeof(uintptr_t) >= 8) ? 31 : 12;
+	static const unsigned int GenerationMask = (1u << GenerationBits) - 1;
+	static const unsigned int SlotShift = GenerationShift + GenerationBits;
+	static_assert((static_cast<uint64_t>(MaxSlots - 1) >> (sizeof(uintptr_t) * 8 - SlotShift)) == 0, "Handles do not fit in a pointer");
+
+	unsigned int poolIndex_;
+	unsigned int size_;
+	unsigned int numSlots_;
+	nctl::Array<nctl::UniquePtr<Wrapper[]>> chunks_;
+	/// A queue of released slots, reused from the first one to let generations wrap as slowly as possible
+	nctl::Array<unsigned int> freeSlots_;
+	/// Index of the next free slot to reuse, the released slots before it are removed once they are half of the queue
+	unsigned int firstFreeSlot_;
+	/// Maps an object address to the slot of its shared wrapper, created on first use
+	nctl::UniquePtr<nctl::HashMap<uintptr_t, unsigned int>> sharedSlots_;
+
+	Wrapper &acquireSlot();
+	/// Invalidates the wrapper and the handles to its slot
+	void resetWrapper(Wrapper &wrapper);
+};
+
+}
+
+#endif
@@ -19,6 +19,8 @@ class LuaVector2Utils
   public:
 	static void push(lua_State *L, const Vector2<T> &v);
 	static void pushField(lua_State *L, const char *name, const Vector2<T> &v);
+	/// Pushes the components as two separate values, without allocating a table
+	static void pushParams(lua_State *L, const Vector2<T> &v);
 	static Vector2<T> retrieve(lua_State *L, int index, int &newIndex);
 	static Vector2<T> retrieveTable(lua_State *L, int index);
 	static Vector2<T> retrieveArray(lua_State *L, int index);
@@ -45,6 +47,13 @@ void LuaVector2Utils<T>::pushField(lua_State *L, const char *name, const Vector2
 	LuaUtils::setField(L, -2, name);
 }
 
+template <class T>
+void LuaVector2Utils<T>::pushParams(lua_State *L, const Vector2<T> &v)
+{
+	LuaUtils::push(L, v.x);
+	LuaUtils::push(L, v.y);
+}
+
 template <class T>
 Vector2<T> LuaVector2Utils<T>::retrieve(lua_State *L, int index, int &newIndex)
 {
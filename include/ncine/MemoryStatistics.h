@@ -0,0 +1,142 @@
+#ifndef CLASS_NCINE_MEMORYSTATISTICS
+#define CLASS_NCINE_MEMORYSTATISTICS
+
+#include <cstddef>
+#include <cstdint>
+#include <nctl/Atomic.h>
+#include "common_defines.h"
+
+namespace ncine {
+
+/// A class to account the allocated memory per engine subsystem
+/*! \note Allocations are attributed to the tag set by the calling thread with a `ScopedTag`.
+ *  The global `new` and `delete` operators only account them when the engine is compiled with `NCINE_WITH_MEMORY_TAGS`,
+ *  memory allocated by other means, like the one of Lua states with statistics, is accounted explicitly.
+ *  As the operators store a header before every block, the option requires the static library on Windows and macOS,
+ *  where the operators replaced in a dynamic library would not be used by the application. */
+class DLL_PUBLIC MemoryStatistics
+{
+  public:
+	/// The subsystems that memory is attributed to
+	struct Tags
+	{
+		enum Enum
+		{
+			UNTAGGED,
+			SCENEGRAPH,
+			RENDER_COMMANDS,
+			TEXTURES,
+			AUDIO,
+			LUA,
+			CONTAINERS,
+			FONTS,
+
+			COUNT
+		};
+	};
+
+	class TagStatistics
+	{
+	  public:
+		/// Number of bytes currently allocated
+		int64_t currentBytes;
+		/// Maximum number of bytes allocated at the same time
+		int64_t peakBytes;
+		/// Number of allocations since the start
+		int64_t allocations;
+		/// Number of allocations during the last frame
+		unsigned int frameAllocations;
+		/// Number of deallocations during the last frame
+		unsigned int frameDeallocations;
+
+		TagStatistics()
+		    : currentBytes(0), peakBytes(0), allocations(0), frameAllocations(0), frameDeallocations(0) {}
+	};
+
+	/// Tags the allocations made by the calling thread in its scope, then restores the previous tag
+	class DLL_PUBLIC ScopedTag
+	{
+	  public:
+		explicit ScopedTag(Tags::Enum tag);
+		~ScopedTag();
+
+	  private:
+		Tags::Enum previousTag_;
+
+		/// Deleted copy constructor
+		ScopedTag(const ScopedTag &) = delete;
+		/// Deleted assignment operator
+		ScopedTag &operator=(const ScopedTag &) = delete;
+	};
+
+	/// Tags the allocations of a container with `Tags::CONTAINERS`, only if the calling thread has not set another tag
+	class DLL_PUBLIC ScopedContainerTag
+	{
+	  public:
+		ScopedContainerTag();
+		~ScopedContainerTag();
+
+	  private:
+		Tags::Enum previousTag_;
+
+		/// Deleted copy constructor
+		ScopedContainerTag(const ScopedContainerTag &) = delete;
+		/// Deleted assignment operator
+		ScopedContainerTag &operator=(const ScopedContainerTag &) = delete;
+	};
+
+	/// Returns true if the global `new` operator is accounting allocations
+	static inline bool isEnabled() { return enabled_; }
+	/// Starts or stops accounting the allocations of the global `new` operator
+	/*! \note It is enabled by the application, the allocations already accounted are tracked until deallocated */
+	static inline void setEnabled(bool enabled) { enabled_ = enabled; }
+	/// Returns true if the global `new` and `delete` operators account tagged allocations
+	static bool isTrackingOperatorNew();
+
+	/// Returns the tag currently set by the calling thread
+	static Tags::Enum currentTag();
+	/// Returns the name of a tag
+	static const char *tagName(Tags::Enum tag);
+
+	/// Accounts an allocation of the specified number of bytes
+	static void addAllocation(Tags::Enum tag, size_t bytes);
+	/// Accounts the deallocation of memory previously accounted with `addAllocation()`
+	static void addDeallocation(Tags::Enum tag, size_t bytes);
+
+	/// Returns the statistics of the specified tag
+	static TagStatistics statistics(Tags::Enum tag);
+	/// Returns the statistics aggregated for all tags
+	static TagStatistics allStatistics();
+
+	/// Updates the counters of the last frame, it should always be called by the same thread
+	static void markFrame();
+
+  private:
+	struct Counters
+	{
+		nctl::Atomic64 currentBytes;
+		nctl::Atomic64 peakBytes;
+		nctl::Atomic64 allocations;
+		nctl::Atomic64 deallocations;
+	};
+
+	static bool enabled_;
+	static Counters counters_[Tags::COUNT];
+
+	/// Counters at the last frame mark, only accessed by the thread that marks frames
+	static int64_t lastAllocations_[Tags::COUNT];
+	static int64_t lastDeallocations_[Tags::COUNT];
+	static unsigned int frameAllocations_[Tags::COUNT];
+	static unsigned int frameDeallocations_[Tags::COUNT];
+
+	/// Static class, deleted constructor
+	MemoryStatistics() = delete;
+	/// Static class, deleted copy constructor
+	MemoryStatistics(const MemoryStatistics &other) = delete;
+	/// Static class, deleted assignement operator
+	MemoryStatistics &operator=(const MemoryStatistics &other) = delete;
+};
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "Object.h"
 #include <nctl/Array.h>
+#include <nctl/UniquePtr.h>
 #include "Vector2.h"
 #include "Matrix4x4.h"
 #include "Color.h"
@@ -70,7 +71,7 @@ class DLL_PUBLIC SceneNode : public Object
 	/// Returns true if the node is drawing
 	inline bool drawEnabled() const { return drawEnabled_; }
 	/// Enables or disables node drawing
-	inline void setDrawEnabled(bool drawEnabled) { drawEnabled_ = drawEnabled; }
+	void setDrawEnabled(bool drawEnabled);
 	/// Returns true if the node is both updating and drawing
 	inline bool enabled() const { return (updateEnabled_ == true && drawEnabled_ == true); }
 	/// Enables or disables both node updating and drawing
@@ -144,6 +145,20 @@ class DLL_PUBLIC SceneNode : public Object
 	/// Gets the node local matrix
 	inline const Matrix4x4f &localMatrix() const { return localMatrix_; }
 
+	/// Returns true if the render commands of the node descendants are recorded once and then replayed
+	inline bool recordsCommands() const { return commandsRecording_ != nullptr; }
+	/// Enables or disables the recording of the render commands of the node descendants
+	/*! \note The recording is invalidated by structural changes in the subtree and by any change to the transformation,
+	 *  color, drawing state or render command of a descendant.
+	 *  \note A clean recording skips the visit of the descendants, but not their update. As the coordinates are public fields
+	 *  and nodes can animate in `update()`, every descendant is still updated and transformed each frame, and its world matrix
+	 *  and color are compared with the previous ones. The replayed commands are also sorted, batched and committed again. */
+	void setRecordCommands(bool recordCommands);
+	/// Returns true if the recorded commands have been invalidated since they were last recorded
+	bool recordedCommandsAreDirty() const;
+	/// Invalidates the recorded commands of this node and of every ancestor, so that they are recorded again at the next visit
+	void invalidateRecordedCommands();
+
 	/// Gets the delete children on destruction flag
 	/*! If the flag is true the children are deleted upon node destruction. */
 	inline bool deleteChildrenOnDestruction() const { return shouldDeleteChildrenOnDestruction_; }
@@ -192,12 +207,32 @@ class DLL_PUBLIC SceneNode : public Object
 	/// A flag indicating whether the destructor should also delete all children
 	bool shouldDeleteChildrenOnDestruction_;
 
+	class CommandsRecording;
+	/// The render commands of the descendants, if they are recorded
+	nctl::UniquePtr<CommandsRecording> commandsRecording_;
+
+	/// Invalidates the recorded commands of the ancestors after a change that affects the node rendering
+	inline void invalidateParentRecordedCommands()
+	{
+		if (numRecordingNodes_ > 0 && parent_)
+			parent_->invalidateRecordedCommands();
+	}
+
 	/// Protected copy constructor
 	SceneNode(const SceneNode &);
 	/// Protected assignment operator
 	SceneNode &operator=(const SceneNode &);
 
 	virtual void transform();
+
+  private:
+	/// The number of nodes recording commands, no recording needs to be invalidated when it is zero
+	static unsigned int numRecordingNodes_;
+	/// The number of recording nodes whose subtree is being updated, changes are only checked when it is not zero
+	static unsigned int recordingUpdateDepth_;
+
+	/// Draws and visits every child with drawing enabled
+	void visitChildren(RenderQueue &renderQueue);
 };
 
 inline const nctl::Array<const SceneNode *> &SceneNode::children() const
@@ -205,10 +240,17 @@ inline const nctl::Array<const SceneNode *> &SceneNode::children() const
 	return reinterpret_cast<const nctl::Array<const SceneNode *> &>(children_);
 }
 
+inline void SceneNode::setDrawEnabled(bool drawEnabled)
+{
+	if (drawEnabled_ != drawEnabled)
+		invalidateParentRecordedCommands();
+	drawEnabled_ = drawEnabled;
+}
+
 inline void SceneNode::setEnabled(bool enabled)
 {
 	updateEnabled_ = enabled;
-	drawEnabled_ = enabled;
+	setDrawEnabled(enabled);
 }
 
 inline void SceneNode::setPosition(float xx, float yy)
@@ -4,6 +4,7 @@
 #include "DrawableNode.h"
 #include "Font.h"
 #include "Color.h"
+#include "Colorf.h"
 #include <nctl/Array.h>
 #include <nctl/String.h>
 
@@ -19,7 +20,8 @@ class DLL_PUBLIC TextNode : public DrawableNode
   public:
 	/// Default maximum length for a string to be rendered
 	/*! This number affects both the size of the string container
-	 * and the initial size of the vertex array in host memory. */
+	 * and the initial size of the vertex array in host memory.
+	 * \note The length is measured in bytes, a UTF-8 character can take up to four. */
 	static const unsigned int DefaultStringLength = 256;
 
 	/// Horizontal alignment modes for text made of multiple lines
@@ -52,15 +54,38 @@ class DLL_PUBLIC TextNode : public DrawableNode
 	/// Sets the horizontal text alignment of multiple lines
 	void setAlignment(Alignment alignment);
 
+	/// Returns true if the font glyphs are stored as a signed distance field
+	inline bool hasDistanceField() const { return font_->hasDistanceField(); }
+	/// Gets the outline width in font texture pixels
+	inline float outlineWidth() const { return outlineWidth_; }
+	/// Gets the outline color
+	inline const Colorf &outlineColor() const { return outlineColor_; }
+	/// Sets the outline width in font texture pixels and its color
+	/*! \note The outline is only rendered with a distance field font and cannot exceed half of its distance range */
+	void setOutline(float width, const Colorf &color);
+	/// Gets the shadow offset in font texture pixels
+	inline const Vector2f &shadowOffset() const { return shadowOffset_; }
+	/// Gets the shadow color
+	inline const Colorf &shadowColor() const { return shadowColor_; }
+	/// Gets the shadow softness in font texture pixels
+	inline float shadowSoftness() const { return shadowSoftness_; }
+	/// Sets the shadow offset and softness in font texture pixels and its color
+	/*! \note The shadow is only rendered with a distance field font */
+	void setShadow(const Vector2f &offset, const Colorf &color, float softness);
+
 	/// Gets the font base scaled by the vertical scale factor
 	inline float fontBase() const { return font_->base() * scaleFactor_.y; }
 	/// Gets the font line height scaled by the vertical scale factor
 	inline float fontLineHeight() const { return font_->lineHeight() * scaleFactor_.y; }
 
-	/// Gets the string to render
+	/// Gets the UTF-8 encoded string to render
 	inline const nctl::String &string() const { return string_; }
-	/// Sets the string to render
+	/// Sets the UTF-8 encoded string to render
+	/*! \note Only the lines that differ from the current string are laid out again */
 	void setString(const nctl::String &string);
+	/// Appends a UTF-8 encoded string to the one to render
+	/*! \note Only the last line and the appended ones are laid out again */
+	void appendString(const nctl::String &string);
 
 	void transform() override;
 	void draw(RenderQueue &renderQueue) override;
@@ -79,13 +104,19 @@ class DLL_PUBLIC TextNode : public DrawableNode
 		    : x(xx), y(yy), u(uu), v(vv) {}
 	};
 
-	/// Position of degenerate vertices in glyph quad
-	enum class Degenerate
+	/// Layout information and cached glyph vertices for a line of text
+	struct Line
 	{
-		NONE,
-		START,
-		START_END,
-		END
+		/// Offset of the first byte of the line in the string
+		unsigned int start = 0;
+		/// Length of the line in bytes, without the new line character
+		unsigned int length = 0;
+		/// Total advance on the X-axis for the line
+		float width = 0.0f;
+		/// Four vertices per glyph, relative to the line origin
+		nctl::Array<Vertex> vertices;
+		/// Dirty flag for the line layout
+		bool dirty = true;
 	};
 
 	/// The string to be rendered
@@ -101,23 +132,38 @@ class DLL_PUBLIC TextNode : public DrawableNode
 	/// The array of vertex positions interleaved with texture coordinates for every glyph in the node
 	nctl::Array<Vertex> interleavedVertices_;
 
-	/// Advance on the X-axis for the next processed glyph
-	mutable float xAdvance_;
-	/// Advance on the Y-axis for the next processed glyph
-	mutable float yAdvance_;
-	/// Text width for each line of text
-	mutable nctl::Array<float> lineLengths_;
+	/// Layout information for each line of text
+	mutable nctl::Array<Line> lines_;
+	/// Line array used to match the lines of a new string against the current ones
+	nctl::Array<Line> newLines_;
+	/// Total number of glyphs in the laid out lines
+	mutable unsigned int numGlyphs_;
 	/// Horizontal text alignment of multiple lines
 	Alignment alignment_;
 
+	/// Outline width in font texture pixels for distance field fonts
+	float outlineWidth_;
+	/// Outline color for distance field fonts
+	Colorf outlineColor_;
+	/// Shadow offset in font texture pixels for distance field fonts
+	Vector2f shadowOffset_;
+	/// Shadow color for distance field fonts
+	Colorf shadowColor_;
+	/// Shadow softness in font texture pixels for distance field fonts
+	float shadowSoftness_;
+
 	GLUniformBlockCache *textnodeBlock_;
 
-	/// Calculates rectangle boundaries for the rendered text
+	/// Lays out the dirty lines and calculates rectangle boundaries for the rendered text
 	void calculateBoundaries() const;
 	/// Calculates align offset for a particular line
 	float calculateAlignment(unsigned int lineIndex) const;
-	/// Fills the batch draw command with data from a glyph
-	void processGlyph(const FontGlyph *glyph, Degenerate degen);
+	/// Fills the glyph vertices of a line, relative to its origin
+	void layoutLine(Line &line) const;
+	/// Appends the lines found in a string range to a line array, starting a new line at every new line character
+	void splitLines(const char *data, unsigned int start, unsigned int end, nctl::Array<Line> &lines) const;
+	/// Marks every line as dirty
+	void invalidateLines();
 
 	void updateRenderCommand() override;
 };
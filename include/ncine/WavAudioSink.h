@@ -0,0 +1,44 @@
+#ifndef CLASS_NCINE_WAVAUDIOSINK
+#define CLASS_NCINE_WAVAUDIOSINK
+
+#include "IAudioSink.h"
+#include <nctl/UniquePtr.h>
+
+namespace ncine {
+
+class IFile;
+
+/// An audio sink that saves the mixer output to a 16 bit stereo WAV file
+class DLL_PUBLIC WavAudioSink : public IAudioSink
+{
+  public:
+	/// Creates a sink writing to the specified file at the specified frequency
+	WavAudioSink(const char *filename, int frequency);
+	/// The WAV header is finalized when the sink is destroyed
+	~WavAudioSink() override;
+
+	/// Returns true if the file has been opened for writing
+	bool isOpened() const;
+	/// Returns the number of frames written so far
+	inline unsigned long numFramesWritten() const { return numFramesWritten_; }
+
+	unsigned int numWritableFrames() override { return ~0U; }
+	void write(const int16_t *frames, unsigned int numFrames) override;
+
+  private:
+	nctl::UniquePtr<IFile> fileHandle_;
+	int frequency_;
+	unsigned long numFramesWritten_;
+
+	/// Writes the header with the sizes of the data written so far
+	void writeHeader();
+
+	/// Deleted copy constructor
+	WavAudioSink(const WavAudioSink &) = delete;
+	/// Deleted assignment operator
+	WavAudioSink &operator=(const WavAudioSink &) = delete;
+};
+
+}
+
+#endif
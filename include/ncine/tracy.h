@@ -4,20 +4,62 @@
 
 #else
 
-	#define ZoneNamed(x, y)
-	#define ZoneNamedN(x, y, z)
-	#define ZoneNamedC(x, y, z)
-	#define ZoneNamedNC(x, y, z, w)
+	#ifdef WITH_FRAME_PROFILER
 
-	#define ZoneScoped
-	#define ZoneScopedN(x)
-	#define ZoneScopedC(x)
-	#define ZoneScopedNC(x, y)
+		#include "FrameProfiler.h"
+
+		// Zones of the built-in profiler, colors and call stack depths are ignored
+		#define ZoneNamed(x, y) ncine::FrameProfiler::ScopedZone x(__func__)
+		#define ZoneNamedN(x, y, z) ncine::FrameProfiler::ScopedZone x(y)
+		#define ZoneNamedC(x, y, z) ncine::FrameProfiler::ScopedZone x(__func__)
+		#define ZoneNamedNC(x, y, z, w) ncine::FrameProfiler::ScopedZone x(y)
+
+		#define ZoneScoped ncine::FrameProfiler::ScopedZone ___ncine_scoped_zone(__func__)
+		#define ZoneScopedN(x) ncine::FrameProfiler::ScopedZone ___ncine_scoped_zone(x)
+		#define ZoneScopedC(x) ncine::FrameProfiler::ScopedZone ___ncine_scoped_zone(__func__)
+		#define ZoneScopedNC(x, y) ncine::FrameProfiler::ScopedZone ___ncine_scoped_zone(x)
+
+		#define FrameMark ncine::FrameProfiler::markFrame()
+
+		#define ZoneNamedS(x, y, z) ZoneNamed(x, z)
+		#define ZoneNamedNS(x, y, z, w) ZoneNamedN(x, y, w)
+		#define ZoneNamedCS(x, y, z, w) ZoneNamedC(x, y, w)
+		#define ZoneNamedNCS(x, y, z, w, a) ZoneNamedNC(x, y, z, a)
+
+		#define ZoneScopedS(x) ZoneScoped
+		#define ZoneScopedNS(x, y) ZoneScopedN(x)
+		#define ZoneScopedCS(x, y) ZoneScopedC(x)
+		#define ZoneScopedNCS(x, y, z) ZoneScopedNC(x, y)
+
+	#else
+
+		#define ZoneNamed(x, y)
+		#define ZoneNamedN(x, y, z)
+		#define ZoneNamedC(x, y, z)
+		#define ZoneNamedNC(x, y, z, w)
+
+		#define ZoneScoped
+		#define ZoneScopedN(x)
+		#define ZoneScopedC(x)
+		#define ZoneScopedNC(x, y)
+
+		#define FrameMark
+
+		#define ZoneNamedS(x, y, z)
+		#define ZoneNamedNS(x, y, z, w)
+		#define ZoneNamedCS(x, y, z, w)
+		#define ZoneNamedNCS(x, y, z, w, a)
+
+		#define ZoneScopedS(x)
+		#define ZoneScopedNS(x, y)
+		#define ZoneScopedCS(x, y)
+		#define ZoneScopedNCS(x, y, z)
+
+	#endif
 
 	#define ZoneText(x, y)
 	#define ZoneName(x, y)
 
-	#define FrameMark
 	#define FrameMarkNamed(x)
 	#define FrameMarkStart(x)
 	#define FrameMarkEnd(x)
@@ -43,16 +85,6 @@
 	#define TracyAlloc(x, y)
 	#define TracyFree(x)
 
-	#define ZoneNamedS(x, y, z)
-	#define ZoneNamedNS(x, y, z, w)
-	#define ZoneNamedCS(x, y, z, w)
-	#define ZoneNamedNCS(x, y, z, w, a)
-
-	#define ZoneScopedS(x)
-	#define ZoneScopedNS(x, y)
-	#define ZoneScopedCS(x, y)
-	#define ZoneScopedNCS(x, y, z)
-
 	#define TracyAllocS(x, y, z)
 	#define TracyFreeS(x, y)
 
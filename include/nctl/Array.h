@@ -2,6 +2,7 @@
 #define CLASS_NCTL_ARRAY
 
 #include <ncine/common_macros.h>
+#include "memory_tags.h"
 #include "ArrayIterator.h"
 #include "ReverseIterator.h"
 #include "utility.h"
@@ -195,6 +196,7 @@ template <class T>
 Array<T>::Array(const Array<T> &other)
     : array_(nullptr), size_(other.size_), capacity_(other.capacity_), fixedCapacity_(other.fixedCapacity_)
 {
+	NCTL_CONTAINER_MEMORY_TAG;
 	array_ = new T[capacity_];
 	// copying all elements invoking their copy constructor
 	for (unsigned int i = 0; i < size_; i++)
@@ -242,7 +244,10 @@ void Array<T>::setCapacity(unsigned int newCapacity)
 
 	T *newArray = nullptr;
 	if (newCapacity > 0)
+	{
+		NCTL_CONTAINER_MEMORY_TAG;
 		newArray = new T[newCapacity];
+	}
 
 	if (size_ > 0)
 	{
@@ -2,6 +2,7 @@
 #define CLASS_NCTL_HASHMAP
 
 #include <ncine/common_macros.h>
+#include "memory_tags.h"
 #include "UniquePtr.h"
 #include "HashFunctions.h"
 #include "ReverseIterator.h"
@@ -209,6 +210,7 @@ HashMap<K, T, HashFunc>::HashMap(unsigned int capacity)
 	FATAL_ASSERT_MSG(capacity > 0, "Zero is not a valid capacity");
 
 	const unsigned int bytes = capacity_ * (sizeof(uint8_t) * 2 + sizeof(hash_t));
+	NCTL_CONTAINER_MEMORY_TAG;
 	buffer_ = makeUnique<uint8_t[]>(bytes);
 
 	uint8_t *pointer = buffer_.get();
@@ -230,6 +232,7 @@ HashMap<K, T, HashFunc>::HashMap(const HashMap<K, T, HashFunc> &other)
     : size_(other.size_), capacity_(other.capacity_)
 {
 	const unsigned int bytes = capacity_ * (sizeof(uint8_t) * 2 + sizeof(hash_t));
+	NCTL_CONTAINER_MEMORY_TAG;
 	buffer_ = makeUnique<uint8_t[]>(bytes);
 	memcpy(buffer_.get(), other.buffer_.get(), bytes);
 
@@ -606,8 +609,9 @@ void HashMap<K, T, HashFunc>::rehash(unsigned int count)
 	{
 		if (hashes_[i] != NullHash)
 		{
-			const Node &node = nodes_[i];
-			hashMap[node.key] = node.value;
+			// Values are moved as the old nodes are discarded afterwards
+			Node &node = nodes_[i];
+			hashMap[node.key] = nctl::move(node.value);
 
 			rehashedNodes++;
 			if (rehashedNodes == size_)
@@ -744,7 +748,8 @@ T &HashMap<K, T, HashFunc>::addNode(unsigned int index, hash_t hash, const K &ke
 
 	size_++;
 	hashes_[index] = hash;
-	nodes_[index].key = key;
+	// A copy is moved in as assigning a key, like a string, could truncate it to the capacity of the node
+	nodes_[index].key = K(key);
 	return nodes_[index].value;
 }
 
@@ -756,7 +761,7 @@ void HashMap<K, T, HashFunc>::insertNode(unsigned int index, hash_t hash, const
 
 	size_++;
 	hashes_[index] = hash;
-	nodes_[index].key = key;
+	nodes_[index].key = K(key);
 	nodes_[index].value = value;
 }
 
@@ -768,7 +773,7 @@ void HashMap<K, T, HashFunc>::insertNode(unsigned int index, hash_t hash, const
 
 	size_++;
 	hashes_[index] = hash;
-	nodes_[index].key = key;
+	nodes_[index].key = K(key);
 	nodes_[index].value = nctl::move(value);
 }
 
@@ -781,7 +786,7 @@ void HashMap<K, T, HashFunc>::emplaceNode(unsigned int index, hash_t hash, const
 
 	size_++;
 	hashes_[index] = hash;
-	nodes_[index].key = key;
+	nodes_[index].key = K(key);
 	new (&nodes_[index].value) T(nctl::forward<Args>(args)...);
 }
 
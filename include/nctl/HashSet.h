@@ -2,6 +2,7 @@
 #define CLASS_NCTL_HASHSET
 
 #include <ncine/common_macros.h>
+#include "memory_tags.h"
 #include "UniquePtr.h"
 #include "HashFunctions.h"
 #include "ReverseIterator.h"
@@ -194,6 +195,7 @@ HashSet<K, HashFunc>::HashSet(unsigned int capacity)
 	FATAL_ASSERT_MSG(capacity > 0, "Zero is not a valid capacity");
 
 	const unsigned int bytes = capacity_ * (sizeof(uint8_t) * 2 + sizeof(hash_t));
+	NCTL_CONTAINER_MEMORY_TAG;
 	buffer_ = makeUnique<uint8_t[]>(bytes);
 
 	uint8_t *pointer = buffer_.get();
@@ -215,6 +217,7 @@ HashSet<K, HashFunc>::HashSet(const HashSet<K, HashFunc> &other)
     : size_(other.size_), capacity_(other.capacity_)
 {
 	const unsigned int bytes = capacity_ * (sizeof(uint8_t) * 2 + sizeof(hash_t));
+	NCTL_CONTAINER_MEMORY_TAG;
 	buffer_ = makeUnique<uint8_t[]>(bytes);
 	memcpy(buffer_.get(), other.buffer_.get(), bytes);
 
@@ -0,0 +1,37 @@
+#ifndef NCTL_UTF8
+#define NCTL_UTF8
+
+#include <ncine/common_macros.h>
+
+namespace nctl {
+
+/// Functions to encode and decode UTF-8 sequences
+namespace Utf8 {
+
+	/// The maximum number of code units (bytes) in a UTF-8 sequence
+	static const unsigned int MaxCodeUnits = 4;
+	/// The replacement character code point, returned when decoding an invalid sequence
+	static const unsigned int InvalidCodePoint = 0xFFFD;
+	/// The largest valid Unicode code point
+	static const unsigned int MaxCodePoint = 0x10FFFF;
+
+	/// Returns true if the code unit is a continuation byte of a multi-byte sequence
+	inline bool isContinuation(char codeUnit) { return (static_cast<unsigned char>(codeUnit) & 0xC0) == 0x80; }
+
+	/// Decodes the UTF-8 sequence at the beginning of a buffer without reading more than `maxCodeUnits` bytes
+	/*! \returns The number of consumed code units, one when the sequence is invalid or zero if there are no code units to decode
+	 *  \note An invalid or truncated sequence decodes to `InvalidCodePoint` */
+	DLL_PUBLIC unsigned int decode(const char *sequence, unsigned int maxCodeUnits, unsigned int &codePoint);
+	/// Encodes a code point into a buffer of at least `MaxCodeUnits` bytes
+	/*! \returns The number of written code units or zero if the code point is not valid */
+	DLL_PUBLIC unsigned int encode(unsigned int codePoint, char *sequence);
+	/// Returns the number of code points in a UTF-8 buffer of the specified length
+	DLL_PUBLIC unsigned int numCodePoints(const char *sequence, unsigned int length);
+	/// Returns the largest length not exceeding `length` that does not split a multi-byte sequence
+	DLL_PUBLIC unsigned int truncatedLength(const char *sequence, unsigned int length);
+
+}
+
+}
+
+#endif
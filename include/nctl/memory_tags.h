@@ -0,0 +1,18 @@
+#ifndef NCTL_MEMORY_TAGS
+#define NCTL_MEMORY_TAGS
+
+#ifdef NCINE_WITH_MEMORY_TAGS
+
+	#include <ncine/MemoryStatistics.h>
+
+	/// Tags the allocations of a container in the current scope, unless the calling thread has set another tag
+	#define NCTL_CONTAINER_MEMORY_TAG ncine::MemoryStatistics::ScopedContainerTag ___nctl_container_memory_tag
+
+#else
+
+	/// Containers are not tagged if the global `new` operator does not account allocations
+	#define NCTL_CONTAINER_MEMORY_TAG
+
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+#!/usr/bin/env lua
+
+-- Measures the cost of the most common binding calls and prints the calls per second
+
+if ncine == nil then
+	ncine = require "libncine"
+	needs_start = true
+end
+
+nc = ncine
+
+local NumSprites = 1000
+local NumIterations = 100
+
+local function bench(name, num_calls, func)
+	local start = nc.timestamp.now()
+	func()
+	local seconds = nc.timestamp.seconds_since(start)
+	nc.log.info(string.format("%-32s %10.0f calls/s", name, num_calls / seconds))
+end
+
+function ncine.on_pre_init(cfg)
+	cfg.resolution = {x = 1280, y = 720}
+	cfg.window_title = "nCine Lua bindings benchmark"
+	return cfg
+end
+
+function ncine.on_init()
+	local rootnode = nc.application.rootnode()
+	local texture_file = nc.ANDROID and "texture2_ETC2.ktx" or "texture2.png"
+	texture_ = nc.texture.new(nc.fs.get_datapath().."textures/"..texture_file)
+
+	local sprites = {}
+	for i = 1, NumSprites do
+		sprites[i] = nc.sprite.new(rootnode, texture_, i % 1280, i % 720)
+	end
+	sprites_ = sprites
+
+	local num_calls = NumSprites * NumIterations
+
+	bench("get_position (table)", num_calls, function()
+		for _ = 1, NumIterations do
+			for i = 1, NumSprites do
+				local pos = nc.sprite.get_position(sprites[i])
+				nc.sprite.set_position(sprites[i], pos)
+			end
+		end
+	end)
+
+	bench("get_position_xy (values)", num_calls, function()
+		for _ = 1, NumIterations do
+			for i = 1, NumSprites do
+				local x, y = nc.sprite.get_position_xy(sprites[i])
+				nc.sprite.set_position(sprites[i], x, y)
+			end
+		end
+	end)
+
+	local get_position_xy = nc.sprite.get_position_xy
+	local set_position = nc.sprite.set_position
+	bench("get_position_xy (cached)", num_calls, function()
+		for _ = 1, NumIterations do
+			for i = 1, NumSprites do
+				local x, y = get_position_xy(sprites[i])
+				set_position(sprites[i], x, y)
+			end
+		end
+	end)
+
+	-- Pushing the same engine object repeatedly reuses a single handle
+	bench("get_parent (untracked)", num_calls, function()
+		local get_parent = nc.sprite.get_parent
+		for _ = 1, NumIterations do
+			for i = 1, NumSprites do
+				get_parent(sprites[i])
+			end
+		end
+	end)
+
+	nc.application.quit()
+end
+
+function ncine.on_shutdown()
+	for i = 1, #sprites_ do
+		nc.sprite.delete(sprites_[i])
+	end
+	nc.texture.delete(texture_)
+end
+
+if needs_start then
+	ncine.start()
+end
@@ -16,14 +16,24 @@ AppConfiguration::AppConfiguration()
 #endif
       fileLogLevel(ILogger::LogLevel::OFF),
       frameTimerLogInterval(5.0f),
+      withAsyncLogging(false),
+      frameCaptureKey(KeySym::UNKNOWN),
       resolution(1280, 720),
       inFullscreen(false),
       isResizable(false),
       frameLimit(0),
+      isHeadless(false),
+      fixedTimestep(0.0f),
+      benchmarkFrames(0),
+      benchmarkFile(128),
+      replayRecordFile(128),
+      replayPlaybackFile(128),
       windowTitle(128),
       windowIconFilename(128),
       useBufferMapping(false),
       deferShaderQueries(true),
+      useBinaryShaderCache(true),
+      shaderCacheDirname(64),
       fixedBatchSize(10),
 #if defined(WITH_IMGUI) || defined(WITH_NUKLEAR)
       vboSize(512 * 1024),
@@ -33,9 +43,13 @@ AppConfiguration::AppConfiguration()
       iboSize(8 * 1024),
 #endif
       vaoPoolSize(16),
+      audioStreamNumBuffers(3),
+      audioStreamBufferSize(16 * 1024),
+      audioMixerVoices(0),
       withDebugOverlay(false),
       withAudio(true),
       withThreads(false),
+      withAudioStreamThread(true),
       withScenegraph(true),
       withVSync(true),
       withGlDebugContext(false),
@@ -53,8 +67,10 @@ AppConfiguration::AppConfiguration()
       profileTextUpdateTime_(0.2f)
 {
 	logFile = "ncine_log.txt";
+	benchmarkFile = "ncine_benchmark.csv";
 	windowTitle = "nCine";
 	windowIconFilename = "icons/icon48.png";
+	shaderCacheDirname = "nCineShaderCache";
 
 #ifdef __EMSCRIPTEN__
 	// Always disable mapping on Emscripten as it is not supported by WebGL 2
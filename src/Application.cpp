@@ -8,8 +8,12 @@
 #include "RenderResources.h"
 #include "RenderQueue.h"
 #include "GLDebug.h"
-#include "Timer.h" // for `sleep()`
 #include "FrameTimer.h"
+#include "FramePacer.h"
+#include "FrameProfiler.h"
+#include "FrameBenchmark.h"
+#include "FrameReplay.h"
+#include "MemoryStatistics.h"
 #include "SceneNode.h"
 #include <nctl/String.h>
 #include "IInputManager.h"
@@ -21,10 +25,12 @@
 
 #ifdef WITH_THREADS
 	#include "ThreadPool.h"
+	#include "ParallelVisit.h"
 #endif
 
 #ifdef WITH_LUA
 	#include "LuaStatistics.h"
+	#include "LuaStateManager.h"
 #endif
 
 #ifdef WITH_IMGUI
@@ -51,7 +57,7 @@ namespace ncine {
 ///////////////////////////////////////////////////////////
 
 Application::Application()
-    : isSuspended_(false), autoSuspension_(true), hasFocus_(true), shouldQuit_(false)
+    : isSuspended_(false), autoSuspension_(true), hasFocus_(true), shouldQuit_(false), frameCaptureKeyDown_(false)
 {
 }
 
@@ -68,7 +74,27 @@ unsigned long int Application::numFrames() const
 
 float Application::interval() const
 {
-	return frameTimer_->lastFrameInterval();
+	if (frameReplay_ && frameReplay_->isPlaying())
+		return frameReplay_->interval();
+	// A fixed timestep makes the updates of a benchmark independent from the speed of the machine
+	return (appCfg_.fixedTimestep > 0.0f) ? appCfg_.fixedTimestep : frameTimer_->lastFrameInterval();
+}
+
+float Application::intervalDeviation() const
+{
+	return frameTimer_->frameIntervalDeviation();
+}
+
+float Application::maxInterval() const
+{
+	return frameTimer_->maxFrameInterval();
+}
+
+bool Application::exportFrameCapture()
+{
+	nctl::String filename(64);
+	filename.format("frame_capture_%lu.json", numFrames());
+	return FrameProfiler::exportChromeTrace(fs::joinPath(fs::savePath(), filename).data());
 }
 
 ///////////////////////////////////////////////////////////
@@ -78,8 +104,11 @@ float Application::interval() const
 void Application::initCommon()
 {
 	TracyGpuContext;
+	FrameProfiler::setThreadName("Main thread");
 	ZoneScoped;
 	profileStartTime_ = TimeStamp::now();
+	// Allocations made from now on are attributed to the tag of the allocating thread
+	MemoryStatistics::setEnabled(true);
 
 #ifdef WITH_GIT_VERSION
 	LOGI_X("nCine %s (%s) compiled on %s at %s", VersionStrings::Version, VersionStrings::GitBranch,
@@ -113,6 +142,17 @@ void Application::initCommon()
 	TracyGpuCollect;
 
 	frameTimer_ = nctl::makeUnique<FrameTimer>(appCfg_.frameTimerLogInterval, appCfg_.profileTextUpdateTime());
+	if (appCfg_.frameLimit > 0)
+	{
+		framePacer_ = nctl::makeUnique<FramePacer>();
+		framePacer_->setTargetFps(appCfg_.frameLimit);
+	}
+	if (appCfg_.benchmarkFrames > 0)
+	{
+		frameBenchmark_ = nctl::makeUnique<FrameBenchmark>(appCfg_.benchmarkFile.data(), appCfg_.benchmarkFrames);
+		// GPU times are written alongside the CPU ones
+		renderingSettings_.gpuTimingEnabled = true;
+	}
 
 #ifdef WITH_IMGUI
 	imguiDrawing_ = nctl::makeUnique<ImGuiDrawing>(appCfg_.withScenegraph);
@@ -124,8 +164,14 @@ void Application::initCommon()
 	if (appCfg_.withScenegraph)
 	{
 		gfxDevice_->setupGL();
+		const TimeStamp renderResourcesStartTime = TimeStamp::now();
 		RenderResources::create();
+		timings_[Timings::RENDER_RESOURCES] = renderResourcesStartTime.secondsSince();
 		renderQueue_ = nctl::makeUnique<RenderQueue>();
+#ifdef WITH_THREADS
+		if (appCfg_.withThreads)
+			parallelVisit_ = nctl::makeUnique<ParallelVisit>(Thread::numProcessors());
+#endif
 		rootNode_ = nctl::makeUnique<SceneNode>();
 	}
 	else
@@ -137,8 +183,25 @@ void Application::initCommon()
 		debugOverlay_ = nctl::makeUnique<ImGuiDebugOverlay>(appCfg_.profileTextUpdateTime());
 #endif
 
+	// The replay handler is placed between the input managers and the application handler
+	if (appCfg_.replayPlaybackFile.isEmpty() == false)
+		frameReplay_ = nctl::makeUnique<FrameReplay>(FrameReplay::Mode::PLAYBACK, appCfg_.replayPlaybackFile.data(), IInputManager::handler());
+	else if (appCfg_.replayRecordFile.isEmpty() == false)
+		frameReplay_ = nctl::makeUnique<FrameReplay>(FrameReplay::Mode::RECORD, appCfg_.replayRecordFile.data(), IInputManager::handler());
+	if (frameReplay_ && frameReplay_->isValid() == false)
+		frameReplay_.reset(nullptr);
+
 	// Initialization of the static random generator seeds
-	random().init(static_cast<uint64_t>(TimeStamp::now().ticks()), static_cast<uint64_t>(profileStartTime_.ticks()));
+	uint64_t randomInitState = static_cast<uint64_t>(TimeStamp::now().ticks());
+	uint64_t randomInitSequence = static_cast<uint64_t>(profileStartTime_.ticks());
+	if (frameReplay_ && frameReplay_->isPlaying())
+	{
+		randomInitState = frameReplay_->randomInitState();
+		randomInitSequence = frameReplay_->randomInitSequence();
+	}
+	else if (frameReplay_)
+		frameReplay_->recordRandomSeeds(randomInitState, randomInitSequence);
+	random().init(randomInitState, randomInitSequence);
 
 	LOGI("Application initialized");
 
@@ -169,7 +232,23 @@ void Application::initCommon()
 void Application::step()
 {
 	ZoneScoped;
+	const TimeStamp frameStartTime = TimeStamp::now();
 	frameTimer_->addFrame();
+	// Recorded events are dispatched at the same point where the real ones have been received
+	if (frameReplay_ && frameReplay_->isPlaying())
+	{
+		if (frameReplay_->playFrame() == false)
+			shouldQuit_ = true;
+	}
+	if (appCfg_.frameCaptureKey != KeySym::UNKNOWN)
+	{
+		// Exporting once when the key is pressed, the trace includes the frames before it
+		const bool keyDown = inputManager_->keyboardState().isKeyDown(appCfg_.frameCaptureKey);
+		if (keyDown && frameCaptureKeyDown_ == false)
+			exportFrameCapture();
+		frameCaptureKeyDown_ = keyDown;
+	}
+
 	if (appCfg_.withScenegraph)
 	{
 		TracyGpuZone("Clear");
@@ -213,20 +292,28 @@ void Application::step()
 		ZoneScopedN("SceneGraph");
 		{
 			ZoneScopedN("Update");
+			MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::SCENEGRAPH);
 			profileStartTime_ = TimeStamp::now();
-			rootNode_->update(frameTimer_->lastFrameInterval());
+			rootNode_->update(interval());
 			timings_[Timings::UPDATE] = profileStartTime_.secondsSince();
 		}
 
 		{
 			ZoneScopedN("Visit");
+			MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::SCENEGRAPH);
 			profileStartTime_ = TimeStamp::now();
-			rootNode_->visit(*renderQueue_);
+#ifdef WITH_THREADS
+			if (parallelVisit_ && renderingSettings_.parallelVisit)
+				parallelVisit_->visit(*rootNode_, *renderQueue_);
+			else
+#endif
+				rootNode_->visit(*renderQueue_);
 			timings_[Timings::VISIT] = profileStartTime_.secondsSince();
 		}
 
 		{
 			ZoneScopedN("Draw");
+			MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::RENDER_COMMANDS);
 			profileStartTime_ = TimeStamp::now();
 			renderQueue_->draw();
 			timings_[Timings::DRAW] = profileStartTime_.secondsSince();
@@ -235,12 +322,14 @@ void Application::step()
 
 	{
 		ZoneScopedN("Audio");
+		MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::AUDIO);
 		theServiceLocator().audioDevice().updatePlayers();
 	}
 
 #ifdef WITH_IMGUI
 	{
 		ZoneScopedN("ImGui endFrame");
+		MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::RENDER_COMMANDS);
 		profileStartTime_ = TimeStamp::now();
 		if (appCfg_.withScenegraph)
 			imguiDrawing_->endFrame(*renderQueue_);
@@ -253,6 +342,7 @@ void Application::step()
 #ifdef WITH_NUKLEAR
 	{
 		ZoneScopedN("Nuklear endFrame");
+		MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::RENDER_COMMANDS);
 		profileStartTime_ = TimeStamp::now();
 		if (appCfg_.withScenegraph)
 			nuklearDrawing_->endFrame(*renderQueue_);
@@ -273,20 +363,36 @@ void Application::step()
 		timings_[Timings::FRAME_END] = profileStartTime_.secondsSince();
 	}
 
+#ifdef WITH_LUA
+	{
+		ZoneScopedN("Lua GC");
+		LuaStateManager::stepGarbageCollectors();
+	}
+#endif
+
+	MemoryStatistics::markFrame();
 	if (debugOverlay_)
 		debugOverlay_->updateFrameTimings();
 
-	if (appCfg_.frameLimit > 0)
+	// Flushing at the end of the frame, so events received during it are played back with it and not with the next one
+	if (frameReplay_ && frameReplay_->isPlaying() == false)
+		frameReplay_->recordFrame(interval());
+
+	// The frame duration does not include the time spent waiting for the pacer
+	if (frameBenchmark_ && frameBenchmark_->recordFrame(frameStartTime.secondsSince(), timings_))
+		shouldQuit_ = true;
+
+	if (framePacer_)
 	{
-		const float frameTimeDuration = 1.0f / static_cast<float>(appCfg_.frameLimit);
-		while (frameTimer_->frameInterval() < frameTimeDuration)
-			Timer::sleep(0.0f);
+		ZoneScopedN("Frame pacing");
+		framePacer_->wait();
 	}
 }
 
 void Application::shutdownCommon()
 {
 	ZoneScoped;
+	frameReplay_.reset(nullptr);
 	{
 		ZoneScopedN("onShutdown");
 		appEventHandler_->onShutdown();
@@ -307,8 +413,13 @@ void Application::shutdownCommon()
 
 	debugOverlay_.reset(nullptr);
 	rootNode_.reset(nullptr);
+#ifdef WITH_THREADS
+	parallelVisit_.reset(nullptr);
+#endif
 	renderQueue_.reset(nullptr);
 	RenderResources::dispose();
+	frameBenchmark_.reset(nullptr);
+	framePacer_.reset(nullptr);
 	frameTimer_.reset(nullptr);
 	inputManager_.reset(nullptr);
 	gfxDevice_.reset(nullptr);
@@ -348,6 +459,8 @@ void Application::resume()
 	if (appEventHandler_)
 		appEventHandler_->onResume();
 	const TimeStamp suspensionDuration = frameTimer_->resume();
+	if (framePacer_)
+		framePacer_->reset();
 	LOGV_X("Suspended for %.3f seconds", suspensionDuration.seconds());
 	profileStartTime_ += suspensionDuration;
 	LOGI("IAppEventHandler::onResume() invoked");
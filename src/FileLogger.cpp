@@ -5,12 +5,112 @@
 	#include <cstdarg>
 #endif
 #include <ctime>
+#include <cstring> // for memcpy()
 #include "FileLogger.h"
 #include "common_macros.h"
 #include "tracy.h"
 
+#ifdef WITH_THREADS
+	#include <nctl/Atomic.h>
+	#include "Thread.h"
+	#include "ThreadSync.h"
+#endif
+
 namespace ncine {
 
+namespace {
+	/// Formats the timestamp only once per second for each thread
+	unsigned int formatTimestamp(char *buffer, unsigned int size)
+	{
+		static thread_local time_t lastTime = 0;
+		static thread_local char timestamp[32] = "";
+		static thread_local unsigned int timestampLength = 0;
+
+		const time_t now = time(nullptr);
+		if (now != lastTime || timestampLength == 0)
+		{
+			struct tm ts;
+#ifdef _WIN32
+			localtime_s(&ts, &now);
+#else
+			localtime_r(&now, &ts);
+#endif
+			//timestampLength = strftime(timestamp, sizeof(timestamp), "- %a %Y-%m-%d %H:%M:%S %Z ", &ts);
+			timestampLength = strftime(timestamp, sizeof(timestamp), "- %H:%M:%S ", &ts);
+			lastTime = now;
+		}
+
+		const unsigned int length = (timestampLength < size) ? timestampLength : size;
+		memcpy(buffer, timestamp, length);
+		return length;
+	}
+}
+
+#ifdef WITH_THREADS
+struct FileLogger::AsyncWriter
+{
+	struct Entry
+	{
+		/// Equal to the queue position plus one when the entry is ready to be written
+		nctl::Atomic32 sequence;
+		LogLevel level;
+		unsigned int length;
+		char text[MaxEntryLength];
+	};
+
+	AsyncWriter()
+	    : entries(nctl::makeUnique<Entry[]>(AsyncQueueSize)), dequeuePos(0), numReportedDrops(0)
+	{
+		for (unsigned int i = 0; i < AsyncQueueSize; i++)
+			entries[i].sequence.store(static_cast<int32_t>(i), nctl::Atomic32::MemoryModel::RELAXED);
+	}
+
+	inline Entry &entryAt(uint32_t position) { return entries[position & (AsyncQueueSize - 1)]; }
+	inline bool isEmpty() { return static_cast<uint32_t>(entryAt(dequeuePos).sequence.load()) != dequeuePos + 1; }
+
+	nctl::UniquePtr<Entry[]> entries;
+	nctl::Atomic32 enqueuePos;
+	/// Only accessed by the writer thread
+	uint32_t dequeuePos;
+	/// The position up to which the entries have been written
+	nctl::Atomic32 writtenPos;
+	mutable nctl::Atomic32 numDrops;
+	int32_t numReportedDrops;
+
+	nctl::Atomic32 isWriterSleeping;
+	nctl::Atomic32 shouldQuit;
+	Mutex mutex;
+	CondVariable condVar;
+	/// Serializes the writer thread with the entries written directly by the caller
+	Mutex outputMutex;
+	Thread thread;
+};
+#else
+struct FileLogger::AsyncWriter
+{
+};
+#endif
+
+#ifdef WITH_IMGUI
+struct FileLogger::LogString
+{
+	LogString()
+	    : entries(LogStringCapacity), snapshot(LogStringCapacity), hasChanged(false) {}
+
+	/// Appended by the threads calling `write()`, guarded by the mutex
+	nctl::String entries;
+	/// The copy read by the ImGui console, only accessed by the main thread
+	mutable nctl::String snapshot;
+	/// True if the entries have changed since the last copy, guarded by the mutex
+	mutable bool hasChanged;
+	#ifdef WITH_THREADS
+	mutable Mutex mutex;
+	#endif
+};
+#endif
+
+static_assert((FileLogger::AsyncQueueSize & (FileLogger::AsyncQueueSize - 1)) == 0, "The queue size should be a power of two");
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
@@ -24,7 +124,7 @@ FileLogger::FileLogger(LogLevel consoleLevel, LogLevel fileLevel, const char *fi
     : consoleLevel_(consoleLevel), fileLevel_(fileLevel)
 #ifdef WITH_IMGUI
       ,
-      logString_(LogStringCapacity)
+      logString_(nctl::makeUnique<LogString>())
 #endif
 {
 	openLogFile(filename);
@@ -33,6 +133,7 @@ FileLogger::FileLogger(LogLevel consoleLevel, LogLevel fileLevel, const char *fi
 
 FileLogger::~FileLogger()
 {
+	setAsynchronous(false);
 	write(LogLevel::VERBOSE, "FileLogger::~FileLogger -> End of the log");
 }
 
@@ -82,40 +183,193 @@ unsigned int FileLogger::write(LogLevel level, const char *fmt, ...)
 	const int consoleLevelInt = static_cast<int>(consoleLevel_);
 	const int fileLevelInt = static_cast<int>(fileLevel_);
 
-	time_t now;
-	struct tm *ts;
-	now = time(nullptr);
-	ts = localtime(&now);
+	// Each thread formats its entries in its own buffer
+	static thread_local char logEntry[MaxEntryLength];
 
-	logEntry_[0] = '\0';
-	logEntry_[MaxEntryLength - 1] = '\0';
+	logEntry[0] = '\0';
+	logEntry[MaxEntryLength - 1] = '\0';
 	unsigned int length = 0;
 
-	//length += strftime(logEntry_ + length, MaxEntryLength - length - 1, "- %a %Y-%m-%d %H:%M:%S %Z ", ts);
-	length += strftime(logEntry_ + length, MaxEntryLength - length - 1, "- %H:%M:%S ", ts);
-	length += snprintf(logEntry_ + length, MaxEntryLength - length - 1, "[L%d] - ", levelInt);
+	length += formatTimestamp(logEntry + length, MaxEntryLength - length - 1);
+	length += snprintf(logEntry + length, MaxEntryLength - length - 1, "[L%d] - ", levelInt);
 
 	va_list args;
 	va_start(args, fmt);
-	length += vsnprintf(logEntry_ + length, MaxEntryLength - length - 1, fmt, args);
+	const int messageLength = vsnprintf(logEntry + length, MaxEntryLength - length - 1, fmt, args);
 	va_end(args);
 
+	// The entry has been truncated if the message is longer than the space left
+	if (messageLength > 0)
+		length += (static_cast<unsigned int>(messageLength) < MaxEntryLength - length - 1) ? messageLength : MaxEntryLength - length - 2;
+
 	if (length < MaxEntryLength - 2)
 	{
-		logEntry_[length++] = '\n';
-		logEntry_[length] = '\0';
+		logEntry[length++] = '\n';
+		logEntry[length] = '\0';
+	}
+
+	appendToLogString(level, logEntry, length);
+
+#ifdef WITH_THREADS
+	if (asyncWriter_ != nullptr)
+	{
+		// Fatal entries are written before the application terminates, after the ones in the queue
+		if (level == LogLevel::FATAL)
+		{
+			flush();
+			asyncWriter_->outputMutex.lock();
+			writeEntry(level, logEntry, length);
+			asyncWriter_->outputMutex.unlock();
+		}
+		else if (levelInt >= consoleLevelInt || levelInt >= fileLevelInt)
+			enqueueEntry(level, logEntry, length);
+	}
+	else
+#endif
+	{
+		writeEntry(level, logEntry, length);
+		if (fileLevel_ != LogLevel::OFF && levelInt >= fileLevelInt &&
+		    fileHandle_ != nullptr && fileHandle_->isOpened())
+		{
+			fflush(fileHandle_->ptr());
+		}
+	}
+
+#ifdef WITH_TRACY
+	if (levelInt >= consoleLevelInt || levelInt >= fileLevelInt)
+	{
+		uint32_t color = 0x999999;
+		// clang-format off
+		switch (level)
+		{
+			case LogLevel::FATAL:		color = 0xec3e40; break;
+			case LogLevel::ERROR:		color = 0xff9b2b; break;
+			case LogLevel::WARN:		color = 0xf5d800; break;
+			case LogLevel::INFO:		color = 0x01a46d; break;
+			case LogLevel::DEBUG:		color = 0x377fc7; break;
+			case LogLevel::VERBOSE:		color = 0x73a5d7; break;
+			case LogLevel::UNKNOWN:		color = 0x999999; break;
+			default:					color = 0x999999; break;
+		}
+		// clang-format on
+
+		TracyMessageC(logEntry, length, color);
+	}
+#endif
+
+	return length;
+}
+
+void FileLogger::setAsynchronous(bool asynchronous)
+{
+#ifdef WITH_THREADS
+	if (asynchronous && asyncWriter_ == nullptr)
+	{
+		asyncWriter_ = nctl::makeUnique<AsyncWriter>();
+		asyncWriter_->thread.run(writerThreadFunction, this);
+	#if !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+		asyncWriter_->thread.setName("LogWriterThread");
+	#endif
 	}
+	else if (asynchronous == false && asyncWriter_ != nullptr)
+	{
+		asyncWriter_->mutex.lock();
+		asyncWriter_->shouldQuit.store(1);
+		asyncWriter_->mutex.unlock();
+		asyncWriter_->condVar.signal();
+		asyncWriter_->thread.join();
+		asyncWriter_.reset(nullptr);
+	}
+#endif
+}
+
+void FileLogger::flush()
+{
+#ifdef WITH_THREADS
+	if (asyncWriter_ == nullptr)
+		return;
+
+	const uint32_t enqueuePos = static_cast<uint32_t>(asyncWriter_->enqueuePos.load(nctl::Atomic32::MemoryModel::ACQUIRE));
+	while (static_cast<int32_t>(static_cast<uint32_t>(asyncWriter_->writtenPos.load(nctl::Atomic32::MemoryModel::ACQUIRE)) - enqueuePos) < 0)
+	{
+		if (asyncWriter_->isWriterSleeping.load())
+		{
+			asyncWriter_->mutex.lock();
+			asyncWriter_->condVar.signal();
+			asyncWriter_->mutex.unlock();
+		}
+		Thread::yieldExecution();
+	}
+#endif
+}
+
+unsigned int FileLogger::numDroppedEntries() const
+{
+#ifdef WITH_THREADS
+	if (asyncWriter_ != nullptr)
+		return static_cast<unsigned int>(asyncWriter_->numDrops.load(nctl::Atomic32::MemoryModel::RELAXED));
+#endif
+	return 0;
+}
+
+#ifdef WITH_IMGUI
+const char *FileLogger::logString() const
+{
+	#ifdef WITH_THREADS
+	logString_->mutex.lock();
+	#endif
+	// The copy is only taken when new entries have been appended
+	if (logString_->hasChanged)
+	{
+		logString_->snapshot = logString_->entries;
+		logString_->hasChanged = false;
+	}
+	#ifdef WITH_THREADS
+	logString_->mutex.unlock();
+	#endif
+
+	return logString_->snapshot.data();
+}
+
+void FileLogger::clearLogString()
+{
+	#ifdef WITH_THREADS
+	logString_->mutex.lock();
+	#endif
+	logString_->entries.clear();
+	logString_->snapshot.clear();
+	logString_->hasChanged = false;
+	#ifdef WITH_THREADS
+	logString_->mutex.unlock();
+	#endif
+}
+
+unsigned int FileLogger::logStringLength() const
+{
+	return logString_->snapshot.length();
+}
+#endif
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FileLogger::writeEntry(LogLevel level, const char *logEntry, unsigned int length)
+{
+	const int levelInt = static_cast<int>(level);
+	const int consoleLevelInt = static_cast<int>(consoleLevel_);
+	const int fileLevelInt = static_cast<int>(fileLevel_);
 
 	if (consoleLevel_ != LogLevel::OFF && levelInt >= consoleLevelInt)
 	{
 #ifndef __ANDROID__
 		if (level == LogLevel::ERROR || level == LogLevel::FATAL)
-			fputs(logEntry_, stderr);
+			fputs(logEntry, stderr);
 		else
-			fputs(logEntry_, stdout);
+			fputs(logEntry, stdout);
 
 	#ifdef _WIN32
-		writeOutputDebug(logEntry_);
+		writeOutputDebug(logEntry);
 	#endif
 
 #else
@@ -135,50 +389,155 @@ unsigned int FileLogger::write(LogLevel level, const char *fmt, ...)
 		}
 		// clang-format on
 
-		__android_log_write(priority, "nCine", logEntry_);
+		__android_log_write(priority, "nCine", logEntry);
 #endif
 	}
 
 	if (fileLevel_ != LogLevel::OFF && levelInt >= fileLevelInt &&
 	    fileHandle_ != nullptr && fileHandle_->isOpened())
 	{
-		fprintf(fileHandle_->ptr(), "%s", logEntry_);
-		fflush(fileHandle_->ptr());
+		fwrite(logEntry, 1, length, fileHandle_->ptr());
 	}
+}
 
+void FileLogger::appendToLogString(LogLevel level, const char *logEntry, unsigned int length)
+{
 #ifdef WITH_IMGUI
-	if (levelInt >= consoleLevelInt || levelInt >= fileLevelInt)
+	const int levelInt = static_cast<int>(level);
+	if (levelInt >= static_cast<int>(consoleLevel_) || levelInt >= static_cast<int>(fileLevel_))
 	{
-		if (length > logString_.capacity() - logString_.length() - 1)
-			logString_.clear();
-
-		logString_.append(logEntry_);
+	#ifdef WITH_THREADS
+		logString_->mutex.lock();
+	#endif
+		nctl::String &entries = logString_->entries;
+		if (length > entries.capacity() - entries.length() - 1)
+			entries.clear();
+
+		entries.append(logEntry);
+		logString_->hasChanged = true;
+	#ifdef WITH_THREADS
+		logString_->mutex.unlock();
+	#endif
 	}
 #endif
+}
 
-#ifdef WITH_TRACY
-	if (levelInt >= consoleLevelInt || levelInt >= fileLevelInt)
+bool FileLogger::enqueueEntry(LogLevel level, const char *logEntry, unsigned int length)
+{
+#ifdef WITH_THREADS
+	using MemoryModel = nctl::Atomic32::MemoryModel;
+	AsyncWriter &writer = *asyncWriter_;
+
+	uint32_t position = static_cast<uint32_t>(writer.enqueuePos.load(MemoryModel::RELAXED));
+	AsyncWriter::Entry *entry = nullptr;
+	while (entry == nullptr)
 	{
-		uint32_t color = 0x999999;
-		// clang-format off
-		switch (level)
+		AsyncWriter::Entry &candidate = writer.entryAt(position);
+		const int32_t difference = static_cast<int32_t>(static_cast<uint32_t>(candidate.sequence.load(MemoryModel::ACQUIRE)) - position);
+		if (difference == 0)
 		{
-			case LogLevel::FATAL:		color = 0xec3e40; break;
-			case LogLevel::ERROR:		color = 0xff9b2b; break;
-			case LogLevel::WARN:		color = 0xf5d800; break;
-			case LogLevel::INFO:		color = 0x01a46d; break;
-			case LogLevel::DEBUG:		color = 0x377fc7; break;
-			case LogLevel::VERBOSE:		color = 0x73a5d7; break;
-			case LogLevel::UNKNOWN:		color = 0x999999; break;
-			default:					color = 0x999999; break;
+			// The slot is free, trying to reserve it before another producer does
+			if (writer.enqueuePos.cmpExchange(static_cast<int32_t>(position + 1), static_cast<int32_t>(position), MemoryModel::RELAXED))
+				entry = &candidate;
+			else
+				position = static_cast<uint32_t>(writer.enqueuePos.load(MemoryModel::RELAXED));
 		}
-		// clang-format on
+		else if (difference < 0)
+		{
+			// The queue is full, the entry is dropped instead of blocking the caller
+			writer.numDrops.fetchAdd(1, MemoryModel::RELAXED);
+			return false;
+		}
+		else
+			position = static_cast<uint32_t>(writer.enqueuePos.load(MemoryModel::RELAXED));
+	}
 
-		TracyMessageC(logEntry_, length, color);
+	entry->level = level;
+	entry->length = length;
+	memcpy(entry->text, logEntry, length + 1);
+	// Sequentially consistent to be ordered with the following load of the sleeping flag
+	entry->sequence.store(static_cast<int32_t>(position + 1));
+
+	if (writer.isWriterSleeping.load())
+	{
+		writer.mutex.lock();
+		writer.condVar.signal();
+		writer.mutex.unlock();
 	}
+
+	return true;
+#else
+	return false;
 #endif
+}
 
-	return length;
+unsigned int FileLogger::writeQueuedEntries()
+{
+	unsigned int numEntries = 0;
+
+#ifdef WITH_THREADS
+	using MemoryModel = nctl::Atomic32::MemoryModel;
+	AsyncWriter &writer = *asyncWriter_;
+
+	writer.outputMutex.lock();
+	while (writer.isEmpty() == false)
+	{
+		AsyncWriter::Entry &entry = writer.entryAt(writer.dequeuePos);
+		writeEntry(entry.level, entry.text, entry.length);
+		// Releasing the slot for the producer that will wrap around the queue
+		entry.sequence.store(static_cast<int32_t>(writer.dequeuePos + AsyncQueueSize), MemoryModel::RELEASE);
+		writer.dequeuePos++;
+		numEntries++;
+	}
+
+	const int32_t numDrops = writer.numDrops.load(MemoryModel::RELAXED);
+	if (numDrops != writer.numReportedDrops)
+	{
+		char logEntry[96];
+		unsigned int length = formatTimestamp(logEntry, sizeof(logEntry));
+		length += snprintf(logEntry + length, sizeof(logEntry) - length, "[L%d] - %d log entries dropped\n",
+		                   static_cast<int>(LogLevel::WARN), numDrops - writer.numReportedDrops);
+		writeEntry(LogLevel::WARN, logEntry, length);
+		writer.numReportedDrops = numDrops;
+	}
+
+	if (numEntries > 0)
+	{
+		// A single flush for the whole batch
+		if (fileHandle_ != nullptr && fileHandle_->isOpened())
+			fflush(fileHandle_->ptr());
+		writer.writtenPos.store(static_cast<int32_t>(writer.dequeuePos), MemoryModel::RELEASE);
+	}
+	writer.outputMutex.unlock();
+#endif
+
+	return numEntries;
+}
+
+void FileLogger::writerThreadFunction(void *arg)
+{
+#ifdef WITH_THREADS
+	FileLogger *logger = static_cast<FileLogger *>(arg);
+	AsyncWriter &writer = *logger->asyncWriter_;
+
+	for (;;)
+	{
+		// Checking the flag before writing guarantees that the queue is empty when quitting
+		const bool shouldQuit = writer.shouldQuit.load() != 0;
+		if (logger->writeQueuedEntries() > 0)
+			continue;
+		else if (shouldQuit)
+			break;
+
+		writer.mutex.lock();
+		writer.isWriterSleeping.store(1);
+		// Producers only signal after seeing the flag, the queue is checked again to not miss a new entry
+		if (writer.isEmpty() && writer.shouldQuit.load() == 0)
+			writer.condVar.wait(writer.mutex);
+		writer.isWriterSleeping.store(0);
+		writer.mutex.unlock();
+	}
+#endif
 }
 
 }
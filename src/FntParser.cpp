@@ -1,5 +1,6 @@
 #include <cstring>
 #include "common_macros.h"
+#include <nctl/Utf8.h>
 #include "FntParser.h"
 #include "IFile.h"
 
@@ -42,16 +43,24 @@ void FntParser::parseFntBuffer(const char *buffer, long int size)
 			parseInfoTag(buffer);
 		else if (strncmp(buffer, "common", 6) == 0)
 			parseCommonTag(buffer);
+		else if (strncmp(buffer, "distanceField", 13) == 0)
+			parseDistanceFieldTag(buffer);
 		else if (strncmp(buffer, "page", 4) == 0 && numPageTags_ < MaxPageTags)
 			parsePageTag(buffer, numPageTags_++);
 		else if (strncmp(buffer, "chars", 5) == 0)
 			parseCharsTag(buffer);
-		else if (strncmp(buffer, "char", 4) == 0 && numCharTags_ < MaxCharTags)
+		else if (strncmp(buffer, "char", 4) == 0)
+		{
+			charTags_.pushBack(CharTag());
 			parseCharTag(buffer, numCharTags_++);
+		}
 		else if (strncmp(buffer, "kernings", 8) == 0)
 			parseKerningsTag(buffer);
-		else if (strncmp(buffer, "kerning", 7) == 0 && numKerningTags_ < MaxKerningTags)
+		else if (strncmp(buffer, "kerning", 7) == 0)
+		{
+			kerningTags_.pushBack(KerningTag());
 			parseKerningTag(buffer, numKerningTags_++);
+		}
 	} while (strchr(buffer, '\n') && (buffer = strchr(buffer, '\n') + 1) < bufferStart + size);
 
 	LOGI_X("FNT file parsed for \"%s\", size %d, texture %dx%d, : %u pages, %u characters, %u kernings", infoTag_.face.data(), infoTag_.size, commonTag_.scaleW, commonTag_.scaleH, numPageTags_, numCharTags_, numKerningTags_);
@@ -214,6 +223,26 @@ void FntParser::parseCommonTag(const char *buffer)
 	}
 }
 
+void FntParser::parseDistanceFieldTag(const char *buffer)
+{
+	buffer = nextField(buffer);
+
+	if (strncmp(buffer, "fieldType", 9) == 0)
+	{
+		if (strncmp(buffer, "fieldType=msdf", 14) == 0)
+			distanceFieldTag_.fieldType = FieldType::MSDF;
+		else if (strncmp(buffer, "fieldType=sdf", 13) == 0)
+			distanceFieldTag_.fieldType = FieldType::SDF;
+		buffer = nextField(buffer);
+	}
+
+	if (strncmp(buffer, "distanceRange", 13) == 0)
+	{
+		sscanf(buffer, "distanceRange=%d", &distanceFieldTag_.distanceRange);
+		buffer = nextField(buffer);
+	}
+}
+
 void FntParser::parsePageTag(const char *buffer, unsigned int index)
 {
 	buffer = nextField(buffer);
@@ -238,6 +267,9 @@ void FntParser::parseCharsTag(const char *buffer)
 	if (strncmp(buffer, "count", 5) == 0)
 	{
 		sscanf(buffer, "count=%d", &charsTag_.count);
+		// Large glyph sets are stored without reallocations
+		if (charsTag_.count > 0)
+			charTags_.setCapacity(numCharTags_ + static_cast<unsigned int>(charsTag_.count));
 		buffer = nextField(buffer);
 	}
 }
@@ -316,6 +348,8 @@ void FntParser::parseKerningsTag(const char *buffer)
 	if (strncmp(buffer, "count", 5) == 0)
 	{
 		sscanf(buffer, "count=%d", &kerningsTag_.count);
+		if (kerningsTag_.count > 0)
+			kerningTags_.setCapacity(numKerningTags_ + static_cast<unsigned int>(kerningsTag_.count));
 		buffer = nextField(buffer);
 	}
 }
@@ -351,6 +385,7 @@ const char *FntParser::nextField(const char *buffer) const
 	bool needEqualSign = true;
 	if (strncmp(buffer, "info", 4) == 0 ||
 	    strncmp(buffer, "common", 6) == 0 ||
+	    strncmp(buffer, "distanceField", 13) == 0 ||
 	    strncmp(buffer, "page", 4) == 0 ||
 	    strncmp(buffer, "chars", 5) == 0 ||
 	    strncmp(buffer, "char", 4) == 0 ||
@@ -392,7 +427,9 @@ bool FntParser::extractValueWithSpaces(const char *buffer, nctl::String &string)
 
 	if (end)
 	{
-		const unsigned int length = end - start + 1;
+		unsigned int length = end - start + 1;
+		if (length > string.capacity() - 1)
+			length = nctl::Utf8::truncatedLength(start, string.capacity() - 1);
 		if (length > 0)
 			string.assign(start, length);
 		extracted = true;
@@ -1,14 +1,27 @@
 #include <cstring> // for `strrchr()`
 #include "common_macros.h"
+#include <nctl/Utf8.h>
+#include <nctl/HashMapIterator.h>
 #include "Font.h"
 #include "FntParser.h"
 #include "FontGlyph.h"
 #include "Texture.h"
 #include "FileSystem.h"
+#include "MemoryStatistics.h"
 #include "tracy.h"
 
 namespace ncine {
 
+namespace {
+
+	/// Packs two code points into a single key for the kerning table
+	inline uint64_t kerningKey(unsigned int firstCodePoint, unsigned int secondCodePoint)
+	{
+		return (static_cast<uint64_t>(firstCodePoint) << 32) | secondCodePoint;
+	}
+
+}
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
@@ -17,10 +30,11 @@ namespace ncine {
 Font::Font(const char *fntFilename)
     : Object(ObjectType::FONT, fntFilename),
       lineHeight_(0), base_(0), width_(0), height_(0), numGlyphs_(0), numKernings_(0),
-      glyphs_(nctl::makeUnique<FontGlyph[]>(MaxGlyphs)), renderMode_(RenderMode::GLYPH_IN_RED)
+      directGlyphs_{}, renderMode_(RenderMode::GLYPH_IN_RED), distanceRange_(0)
 {
 	ZoneScoped;
 	ZoneText(fntFilename, strnlen(fntFilename, nctl::String::MaxCStringLength));
+	MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::FONTS);
 
 	fntParser_ = nctl::makeUnique<FntParser>(fntFilename);
 	retrieveInfoFromFnt();
@@ -29,6 +43,7 @@ Font::Font(const char *fntFilename)
 	nctl::String texFilename = fs::absoluteJoinPath(dirName, fntParser_->pageTag(0).file);
 	texture_ = nctl::makeUnique<Texture>(texFilename.data());
 	checkFntInformation();
+	updateGlyphQuads();
 }
 
 /*! \note The specified texture will override the one in the FNT file */
@@ -36,14 +51,16 @@ Font::Font(const char *fntFilename, const char *texFilename)
     : Object(ObjectType::FONT, fntFilename),
       texture_(nctl::makeUnique<Texture>(texFilename)),
       lineHeight_(0), base_(0), width_(0), height_(0), numGlyphs_(0), numKernings_(0),
-      glyphs_(nctl::makeUnique<FontGlyph[]>(MaxGlyphs)), renderMode_(RenderMode::GLYPH_IN_RED)
+      directGlyphs_{}, renderMode_(RenderMode::GLYPH_IN_RED), distanceRange_(0)
 {
 	ZoneScoped;
 	ZoneText(fntFilename, strnlen(fntFilename, nctl::String::MaxCStringLength));
+	MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::FONTS);
 
 	fntParser_ = nctl::makeUnique<FntParser>(fntFilename);
 	retrieveInfoFromFnt();
 	checkFntInformation();
+	updateGlyphQuads();
 }
 
 Font::~Font()
@@ -54,10 +71,21 @@ Font::~Font()
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
 
-const FontGlyph *Font::glyph(unsigned int glyphId) const
+const FontGlyph *Font::glyph(unsigned int codePoint) const
 {
-	ASSERT(glyphId < MaxGlyphs);
-	return &glyphs_[glyphId];
+	if (codePoint < NumDirectGlyphs)
+		return directGlyphs_[codePoint];
+
+	return glyphs_ ? glyphs_->find(codePoint) : nullptr;
+}
+
+int Font::kerning(unsigned int firstCodePoint, unsigned int secondCodePoint) const
+{
+	if (kernings_ == nullptr)
+		return 0;
+
+	const int *amount = kernings_->find(kerningKey(firstCodePoint, secondCodePoint));
+	return amount ? *amount : 0;
 }
 
 ///////////////////////////////////////////////////////////
@@ -73,29 +101,42 @@ void Font::retrieveInfoFromFnt()
 	width_ = static_cast<unsigned int>(commonTag.scaleW);
 	height_ = static_cast<unsigned int>(commonTag.scaleH);
 
-	const unsigned int numChars = (fntParser_->numCharTags() < MaxGlyphs) ? fntParser_->numCharTags() : MaxGlyphs;
+	const unsigned int numChars = fntParser_->numCharTags();
+	if (numChars > 0)
+		glyphs_ = nctl::makeUnique<nctl::HashMap<unsigned int, FontGlyph>>(numChars * 2);
 	for (unsigned int i = 0; i < numChars; i++)
 	{
 		const FntParser::CharTag &charTag = fntParser_->charTag(i);
-		if (charTag.id < MaxGlyphs)
+		const unsigned int codePoint = static_cast<unsigned int>(charTag.id);
+		if (charTag.id >= 0 && codePoint <= nctl::Utf8::MaxCodePoint)
 		{
-			glyphs_[charTag.id].set(charTag.x, charTag.y, charTag.width, charTag.height, charTag.xoffset, charTag.yoffset, charTag.xadvance);
+			FontGlyph &glyph = (*glyphs_)[codePoint];
+			glyph.set(charTag.x, charTag.y, charTag.width, charTag.height, charTag.xoffset, charTag.yoffset, charTag.xadvance);
 			numGlyphs_++;
 		}
 		else
-			LOGW_X("Skipping character id #%u because bigger than glyph array size (%u)", charTag.id, MaxGlyphs);
+			LOGW_X("Skipping character id #%d because it is not a valid Unicode code point", charTag.id);
 	}
 
-	for (unsigned int i = 0; i < fntParser_->numKerningTags(); i++)
+	// Pointers are taken only after every glyph has been inserted, as the table does not grow anymore
+	for (unsigned int i = 0; i < NumDirectGlyphs && glyphs_ != nullptr; i++)
+		directGlyphs_[i] = glyphs_->find(i);
+
+	const unsigned int numKerningTags = fntParser_->numKerningTags();
+	if (numKerningTags > 0)
+		kernings_ = nctl::makeUnique<nctl::HashMap<uint64_t, int>>(numKerningTags * 2);
+	for (unsigned int i = 0; i < numKerningTags; i++)
 	{
 		const FntParser::KerningTag &kerningTag = fntParser_->kerningTag(i);
-		if (kerningTag.first < MaxGlyphs && kerningTag.second < MaxGlyphs)
+		const unsigned int first = static_cast<unsigned int>(kerningTag.first);
+		const unsigned int second = static_cast<unsigned int>(kerningTag.second);
+		if (glyph(first) != nullptr && glyph(second) != nullptr)
 		{
-			glyphs_[kerningTag.first].addKerning(kerningTag.second, kerningTag.amount);
+			(*kernings_)[kerningKey(first, second)] = kerningTag.amount;
 			numKernings_++;
 		}
 		else
-			LOGW_X("Skipping kerning couple (#%u, #%u) because bigger than glyph array size (%u)", kerningTag.first, kerningTag.second, MaxGlyphs);
+			LOGW_X("Skipping kerning couple (#%d, #%d) because the font does not have both glyphs", kerningTag.first, kerningTag.second);
 	}
 
 	LOGI_X("FNT file information retrieved: %u glyphs and %u kernings", numGlyphs_, numKernings_);
@@ -139,7 +180,39 @@ void Font::checkFntInformation()
 					renderMode_ = RenderMode::GLYPH_IN_ALPHA;
 			}
 		}
+
+		const FntParser::DistanceFieldTag &distanceFieldTag = fntParser_->distanceFieldTag();
+		if (distanceFieldTag.fieldType != FntParser::FieldType::NONE)
+		{
+			FATAL_ASSERT_MSG_X(distanceFieldTag.distanceRange > 0, "Distance field range is not valid: %d", distanceFieldTag.distanceRange);
+			distanceRange_ = static_cast<unsigned int>(distanceFieldTag.distanceRange);
+
+			if (distanceFieldTag.fieldType == FntParser::FieldType::MSDF)
+			{
+				FATAL_ASSERT_MSG_X(texture_->numChannels() >= 3, "Multi-channel distance field needs at least three texture channels, not %u", texture_->numChannels());
+				renderMode_ = RenderMode::GLYPH_MSDF;
+			}
+			else
+			{
+				// The single channel distance is always sampled from the red channel
+				FATAL_ASSERT_MSG(texture_->numChannels() == 1 || commonTag.redChnl == FntParser::ChannelData::GLYPH ||
+				                 commonTag.redChnl == FntParser::ChannelData::MISSING,
+				                 "Texture red channel does not contain the distance field");
+				renderMode_ = RenderMode::GLYPH_SDF;
+			}
+		}
 	}
 }
 
+void Font::updateGlyphQuads()
+{
+	if (texture_ == nullptr || glyphs_ == nullptr)
+		return;
+
+	// Texture coordinates are normalized by the size of the loaded texture, not by the FNT scale
+	const Vector2i texSize = texture_->size();
+	for (FontGlyph &glyph : *glyphs_)
+		glyph.updateQuad(static_cast<unsigned int>(texSize.x), static_cast<unsigned int>(texSize.y));
+}
+
 }
@@ -1,4 +1,5 @@
 #include "FontGlyph.h"
+#include "common_macros.h"
 
 namespace ncine {
 
@@ -14,8 +15,7 @@ FontGlyph::FontGlyph()
 FontGlyph::FontGlyph(unsigned int x, unsigned int y, unsigned int width, unsigned int height,
                      int xOffset, int yOffset, int xAdvance)
     : x_(x), y_(y), width_(width), height_(height),
-      xOffset_(xOffset), yOffset_(yOffset), xAdvance_(xAdvance),
-      kernings_(4)
+      xOffset_(xOffset), yOffset_(yOffset), xAdvance_(xAdvance)
 {
 }
 
@@ -23,20 +23,19 @@ FontGlyph::FontGlyph(unsigned int x, unsigned int y, unsigned int width, unsigne
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
 
-int FontGlyph::kerning(unsigned int secondGlyph) const
+void FontGlyph::updateQuad(unsigned int texWidth, unsigned int texHeight)
 {
-	int kerningAmount = 0;
-
-	for (const Kerning &kerning : kernings_)
-	{
-		if (secondGlyph == kerning.secondGlyph_)
-		{
-			kerningAmount = kerning.amount_;
-			break;
-		}
-	}
-
-	return kerningAmount;
+	ASSERT(texWidth > 0 && texHeight > 0);
+
+	quad_.left = static_cast<float>(xOffset_);
+	quad_.right = quad_.left + width_;
+	quad_.top = static_cast<float>(-yOffset_);
+	quad_.bottom = quad_.top - height_;
+
+	quad_.leftCoord = float(x_) / float(texWidth);
+	quad_.rightCoord = float(x_ + width_) / float(texWidth);
+	quad_.bottomCoord = float(y_ + height_) / float(texHeight);
+	quad_.topCoord = float(y_) / float(texHeight);
 }
 
 }
@@ -0,0 +1,102 @@
+#include "common_macros.h"
+#include "FrameBenchmark.h"
+#include "Application.h"
+#include "RenderStatistics.h"
+#include "IFile.h"
+
+namespace ncine {
+
+namespace {
+	void writeString(IFile &file, const nctl::String &string)
+	{
+		file.write(const_cast<char *>(string.data()), string.length());
+	}
+
+	/// The application timings written in every line, in the same order as the header
+	const unsigned int TimingIndices[] = {
+		Application::Timings::FRAME_START,
+		Application::Timings::UPDATE,
+		Application::Timings::VISIT,
+		Application::Timings::DRAW,
+		Application::Timings::IMGUI,
+		Application::Timings::NUKLEAR,
+		Application::Timings::FRAME_END
+	};
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+FrameBenchmark::FrameBenchmark(const char *filename, unsigned int numFrames)
+    : fileHandle_(IFile::createFileHandle(filename)), line_(512), numFrames_(numFrames),
+      numRecordedFrames_(0), frameTimeSum_(0.0), maxFrameTime_(0.0f)
+{
+	fileHandle_->setExitOnFailToOpen(false);
+	fileHandle_->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
+	if (fileHandle_->isOpened() == false)
+	{
+		LOGW_X("Cannot open the file \"%s\" to write the benchmark", filename);
+		return;
+	}
+
+	// Times are in milliseconds, the statistics are the ones of the frame just rendered
+	// GPU times are the ones read back in the frame, they refer to a frame rendered some time before
+	line_ = "frame,frame_time,frame_start,update,visit,draw,imgui,nuklear,frame_end,"
+	        "commands,vertices,transparents,instances,batch_size,culled,"
+	        "state_changes,skipped_state_changes,vao_bindings,vao_hits,vao_reuses,"
+	        "gpu_total,gpu_commit,gpu_opaques,gpu_transparents\n";
+	writeString(*fileHandle_, line_);
+	LOGI_X("Writing the statistics of %u frames to \"%s\"", numFrames_, filename);
+}
+
+FrameBenchmark::~FrameBenchmark()
+{
+	if (numRecordedFrames_ > 0)
+	{
+		LOGI_X("Benchmarked %u frames: %.3fms average, %.3fms max", numRecordedFrames_,
+		       frameTimeSum_ * 1000.0 / numRecordedFrames_, maxFrameTime_ * 1000.0f);
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool FrameBenchmark::isOpened() const
+{
+	return fileHandle_->isOpened();
+}
+
+bool FrameBenchmark::recordFrame(float frameTime, const float *timings)
+{
+	if (numRecordedFrames_ >= numFrames_)
+		return true;
+
+	frameTimeSum_ += frameTime;
+	if (frameTime > maxFrameTime_)
+		maxFrameTime_ = frameTime;
+
+	if (fileHandle_->isOpened())
+	{
+		line_.format("%u,%.4f", numRecordedFrames_, frameTime * 1000.0f);
+		for (unsigned int i = 0; i < sizeof(TimingIndices) / sizeof(*TimingIndices); i++)
+			line_.formatAppend(",%.4f", timings[TimingIndices[i]] * 1000.0f);
+
+		const RenderStatistics::Commands &commands = RenderStatistics::allCommands();
+		const RenderStatistics::StateChanges &stateChanges = RenderStatistics::allStateChanges();
+		const RenderStatistics::VaoPool &vaoPool = RenderStatistics::vaoPool();
+		const RenderStatistics::GpuTimes &gpuTimes = RenderStatistics::gpuTimes();
+		line_.formatAppend(",%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u", commands.commands, commands.vertices, commands.transparents,
+		                   commands.instances, commands.batchSize, RenderStatistics::culled(),
+		                   stateChanges.issued, stateChanges.skipped, vaoPool.bindings, vaoPool.hits, vaoPool.reuses);
+		line_.formatAppend(",%.4f,%.4f,%.4f,%.4f\n", gpuTimes.total, gpuTimes.phases[RenderStatistics::GpuPhases::COMMIT],
+		                   gpuTimes.phases[RenderStatistics::GpuPhases::OPAQUES], gpuTimes.phases[RenderStatistics::GpuPhases::TRANSPARENTS]);
+		writeString(*fileHandle_, line_);
+	}
+
+	numRecordedFrames_++;
+	return (numRecordedFrames_ >= numFrames_);
+}
+
+}
@@ -0,0 +1,189 @@
+#include "FramePacer.h"
+#include "Clock.h"
+
+#if defined(_WIN32)
+	#include "common_windefines.h"
+	#include <synchapi.h>
+	#include <handleapi.h>
+	#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+		#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+	#endif
+#else
+	#include <time.h> // for nanosleep()
+#endif
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+const float FramePacer::InitialSleepOvershoot = 0.001f;
+const float FramePacer::MinSpinTime = 0.0002f;
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+SystemPacingClock::SystemPacingClock()
+{
+#if defined(_WIN32)
+	// High resolution timers are only available since Windows 10 version 1803
+	timerHandle_ = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (timerHandle_ == nullptr)
+		timerHandle_ = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+#endif
+}
+
+SystemPacingClock::~SystemPacingClock()
+{
+#if defined(_WIN32)
+	if (timerHandle_ != nullptr)
+		CloseHandle(timerHandle_);
+#endif
+}
+
+FramePacer::FramePacer()
+    : FramePacer(systemClock_)
+{
+}
+
+FramePacer::FramePacer(IPacingClock &clock)
+    : clock_(clock), targetFps_(0), frameTicks_(0), hasDeadline_(false), deadline_(0),
+      sleepOvershoot_(static_cast<uint64_t>(InitialSleepOvershoot * clock.frequency())),
+      minSpinTicks_(static_cast<uint64_t>(MinSpinTime * clock.frequency())),
+      numMissedDeadlines_(0), lastSleepTicks_(0), lastSpinTicks_(0)
+{
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+uint64_t SystemPacingClock::now() const
+{
+	return clock().now();
+}
+
+uint32_t SystemPacingClock::frequency() const
+{
+	return clock().frequency();
+}
+
+void SystemPacingClock::sleep(uint64_t ticks)
+{
+	const uint64_t frequency = clock().frequency();
+#if defined(_WIN32)
+	if (timerHandle_ != nullptr)
+	{
+		// A negative due time is relative and expressed in 100 nanoseconds intervals
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -static_cast<LONGLONG>((ticks * 10000000ULL) / frequency);
+		if (SetWaitableTimer(timerHandle_, &dueTime, 0, nullptr, nullptr, FALSE))
+		{
+			WaitForSingleObject(timerHandle_, INFINITE);
+			return;
+		}
+	}
+	SleepEx(static_cast<DWORD>((ticks * 1000ULL) / frequency), FALSE);
+#else
+	const uint64_t nanoseconds = (ticks * 1000000000ULL) / frequency;
+	struct timespec duration;
+	duration.tv_sec = static_cast<time_t>(nanoseconds / 1000000000ULL);
+	duration.tv_nsec = static_cast<long>(nanoseconds % 1000000000ULL);
+	nanosleep(&duration, nullptr);
+#endif
+}
+
+void FramePacer::setTargetFps(unsigned int fps)
+{
+	targetFps_ = fps;
+	frameTicks_ = (fps > 0) ? clock_.frequency() / fps : 0;
+	hasDeadline_ = false;
+}
+
+void FramePacer::wait()
+{
+	lastSleepTicks_ = 0;
+	lastSpinTicks_ = 0;
+	if (frameTicks_ == 0)
+		return;
+
+	uint64_t now = clock_.now();
+	// The first frame is not paced, it only sets the first deadline
+	if (hasDeadline_ == false)
+	{
+		deadline_ = now + frameTicks_;
+		hasDeadline_ = true;
+		return;
+	}
+
+	if (now >= deadline_)
+	{
+		numMissedDeadlines_++;
+		// Catching up after a long frame would produce a burst of short ones
+		if (now - deadline_ >= frameTicks_)
+			deadline_ = now;
+		deadline_ += frameTicks_;
+		return;
+	}
+
+	const uint64_t sleepStart = now;
+	while (now < deadline_ && deadline_ - now > sleepOvershoot_ + minSpinTicks_)
+	{
+		const uint64_t requestedTicks = deadline_ - now - sleepOvershoot_ - minSpinTicks_;
+		clock_.sleep(requestedTicks);
+
+		const uint64_t sleepEnd = clock_.now();
+		const uint64_t sleptTicks = sleepEnd - now;
+		updateSleepOvershoot(sleptTicks > requestedTicks ? sleptTicks - requestedTicks : 0);
+		now = sleepEnd;
+	}
+	lastSleepTicks_ = now - sleepStart;
+
+	const uint64_t spinStart = now;
+	while (now < deadline_)
+		now = clock_.now();
+	lastSpinTicks_ = now - spinStart;
+
+	deadline_ += frameTicks_;
+}
+
+void FramePacer::reset()
+{
+	hasDeadline_ = false;
+}
+
+float FramePacer::lastSleepTime() const
+{
+	return static_cast<float>(lastSleepTicks_) / clock_.frequency();
+}
+
+float FramePacer::lastSpinTime() const
+{
+	return static_cast<float>(lastSpinTicks_) / clock_.frequency();
+}
+
+float FramePacer::sleepOvershoot() const
+{
+	return static_cast<float>(sleepOvershoot_) / clock_.frequency();
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FramePacer::updateSleepOvershoot(uint64_t overshoot)
+{
+	// A preempted thread should not make the pacer spin for whole frames
+	if (overshoot > frameTicks_ / 2)
+		overshoot = frameTicks_ / 2;
+
+	// Growing immediately to avoid missing the next deadline, shrinking slowly to absorb outliers
+	if (overshoot > sleepOvershoot_)
+		sleepOvershoot_ = overshoot;
+	else
+		sleepOvershoot_ -= (sleepOvershoot_ - overshoot) / 16;
+}
+
+}
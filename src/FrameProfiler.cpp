@@ -0,0 +1,296 @@
+#include <cstring>
+#include <nctl/String.h>
+#include <nctl/Array.h>
+#include <nctl/algorithms.h>
+#include "common_macros.h"
+#include "FrameProfiler.h"
+#include "IFile.h"
+#include "Clock.h"
+
+namespace ncine {
+
+namespace {
+	/// The thread identifier used in the trace for the frame boundaries
+	const unsigned int FramesTid = FrameProfiler::MaxThreads;
+
+	/// The slot is not used by any thread
+	const int32_t SlotFree = 0;
+	/// The slot is being allocated or released by its owner thread
+	const int32_t SlotBusy = 1;
+	const int32_t SlotRegistered = 2;
+	/// The zones of the slot are being copied by the exporting thread
+	const int32_t SlotReading = 3;
+
+	void writeString(IFile &file, const char *string, unsigned int length)
+	{
+		file.write(const_cast<char *>(string), length);
+	}
+
+	/// Appends a string between quotes, escaping the characters that are not allowed in JSON strings
+	void appendJsonString(nctl::String &dest, const char *string)
+	{
+		dest.append("\"");
+		for (const char *c = string; *c != '\0'; c++)
+		{
+			if (*c == '"' || *c == '\\')
+				dest.formatAppend("\\%c", *c);
+			else if (static_cast<unsigned char>(*c) < 0x20)
+				dest.formatAppend("\\u%04x", static_cast<unsigned int>(*c));
+			else
+				dest.formatAppend("%c", *c);
+		}
+		dest.append("\"");
+	}
+
+	/// Signed to allow zones that started before the first exported frame
+	double ticksToMicroseconds(int64_t ticks)
+	{
+		return static_cast<double>(ticks) * 1000000.0 / clock().frequency();
+	}
+}
+
+struct FrameProfiler::ThreadBufferOwner
+{
+	ThreadBufferOwner()
+	    : buffer(nullptr), hasTriedRegistering(false) {}
+
+	~ThreadBufferOwner()
+	{
+		if (buffer != nullptr)
+			releaseThreadBuffer(buffer);
+	}
+
+	ThreadBuffer *buffer;
+	bool hasTriedRegistering;
+};
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+static_assert((FrameProfiler::MaxZonesPerThread & (FrameProfiler::MaxZonesPerThread - 1)) == 0, "The number of zones per thread should be a power of two");
+
+const unsigned int FrameProfiler::MaxThreads;
+const unsigned int FrameProfiler::MaxZonesPerThread;
+const unsigned int FrameProfiler::MaxFrames;
+const unsigned int FrameProfiler::MaxThreadNameLength;
+
+bool FrameProfiler::enabled_ = true;
+FrameProfiler::ThreadBuffer FrameProfiler::threadBuffers_[MaxThreads];
+nctl::Atomic32 FrameProfiler::numRegisteredThreads_;
+nctl::Atomic32 FrameProfiler::numDroppedZones_;
+
+uint64_t FrameProfiler::frameEndTicks_[MaxFrames];
+unsigned long int FrameProfiler::numFrames_ = 0;
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+FrameProfiler::ScopedZone::ScopedZone(const char *name)
+    : name_(name), startTicks_(0), isRecording_(enabled_)
+{
+	if (isRecording_)
+		startTicks_ = clock().now();
+}
+
+FrameProfiler::ScopedZone::~ScopedZone()
+{
+	if (isRecording_)
+		recordZone(name_, startTicks_, clock().now());
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FrameProfiler::setThreadName(const char *name)
+{
+	ThreadBuffer *buffer = threadBuffer();
+	if (buffer != nullptr)
+	{
+		strncpy(buffer->name, name, MaxThreadNameLength - 1);
+		buffer->name[MaxThreadNameLength - 1] = '\0';
+	}
+}
+
+unsigned int FrameProfiler::numThreads()
+{
+	return static_cast<unsigned int>(numRegisteredThreads_.load(nctl::Atomic32::MemoryModel::RELAXED));
+}
+
+unsigned int FrameProfiler::numDroppedZones()
+{
+	return static_cast<unsigned int>(numDroppedZones_.load(nctl::Atomic32::MemoryModel::RELAXED));
+}
+
+void FrameProfiler::markFrame()
+{
+	frameEndTicks_[numFrames_ % MaxFrames] = clock().now();
+	numFrames_++;
+}
+
+bool FrameProfiler::exportChromeTrace(const char *filename)
+{
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+	fileHandle->setExitOnFailToOpen(false);
+	fileHandle->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+	{
+		LOGW_X("Cannot open the file \"%s\" to export the frame capture", filename);
+		return false;
+	}
+
+	// Zones that ended before the start of the oldest exported frame are skipped
+	const unsigned long int numExportedFrames = (numFrames_ > MaxFrames) ? MaxFrames : numFrames_;
+	const unsigned long int firstFrame = numFrames_ - numExportedFrames;
+	const uint64_t startTicks = (numExportedFrames > 0) ? frameEndTicks_[firstFrame % MaxFrames] : 0;
+
+	nctl::String event(512);
+	event = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	event.formatAppend("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Frames\"}}", FramesTid);
+	writeString(*fileHandle, event.data(), event.length());
+
+	// The first marked frame is only the start of the following one
+	for (unsigned long int i = firstFrame + 1; i < numFrames_; i++)
+	{
+		const uint64_t frameStart = frameEndTicks_[(i - 1) % MaxFrames];
+		const uint64_t frameEnd = frameEndTicks_[i % MaxFrames];
+		event.format(",\n{\"name\":\"Frame %lu\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+		             i, FramesTid, ticksToMicroseconds(static_cast<int64_t>(frameStart - startTicks)),
+		             ticksToMicroseconds(static_cast<int64_t>(frameEnd - frameStart)));
+		writeString(*fileHandle, event.data(), event.length());
+	}
+
+	nctl::Array<Zone> zones(MaxZonesPerThread);
+	char threadName[MaxThreadNameLength];
+	// The calling thread cannot be writing in its own buffer while exporting
+	const ThreadBuffer *ownBuffer = threadBufferOwner().buffer;
+	unsigned int numExportedZones = 0;
+	for (unsigned int i = 0; i < MaxThreads; i++)
+	{
+		ThreadBuffer &buffer = threadBuffers_[i];
+		// The owner thread cannot release the buffer until it is read
+		if (buffer.state.cmpExchange(SlotReading, SlotRegistered, nctl::Atomic32::MemoryModel::ACQUIRE) == false)
+			continue;
+
+		memcpy(threadName, buffer.name, MaxThreadNameLength);
+		threadName[MaxThreadNameLength - 1] = '\0';
+
+		// The owner thread keeps writing while the ring buffer is copied
+		const unsigned int numWritten = static_cast<unsigned int>(buffer.numWrittenZones.load(nctl::Atomic32::MemoryModel::ACQUIRE));
+		const unsigned int numAvailable = (numWritten > MaxZonesPerThread) ? MaxZonesPerThread : numWritten;
+		zones.clear();
+		for (unsigned int j = numWritten - numAvailable; j != numWritten; j++)
+			zones.pushBack(buffer.zones[j & (MaxZonesPerThread - 1)]);
+
+		// Discarding the oldest zones if they have been overwritten during the copy,
+		// plus the one that could have been partially written when the counter was read again
+		const unsigned int numWrittenAfterCopy = static_cast<unsigned int>(buffer.numWrittenZones.load(nctl::Atomic32::MemoryModel::ACQUIRE));
+		const unsigned int numPartiallyWritten = (&buffer != ownBuffer) ? 1 : 0;
+		const unsigned int numOverwritten = nctl::min(numWrittenAfterCopy - numWritten + numPartiallyWritten, numAvailable);
+		buffer.state.store(SlotRegistered, nctl::Atomic32::MemoryModel::RELEASE);
+
+		event = ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":";
+		event.formatAppend("%u,\"args\":{\"name\":", i);
+		if (threadName[0] != '\0')
+			appendJsonString(event, threadName);
+		else
+			event.formatAppend("\"Thread %u\"", i);
+		event.append("}}");
+		writeString(*fileHandle, event.data(), event.length());
+
+		for (unsigned int j = numOverwritten; j < zones.size(); j++)
+		{
+			const Zone &zone = zones[j];
+			if (zone.endTicks < startTicks)
+				continue;
+
+			event = ",\n{\"name\":";
+			appendJsonString(event, zone.name);
+			event.formatAppend(",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", i,
+			                   ticksToMicroseconds(static_cast<int64_t>(zone.startTicks - startTicks)),
+			                   ticksToMicroseconds(static_cast<int64_t>(zone.endTicks - zone.startTicks)));
+			writeString(*fileHandle, event.data(), event.length());
+			numExportedZones++;
+		}
+	}
+
+	event = "\n]}\n";
+	writeString(*fileHandle, event.data(), event.length());
+
+	LOGI_X("Exported %u zones of %lu frames to \"%s\"", numExportedZones, numExportedFrames, filename);
+	return true;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+FrameProfiler::ThreadBufferOwner &FrameProfiler::threadBufferOwner()
+{
+	static thread_local ThreadBufferOwner owner;
+	return owner;
+}
+
+FrameProfiler::ThreadBuffer *FrameProfiler::threadBuffer()
+{
+	ThreadBufferOwner &owner = threadBufferOwner();
+	if (owner.buffer == nullptr && owner.hasTriedRegistering == false)
+	{
+		owner.hasTriedRegistering = true;
+		owner.buffer = acquireThreadBuffer();
+	}
+
+	return owner.buffer;
+}
+
+FrameProfiler::ThreadBuffer *FrameProfiler::acquireThreadBuffer()
+{
+	for (unsigned int i = 0; i < MaxThreads; i++)
+	{
+		ThreadBuffer &slot = threadBuffers_[i];
+		// Acquiring to not reuse the slot before the previous owner has freed its zones
+		if (slot.state.cmpExchange(SlotBusy, SlotFree, nctl::Atomic32::MemoryModel::ACQUIRE))
+		{
+			slot.zones = nctl::makeUnique<Zone[]>(MaxZonesPerThread);
+			slot.numWrittenZones.store(0, nctl::Atomic32::MemoryModel::RELAXED);
+			slot.name[0] = '\0';
+			numRegisteredThreads_.fetchAdd(1, nctl::Atomic32::MemoryModel::RELAXED);
+			slot.state.store(SlotRegistered, nctl::Atomic32::MemoryModel::RELEASE);
+			return &slot;
+		}
+	}
+
+	return nullptr;
+}
+
+void FrameProfiler::releaseThreadBuffer(ThreadBuffer *buffer)
+{
+	// Waiting for the exporting thread to finish copying the zones
+	while (buffer->state.cmpExchange(SlotBusy, SlotRegistered, nctl::Atomic32::MemoryModel::ACQUIRE) == false) {}
+
+	buffer->zones.reset(nullptr);
+	numRegisteredThreads_.fetchSub(1, nctl::Atomic32::MemoryModel::RELAXED);
+	buffer->state.store(SlotFree, nctl::Atomic32::MemoryModel::RELEASE);
+}
+
+void FrameProfiler::recordZone(const char *name, uint64_t startTicks, uint64_t endTicks)
+{
+	ThreadBuffer *buffer = threadBuffer();
+	if (buffer == nullptr)
+	{
+		numDroppedZones_.fetchAdd(1, nctl::Atomic32::MemoryModel::RELAXED);
+		return;
+	}
+
+	// Only the owner thread modifies the counter, a relaxed load is enough
+	const unsigned int index = static_cast<unsigned int>(buffer->numWrittenZones.load(nctl::Atomic32::MemoryModel::RELAXED));
+	Zone &zone = buffer->zones[index & (MaxZonesPerThread - 1)];
+	zone.name = name;
+	zone.startTicks = startTicks;
+	zone.endTicks = endTicks;
+	buffer->numWrittenZones.store(static_cast<int32_t>(index + 1), nctl::Atomic32::MemoryModel::RELEASE);
+}
+
+}
@@ -0,0 +1,679 @@
+#include <cstring>
+#include "common_macros.h"
+#include "FrameReplay.h"
+#include "IFile.h"
+
+namespace ncine {
+
+namespace {
+	const char FileMagic[4] = { 'N', 'C', 'R', 'P' };
+	const uint32_t FileVersion = 1;
+
+	/// Mouse button indices in the same order of the `MouseEvent` functions
+	const uint8_t NoMouseButton = 0xFF;
+
+	uint8_t mouseButtonIndex(const MouseEvent &event)
+	{
+		if (event.isLeftButton())
+			return 0;
+		else if (event.isMiddleButton())
+			return 1;
+		else if (event.isRightButton())
+			return 2;
+		else if (event.isFourthButton())
+			return 3;
+		else if (event.isFifthButton())
+			return 4;
+		return NoMouseButton;
+	}
+
+	uint8_t mouseButtonsMask(const MouseState &state)
+	{
+		uint8_t mask = 0;
+		mask |= state.isLeftButtonDown() ? (1 << 0) : 0;
+		mask |= state.isMiddleButtonDown() ? (1 << 1) : 0;
+		mask |= state.isRightButtonDown() ? (1 << 2) : 0;
+		mask |= state.isFourthButtonDown() ? (1 << 3) : 0;
+		mask |= state.isFifthButtonDown() ? (1 << 4) : 0;
+		return mask;
+	}
+
+	class ReplayMouseEvent : public MouseEvent
+	{
+	  public:
+		uint8_t button;
+
+		inline bool isLeftButton() const override { return button == 0; }
+		inline bool isMiddleButton() const override { return button == 1; }
+		inline bool isRightButton() const override { return button == 2; }
+		inline bool isFourthButton() const override { return button == 3; }
+		inline bool isFifthButton() const override { return button == 4; }
+	};
+
+	class ReplayMouseState : public MouseState
+	{
+	  public:
+		uint8_t buttons;
+
+		inline bool isLeftButtonDown() const override { return (buttons & (1 << 0)) != 0; }
+		inline bool isMiddleButtonDown() const override { return (buttons & (1 << 1)) != 0; }
+		inline bool isRightButtonDown() const override { return (buttons & (1 << 2)) != 0; }
+		inline bool isFourthButtonDown() const override { return (buttons & (1 << 3)) != 0; }
+		inline bool isFifthButtonDown() const override { return (buttons & (1 << 4)) != 0; }
+	};
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+FrameReplay::FrameReplay(Mode mode, const char *filename, IInputEventHandler *appInputHandler)
+    : mode_(mode), isValid_(false), appInputHandler_(appInputHandler), fileHandle_(IFile::createFileHandle(filename)),
+      randomInitState_(0), randomInitSequence_(0), interval_(0.0f), numFrames_(0), buffer_(1024), readOffset_(0)
+{
+	fileHandle_->setExitOnFailToOpen(false);
+	if (mode_ == Mode::RECORD)
+	{
+		fileHandle_->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
+		isValid_ = fileHandle_->isOpened();
+		if (isValid_ == false)
+			LOGW_X("Cannot open the file \"%s\" to record the replay", filename);
+	}
+	else
+	{
+		isValid_ = loadFile();
+		if (isValid_)
+			LOGI_X("Playing back the replay file \"%s\"", filename);
+	}
+
+	// Only handling events when the replay is working
+	if (isValid_ == false)
+		IInputManager::setHandler(appInputHandler_);
+}
+
+FrameReplay::~FrameReplay()
+{
+	if (IInputManager::handler() == this)
+		IInputManager::setHandler(appInputHandler_);
+
+	if (isValid_)
+		LOGI_X("%s %u frames of replay", (mode_ == Mode::RECORD) ? "Recorded" : "Played back", numFrames_);
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FrameReplay::recordRandomSeeds(uint64_t initState, uint64_t initSequence)
+{
+	ASSERT(mode_ == Mode::RECORD);
+	ASSERT(numFrames_ == 0);
+	randomInitState_ = initState;
+	randomInitSequence_ = initSequence;
+
+	if (isValid_)
+	{
+		uint32_t version = FileVersion;
+		fileHandle_->write(const_cast<char *>(FileMagic), sizeof(FileMagic));
+		fileHandle_->write(&version, sizeof(uint32_t));
+		fileHandle_->write(&randomInitState_, sizeof(uint64_t));
+		fileHandle_->write(&randomInitSequence_, sizeof(uint64_t));
+	}
+}
+
+void FrameReplay::recordFrame(float interval)
+{
+	ASSERT(mode_ == Mode::RECORD);
+	if (isValid_ == false)
+		return;
+
+	// Every frame is the interval, the size of its events and the events themselves
+	interval_ = interval;
+	uint32_t numBytes = buffer_.size();
+	fileHandle_->write(&interval_, sizeof(float));
+	fileHandle_->write(&numBytes, sizeof(uint32_t));
+	if (numBytes > 0)
+		fileHandle_->write(buffer_.data(), numBytes);
+
+	buffer_.clear();
+	numFrames_++;
+}
+
+bool FrameReplay::playFrame()
+{
+	ASSERT(mode_ == Mode::PLAYBACK);
+	if (isValid_ == false || readOffset_ + sizeof(float) + sizeof(uint32_t) > buffer_.size())
+		return false;
+
+	interval_ = read<float>();
+	const uint32_t numBytes = read<uint32_t>();
+	if (readOffset_ + numBytes > buffer_.size())
+	{
+		LOGW_X("The replay is truncated after %u frames", numFrames_);
+		isValid_ = false;
+		return false;
+	}
+
+	const unsigned int frameEnd = readOffset_ + numBytes;
+	while (readOffset_ < frameEnd)
+		dispatchEvent(static_cast<EventType>(read<uint8_t>()));
+
+	numFrames_++;
+	return true;
+}
+
+void FrameReplay::onKeyPressed(const KeyboardEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::KEY_PRESSED);
+	write(static_cast<int32_t>(event.scancode));
+	write(static_cast<int32_t>(event.sym));
+	write(static_cast<int32_t>(event.mod));
+	if (appInputHandler_)
+		appInputHandler_->onKeyPressed(event);
+}
+
+void FrameReplay::onKeyReleased(const KeyboardEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::KEY_RELEASED);
+	write(static_cast<int32_t>(event.scancode));
+	write(static_cast<int32_t>(event.sym));
+	write(static_cast<int32_t>(event.mod));
+	if (appInputHandler_)
+		appInputHandler_->onKeyReleased(event);
+}
+
+void FrameReplay::onTouchDown(const TouchEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	writeTouchEvent(EventType::TOUCH_DOWN, event);
+	if (appInputHandler_)
+		appInputHandler_->onTouchDown(event);
+}
+
+void FrameReplay::onTouchUp(const TouchEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	writeTouchEvent(EventType::TOUCH_UP, event);
+	if (appInputHandler_)
+		appInputHandler_->onTouchUp(event);
+}
+
+void FrameReplay::onTouchMove(const TouchEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	writeTouchEvent(EventType::TOUCH_MOVE, event);
+	if (appInputHandler_)
+		appInputHandler_->onTouchMove(event);
+}
+
+void FrameReplay::onPointerDown(const TouchEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	writeTouchEvent(EventType::POINTER_DOWN, event);
+	if (appInputHandler_)
+		appInputHandler_->onPointerDown(event);
+}
+
+void FrameReplay::onPointerUp(const TouchEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	writeTouchEvent(EventType::POINTER_UP, event);
+	if (appInputHandler_)
+		appInputHandler_->onPointerUp(event);
+}
+
+#ifdef __ANDROID__
+void FrameReplay::onAcceleration(const AccelerometerEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::ACCELERATION);
+	write(event.x);
+	write(event.y);
+	write(event.z);
+	if (appInputHandler_)
+		appInputHandler_->onAcceleration(event);
+}
+#endif
+
+void FrameReplay::onMouseButtonPressed(const MouseEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::MOUSE_BUTTON_PRESSED);
+	write(static_cast<int32_t>(event.x));
+	write(static_cast<int32_t>(event.y));
+	write(mouseButtonIndex(event));
+	if (appInputHandler_)
+		appInputHandler_->onMouseButtonPressed(event);
+}
+
+void FrameReplay::onMouseButtonReleased(const MouseEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::MOUSE_BUTTON_RELEASED);
+	write(static_cast<int32_t>(event.x));
+	write(static_cast<int32_t>(event.y));
+	write(mouseButtonIndex(event));
+	if (appInputHandler_)
+		appInputHandler_->onMouseButtonReleased(event);
+}
+
+void FrameReplay::onMouseMoved(const MouseState &state)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::MOUSE_MOVED);
+	write(static_cast<int32_t>(state.x));
+	write(static_cast<int32_t>(state.y));
+	write(mouseButtonsMask(state));
+	if (appInputHandler_)
+		appInputHandler_->onMouseMoved(state);
+}
+
+void FrameReplay::onScrollInput(const ScrollEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::SCROLL_INPUT);
+	write(event.x);
+	write(event.y);
+	if (appInputHandler_)
+		appInputHandler_->onScrollInput(event);
+}
+
+void FrameReplay::onJoyButtonPressed(const JoyButtonEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::JOY_BUTTON_PRESSED);
+	write(static_cast<int32_t>(event.joyId));
+	write(static_cast<int32_t>(event.buttonId));
+	if (appInputHandler_)
+		appInputHandler_->onJoyButtonPressed(event);
+}
+
+void FrameReplay::onJoyButtonReleased(const JoyButtonEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::JOY_BUTTON_RELEASED);
+	write(static_cast<int32_t>(event.joyId));
+	write(static_cast<int32_t>(event.buttonId));
+	if (appInputHandler_)
+		appInputHandler_->onJoyButtonReleased(event);
+}
+
+void FrameReplay::onJoyHatMoved(const JoyHatEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::JOY_HAT_MOVED);
+	write(static_cast<int32_t>(event.joyId));
+	write(static_cast<int32_t>(event.hatId));
+	write(static_cast<uint8_t>(event.hatState));
+	if (appInputHandler_)
+		appInputHandler_->onJoyHatMoved(event);
+}
+
+void FrameReplay::onJoyAxisMoved(const JoyAxisEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::JOY_AXIS_MOVED);
+	write(static_cast<int32_t>(event.joyId));
+	write(static_cast<int32_t>(event.axisId));
+	write(static_cast<int16_t>(event.value));
+	write(event.normValue);
+	if (appInputHandler_)
+		appInputHandler_->onJoyAxisMoved(event);
+}
+
+void FrameReplay::onJoyMappedButtonPressed(const JoyMappedButtonEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::JOY_MAPPED_BUTTON_PRESSED);
+	write(static_cast<int32_t>(event.joyId));
+	write(static_cast<int16_t>(event.buttonName));
+	if (appInputHandler_)
+		appInputHandler_->onJoyMappedButtonPressed(event);
+}
+
+void FrameReplay::onJoyMappedButtonReleased(const JoyMappedButtonEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::JOY_MAPPED_BUTTON_RELEASED);
+	write(static_cast<int32_t>(event.joyId));
+	write(static_cast<int16_t>(event.buttonName));
+	if (appInputHandler_)
+		appInputHandler_->onJoyMappedButtonReleased(event);
+}
+
+void FrameReplay::onJoyMappedAxisMoved(const JoyMappedAxisEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::JOY_MAPPED_AXIS_MOVED);
+	write(static_cast<int32_t>(event.joyId));
+	write(static_cast<int16_t>(event.axisName));
+	write(event.value);
+	if (appInputHandler_)
+		appInputHandler_->onJoyMappedAxisMoved(event);
+}
+
+void FrameReplay::onJoyConnected(const JoyConnectionEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::JOY_CONNECTED);
+	write(static_cast<int32_t>(event.joyId));
+	if (appInputHandler_)
+		appInputHandler_->onJoyConnected(event);
+}
+
+void FrameReplay::onJoyDisconnected(const JoyConnectionEvent &event)
+{
+	if (mode_ == Mode::PLAYBACK)
+		return;
+
+	write(EventType::JOY_DISCONNECTED);
+	write(static_cast<int32_t>(event.joyId));
+	if (appInputHandler_)
+		appInputHandler_->onJoyDisconnected(event);
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool FrameReplay::loadFile()
+{
+	fileHandle_->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
+	if (fileHandle_->isOpened() == false)
+	{
+		LOGW_X("Cannot open the file \"%s\" to play back the replay", fileHandle_->filename());
+		return false;
+	}
+
+	const unsigned int fileSize = static_cast<unsigned int>(fileHandle_->size());
+	buffer_.setSize(fileSize);
+	if (fileHandle_->read(buffer_.data(), fileSize) != fileSize)
+	{
+		LOGW_X("Cannot read the replay file \"%s\"", fileHandle_->filename());
+		return false;
+	}
+	fileHandle_->close();
+
+	const unsigned int headerSize = sizeof(FileMagic) + sizeof(uint32_t) + 2 * sizeof(uint64_t);
+	if (fileSize < headerSize || memcmp(buffer_.data(), FileMagic, sizeof(FileMagic)) != 0)
+	{
+		LOGW_X("The file \"%s\" is not a replay", fileHandle_->filename());
+		return false;
+	}
+	readOffset_ = sizeof(FileMagic);
+
+	const uint32_t version = read<uint32_t>();
+	if (version != FileVersion)
+	{
+		LOGW_X("The replay file \"%s\" has version %u instead of %u", fileHandle_->filename(), version, FileVersion);
+		return false;
+	}
+	randomInitState_ = read<uint64_t>();
+	randomInitSequence_ = read<uint64_t>();
+
+	return true;
+}
+
+template <class T>
+void FrameReplay::write(const T &value)
+{
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+	buffer_.insertRange(buffer_.size(), bytes, bytes + sizeof(T));
+}
+
+template <class T>
+T FrameReplay::read()
+{
+	T value;
+	if (readOffset_ + sizeof(T) > buffer_.size())
+	{
+		// Stopping the parsing of a corrupted file
+		readOffset_ = buffer_.size();
+		memset(&value, 0, sizeof(T));
+		return value;
+	}
+
+	memcpy(&value, buffer_.data() + readOffset_, sizeof(T));
+	readOffset_ += sizeof(T);
+	return value;
+}
+
+void FrameReplay::writeTouchEvent(EventType type, const TouchEvent &event)
+{
+	const uint8_t count = static_cast<uint8_t>((event.count < TouchEvent::MaxPointers) ? event.count : TouchEvent::MaxPointers);
+	write(type);
+	write(count);
+	write(static_cast<int32_t>(event.actionIndex));
+	for (unsigned int i = 0; i < count; i++)
+	{
+		write(static_cast<int32_t>(event.pointers[i].id));
+		write(event.pointers[i].x);
+		write(event.pointers[i].y);
+		write(event.pointers[i].pressure);
+	}
+}
+
+void FrameReplay::readTouchEvent(TouchEvent &event)
+{
+	const uint8_t count = read<uint8_t>();
+	event.count = (count < TouchEvent::MaxPointers) ? count : TouchEvent::MaxPointers;
+	event.actionIndex = read<int32_t>();
+	for (unsigned int i = 0; i < event.count; i++)
+	{
+		event.pointers[i].id = read<int32_t>();
+		event.pointers[i].x = read<float>();
+		event.pointers[i].y = read<float>();
+		event.pointers[i].pressure = read<float>();
+	}
+}
+
+void FrameReplay::dispatchEvent(EventType type)
+{
+	// Events are always read to advance in the file, even without a handler to receive them
+	switch (type)
+	{
+		case EventType::KEY_PRESSED:
+		case EventType::KEY_RELEASED:
+		{
+			KeyboardEvent event;
+			event.scancode = read<int32_t>();
+			event.sym = static_cast<KeySym>(read<int32_t>());
+			event.mod = read<int32_t>();
+			if (appInputHandler_ && type == EventType::KEY_PRESSED)
+				appInputHandler_->onKeyPressed(event);
+			else if (appInputHandler_)
+				appInputHandler_->onKeyReleased(event);
+			break;
+		}
+		case EventType::TOUCH_DOWN:
+		case EventType::TOUCH_UP:
+		case EventType::TOUCH_MOVE:
+		case EventType::POINTER_DOWN:
+		case EventType::POINTER_UP:
+		{
+			TouchEvent event;
+			readTouchEvent(event);
+			if (appInputHandler_ == nullptr)
+				break;
+
+			if (type == EventType::TOUCH_DOWN)
+				appInputHandler_->onTouchDown(event);
+			else if (type == EventType::TOUCH_UP)
+				appInputHandler_->onTouchUp(event);
+			else if (type == EventType::TOUCH_MOVE)
+				appInputHandler_->onTouchMove(event);
+			else if (type == EventType::POINTER_DOWN)
+				appInputHandler_->onPointerDown(event);
+			else
+				appInputHandler_->onPointerUp(event);
+			break;
+		}
+		case EventType::ACCELERATION:
+		{
+			const float x = read<float>();
+			const float y = read<float>();
+			const float z = read<float>();
+#ifdef __ANDROID__
+			AccelerometerEvent event;
+			event.x = x;
+			event.y = y;
+			event.z = z;
+			if (appInputHandler_)
+				appInputHandler_->onAcceleration(event);
+#else
+			static_cast<void>(x);
+			static_cast<void>(y);
+			static_cast<void>(z);
+#endif
+			break;
+		}
+		case EventType::MOUSE_BUTTON_PRESSED:
+		case EventType::MOUSE_BUTTON_RELEASED:
+		{
+			ReplayMouseEvent event;
+			event.x = read<int32_t>();
+			event.y = read<int32_t>();
+			event.button = read<uint8_t>();
+			if (appInputHandler_ && type == EventType::MOUSE_BUTTON_PRESSED)
+				appInputHandler_->onMouseButtonPressed(event);
+			else if (appInputHandler_)
+				appInputHandler_->onMouseButtonReleased(event);
+			break;
+		}
+		case EventType::MOUSE_MOVED:
+		{
+			ReplayMouseState state;
+			state.x = read<int32_t>();
+			state.y = read<int32_t>();
+			state.buttons = read<uint8_t>();
+			if (appInputHandler_)
+				appInputHandler_->onMouseMoved(state);
+			break;
+		}
+		case EventType::SCROLL_INPUT:
+		{
+			ScrollEvent event;
+			event.x = read<float>();
+			event.y = read<float>();
+			if (appInputHandler_)
+				appInputHandler_->onScrollInput(event);
+			break;
+		}
+		case EventType::JOY_BUTTON_PRESSED:
+		case EventType::JOY_BUTTON_RELEASED:
+		{
+			JoyButtonEvent event;
+			event.joyId = read<int32_t>();
+			event.buttonId = read<int32_t>();
+			if (appInputHandler_ && type == EventType::JOY_BUTTON_PRESSED)
+				appInputHandler_->onJoyButtonPressed(event);
+			else if (appInputHandler_)
+				appInputHandler_->onJoyButtonReleased(event);
+			break;
+		}
+		case EventType::JOY_HAT_MOVED:
+		{
+			JoyHatEvent event;
+			event.joyId = read<int32_t>();
+			event.hatId = read<int32_t>();
+			event.hatState = read<uint8_t>();
+			if (appInputHandler_)
+				appInputHandler_->onJoyHatMoved(event);
+			break;
+		}
+		case EventType::JOY_AXIS_MOVED:
+		{
+			JoyAxisEvent event;
+			event.joyId = read<int32_t>();
+			event.axisId = read<int32_t>();
+			event.value = read<int16_t>();
+			event.normValue = read<float>();
+			if (appInputHandler_)
+				appInputHandler_->onJoyAxisMoved(event);
+			break;
+		}
+		case EventType::JOY_MAPPED_BUTTON_PRESSED:
+		case EventType::JOY_MAPPED_BUTTON_RELEASED:
+		{
+			JoyMappedButtonEvent event;
+			event.joyId = read<int32_t>();
+			event.buttonName = static_cast<ButtonName>(read<int16_t>());
+			if (appInputHandler_ && type == EventType::JOY_MAPPED_BUTTON_PRESSED)
+				appInputHandler_->onJoyMappedButtonPressed(event);
+			else if (appInputHandler_)
+				appInputHandler_->onJoyMappedButtonReleased(event);
+			break;
+		}
+		case EventType::JOY_MAPPED_AXIS_MOVED:
+		{
+			JoyMappedAxisEvent event;
+			event.joyId = read<int32_t>();
+			event.axisName = static_cast<AxisName>(read<int16_t>());
+			event.value = read<float>();
+			if (appInputHandler_)
+				appInputHandler_->onJoyMappedAxisMoved(event);
+			break;
+		}
+		case EventType::JOY_CONNECTED:
+		case EventType::JOY_DISCONNECTED:
+		{
+			JoyConnectionEvent event;
+			event.joyId = read<int32_t>();
+			if (appInputHandler_ && type == EventType::JOY_CONNECTED)
+				appInputHandler_->onJoyConnected(event);
+			else if (appInputHandler_)
+				appInputHandler_->onJoyDisconnected(event);
+			break;
+		}
+		default:
+			LOGW_X("Unknown replay event type %u after %u frames", static_cast<unsigned int>(type), numFrames_);
+			// The size of an unknown event is not known, the rest of the file cannot be parsed
+			readOffset_ = buffer_.size();
+			isValid_ = false;
+			break;
+	}
+}
+
+}
@@ -1,3 +1,4 @@
+#include <cmath> // for sqrt()
 #include "common_macros.h"
 #include "FrameTimer.h"
 
@@ -11,7 +12,9 @@ namespace ncine {
  *  seconds and writes to the log every `logInterval` seconds. */
 FrameTimer::FrameTimer(float logInterval, float avgInterval)
     : logInterval_(logInterval), avgInterval_(avgInterval),
-      totNumFrames_(0L), avgNumFrames_(0L), logNumFrames_(0L), fps_(0.0f)
+      frameInterval_(0.0f), totNumFrames_(0L), avgNumFrames_(0L), logNumFrames_(0L), fps_(0.0f),
+      intervalSum_(0.0), intervalSquaresSum_(0.0), intervalMax_(0.0f),
+      frameIntervalDeviation_(0.0f), maxFrameInterval_(0.0f)
 {
 }
 
@@ -30,12 +33,25 @@ void FrameTimer::addFrame()
 	avgNumFrames_++;
 	logNumFrames_++;
 
+	intervalSum_ += frameInterval_;
+	intervalSquaresSum_ += static_cast<double>(frameInterval_) * frameInterval_;
+	if (frameInterval_ > intervalMax_)
+		intervalMax_ = frameInterval_;
+
 	// Update the FPS average calculation every `avgInterval_` seconds
 	const float secsSinceLastAvgUpdate = (frameStart_ - lastAvgUpdate_).seconds();
 	if (avgInterval_ > 0.0f && secsSinceLastAvgUpdate > avgInterval_)
 	{
 		fps_ = static_cast<float>(avgNumFrames_) / secsSinceLastAvgUpdate;
 
+		const double mean = intervalSum_ / avgNumFrames_;
+		const double variance = intervalSquaresSum_ / avgNumFrames_ - mean * mean;
+		frameIntervalDeviation_ = (variance > 0.0) ? static_cast<float>(sqrt(variance)) : 0.0f;
+		maxFrameInterval_ = intervalMax_;
+
+		intervalSum_ = 0.0;
+		intervalSquaresSum_ = 0.0;
+		intervalMax_ = 0.0f;
 		avgNumFrames_ = 0L;
 		lastAvgUpdate_ = TimeStamp::now();
 	}
@@ -1,6 +1,7 @@
 #include "common_macros.h"
 #include "IFile.h"
 #include "StandardFile.h"
+#include "MemoryFile.h"
 
 #ifdef __ANDROID__
 	#include <cstring>
@@ -47,4 +48,11 @@ nctl::UniquePtr<IFile> IFile::createFileHandle(const char *filename)
 		return nctl::makeUnique<StandardFile>(filename);
 }
 
+nctl::UniquePtr<IFile> IFile::createFromMemory(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize)
+{
+	ASSERT(bufferName);
+	ASSERT(bufferPtr);
+	return nctl::makeUnique<MemoryFile>(bufferName, bufferPtr, bufferSize);
+}
+
 }
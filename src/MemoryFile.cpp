@@ -0,0 +1,108 @@
+#include <cstring> // for memcpy()
+#include "common_macros.h"
+#include "MemoryFile.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+MemoryFile::MemoryFile(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize)
+    : IFile(bufferName), bufferPtr_(bufferPtr), seekOffset_(0), isFileOpened_(false)
+{
+	ASSERT(bufferPtr || bufferSize == 0);
+	type_ = FileType::MEMORY;
+	fileSize_ = static_cast<long int>(bufferSize);
+}
+
+MemoryFile::~MemoryFile()
+{
+	if (shouldCloseOnDestruction_)
+		close();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void MemoryFile::open(unsigned char mode)
+{
+	if (isFileOpened_)
+		LOGW_X("Memory file \"%s\" is already opened", filename_.data());
+	else if (mode & OpenMode::WRITE)
+		LOGE_X("Memory file \"%s\" can only be opened for reading", filename_.data());
+	else
+	{
+		isFileOpened_ = true;
+		seekOffset_ = 0;
+	}
+}
+
+void MemoryFile::close()
+{
+	isFileOpened_ = false;
+	seekOffset_ = 0;
+}
+
+/*! \return Zero on success like `fseek()`, or -1 if the new position would be outside the buffer */
+long int MemoryFile::seek(long int offset, int whence) const
+{
+	if (isFileOpened_ == false)
+		return -1;
+
+	long int newOffset = -1;
+	switch (whence)
+	{
+		case SEEK_SET:
+			newOffset = offset;
+			break;
+		case SEEK_CUR:
+			newOffset = static_cast<long int>(seekOffset_) + offset;
+			break;
+		case SEEK_END:
+			newOffset = fileSize_ + offset;
+			break;
+	}
+
+	if (newOffset < 0 || newOffset > fileSize_)
+		return -1;
+
+	seekOffset_ = static_cast<unsigned long int>(newOffset);
+	return 0;
+}
+
+long int MemoryFile::tell() const
+{
+	return isFileOpened_ ? static_cast<long int>(seekOffset_) : -1;
+}
+
+unsigned long int MemoryFile::read(void *buffer, unsigned long int bytes) const
+{
+	ASSERT(buffer);
+
+	if (isFileOpened_ == false)
+		return 0;
+
+	const unsigned long int bytesLeft = static_cast<unsigned long int>(fileSize_) - seekOffset_;
+	const unsigned long int bytesRead = (bytes < bytesLeft) ? bytes : bytesLeft;
+	if (bytesRead > 0)
+	{
+		memcpy(buffer, bufferPtr_ + seekOffset_, bytesRead);
+		seekOffset_ += bytesRead;
+	}
+
+	return bytesRead;
+}
+
+unsigned long int MemoryFile::write(void *buffer, unsigned long int bytes)
+{
+	return 0;
+}
+
+bool MemoryFile::isOpened() const
+{
+	return isFileOpened_;
+}
+
+}
@@ -0,0 +1,146 @@
+#include "MemoryStatistics.h"
+
+namespace ncine {
+
+namespace {
+	/// The tag of the calling thread, it is constant initialized and does not allocate
+	thread_local MemoryStatistics::Tags::Enum currentThreadTag = MemoryStatistics::Tags::UNTAGGED;
+
+	const char *TagNames[MemoryStatistics::Tags::COUNT] = {
+		"untagged",
+		"scenegraph",
+		"render_commands",
+		"textures",
+		"audio",
+		"lua",
+		"containers",
+		"fonts"
+	};
+}
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+bool MemoryStatistics::enabled_ = false;
+MemoryStatistics::Counters MemoryStatistics::counters_[Tags::COUNT];
+int64_t MemoryStatistics::lastAllocations_[Tags::COUNT];
+int64_t MemoryStatistics::lastDeallocations_[Tags::COUNT];
+unsigned int MemoryStatistics::frameAllocations_[Tags::COUNT];
+unsigned int MemoryStatistics::frameDeallocations_[Tags::COUNT];
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+MemoryStatistics::ScopedTag::ScopedTag(Tags::Enum tag)
+    : previousTag_(currentThreadTag)
+{
+	currentThreadTag = tag;
+}
+
+MemoryStatistics::ScopedTag::~ScopedTag()
+{
+	currentThreadTag = previousTag_;
+}
+
+MemoryStatistics::ScopedContainerTag::ScopedContainerTag()
+    : previousTag_(currentThreadTag)
+{
+	if (currentThreadTag == Tags::UNTAGGED)
+		currentThreadTag = Tags::CONTAINERS;
+}
+
+MemoryStatistics::ScopedContainerTag::~ScopedContainerTag()
+{
+	currentThreadTag = previousTag_;
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool MemoryStatistics::isTrackingOperatorNew()
+{
+#ifdef WITH_MEMORY_TAGS
+	return true;
+#else
+	return false;
+#endif
+}
+
+MemoryStatistics::Tags::Enum MemoryStatistics::currentTag()
+{
+	return currentThreadTag;
+}
+
+const char *MemoryStatistics::tagName(Tags::Enum tag)
+{
+	return (tag >= 0 && tag < Tags::COUNT) ? TagNames[tag] : "unknown";
+}
+
+void MemoryStatistics::addAllocation(Tags::Enum tag, size_t bytes)
+{
+	Counters &counters = counters_[tag];
+	counters.allocations.fetchAdd(1, nctl::Atomic64::MemoryModel::RELAXED);
+	const int64_t currentBytes = counters.currentBytes.fetchAdd(static_cast<int64_t>(bytes), nctl::Atomic64::MemoryModel::RELAXED) + static_cast<int64_t>(bytes);
+
+	// Another thread could have raised the peak in the meantime
+	int64_t peakBytes = counters.peakBytes.load(nctl::Atomic64::MemoryModel::RELAXED);
+	while (currentBytes > peakBytes)
+	{
+		if (counters.peakBytes.cmpExchange(currentBytes, peakBytes, nctl::Atomic64::MemoryModel::RELAXED))
+			break;
+		peakBytes = counters.peakBytes.load(nctl::Atomic64::MemoryModel::RELAXED);
+	}
+}
+
+void MemoryStatistics::addDeallocation(Tags::Enum tag, size_t bytes)
+{
+	Counters &counters = counters_[tag];
+	counters.deallocations.fetchAdd(1, nctl::Atomic64::MemoryModel::RELAXED);
+	counters.currentBytes.fetchSub(static_cast<int64_t>(bytes), nctl::Atomic64::MemoryModel::RELAXED);
+}
+
+MemoryStatistics::TagStatistics MemoryStatistics::statistics(Tags::Enum tag)
+{
+	TagStatistics stats;
+	Counters &counters = counters_[tag];
+	stats.currentBytes = counters.currentBytes.load(nctl::Atomic64::MemoryModel::RELAXED);
+	stats.peakBytes = counters.peakBytes.load(nctl::Atomic64::MemoryModel::RELAXED);
+	stats.allocations = counters.allocations.load(nctl::Atomic64::MemoryModel::RELAXED);
+	stats.frameAllocations = frameAllocations_[tag];
+	stats.frameDeallocations = frameDeallocations_[tag];
+	return stats;
+}
+
+MemoryStatistics::TagStatistics MemoryStatistics::allStatistics()
+{
+	TagStatistics allStats;
+	for (unsigned int i = 0; i < Tags::COUNT; i++)
+	{
+		const TagStatistics stats = statistics(static_cast<Tags::Enum>(i));
+		allStats.currentBytes += stats.currentBytes;
+		// The sum of the peaks is an upper bound, as they could have been reached at different times
+		allStats.peakBytes += stats.peakBytes;
+		allStats.allocations += stats.allocations;
+		allStats.frameAllocations += stats.frameAllocations;
+		allStats.frameDeallocations += stats.frameDeallocations;
+	}
+	return allStats;
+}
+
+void MemoryStatistics::markFrame()
+{
+	for (unsigned int i = 0; i < Tags::COUNT; i++)
+	{
+		const int64_t allocations = counters_[i].allocations.load(nctl::Atomic64::MemoryModel::RELAXED);
+		const int64_t deallocations = counters_[i].deallocations.load(nctl::Atomic64::MemoryModel::RELAXED);
+		frameAllocations_[i] = static_cast<unsigned int>(allocations - lastAllocations_[i]);
+		frameDeallocations_[i] = static_cast<unsigned int>(deallocations - lastDeallocations_[i]);
+		lastAllocations_[i] = allocations;
+		lastDeallocations_[i] = deallocations;
+	}
+}
+
+}
@@ -1,3 +1,4 @@
+#include <cstdlib> // for `getenv()`
 #include "PCApplication.h"
 #include "IAppEventHandler.h"
 #include "FileLogger.h"
@@ -25,6 +26,43 @@
 
 namespace ncine {
 
+namespace {
+	/// Lets automated runs turn any application into a headless benchmark without recompiling it
+	void applyEnvironmentOverrides(AppConfiguration &appCfg)
+	{
+		const char *headless = getenv("NCINE_HEADLESS");
+		if (headless != nullptr)
+			appCfg.isHeadless = (atoi(headless) != 0);
+
+		const char *fixedTimestep = getenv("NCINE_FIXED_TIMESTEP");
+		if (fixedTimestep != nullptr)
+			appCfg.fixedTimestep = static_cast<float>(atof(fixedTimestep));
+
+		const char *benchmarkFrames = getenv("NCINE_BENCHMARK_FRAMES");
+		if (benchmarkFrames != nullptr)
+			appCfg.benchmarkFrames = static_cast<unsigned int>(strtoul(benchmarkFrames, nullptr, 10));
+
+		const char *benchmarkFile = getenv("NCINE_BENCHMARK_FILE");
+		if (benchmarkFile != nullptr)
+			appCfg.benchmarkFile = benchmarkFile;
+
+		const char *replayRecordFile = getenv("NCINE_REPLAY_RECORD");
+		if (replayRecordFile != nullptr)
+			appCfg.replayRecordFile = replayRecordFile;
+
+		const char *replayPlaybackFile = getenv("NCINE_REPLAY_PLAYBACK");
+		if (replayPlaybackFile != nullptr)
+			appCfg.replayPlaybackFile = replayPlaybackFile;
+
+		if (appCfg.benchmarkFrames > 0)
+		{
+			// Frames should not be throttled when measuring them
+			appCfg.withVSync = false;
+			appCfg.frameLimit = 0;
+		}
+	}
+}
+
 Application &theApplication()
 {
 	static PCApplication instance;
@@ -70,18 +108,23 @@ void PCApplication::init(IAppEventHandler *(*createAppEventHandler)())
 	AppConfiguration &modifiableAppCfg = const_cast<AppConfiguration &>(appCfg_);
 	appEventHandler_->onPreInit(modifiableAppCfg);
 	LOGI("IAppEventHandler::onPreInit() invoked");
+	applyEnvironmentOverrides(modifiableAppCfg);
 
 	// Setting log levels and filename based on application configuration
 	FileLogger &fileLogger = static_cast<FileLogger &>(theServiceLocator().logger());
 	fileLogger.setConsoleLevel(appCfg_.consoleLogLevel);
 	fileLogger.setFileLevel(appCfg_.fileLogLevel);
 	fileLogger.openLogFile(appCfg_.logFile.data());
+	fileLogger.setAsynchronous(appCfg_.withAsyncLogging);
 	// Graphics device should always be created before the input manager!
 	IGfxDevice::GLContextInfo glContextInfo(appCfg_);
 	const DisplayMode::VSync vSyncMode = appCfg_.withVSync ? DisplayMode::VSync::ENABLED : DisplayMode::VSync::DISABLED;
 	DisplayMode displayMode(8, 8, 8, 8, 24, 8, DisplayMode::DoubleBuffering::ENABLED, vSyncMode);
 
-	const IGfxDevice::WindowMode windowMode(appCfg_.resolution.x, appCfg_.resolution.y, appCfg_.inFullscreen, appCfg_.isResizable);
+	const IGfxDevice::WindowMode windowMode(appCfg_.resolution.x, appCfg_.resolution.y, appCfg_.inFullscreen, appCfg_.isResizable, appCfg_.isHeadless);
+	// A hidden window never gains the focus
+	if (appCfg_.isHeadless)
+		autoSuspension_ = false;
 #if defined(WITH_SDL)
 	gfxDevice_ = nctl::makeUnique<SdlGfxDevice>(windowMode, glContextInfo, displayMode);
 	inputManager_ = nctl::makeUnique<SdlInputManager>();
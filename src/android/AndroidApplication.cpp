@@ -243,6 +243,7 @@ void AndroidApplication::preInit()
 	fileLogger.setConsoleLevel(appCfg_.consoleLogLevel);
 	fileLogger.setFileLevel(appCfg_.fileLogLevel);
 	fileLogger.openLogFile(logFilePath.data());
+	fileLogger.setAsynchronous(appCfg_.withAsyncLogging);
 }
 
 void AndroidApplication::init()
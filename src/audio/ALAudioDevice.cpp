@@ -2,6 +2,9 @@
 #include "ALAudioDevice.h"
 #include "AudioBufferPlayer.h"
 #include "AudioStreamPlayer.h"
+#include "Application.h"
+#include "AudioMixer.h"
+#include "ALAudioSink.h"
 #include <nctl/algorithms.h>
 
 namespace ncine {
@@ -13,6 +16,10 @@ namespace ncine {
 ALAudioDevice::ALAudioDevice()
     : device_(nullptr), context_(nullptr), gain_(1.0f),
       sources_(nctl::StaticArrayMode::EXTEND_SIZE), deviceName_(nullptr)
+#ifdef WITH_THREADS
+      ,
+      currentDecodingStream_(nullptr), decodeThreadRunning_(false), hasDecodeThread_(false)
+#endif
 {
 	device_ = alcOpenDevice(nullptr);
 	FATAL_ASSERT_MSG_X(device_ != nullptr, "alcOpenDevice failed: %x", alGetError());
@@ -39,10 +46,43 @@ ALAudioDevice::ALAudioDevice()
 
 	alListener3f(AL_POSITION, 0.0f, 0.0f, 0.0f);
 	alListenerf(AL_GAIN, gain_);
+
+	const AppConfiguration &appCfg = theApplication().appConfiguration();
+	if (appCfg.audioMixerVoices > 0)
+	{
+		mixer_ = nctl::makeUnique<AudioMixer>(MixerFrequency, appCfg.audioMixerVoices);
+		mixerSink_ = nctl::makeUnique<ALAudioSink>(MixerFrequency, MixerNumBuffers, MixerFramesPerBuffer);
+	}
+
+#ifdef WITH_THREADS
+	if (appCfg.withAudioStreamThread)
+	{
+		decodeThreadRunning_ = true;
+		decodeThread_.run(decodeThreadFunction, this);
+	#if !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+		decodeThread_.setName("AudioDecodeThread");
+	#endif
+		hasDecodeThread_ = true;
+	}
+#endif
 }
 
 ALAudioDevice::~ALAudioDevice()
 {
+#ifdef WITH_THREADS
+	if (hasDecodeThread_)
+	{
+		decodeMutex_.lock();
+		decodeThreadRunning_ = false;
+		decodeMutex_.unlock();
+		decodeCondVar_.broadcast();
+		decodeThread_.join();
+	}
+#endif
+
+	mixerSink_.reset(nullptr);
+	mixer_.reset(nullptr);
+
 	for (ALuint sourceId : sources_)
 		alSourcei(sourceId, AL_BUFFER, AL_NONE);
 	alDeleteSources(MaxSources, sources_.data());
@@ -74,13 +114,13 @@ const IAudioPlayer *ALAudioDevice::player(unsigned int index) const
 void ALAudioDevice::stopPlayers()
 {
 	forEach(players_.begin(), players_.end(), [](IAudioPlayer *player) { player->stop(); });
-	players_.clear();
+	removeAllPlayers();
 }
 
 void ALAudioDevice::pausePlayers()
 {
 	forEach(players_.begin(), players_.end(), [](IAudioPlayer *player) { player->pause(); });
-	players_.clear();
+	removeAllPlayers();
 }
 
 void ALAudioDevice::stopPlayers(PlayerType playerType)
@@ -94,7 +134,7 @@ void ALAudioDevice::stopPlayers(PlayerType playerType)
 		if (players_[i]->type() == objectType)
 		{
 			players_[i]->stop();
-			players_.unorderedRemoveAt(i);
+			removePlayerAt(i);
 		}
 	}
 }
@@ -110,7 +150,7 @@ void ALAudioDevice::pausePlayers(PlayerType playerType)
 		if (players_[i]->type() == objectType)
 		{
 			players_[i]->pause();
-			players_.unorderedRemoveAt(i);
+			removePlayerAt(i);
 		}
 	}
 }
@@ -118,12 +158,16 @@ void ALAudioDevice::pausePlayers(PlayerType playerType)
 void ALAudioDevice::freezePlayers()
 {
 	forEach(players_.begin(), players_.end(), [](IAudioPlayer *player) { player->pause(); });
+	if (mixerSink_)
+		mixerSink_->pause();
 	// The players array is not cleared at this point, it is needed as-is by the unfreeze method
 }
 
 void ALAudioDevice::unfreezePlayers()
 {
 	forEach(players_.begin(), players_.end(), [](IAudioPlayer *player) { player->play(); });
+	if (mixerSink_)
+		mixerSink_->resume();
 }
 
 unsigned int ALAudioDevice::nextAvailableSource()
@@ -144,17 +188,156 @@ void ALAudioDevice::registerPlayer(IAudioPlayer *player)
 {
 	ASSERT(player);
 	players_.pushBack(player);
+
+#ifdef WITH_THREADS
+	if (hasDecodeThread_ && player->type() == AudioStreamPlayer::sType())
+	{
+		AudioStream *stream = &static_cast<AudioStreamPlayer *>(player)->audioStream_;
+
+		decodeMutex_.lock();
+		if (isDecodingStream(stream) == false)
+			decodingStreams_.pushBack(stream);
+		decodeMutex_.unlock();
+		decodeCondVar_.signal();
+	}
+#endif
+}
+
+void ALAudioDevice::unregisterPlayer(IAudioPlayer *player)
+{
+	ASSERT(player);
+	for (int i = players_.size() - 1; i >= 0; i--)
+	{
+		if (players_[i] == player)
+			removePlayerAt(i);
+	}
 }
 
 void ALAudioDevice::updatePlayers()
 {
+	const bool decodeOnMainThread = (hasDecodeThread() == false);
 	for (int i = players_.size() - 1; i >= 0; i--)
 	{
 		if (players_[i]->isPlaying())
+		{
+			if (decodeOnMainThread && players_[i]->type() == AudioStreamPlayer::sType())
+				static_cast<AudioStreamPlayer *>(players_[i])->audioStream_.decode();
 			players_[i]->updateState();
+		}
 		else
-			players_.unorderedRemoveAt(i);
+			removePlayerAt(i);
+	}
+
+	// Mixing only what is needed to fill the free buffers of the sink
+	if (mixer_)
+		mixer_->render(*mixerSink_, mixerSink_->numWritableFrames());
+
+#ifdef WITH_THREADS
+	// Signalling without holding the mutex to never wait for a decode, a missed wake-up is recovered at the next frame
+	if (hasDecodeThread_)
+		decodeCondVar_.signal();
+#endif
+}
+
+bool ALAudioDevice::hasDecodeThread() const
+{
+#ifdef WITH_THREADS
+	return hasDecodeThread_;
+#else
+	return false;
+#endif
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+#ifdef WITH_THREADS
+void ALAudioDevice::decodeThreadFunction(void *arg)
+{
+	ALAudioDevice *device = static_cast<ALAudioDevice *>(arg);
+
+	device->decodeMutex_.lock();
+	while (device->decodeThreadRunning_)
+	{
+		// Decoding happens without holding the mutex, on a copy of the array, so that players can be registered and removed meanwhile
+		nctl::StaticArray<AudioStream *, MaxSources> streams(device->decodingStreams_);
+
+		bool hasDecoded = false;
+		for (AudioStream *stream : streams)
+		{
+			// The stream could have been removed, and destroyed, while the mutex was released
+			if (device->isDecodingStream(stream) == false)
+				continue;
+
+			device->currentDecodingStream_ = stream;
+			device->decodeMutex_.unlock();
+			hasDecoded = stream->decode() || hasDecoded;
+			device->decodeMutex_.lock();
+			device->currentDecodingStream_ = nullptr;
+			device->streamDecodedCondVar_.broadcast();
+		}
+
+		// Waiting for the main thread to consume some buffers or to register new streams
+		if (hasDecoded == false && device->decodeThreadRunning_)
+			device->decodeCondVar_.wait(device->decodeMutex_);
+	}
+	device->decodeMutex_.unlock();
+}
+
+bool ALAudioDevice::isDecodingStream(const AudioStream *stream) const
+{
+	for (unsigned int i = 0; i < decodingStreams_.size(); i++)
+	{
+		if (decodingStreams_[i] == stream)
+			return true;
+	}
+	return false;
+}
+
+void ALAudioDevice::waitForStreamDecoded(const AudioStream *stream)
+{
+	while (currentDecodingStream_ != nullptr && (stream == nullptr || currentDecodingStream_ == stream))
+		streamDecodedCondVar_.wait(decodeMutex_);
+}
+#endif
+
+void ALAudioDevice::removePlayerAt(unsigned int index)
+{
+#ifdef WITH_THREADS
+	if (hasDecodeThread_ && players_[index]->type() == AudioStreamPlayer::sType())
+	{
+		const AudioStream *stream = &static_cast<AudioStreamPlayer *>(players_[index])->audioStream_;
+
+		// After the removal the decode thread will not access the stream anymore
+		decodeMutex_.lock();
+		for (int i = decodingStreams_.size() - 1; i >= 0; i--)
+		{
+			if (decodingStreams_[i] == stream)
+				decodingStreams_.unorderedRemoveAt(i);
+		}
+		// Only waiting if the thread is decoding this very stream
+		waitForStreamDecoded(stream);
+		decodeMutex_.unlock();
 	}
+#endif
+
+	players_.unorderedRemoveAt(index);
+}
+
+void ALAudioDevice::removeAllPlayers()
+{
+#ifdef WITH_THREADS
+	if (hasDecodeThread_)
+	{
+		decodeMutex_.lock();
+		decodingStreams_.clear();
+		waitForStreamDecoded(nullptr);
+		decodeMutex_.unlock();
+	}
+#endif
+
+	players_.clear();
 }
 
 }
@@ -0,0 +1,127 @@
+#define NCINE_INCLUDE_OPENAL
+#include "common_headers.h"
+#include "common_macros.h"
+#include "ALAudioSink.h"
+#include <cstring>
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+ALAudioSink::ALAudioSink(int frequency, unsigned int numBuffers, unsigned int framesPerBuffer)
+    : frequency_(frequency), numBuffers_(numBuffers), framesPerBuffer_(framesPerBuffer),
+      sourceId_(0), nextAvailableBufferIndex_(0), numPendingFrames_(0),
+      isSourceStarted_(false), isPaused_(false), numUnderruns_(0)
+{
+	FATAL_ASSERT(numBuffers_ >= 2);
+	FATAL_ASSERT(framesPerBuffer_ > 0);
+
+	buffersIds_ = nctl::makeUnique<unsigned int[]>(numBuffers_);
+	pendingFrames_ = nctl::makeUnique<int16_t[]>(framesPerBuffer_ * 2);
+
+	alGetError();
+	alGenSources(1, &sourceId_);
+	alGenBuffers(numBuffers_, buffersIds_.get());
+	const ALenum error = alGetError();
+	ASSERT_MSG_X(error == AL_NO_ERROR, "alGenSources or alGenBuffers failed: %x", error);
+
+	alSourcei(sourceId_, AL_LOOPING, AL_FALSE);
+}
+
+ALAudioSink::~ALAudioSink()
+{
+	alSourceStop(sourceId_);
+	alSourcei(sourceId_, AL_BUFFER, AL_NONE);
+	alDeleteSources(1, &sourceId_);
+	alDeleteBuffers(numBuffers_, buffersIds_.get());
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+unsigned int ALAudioSink::numWritableFrames()
+{
+	if (isPaused_)
+		return 0;
+
+	ALint numProcessedBuffers;
+	alGetSourcei(sourceId_, AL_BUFFERS_PROCESSED, &numProcessedBuffers);
+
+	// Unqueueing
+	while (numProcessedBuffers > 0)
+	{
+		ALuint unqueuedAlBuffer;
+		alSourceUnqueueBuffers(sourceId_, 1, &unqueuedAlBuffer);
+		nextAvailableBufferIndex_--;
+		buffersIds_[nextAvailableBufferIndex_] = unqueuedAlBuffer;
+		numProcessedBuffers--;
+	}
+
+	return (numBuffers_ - nextAvailableBufferIndex_) * framesPerBuffer_ - numPendingFrames_;
+}
+
+void ALAudioSink::write(const int16_t *frames, unsigned int numFrames)
+{
+	while (numFrames > 0 && nextAvailableBufferIndex_ < numBuffers_)
+	{
+		const unsigned int freeFrames = framesPerBuffer_ - numPendingFrames_;
+		const unsigned int copiedFrames = (numFrames < freeFrames) ? numFrames : freeFrames;
+		memcpy(pendingFrames_.get() + numPendingFrames_ * 2, frames, copiedFrames * 2 * sizeof(int16_t));
+
+		numPendingFrames_ += copiedFrames;
+		frames += copiedFrames * 2;
+		numFrames -= copiedFrames;
+
+		if (numPendingFrames_ == framesPerBuffer_)
+			queuePendingFrames();
+	}
+
+	ALenum state;
+	alGetSourcei(sourceId_, AL_SOURCE_STATE, &state);
+
+	if (state != AL_PLAYING && isPaused_ == false)
+	{
+		ALint numQueuedBuffers = 0;
+		alGetSourcei(sourceId_, AL_BUFFERS_QUEUED, &numQueuedBuffers);
+		// Waiting for at least two buffers before starting, to have some headroom
+		if (numQueuedBuffers >= 2 || (isSourceStarted_ && numQueuedBuffers > 0))
+		{
+			if (isSourceStarted_)
+				numUnderruns_++;
+			alSourcePlay(sourceId_);
+			isSourceStarted_ = true;
+		}
+	}
+}
+
+void ALAudioSink::pause()
+{
+	isPaused_ = true;
+	alSourcePause(sourceId_);
+}
+
+void ALAudioSink::resume()
+{
+	isPaused_ = false;
+	alSourcePlay(sourceId_);
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void ALAudioSink::queuePendingFrames()
+{
+	ASSERT(nextAvailableBufferIndex_ < numBuffers_);
+
+	const unsigned int bufferId = buffersIds_[nextAvailableBufferIndex_];
+	alBufferData(bufferId, AL_FORMAT_STEREO16, pendingFrames_.get(), numPendingFrames_ * 2 * sizeof(int16_t), frequency_);
+	alSourceQueueBuffers(sourceId_, 1, &bufferId);
+	nextAvailableBufferIndex_++;
+	numPendingFrames_ = 0;
+}
+
+}
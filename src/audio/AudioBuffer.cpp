@@ -3,6 +3,7 @@
 #include "common_macros.h"
 #include "AudioBuffer.h"
 #include "IAudioLoader.h"
+#include "MemoryStatistics.h"
 #include "tracy.h"
 
 namespace ncine {
@@ -27,6 +28,7 @@ AudioBuffer::AudioBuffer(const char *filename)
 {
 	ZoneScoped;
 	ZoneText(filename, strnlen(filename, nctl::String::MaxCStringLength));
+	MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::AUDIO);
 
 	alGetError();
 	alGenBuffers(1, &bufferId_);
@@ -37,6 +39,23 @@ AudioBuffer::AudioBuffer(const char *filename)
 	load(audioLoader.get());
 }
 
+AudioBuffer::AudioBuffer(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize)
+    : Object(ObjectType::AUDIOBUFFER, bufferName),
+      numChannels_(0), frequency_(0), bufferSize_(0)
+{
+	ZoneScoped;
+	ZoneText(bufferName, strnlen(bufferName, nctl::String::MaxCStringLength));
+	MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::AUDIO);
+
+	alGetError();
+	alGenBuffers(1, &bufferId_);
+	const ALenum error = alGetError();
+	ASSERT_MSG_X(error == AL_NO_ERROR, "alGenBuffers failed: %x", error);
+
+	nctl::UniquePtr<IAudioLoader> audioLoader = IAudioLoader::createFromMemory(bufferName, bufferPtr, bufferSize);
+	load(audioLoader.get());
+}
+
 AudioBuffer::~AudioBuffer()
 {
 	alDeleteBuffers(1, &bufferId_);
@@ -0,0 +1,247 @@
+#include "common_macros.h"
+#include "AudioBufferCache.h"
+#include "AudioBuffer.h"
+#include "IFile.h"
+#include <nctl/HashMapIterator.h>
+#include "tracy.h"
+
+namespace ncine {
+
+namespace {
+
+	/// Reads the whole file content in a string, returns false if the file cannot be read
+	bool readFileContent(const char *filename, nctl::String &content)
+	{
+		nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+		fileHandle->setExitOnFailToOpen(false);
+		fileHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
+		if (fileHandle->isOpened() == false)
+			return false;
+
+		const unsigned long length = fileHandle->size();
+		content = nctl::String(static_cast<unsigned int>(length) + 1);
+		const unsigned long bytesRead = fileHandle->read(content.data(), length);
+		content.setLength(static_cast<unsigned int>(bytesRead));
+
+		return (bytesRead == length);
+	}
+
+	/// Returns the hash of the file content, never equal to `NullHash`
+	nctl::hash_t hashContent(const nctl::String &content)
+	{
+		const nctl::hash_t hash = nctl::FNV1aHashFuncContainer<nctl::String>()(content);
+		return (hash != nctl::NullHash) ? hash : hash + 1;
+	}
+
+	/// Returns the 64 bit FNV-1a hash of the file content, used to verify a match of the 32 bit one
+	uint64_t digestContent(const nctl::String &content)
+	{
+		uint64_t digest = 14695981039346656037ULL;
+		for (unsigned int i = 0; i < content.length(); i++)
+		{
+			digest ^= static_cast<unsigned char>(content[i]);
+			digest *= 1099511628211ULL;
+		}
+		return digest;
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+AudioBufferCache::AudioBufferCache(unsigned long memoryBudget)
+    : memoryBudget_(memoryBudget), memoryUsed_(0), releaseCounter_(0),
+      numHits_(0), numMisses_(0), numEvictions_(0),
+      buffers_(InitialCapacity), contentHashes_(InitialCapacity), bufferHashes_(InitialCapacity)
+{
+}
+
+AudioBufferCache::~AudioBufferCache()
+{
+	for (const Entry &entry : buffers_)
+		ASSERT_MSG_X(entry.refCount == 0, "Audio buffer \"%s\" is still referenced %u times", entry.audioBuffer->name().data(), entry.refCount);
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+AudioBuffer *AudioBufferCache::acquire(const char *filename)
+{
+	Entry *entry = retrieveEntry(filename);
+	if (entry == nullptr)
+		return nullptr;
+
+	entry->refCount++;
+	return entry->audioBuffer.get();
+}
+
+void AudioBufferCache::release(AudioBuffer *audioBuffer)
+{
+	ASSERT(audioBuffer);
+
+	nctl::hash_t contentHash = nctl::NullHash;
+	if (bufferHashes_.contains(audioBuffer, contentHash) == false)
+	{
+		LOGW_X("Audio buffer \"%s\" has not been acquired from the cache", audioBuffer->name().data());
+		return;
+	}
+
+	Entry *entry = buffers_.find(contentHash);
+	ASSERT(entry != nullptr);
+	ASSERT(entry->refCount > 0);
+	entry->refCount--;
+	if (entry->refCount == 0)
+	{
+		entry->releaseStamp = ++releaseCounter_;
+		evict(memoryBudget_);
+	}
+}
+
+bool AudioBufferCache::preload(const char *filename)
+{
+	Entry *entry = retrieveEntry(filename);
+	if (entry == nullptr)
+		return false;
+
+	// An unreferenced preloaded buffer is considered as just released
+	if (entry->refCount == 0)
+		entry->releaseStamp = ++releaseCounter_;
+	evict(memoryBudget_);
+
+	return true;
+}
+
+void AudioBufferCache::setMemoryBudget(unsigned long memoryBudget)
+{
+	memoryBudget_ = memoryBudget;
+	evict(memoryBudget_);
+}
+
+void AudioBufferCache::clear()
+{
+	evict(0);
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+AudioBufferCache::Entry *AudioBufferCache::retrieveEntry(const char *filename)
+{
+	ASSERT(filename);
+
+	const nctl::String filenameString(filename);
+	nctl::hash_t contentHash = nctl::NullHash;
+	if (contentHashes_.contains(filenameString, contentHash))
+	{
+		Entry *entry = buffers_.find(contentHash);
+		ASSERT(entry != nullptr);
+		numHits_++;
+		return entry;
+	}
+
+	// The file is read only once, to be both hashed and decoded
+	nctl::String content;
+	if (readFileContent(filename, content) == false)
+	{
+		LOGW_X("Cannot read audio file \"%s\"", filename);
+		return nullptr;
+	}
+	contentHash = hashContent(content);
+	const uint64_t contentDigest = digestContent(content);
+
+	// A different content with the same hash is skipped by probing the next hash values
+	Entry *entry = buffers_.find(contentHash);
+	while (entry != nullptr && (entry->contentLength != content.length() || entry->contentDigest != contentDigest))
+	{
+		contentHash = (contentHash + 1 != nctl::NullHash) ? contentHash + 1 : 0;
+		entry = buffers_.find(contentHash);
+	}
+
+	if (contentHashes_.size() >= contentHashes_.capacity() / 2)
+		contentHashes_.rehash(contentHashes_.capacity() * 2);
+	contentHashes_.insert(filenameString, contentHash);
+
+	// The same content has already been decoded from another file
+	if (entry != nullptr)
+	{
+		numHits_++;
+		return entry;
+	}
+
+	ZoneScoped;
+	ZoneText(filename, strnlen(filename, nctl::String::MaxCStringLength));
+	numMisses_++;
+
+	if (buffers_.size() >= buffers_.capacity() / 2)
+		buffers_.rehash(buffers_.capacity() * 2);
+	if (bufferHashes_.size() >= bufferHashes_.capacity() / 2)
+		bufferHashes_.rehash(bufferHashes_.capacity() * 2);
+
+	Entry &newEntry = buffers_[contentHash];
+	newEntry.contentLength = content.length();
+	newEntry.contentDigest = contentDigest;
+	newEntry.audioBuffer = nctl::makeUnique<AudioBuffer>(filename, reinterpret_cast<const unsigned char *>(content.data()), content.length());
+	memoryUsed_ += newEntry.audioBuffer->bufferSize();
+	bufferHashes_.insert(newEntry.audioBuffer.get(), contentHash);
+
+	return &newEntry;
+}
+
+void AudioBufferCache::evict(unsigned long memoryLimit)
+{
+	while (memoryUsed_ > memoryLimit)
+	{
+		// Searching for the least recently released buffer
+		nctl::hash_t evictedHash = nctl::NullHash;
+		unsigned long oldestStamp = 0;
+		for (auto it = buffers_.begin(); it != buffers_.end(); ++it)
+		{
+			const Entry &entry = it.value();
+			if (entry.refCount == 0 && (evictedHash == nctl::NullHash || entry.releaseStamp < oldestStamp))
+			{
+				evictedHash = it.key();
+				oldestStamp = entry.releaseStamp;
+			}
+		}
+
+		// Every buffer is still referenced
+		if (evictedHash == nctl::NullHash)
+			break;
+
+		removeEntry(evictedHash);
+		numEvictions_++;
+	}
+}
+
+void AudioBufferCache::removeEntry(nctl::hash_t contentHash)
+{
+	Entry *entry = buffers_.find(contentHash);
+	ASSERT(entry != nullptr);
+
+	memoryUsed_ -= entry->audioBuffer->bufferSize();
+	bufferHashes_.remove(entry->audioBuffer.get());
+	buffers_.remove(contentHash);
+
+	// Filenames are removed one at a time as removing invalidates the iterators
+	bool filenameFound = true;
+	while (filenameFound)
+	{
+		filenameFound = false;
+		for (auto it = contentHashes_.begin(); it != contentHashes_.end(); ++it)
+		{
+			if (it.value() == contentHash)
+			{
+				const nctl::String filename = it.key();
+				contentHashes_.remove(filename);
+				filenameFound = true;
+				break;
+			}
+		}
+	}
+}
+
+}
@@ -9,6 +9,12 @@ namespace ncine {
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
 
+AudioBufferPlayer::AudioBufferPlayer()
+    : audioBuffer_(nullptr)
+{
+	type_ = ObjectType::AUDIOBUFFER_PLAYER;
+}
+
 AudioBufferPlayer::AudioBufferPlayer(AudioBuffer *audioBuffer)
     : audioBuffer_(audioBuffer)
 {
@@ -41,6 +47,12 @@ unsigned long AudioBufferPlayer::bufferSize() const
 	return (audioBuffer_ ? audioBuffer_->bufferSize() : 0UL);
 }
 
+void AudioBufferPlayer::setAudioBuffer(AudioBuffer *audioBuffer)
+{
+	stop();
+	audioBuffer_ = audioBuffer;
+}
+
 void AudioBufferPlayer::play()
 {
 	switch (state_)
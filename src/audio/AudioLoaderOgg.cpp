@@ -6,36 +6,35 @@
 
 namespace ncine {
 
-#ifdef __ANDROID__
 namespace {
-	size_t asset_read(void *ptr, size_t size, size_t nmemb, void *datasource)
+	/// Callbacks to decode from files that cannot be opened with `ov_fopen()`, like assets and memory files
+	size_t file_read(void *ptr, size_t size, size_t nmemb, void *datasource)
 	{
-		AssetFile *assetFile = static_cast<AssetFile *>(datasource);
-		return assetFile->read(ptr, size * nmemb);
+		IFile *file = static_cast<IFile *>(datasource);
+		return file->read(ptr, size * nmemb);
 	}
 
-	int asset_seek(void *datasource, ogg_int64_t offset, int whence)
+	int file_seek(void *datasource, ogg_int64_t offset, int whence)
 	{
-		AssetFile *assetFile = static_cast<AssetFile *>(datasource);
-		return assetFile->seek(offset, whence);
+		IFile *file = static_cast<IFile *>(datasource);
+		return file->seek(offset, whence);
 	}
 
-	int asset_close(void *datasource)
+	int file_close(void *datasource)
 	{
-		AssetFile *assetFile = static_cast<AssetFile *>(datasource);
-		assetFile->close();
+		IFile *file = static_cast<IFile *>(datasource);
+		file->close();
 		return 0;
 	}
 
-	long asset_tell(void *datasource)
+	long file_tell(void *datasource)
 	{
-		AssetFile *assetFile = static_cast<AssetFile *>(datasource);
-		return assetFile->tell();
+		IFile *file = static_cast<IFile *>(datasource);
+		return file->tell();
 	}
 
-	const ov_callbacks oggCallbacks = { asset_read, asset_seek, asset_close, asset_tell };
+	const ov_callbacks fileCallbacks = { file_read, file_seek, file_close, file_tell };
 }
-#endif
 
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
@@ -54,12 +53,21 @@ AudioLoaderOgg::AudioLoaderOgg(nctl::UniquePtr<IFile> fileHandle)
 	// File is closed by `ov_clear()`
 	fileHandle_->setCloseOnDestruction(false);
 
+	bool openWithCallbacks = (fileHandle_->type() == IFile::FileType::MEMORY);
 #ifdef __ANDROID__
-	if (fileHandle_->type() == AssetFile::sType())
+	openWithCallbacks = openWithCallbacks || (fileHandle_->type() == AssetFile::sType());
+#endif
+
+	if (openWithCallbacks)
 	{
-		fileHandle_->open(IFile::OpenMode::FD | IFile::OpenMode::READ);
+#ifdef __ANDROID__
+		if (fileHandle_->type() == AssetFile::sType())
+			fileHandle_->open(IFile::OpenMode::FD | IFile::OpenMode::READ);
+		else
+#endif
+			fileHandle_->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
 
-		if (ov_open_callbacks(fileHandle_.get(), &oggFile_, nullptr, 0, oggCallbacks) != 0)
+		if (ov_open_callbacks(fileHandle_.get(), &oggFile_, nullptr, 0, fileCallbacks) != 0)
 		{
 			LOGF_X("Cannot open \"%s\" with ov_open_callbacks()", fileHandle_->filename());
 			fileHandle_->close();
@@ -68,6 +76,7 @@ AudioLoaderOgg::AudioLoaderOgg(nctl::UniquePtr<IFile> fileHandle)
 	}
 	else
 	{
+#ifdef __ANDROID__
 		fileHandle_->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
 
 		if (ov_open(fileHandle_->ptr(), &oggFile_, nullptr, 0) != 0)
@@ -76,11 +85,11 @@ AudioLoaderOgg::AudioLoaderOgg(nctl::UniquePtr<IFile> fileHandle)
 			fileHandle_->close();
 			exit(EXIT_FAILURE);
 		}
-	}
 #else
-	const int err = ov_fopen(fileHandle_->filename(), &oggFile_);
-	FATAL_ASSERT_MSG_X(err == 0, "Cannot open \"%s\" with ov_fopen()", fileHandle_->filename());
+		const int err = ov_fopen(fileHandle_->filename(), &oggFile_);
+		FATAL_ASSERT_MSG_X(err == 0, "Cannot open \"%s\" with ov_fopen()", fileHandle_->filename());
 #endif
+	}
 
 	// Get some information about the OGG file
 	const vorbis_info *info = ov_info(&oggFile_, -1);
@@ -0,0 +1,351 @@
+#include <cmath>
+#include <cstring>
+#include "common_constants.h"
+#include "common_macros.h"
+#include "AudioMixer.h"
+#include "IAudioSink.h"
+#include "IAudioLoader.h"
+#include "tracy.h"
+
+namespace ncine {
+
+namespace {
+
+	const float SampleScale = 1.0f / 32768.0f;
+	const float Sqrt2 = 1.41421356f;
+	/// Voice handles store the index in the lower bits and the generation in the upper ones
+	const unsigned int IndexBits = 16;
+	const unsigned int IndexMask = (1U << IndexBits) - 1;
+	/// The generation wraps around in the bits left by the index
+	const unsigned int GenerationMask = (1U << (32 - IndexBits)) - 1;
+
+	/// Adds contiguous mono samples to both channels, a loop the compiler can vectorize
+	void accumulateMono(float *__restrict left, float *__restrict right, const int16_t *__restrict samples,
+	                    unsigned int numFrames, float leftGain, float rightGain)
+	{
+		for (unsigned int i = 0; i < numFrames; i++)
+		{
+			const float sample = static_cast<float>(samples[i]);
+			left[i] += sample * leftGain;
+			right[i] += sample * rightGain;
+		}
+	}
+
+	/// Adds contiguous interleaved stereo samples to the channels, a loop the compiler can vectorize
+	void accumulateStereo(float *__restrict left, float *__restrict right, const int16_t *__restrict samples,
+	                      unsigned int numFrames, float leftGain, float rightGain)
+	{
+		for (unsigned int i = 0; i < numFrames; i++)
+		{
+			left[i] += static_cast<float>(samples[i * 2]) * leftGain;
+			right[i] += static_cast<float>(samples[i * 2 + 1]) * rightGain;
+		}
+	}
+
+	/// A pitch that is not positive would move the playback position backwards or stall it
+	float clampPitch(float pitch)
+	{
+		// Written so that a NaN fails the first comparison
+		return (pitch > AudioMixer::MinPitch) ? ((pitch < AudioMixer::MaxPitch) ? pitch : AudioMixer::MaxPitch) : AudioMixer::MinPitch;
+	}
+
+	/// A pan outside the range would give a negative gain to one of the channels, inverting its phase
+	float clampPan(float pan)
+	{
+		// Written so that a NaN fails the first comparison
+		return (pan > -1.0f) ? ((pan < 1.0f) ? pan : 1.0f) : -1.0f;
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+const float AudioMixer::MinPitch = 1.0f / 64.0f;
+const float AudioMixer::MaxPitch = 64.0f;
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+AudioMixer::Sound::Sound(const char *filename)
+    : numFrames_(0), numChannels_(0), frequency_(0)
+{
+	ZoneScoped;
+	ZoneText(filename, strnlen(filename, nctl::String::MaxCStringLength));
+
+	nctl::UniquePtr<IAudioLoader> audioLoader = IAudioLoader::createFromFile(filename);
+	FATAL_ASSERT_MSG_X(audioLoader->bytesPerSample() == 2, "Unsupported number of bytes per sample: %d", audioLoader->bytesPerSample());
+	numChannels_ = audioLoader->numChannels();
+	FATAL_ASSERT_MSG_X(numChannels_ == 1 || numChannels_ == 2, "Unsupported number of channels: %d", numChannels_);
+	frequency_ = audioLoader->frequency();
+	numFrames_ = audioLoader->numSamples();
+
+	samples_ = nctl::makeUnique<int16_t[]>(numFrames_ * numChannels_);
+	const unsigned long bytes = audioLoader->read(reinterpret_cast<char *>(samples_.get()), audioLoader->bufferSize());
+	// The loader could return less data than advertised
+	numFrames_ = bytes / (numChannels_ * sizeof(int16_t));
+}
+
+AudioMixer::Sound::Sound(const int16_t *samples, unsigned long numFrames, int numChannels, int frequency)
+    : numFrames_(numFrames), numChannels_(numChannels), frequency_(frequency)
+{
+	ASSERT(samples);
+	FATAL_ASSERT_MSG_X(numChannels_ == 1 || numChannels_ == 2, "Unsupported number of channels: %d", numChannels_);
+	samples_ = nctl::makeUnique<int16_t[]>(numFrames_ * numChannels_);
+	memcpy(samples_.get(), samples, numFrames_ * numChannels_ * sizeof(int16_t));
+}
+
+AudioMixer::AudioMixer(int frequency, unsigned int maxVoices)
+    : frequency_(frequency), masterGain_(1.0f), numActiveVoices_(0),
+      voices_(maxVoices, nctl::ArrayMode::FIXED_CAPACITY)
+{
+	FATAL_ASSERT(frequency > 0);
+	FATAL_ASSERT_MSG_X(maxVoices > 0 && maxVoices <= IndexMask, "Invalid number of voices: %u", maxVoices);
+
+	for (unsigned int i = 0; i < NumGroups; i++)
+		groupGains_[i] = 1.0f;
+	voices_.setSize(maxVoices);
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+float AudioMixer::groupGain(unsigned int group) const
+{
+	ASSERT(group < NumGroups);
+	return (group < NumGroups) ? groupGains_[group] : 0.0f;
+}
+
+void AudioMixer::setGroupGain(unsigned int group, float gain)
+{
+	ASSERT(group < NumGroups);
+	if (group < NumGroups)
+		groupGains_[group] = gain;
+}
+
+unsigned int AudioMixer::play(const Sound &sound)
+{
+	return play(sound, 0, 1.0f, 1.0f, 0.0f, false);
+}
+
+unsigned int AudioMixer::play(const Sound &sound, unsigned int group, float gain, float pitch, float pan, bool looping)
+{
+	ASSERT(group < NumGroups);
+	if (sound.numFrames() == 0 || group >= NumGroups || numActiveVoices_ == voices_.size())
+		return InvalidVoice;
+
+	for (unsigned int i = 0; i < voices_.size(); i++)
+	{
+		Voice &voice = voices_[i];
+		if (voice.isActive == false)
+		{
+			voice.sound = &sound;
+			voice.position = 0.0;
+			voice.gain = gain;
+			voice.pitch = clampPitch(pitch);
+			voice.pan = clampPan(pan);
+			voice.group = group;
+			voice.isLooping = looping;
+			voice.isActive = true;
+			voice.generation = (voice.generation + 1) & GenerationMask;
+			numActiveVoices_++;
+
+			return (voice.generation << IndexBits) | i;
+		}
+	}
+
+	return InvalidVoice;
+}
+
+void AudioMixer::stop(unsigned int handle)
+{
+	Voice *voice = retrieveVoice(handle);
+	if (voice != nullptr)
+	{
+		voice->isActive = false;
+		numActiveVoices_--;
+	}
+}
+
+void AudioMixer::stopAll()
+{
+	for (Voice &voice : voices_)
+		voice.isActive = false;
+	numActiveVoices_ = 0;
+}
+
+bool AudioMixer::isPlaying(unsigned int handle) const
+{
+	return (retrieveVoice(handle) != nullptr);
+}
+
+void AudioMixer::setGain(unsigned int handle, float gain)
+{
+	Voice *voice = retrieveVoice(handle);
+	if (voice != nullptr)
+		voice->gain = gain;
+}
+
+void AudioMixer::setPitch(unsigned int handle, float pitch)
+{
+	Voice *voice = retrieveVoice(handle);
+	if (voice != nullptr)
+		voice->pitch = clampPitch(pitch);
+}
+
+void AudioMixer::setPan(unsigned int handle, float pan)
+{
+	Voice *voice = retrieveVoice(handle);
+	if (voice != nullptr)
+		voice->pan = clampPan(pan);
+}
+
+void AudioMixer::render(IAudioSink &sink, unsigned int numFrames)
+{
+	ZoneScoped;
+
+	while (numFrames > 0)
+	{
+		const unsigned int chunkFrames = (numFrames < ChunkFrames) ? numFrames : ChunkFrames;
+
+		memset(busLeft_, 0, chunkFrames * sizeof(float));
+		memset(busRight_, 0, chunkFrames * sizeof(float));
+
+		if (numActiveVoices_ > 0)
+		{
+			for (Voice &voice : voices_)
+			{
+				if (voice.isActive)
+					mixVoice(voice, chunkFrames);
+			}
+		}
+
+		// Converting the bus to interleaved 16 bit samples
+		const float outputScale = masterGain_ * 32767.0f;
+		for (unsigned int i = 0; i < chunkFrames; i++)
+		{
+			const float left = busLeft_[i] * outputScale;
+			const float right = busRight_[i] * outputScale;
+			output_[i * 2] = static_cast<int16_t>(left > 32767.0f ? 32767.0f : (left < -32768.0f ? -32768.0f : left));
+			output_[i * 2 + 1] = static_cast<int16_t>(right > 32767.0f ? 32767.0f : (right < -32768.0f ? -32768.0f : right));
+		}
+
+		sink.write(output_, chunkFrames);
+		numFrames -= chunkFrames;
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+AudioMixer::Voice *AudioMixer::retrieveVoice(unsigned int handle)
+{
+	const unsigned int index = handle & IndexMask;
+	if (handle == InvalidVoice || index >= voices_.size())
+		return nullptr;
+
+	Voice &voice = voices_[index];
+	return (voice.isActive && voice.generation == ((handle >> IndexBits) & GenerationMask)) ? &voice : nullptr;
+}
+
+const AudioMixer::Voice *AudioMixer::retrieveVoice(unsigned int handle) const
+{
+	const unsigned int index = handle & IndexMask;
+	if (handle == InvalidVoice || index >= voices_.size())
+		return nullptr;
+
+	const Voice &voice = voices_[index];
+	return (voice.isActive && voice.generation == ((handle >> IndexBits) & GenerationMask)) ? &voice : nullptr;
+}
+
+void AudioMixer::mixVoice(Voice &voice, unsigned int numFrames)
+{
+	const Sound &sound = *voice.sound;
+	const int16_t *samples = sound.samples();
+	const unsigned long soundFrames = sound.numFrames();
+	const bool isStereo = (sound.numChannels() == 2);
+
+	// Constant power panning, normalized to have unity gain at the center
+	const float angle = (voice.pan + 1.0f) * fPi * 0.25f;
+	const float gain = voice.gain * groupGains_[voice.group] * SampleScale;
+	const float leftGain = gain * cosf(angle) * Sqrt2;
+	const float rightGain = gain * sinf(angle) * Sqrt2;
+	const double step = static_cast<double>(voice.pitch) * sound.frequency() / frequency_;
+
+	unsigned int frame = 0;
+	if (step == 1.0 && voice.position == floor(voice.position))
+	{
+		// Fast path without resampling, contiguous runs of samples are accumulated
+		unsigned long position = static_cast<unsigned long>(voice.position);
+		while (frame < numFrames)
+		{
+			if (position >= soundFrames)
+			{
+				if (voice.isLooping == false)
+					break;
+				position = 0;
+			}
+
+			const unsigned long available = soundFrames - position;
+			const unsigned int runFrames = (available < numFrames - frame) ? static_cast<unsigned int>(available) : numFrames - frame;
+			if (isStereo)
+				accumulateStereo(busLeft_ + frame, busRight_ + frame, samples + position * 2, runFrames, leftGain, rightGain);
+			else
+				accumulateMono(busLeft_ + frame, busRight_ + frame, samples + position, runFrames, leftGain, rightGain);
+
+			frame += runFrames;
+			position += runFrames;
+		}
+		voice.position = static_cast<double>(position);
+	}
+	else
+	{
+		// Resampling with linear interpolation
+		double position = voice.position;
+		while (frame < numFrames)
+		{
+			if (position >= soundFrames)
+			{
+				if (voice.isLooping == false)
+					break;
+				position -= soundFrames;
+				continue;
+			}
+
+			const unsigned long index = static_cast<unsigned long>(position);
+			const unsigned long next = (index + 1 < soundFrames) ? index + 1 : (voice.isLooping ? 0 : index);
+			const float fraction = static_cast<float>(position - index);
+
+			if (isStereo)
+			{
+				const float left = samples[index * 2] + (samples[next * 2] - samples[index * 2]) * fraction;
+				const float right = samples[index * 2 + 1] + (samples[next * 2 + 1] - samples[index * 2 + 1]) * fraction;
+				busLeft_[frame] += left * leftGain;
+				busRight_[frame] += right * rightGain;
+			}
+			else
+			{
+				const float sample = samples[index] + (samples[next] - samples[index]) * fraction;
+				busLeft_[frame] += sample * leftGain;
+				busRight_[frame] += sample * rightGain;
+			}
+
+			position += step;
+			frame++;
+		}
+		voice.position = position;
+	}
+
+	// The voice has reached the end of a non looping sound
+	if (frame < numFrames)
+	{
+		voice.isActive = false;
+		numActiveVoices_--;
+	}
+}
+
+}
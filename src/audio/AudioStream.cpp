@@ -3,7 +3,12 @@
 #include "common_macros.h"
 #include "AudioStream.h"
 #include "IAudioLoader.h"
+#include "MemoryStatistics.h"
+#include "Application.h"
 #include "tracy.h"
+#ifdef WITH_THREADS
+	#include "ThreadSync.h"
+#endif
 
 namespace ncine {
 
@@ -13,16 +18,28 @@ namespace ncine {
 
 /*! Private constructor called only by `AudioStreamPlayer`. */
 AudioStream::AudioStream(const char *filename)
-    : nextAvailableBufferIndex_(0), currentBufferId_(0), frequency_(0)
+    : numBuffers_(theApplication().appConfiguration().audioStreamNumBuffers),
+      nextAvailableBufferIndex_(0), bufferSize_(theApplication().appConfiguration().audioStreamBufferSize),
+      isDecoding_(false), isSourceStarted_(false), numUnderruns_(0), currentBufferId_(0), frequency_(0)
 {
 	ZoneScoped;
 	ZoneText(filename, strnlen(filename, nctl::String::MaxCStringLength));
+	MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::AUDIO);
+
+	FATAL_ASSERT_MSG_X(numBuffers_ >= 2, "At least two streaming buffers are needed: %u", numBuffers_);
+	FATAL_ASSERT_MSG_X(bufferSize_ > 0, "Invalid streaming buffer size: %lu", bufferSize_);
+	buffersIds_ = nctl::makeUnique<unsigned int[]>(numBuffers_);
 
 	alGetError();
-	alGenBuffers(NumBuffers, buffersIds_.data());
+	alGenBuffers(numBuffers_, buffersIds_.get());
 	const ALenum error = alGetError();
 	ASSERT_MSG_X(error == AL_NO_ERROR, "alGenBuffers failed: %x", error);
-	memBuffer_ = nctl::makeUnique<char[]>(BufferSize);
+	memBuffer_ = nctl::makeUnique<char[]>(numBuffers_ * bufferSize_);
+	decodedBytes_ = nctl::makeUnique<unsigned long[]>(numBuffers_);
+#ifdef WITH_THREADS
+	decodeMutex_ = nctl::makeUnique<Mutex>();
+	decodeCondVar_ = nctl::makeUnique<CondVariable>();
+#endif
 
 	audioLoader_ = IAudioLoader::createFromFile(filename);
 	numChannels_ = audioLoader_->numChannels();
@@ -34,64 +51,99 @@ AudioStream::AudioStream(const char *filename)
 
 AudioStream::~AudioStream()
 {
-	alDeleteBuffers(NumBuffers, buffersIds_.data());
+	alDeleteBuffers(numBuffers_, buffersIds_.get());
 }
 
 ///////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
 
-/*! \return A flag indicating whether the stream has been entirely decoded and played or not. */
-bool AudioStream::enqueue(unsigned int source, bool looping)
+unsigned int AudioStream::numDecodedBuffers() const
 {
-	// Set to false when the queue is empty and there is no more data to decode
-	bool shouldKeepPlaying = true;
-
-	ALint numProcessedBuffers;
-	alGetSourcei(source, AL_BUFFERS_PROCESSED, &numProcessedBuffers);
+	const uint32_t readCount = static_cast<uint32_t>(readCount_.load(nctl::Atomic32::MemoryModel::ACQUIRE));
+	const uint32_t writeCount = static_cast<uint32_t>(writeCount_.load(nctl::Atomic32::MemoryModel::ACQUIRE));
+	return writeCount - readCount;
+}
 
-	// Unqueueing
-	while (numProcessedBuffers > 0)
-	{
-		ALuint unqueuedAlBuffer;
-		alSourceUnqueueBuffers(source, 1, &unqueuedAlBuffer);
-		nextAvailableBufferIndex_--;
-		buffersIds_[nextAvailableBufferIndex_] = unqueuedAlBuffer;
-		numProcessedBuffers--;
-	}
+/*! It can be called by a different thread than the one calling `enqueue()` and `stop()`.
+ *  \return A flag indicating whether new data has been decoded or not. */
+bool AudioStream::decode()
+{
+	ZoneScoped;
+	beginDecoding();
+	bool hasDecoded = false;
+	const uint32_t readCount = static_cast<uint32_t>(readCount_.load(nctl::Atomic32::MemoryModel::ACQUIRE));
+	uint32_t writeCount = static_cast<uint32_t>(writeCount_.load(nctl::Atomic32::MemoryModel::RELAXED));
 
-	// Queueing
-	if (nextAvailableBufferIndex_ < NumBuffers)
+	while (writeCount - readCount < numBuffers_ && hasReachedEnd_.load(nctl::Atomic32::MemoryModel::RELAXED) == 0)
 	{
-		currentBufferId_ = buffersIds_[nextAvailableBufferIndex_];
-
-		unsigned long bytes = audioLoader_->read(memBuffer_.get(), BufferSize);
+		const unsigned int index = writeCount % numBuffers_;
+		char *buffer = memBuffer_.get() + index * bufferSize_;
+		unsigned long bytes = audioLoader_->read(buffer, bufferSize_);
 
 		// EOF reached
-		if (bytes < BufferSize)
+		if (bytes < bufferSize_)
 		{
-			if (looping)
+			if (isLooping_.load(nctl::Atomic32::MemoryModel::RELAXED))
 			{
 				audioLoader_->rewind();
-				const unsigned long moreBytes = audioLoader_->read(memBuffer_.get() + bytes, BufferSize - bytes);
+				const unsigned long moreBytes = audioLoader_->read(buffer + bytes, bufferSize_ - bytes);
 				bytes += moreBytes;
 			}
 		}
 
-		// If it is still decoding data then enqueue
-		if (bytes > 0)
-		{
-			// On iOS `alBufferDataStatic()` could be used instead
-			alBufferData(currentBufferId_, format_, memBuffer_.get(), bytes, frequency_);
-			alSourceQueueBuffers(source, 1, &currentBufferId_);
-			nextAvailableBufferIndex_++;
-		}
-		// If there is no more data left to decode and the queue is empty
-		else if (nextAvailableBufferIndex_ == 0)
+		if (bytes == 0)
 		{
-			shouldKeepPlaying = false;
-			stop(source);
+			hasReachedEnd_.store(1, nctl::Atomic32::MemoryModel::RELEASE);
+			break;
 		}
+
+		decodedBytes_[index] = bytes;
+		writeCount++;
+		// Publishing the decoded buffer to the OpenAL side
+		writeCount_.store(static_cast<int32_t>(writeCount), nctl::Atomic32::MemoryModel::RELEASE);
+		hasDecoded = true;
+	}
+
+	endDecoding();
+	return hasDecoded;
+}
+
+/*! \return A flag indicating whether the stream has been entirely decoded and played or not. */
+bool AudioStream::enqueue(unsigned int source, bool looping)
+{
+	ZoneScoped;
+	// Set to false when the queue is empty and there is no more data to decode
+	bool shouldKeepPlaying = true;
+
+	setLooping(looping);
+	unqueueProcessed(source);
+
+	// Queueing every decoded buffer as long as there are available OpenAL ones
+	const uint32_t writeCount = static_cast<uint32_t>(writeCount_.load(nctl::Atomic32::MemoryModel::ACQUIRE));
+	uint32_t readCount = static_cast<uint32_t>(readCount_.load(nctl::Atomic32::MemoryModel::RELAXED));
+	while (nextAvailableBufferIndex_ < numBuffers_ && readCount != writeCount)
+	{
+		const unsigned int index = readCount % numBuffers_;
+		currentBufferId_ = buffersIds_[nextAvailableBufferIndex_];
+
+		// On iOS `alBufferDataStatic()` could be used instead
+		alBufferData(currentBufferId_, format_, memBuffer_.get() + index * bufferSize_, decodedBytes_[index], frequency_);
+		alSourceQueueBuffers(source, 1, &currentBufferId_);
+		nextAvailableBufferIndex_++;
+
+		readCount++;
+		// Giving the ring buffer back to the decoding side
+		readCount_.store(static_cast<int32_t>(readCount), nctl::Atomic32::MemoryModel::RELEASE);
+	}
+
+	// If there is no more data left to decode and the queue is empty
+	if (nextAvailableBufferIndex_ == 0 && hasReachedEnd_.load(nctl::Atomic32::MemoryModel::ACQUIRE) &&
+	    readCount == static_cast<uint32_t>(writeCount_.load(nctl::Atomic32::MemoryModel::ACQUIRE)))
+	{
+		shouldKeepPlaying = false;
+		stop(source);
+		return shouldKeepPlaying;
 	}
 
 	ALenum state;
@@ -104,10 +156,17 @@ bool AudioStream::enqueue(unsigned int source, bool looping)
 		alGetSourcei(source, AL_BUFFERS_QUEUED, &numQueuedBuffers);
 		if (numQueuedBuffers > 0)
 		{
+			// The first start after queueing the initial buffers is not an underrun
+			if (isSourceStarted_)
+				numUnderruns_++;
+
 			// Need to restart play
 			alSourcePlay(source);
+			isSourceStarted_ = true;
 		}
 	}
+	else
+		isSourceStarted_ = true;
 
 	return shouldKeepPlaying;
 }
@@ -116,7 +175,39 @@ void AudioStream::stop(unsigned int source)
 {
 	// In order to unqueue all the buffers, the source must be stopped first
 	alSourceStop(source);
+	unqueueProcessed(source);
+
+#ifdef WITH_THREADS
+	// Sleeping until the decoding side has finished, it will not access the loader again until the mutex is released
+	decodeMutex_->lock();
+	while (isDecoding_)
+		decodeCondVar_->wait(*decodeMutex_);
+#endif
 
+	audioLoader_->rewind();
+	readCount_.store(0, nctl::Atomic32::MemoryModel::RELAXED);
+	writeCount_.store(0, nctl::Atomic32::MemoryModel::RELAXED);
+	hasReachedEnd_.store(0, nctl::Atomic32::MemoryModel::RELAXED);
+
+#ifdef WITH_THREADS
+	decodeMutex_->unlock();
+#endif
+
+	currentBufferId_ = 0;
+	isSourceStarted_ = false;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void AudioStream::setLooping(bool looping)
+{
+	isLooping_.store(looping ? 1 : 0, nctl::Atomic32::MemoryModel::RELAXED);
+}
+
+void AudioStream::unqueueProcessed(unsigned int source)
+{
 	ALint numProcessedBuffers;
 	alGetSourcei(source, AL_BUFFERS_PROCESSED, &numProcessedBuffers);
 
@@ -129,9 +220,26 @@ void AudioStream::stop(unsigned int source)
 		buffersIds_[nextAvailableBufferIndex_] = unqueuedAlBuffer;
 		numProcessedBuffers--;
 	}
+}
 
-	audioLoader_->rewind();
-	currentBufferId_ = 0;
+void AudioStream::beginDecoding()
+{
+#ifdef WITH_THREADS
+	// The mutex is held by `stop()` while the loader is rewound
+	decodeMutex_->lock();
+	isDecoding_ = true;
+	decodeMutex_->unlock();
+#endif
+}
+
+void AudioStream::endDecoding()
+{
+#ifdef WITH_THREADS
+	decodeMutex_->lock();
+	isDecoding_ = false;
+	decodeMutex_->unlock();
+	decodeCondVar_->broadcast();
+#endif
 }
 
 }
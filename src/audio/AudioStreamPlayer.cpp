@@ -17,6 +17,8 @@ AudioStreamPlayer::AudioStreamPlayer(const char *filename)
 
 AudioStreamPlayer::~AudioStreamPlayer()
 {
+	// The stream should not be accessed by the decode thread anymore
+	theServiceLocator().audioDevice().unregisterPlayer(this);
 	if (state_ != PlayerState::STOPPED)
 		audioStream_.stop(sourceId_);
 }
@@ -46,6 +48,7 @@ void AudioStreamPlayer::play()
 			alSourcef(sourceId_, AL_GAIN, gain_);
 			alSourcef(sourceId_, AL_PITCH, pitch_);
 			alSourcefv(sourceId_, AL_POSITION, position_.data());
+			audioStream_.setLooping(isLooping_);
 
 			alSourcePlay(sourceId_);
 			state_ = PlayerState::PLAYING;
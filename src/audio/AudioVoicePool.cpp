@@ -0,0 +1,122 @@
+#include "common_macros.h"
+#include "AudioVoicePool.h"
+#include "ServiceLocator.h"
+#include "tracy.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+AudioVoicePool::AudioVoicePool(unsigned int numVoices)
+    : numVoices_(numVoices), playCounter_(0), numSteals_(0), numDropped_(0)
+{
+	FATAL_ASSERT(numVoices > 0);
+	voices_ = nctl::makeUnique<Voice[]>(numVoices_);
+}
+
+AudioVoicePool::~AudioVoicePool()
+{
+	stopAll();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+AudioBufferPlayer *AudioVoicePool::play(AudioBuffer *audioBuffer, int priority)
+{
+	return play(audioBuffer, priority, 1.0f, 1.0f, Vector3f::Zero);
+}
+
+AudioBufferPlayer *AudioVoicePool::play(AudioBuffer *audioBuffer, int priority, float gain, float pitch, const Vector3f &position)
+{
+	ZoneScoped;
+	ASSERT(audioBuffer);
+
+	for (unsigned int i = 0; i < numVoices_; i++)
+	{
+		Voice &voice = voices_[i];
+		if (voice.player.isPlaying() == false)
+		{
+			if (playOnVoice(voice, audioBuffer, priority, gain, pitch, position))
+				return &voice.player;
+			// There are no free sources in the device, one has to be stolen from a playing voice
+			break;
+		}
+	}
+
+	Voice *victim = findVictim(priority);
+	if (victim != nullptr && playOnVoice(*victim, audioBuffer, priority, gain, pitch, position))
+	{
+		numSteals_++;
+		return &victim->player;
+	}
+
+	numDropped_++;
+	return nullptr;
+}
+
+void AudioVoicePool::stopAll()
+{
+	for (unsigned int i = 0; i < numVoices_; i++)
+	{
+		voices_[i].player.stop();
+		theServiceLocator().audioDevice().unregisterPlayer(&voices_[i].player);
+	}
+}
+
+unsigned int AudioVoicePool::numActiveVoices() const
+{
+	unsigned int numActive = 0;
+	for (unsigned int i = 0; i < numVoices_; i++)
+	{
+		if (voices_[i].player.isPlaying())
+			numActive++;
+	}
+	return numActive;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+AudioVoicePool::Voice *AudioVoicePool::findVictim(int priority)
+{
+	Voice *victim = nullptr;
+	for (unsigned int i = 0; i < numVoices_; i++)
+	{
+		Voice &voice = voices_[i];
+		if (voice.player.isPlaying() == false || voice.priority > priority)
+			continue;
+
+		if (victim == nullptr || voice.priority < victim->priority ||
+		    (voice.priority == victim->priority && voice.playStamp < victim->playStamp))
+			victim = &voice;
+	}
+
+	return victim;
+}
+
+bool AudioVoicePool::playOnVoice(Voice &voice, AudioBuffer *audioBuffer, int priority, float gain, float pitch, const Vector3f &position)
+{
+	// Stopping and unregistering releases the source of a stolen voice before playing again
+	voice.player.setAudioBuffer(audioBuffer);
+	theServiceLocator().audioDevice().unregisterPlayer(&voice.player);
+
+	voice.player.setLooping(false);
+	voice.player.setGain(gain);
+	voice.player.setPitch(pitch);
+	voice.player.setPosition(position);
+	voice.player.play();
+
+	if (voice.player.isPlaying() == false)
+		return false;
+
+	voice.priority = priority;
+	voice.playStamp = ++playCounter_;
+	return true;
+}
+
+}
@@ -30,8 +30,20 @@ IAudioLoader::IAudioLoader(nctl::UniquePtr<IFile> fileHandle)
 nctl::UniquePtr<IAudioLoader> IAudioLoader::createFromFile(const char *filename)
 {
 	// Creating a handle from IFile static method to detect assets file
-	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+	return createLoader(IFile::createFileHandle(filename), filename);
+}
+
+nctl::UniquePtr<IAudioLoader> IAudioLoader::createFromMemory(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize)
+{
+	return createLoader(IFile::createFromMemory(bufferName, bufferPtr, bufferSize), bufferName);
+}
 
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+nctl::UniquePtr<IAudioLoader> IAudioLoader::createLoader(nctl::UniquePtr<IFile> fileHandle, const char *filename)
+{
 	if (fs::hasExtension(filename, "wav"))
 		return nctl::makeUnique<AudioLoaderWav>(nctl::move(fileHandle));
 #ifdef WITH_VORBIS
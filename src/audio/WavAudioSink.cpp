@@ -0,0 +1,110 @@
+#include <cstring>
+#include "common_macros.h"
+#include "WavAudioSink.h"
+#include "IFile.h"
+
+namespace ncine {
+
+namespace {
+
+	/// Header for the RIFF WAVE format, the same used by `AudioLoaderWav`
+	struct WavHeader
+	{
+		char chunkId[4];
+		uint32_t chunkSize;
+		char format[4];
+
+		char subchunk1Id[4];
+		uint32_t subchunk1Size;
+		uint16_t audioFormat;
+		uint16_t numChannels;
+		uint32_t sampleRate;
+		uint32_t byteRate;
+		uint16_t blockAlign;
+		uint16_t bitsPerSample;
+
+		char subchunk2Id[4];
+		uint32_t subchunk2Size;
+	};
+
+	const unsigned int NumChannels = 2;
+	const unsigned int BytesPerSample = 2;
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+WavAudioSink::WavAudioSink(const char *filename, int frequency)
+    : fileHandle_(IFile::createFileHandle(filename)), frequency_(frequency), numFramesWritten_(0)
+{
+	ASSERT(frequency > 0);
+	// A file that cannot be written is reported by `isOpened()`
+	fileHandle_->setExitOnFailToOpen(false);
+	fileHandle_->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
+	if (fileHandle_->isOpened())
+		writeHeader();
+	else
+		LOGE_X("Cannot open \"%s\" for writing", filename);
+}
+
+WavAudioSink::~WavAudioSink()
+{
+	if (fileHandle_->isOpened())
+	{
+		// Rewriting the header now that the data size is known
+		fileHandle_->seek(0, SEEK_SET);
+		writeHeader();
+		fileHandle_->close();
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool WavAudioSink::isOpened() const
+{
+	return fileHandle_->isOpened();
+}
+
+void WavAudioSink::write(const int16_t *frames, unsigned int numFrames)
+{
+	if (fileHandle_->isOpened() == false || numFrames == 0)
+		return;
+
+	// Samples are written as they are, assuming a little endian machine like `IFile::int16FromLE()` does
+	fileHandle_->write(const_cast<int16_t *>(frames), numFrames * NumChannels * BytesPerSample);
+	numFramesWritten_ += numFrames;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void WavAudioSink::writeHeader()
+{
+	const uint32_t dataSize = static_cast<uint32_t>(numFramesWritten_ * NumChannels * BytesPerSample);
+
+	WavHeader header;
+	memcpy(header.chunkId, "RIFF", 4);
+	header.chunkSize = sizeof(WavHeader) - 8 + dataSize;
+	memcpy(header.format, "WAVE", 4);
+
+	memcpy(header.subchunk1Id, "fmt ", 4);
+	header.subchunk1Size = 16;
+	header.audioFormat = 1; // PCM
+	header.numChannels = NumChannels;
+	header.sampleRate = static_cast<uint32_t>(frequency_);
+	header.byteRate = frequency_ * NumChannels * BytesPerSample;
+	header.blockAlign = NumChannels * BytesPerSample;
+	header.bitsPerSample = BytesPerSample * 8;
+
+	memcpy(header.subchunk2Id, "data", 4);
+	header.subchunk2Size = dataSize;
+
+	fileHandle_->write(&header, sizeof(WavHeader));
+}
+
+}
@@ -1,5 +1,8 @@
 #include "common_macros.h"
 #include "Object.h"
+#ifdef WITH_LUA
+	#include "LuaStateManager.h"
+#endif
 
 namespace ncine {
 
@@ -22,6 +25,10 @@ Object::Object(ObjectType type, const char *name)
 Object::~Object()
 {
 	theServiceLocator().indexer().removeObject(id_);
+#ifdef WITH_LUA
+	// Scripts could still hold handles to the object, and a new object could be allocated at the same address
+	LuaStateManager::releaseSharedUserData(this);
+#endif
 }
 
 ///////////////////////////////////////////////////////////
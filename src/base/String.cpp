@@ -3,11 +3,18 @@
 #include "common_macros.h"
 #include <nctl/String.h>
 #include <nctl/algorithms.h>
+#include <nctl/memory_tags.h>
 
 namespace nctl {
 
 namespace {
 
+	char *allocateCharacters(unsigned int capacity)
+	{
+		NCTL_CONTAINER_MEMORY_TAG;
+		return new char[capacity];
+	}
+
 	size_t wrappedStrnlen(const char *str, size_t maxLen)
 	{
 #if defined(_WIN32) && !defined(__MINGW32__)
@@ -59,7 +66,7 @@ String::String(unsigned int capacity)
 		capacity_ = SmallBufferSize;
 	else
 	{
-		array_.begin_ = new char[capacity_];
+		array_.begin_ = allocateCharacters(capacity_);
 		array_.begin_[0] = '\0';
 	}
 }
@@ -77,7 +84,7 @@ String::String(const char *cString)
 		capacity_ = SmallBufferSize;
 	else
 	{
-		array_.begin_ = new char[capacity_];
+		array_.begin_ = allocateCharacters(capacity_);
 		dest = array_.begin_;
 	}
 
@@ -98,7 +105,7 @@ String::String(const String &other)
 	char *dest = array_.local_;
 	if (capacity_ > SmallBufferSize)
 	{
-		array_.begin_ = new char[capacity_];
+		array_.begin_ = allocateCharacters(capacity_);
 		src = other.array_.begin_;
 		dest = array_.begin_;
 	}
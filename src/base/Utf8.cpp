@@ -0,0 +1,144 @@
+#include <nctl/Utf8.h>
+
+namespace nctl {
+
+namespace Utf8 {
+
+	unsigned int decode(const char *sequence, unsigned int maxCodeUnits, unsigned int &codePoint)
+	{
+		if (maxCodeUnits == 0)
+			return 0;
+
+		const unsigned char lead = static_cast<unsigned char>(sequence[0]);
+		if (lead < 0x80)
+		{
+			codePoint = lead;
+			return 1;
+		}
+
+		unsigned int numCodeUnits = 0;
+		unsigned int minCodePoint = 0;
+		if ((lead & 0xE0) == 0xC0)
+		{
+			numCodeUnits = 2;
+			minCodePoint = 0x80;
+			codePoint = lead & 0x1F;
+		}
+		else if ((lead & 0xF0) == 0xE0)
+		{
+			numCodeUnits = 3;
+			minCodePoint = 0x800;
+			codePoint = lead & 0x0F;
+		}
+		else if ((lead & 0xF8) == 0xF0)
+		{
+			numCodeUnits = 4;
+			minCodePoint = 0x10000;
+			codePoint = lead & 0x07;
+		}
+		else
+		{
+			// A stray continuation byte or an invalid lead byte
+			codePoint = InvalidCodePoint;
+			return 1;
+		}
+
+		if (numCodeUnits > maxCodeUnits)
+		{
+			codePoint = InvalidCodePoint;
+			return 1;
+		}
+
+		for (unsigned int i = 1; i < numCodeUnits; i++)
+		{
+			if (isContinuation(sequence[i]) == false)
+			{
+				codePoint = InvalidCodePoint;
+				return 1;
+			}
+			codePoint = (codePoint << 6) | (static_cast<unsigned char>(sequence[i]) & 0x3F);
+		}
+
+		// Reject overlong encodings, surrogate halves and out of range values
+		if (codePoint < minCodePoint || codePoint > MaxCodePoint || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+		{
+			codePoint = InvalidCodePoint;
+			return 1;
+		}
+
+		return numCodeUnits;
+	}
+
+	unsigned int encode(unsigned int codePoint, char *sequence)
+	{
+		if (codePoint > MaxCodePoint || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+			return 0;
+
+		if (codePoint < 0x80)
+		{
+			sequence[0] = static_cast<char>(codePoint);
+			return 1;
+		}
+		else if (codePoint < 0x800)
+		{
+			sequence[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+			sequence[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+			return 2;
+		}
+		else if (codePoint < 0x10000)
+		{
+			sequence[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+			sequence[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			sequence[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+			return 3;
+		}
+		else
+		{
+			sequence[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+			sequence[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+			sequence[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			sequence[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+			return 4;
+		}
+	}
+
+	unsigned int numCodePoints(const char *sequence, unsigned int length)
+	{
+		unsigned int count = 0;
+		unsigned int codePoint = 0;
+		unsigned int position = 0;
+		while (position < length)
+		{
+			position += decode(sequence + position, length - position, codePoint);
+			count++;
+		}
+
+		return count;
+	}
+
+	unsigned int truncatedLength(const char *sequence, unsigned int length)
+	{
+		unsigned int position = 0;
+		while (position < length)
+		{
+			// Only the lead byte is inspected, code units after `length` are never read
+			const unsigned char lead = static_cast<unsigned char>(sequence[position]);
+			unsigned int numCodeUnits = 1;
+			if ((lead & 0xE0) == 0xC0)
+				numCodeUnits = 2;
+			else if ((lead & 0xF0) == 0xE0)
+				numCodeUnits = 3;
+			else if ((lead & 0xF8) == 0xF0)
+				numCodeUnits = 4;
+
+			if (position + numCodeUnits > length)
+				break;
+			position += numCodeUnits;
+		}
+
+		return position;
+	}
+
+}
+
+}
@@ -25,6 +25,18 @@ BaseSprite::BaseSprite(SceneNode *parent, Texture *texture, const Vector2f &posi
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
 
+void BaseSprite::setWidth(float width)
+{
+	width_ = width;
+	invalidateParentRecordedCommands();
+}
+
+void BaseSprite::setHeight(float height)
+{
+	height_ = height;
+	invalidateParentRecordedCommands();
+}
+
 void BaseSprite::setSize(float width, float height)
 {
 	// Update anchor points when size changes
@@ -35,6 +47,13 @@ void BaseSprite::setSize(float width, float height)
 
 	width_ = width;
 	height_ = height;
+	invalidateParentRecordedCommands();
+}
+
+void BaseSprite::setTexture(Texture *texture)
+{
+	texture_ = texture;
+	invalidateParentRecordedCommands();
 }
 
 void BaseSprite::setTexRect(const Recti &rect)
@@ -62,6 +81,7 @@ void BaseSprite::setFlippedX(bool flippedX)
 		texRect_.x += texRect_.w;
 		texRect_.w *= -1;
 		flippedX_ = flippedX;
+		invalidateParentRecordedCommands();
 	}
 }
 
@@ -72,6 +92,7 @@ void BaseSprite::setFlippedY(bool flippedY)
 		texRect_.y += texRect_.h;
 		texRect_.h *= -1;
 		flippedY_ = flippedY;
+		invalidateParentRecordedCommands();
 	}
 }
 
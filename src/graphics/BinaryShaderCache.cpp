@@ -0,0 +1,219 @@
+#include "common_macros.h"
+#include "BinaryShaderCache.h"
+#include "FileSystem.h"
+#include "IFile.h"
+#include "IGfxCapabilities.h"
+#include "ServiceLocator.h"
+#include "Application.h"
+#include <nctl/Array.h>
+
+namespace ncine {
+
+namespace {
+
+	void appendFileContent(nctl::String &string, const char *filename)
+	{
+		nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+		fileHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
+		if (fileHandle->isOpened())
+		{
+			const unsigned long length = fileHandle->size();
+			nctl::String content(static_cast<unsigned int>(length) + 1);
+			fileHandle->read(content.data(), length);
+			content.setLength(static_cast<unsigned int>(length));
+			string.append(content);
+		}
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+BinaryShaderCache::BinaryShaderCache(bool enabled, const char *dirname)
+    : isAvailable_(false), platformHash_(0), batchSize_(0), numHits_(0), numMisses_(0), path_(fs::MaxPathLength)
+{
+	if (enabled == false)
+		return;
+
+#ifndef __EMSCRIPTEN__
+	const IGfxCapabilities &gfxCaps = theServiceLocator().gfxCapabilities();
+	#if !defined(__ANDROID__) && !defined(WITH_ANGLE)
+	// Program binaries are part of the core profile since OpenGL 4.1
+	const bool isSupported = gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::ARB_GET_PROGRAM_BINARY) ||
+	                         gfxCaps.glVersion(IGfxCapabilities::GLVersion::MAJOR) * 10 + gfxCaps.glVersion(IGfxCapabilities::GLVersion::MINOR) >= 41;
+	#else
+	const bool isSupported = true;
+	#endif
+
+	GLint numFormats = 0;
+	if (isSupported)
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+
+	if (numFormats > 0)
+	{
+		const IGfxCapabilities::GlInfoStrings &infoStrings = gfxCaps.glInfoStrings();
+		nctl::String platformString(256);
+		platformString.formatAppend("%s|%s|%s", reinterpret_cast<const char *>(infoStrings.vendor),
+		                            reinterpret_cast<const char *>(infoStrings.renderer), reinterpret_cast<const char *>(infoStrings.glVersion));
+		platformHash_ = nctl::FNV1aHashFuncContainer<nctl::String>()(platformString);
+		batchSize_ = theApplication().appConfiguration().fixedBatchSize;
+
+		path_ = fs::joinPath(fs::savePath(), dirname);
+		if (fs::isDirectory(path_.data()) == false)
+			fs::createDir(path_.data());
+		isAvailable_ = fs::isWritable(path_.data());
+
+		if (isAvailable_ == false)
+			LOGW_X("Binary shader cache directory is not writable: \"%s\"", path_.data());
+	}
+#endif
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+nctl::hash_t BinaryShaderCache::hashSources(const char *vertexSource, const char *fragmentSource) const
+{
+	nctl::String sources(1024);
+	sources.append(vertexSource);
+	sources.append(fragmentSource);
+	return nctl::FNV1aHashFuncContainer<nctl::String>()(sources);
+}
+
+nctl::hash_t BinaryShaderCache::hashFiles(const char *vertexFile, const char *fragmentFile) const
+{
+	nctl::String sources(1024);
+	appendFileContent(sources, vertexFile);
+	appendFileContent(sources, fragmentFile);
+	return nctl::FNV1aHashFuncContainer<nctl::String>()(sources);
+}
+
+bool BinaryShaderCache::loadFromCache(nctl::hash_t sourcesHash, GLShaderProgram &program, GLShaderProgram::Introspection introspection)
+{
+	if (isAvailable_ == false)
+		return false;
+
+	const nctl::String filePath = cacheFilePath(sourcesHash);
+	if (fs::isReadableFile(filePath.data()) == false)
+	{
+		numMisses_++;
+		return false;
+	}
+
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filePath.data());
+	fileHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
+
+	Header header;
+	bool isValid = fileHandle->isOpened() && fileHandle->read(&header, sizeof(Header)) == sizeof(Header);
+	isValid = isValid && header.signature == Signature && header.version == Version &&
+	          header.platformHash == platformHash_ && header.sourcesHash == sourcesHash &&
+	          header.batchSize == batchSize_ && header.binaryLength > 0 &&
+	          static_cast<unsigned long>(fileHandle->size()) == sizeof(Header) + header.binaryLength;
+
+	if (isValid)
+	{
+		nctl::Array<unsigned char> binary(header.binaryLength, nctl::ArrayMode::FIXED_CAPACITY);
+		binary.setSize(header.binaryLength);
+		isValid = fileHandle->read(binary.data(), header.binaryLength) == header.binaryLength &&
+		          program.loadBinary(header.binaryFormat, binary.data(), header.binaryLength, introspection);
+	}
+	fileHandle->close();
+
+	if (isValid == false)
+	{
+		// Removing a stale or corrupted entry, it will be replaced after compilation
+		LOGW_X("Discarding invalid binary shader cache entry: \"%s\"", filePath.data());
+		fs::deleteFile(filePath.data());
+		numMisses_++;
+		return false;
+	}
+
+	numHits_++;
+	return true;
+}
+
+bool BinaryShaderCache::saveToCache(nctl::hash_t sourcesHash, const GLShaderProgram &program)
+{
+	if (isAvailable_ == false)
+		return false;
+
+	const int length = program.binaryLength();
+	if (length <= 0)
+		return false;
+
+	nctl::Array<unsigned char> binary(length, nctl::ArrayMode::FIXED_CAPACITY);
+	binary.setSize(length);
+	unsigned int binaryFormat = 0;
+	if (program.retrieveBinary(length, binaryFormat, binary.data()) == false)
+		return false;
+
+	Header header;
+	header.signature = Signature;
+	header.version = Version;
+	header.platformHash = platformHash_;
+	header.sourcesHash = sourcesHash;
+	header.batchSize = batchSize_;
+	header.binaryFormat = binaryFormat;
+	header.binaryLength = static_cast<uint32_t>(length);
+
+	const nctl::String filePath = cacheFilePath(sourcesHash);
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filePath.data());
+	// A cache entry that cannot be written is not a fatal error
+	fileHandle->setExitOnFailToOpen(false);
+	fileHandle->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+		return false;
+
+	const bool written = fileHandle->write(&header, sizeof(Header)) == sizeof(Header) &&
+	                     fileHandle->write(binary.data(), header.binaryLength) == header.binaryLength;
+	fileHandle->close();
+
+	// A partially written entry would be rejected at the next launch anyway
+	if (written == false)
+		fs::deleteFile(filePath.data());
+
+	return written;
+}
+
+void BinaryShaderCache::saveToCacheWhenLinked(nctl::hash_t sourcesHash, const GLShaderProgram &program)
+{
+	if (isAvailable_ == false)
+		return;
+
+	// The binary of a program with deferred queries is only retrieved after its link status has been checked
+	if (program.status() == GLShaderProgram::Status::LINKED_WITH_DEFERRED_QUERIES)
+		pendingPrograms_.pushBack(PendingProgram(sourcesHash, &program));
+	else
+		saveToCache(sourcesHash, program);
+}
+
+void BinaryShaderCache::savePendingToCache()
+{
+	for (int i = static_cast<int>(pendingPrograms_.size()) - 1; i >= 0; i--)
+	{
+		const PendingProgram &pending = pendingPrograms_[i];
+		const GLShaderProgram::Status status = pending.program->status();
+		if (status == GLShaderProgram::Status::LINKED_WITH_DEFERRED_QUERIES)
+			continue;
+
+		if (status != GLShaderProgram::Status::LINKING_FAILED)
+			saveToCache(pending.sourcesHash, *pending.program);
+		pendingPrograms_.unorderedRemoveAt(i);
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+nctl::String BinaryShaderCache::cacheFilePath(nctl::hash_t sourcesHash) const
+{
+	nctl::String filename(32);
+	filename.format("%08x_%08x_%u.bin", platformHash_, sourcesHash, batchSize_);
+	return fs::joinPath(path_, filename);
+}
+
+}
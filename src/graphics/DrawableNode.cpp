@@ -4,11 +4,18 @@
 #include "RenderCommand.h"
 #include "Application.h"
 #include "RenderStatistics.h"
+#include "MemoryStatistics.h"
 
 namespace ncine {
 
 namespace {
 
+	nctl::UniquePtr<RenderCommand> createRenderCommand()
+	{
+		MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::RENDER_COMMANDS);
+		return nctl::makeUnique<RenderCommand>();
+	}
+
 	GLenum toGlBlendingFactor(DrawableNode::BlendingFactor blendingFactor)
 	{
 		switch (blendingFactor)
@@ -76,7 +83,7 @@ unsigned short DrawableNode::nuklearLayer_ = LayerBase::HIGHEST - 512;
 
 DrawableNode::DrawableNode(SceneNode *parent, float xx, float yy)
     : SceneNode(parent, xx, yy), width_(0.0f), height_(0.0f),
-      renderCommand_(nctl::makeUnique<RenderCommand>())
+      renderCommand_(createRenderCommand())
 {
 	renderCommand_->setIdSortKey(id());
 }
@@ -104,23 +111,21 @@ DrawableNode::~DrawableNode() = default;
 
 void DrawableNode::draw(RenderQueue &renderQueue)
 {
-	const bool cullingEnabled = theApplication().renderingSettings().cullingEnabled;
+	const Application::RenderingSettings &settings = theApplication().renderingSettings();
+	const bool cullingEnabled = settings.cullingEnabled;
+	// The batcher needs the bounding box to know if transparent commands can be reordered
+	const bool aabbNeeded = cullingEnabled || (settings.batchingEnabled && settings.batchingWithReordering);
 
-	if (cullingEnabled)
-	{
+	if (aabbNeeded)
 		updateAabb();
 
-		if (aabb_.overlaps(theApplication().gfxDevice().screenRect()))
-		{
-			updateRenderCommand();
-			renderQueue.addCommand(renderCommand_.get());
-		}
-		else
-			RenderStatistics::addCulledNode();
-	}
+	if (cullingEnabled && aabb_.overlaps(theApplication().gfxDevice().screenRect()) == false)
+		RenderStatistics::addCulledNode();
 	else
 	{
 		updateRenderCommand();
+		if (aabbNeeded)
+			renderCommand_->setAabb(aabb_);
 		renderQueue.addCommand(renderCommand_.get());
 	}
 }
@@ -140,6 +145,7 @@ bool DrawableNode::isBlendingEnabled() const
 void DrawableNode::setBlendingEnabled(bool blendingEnabled)
 {
 	renderCommand_->material().setBlendingEnabled(blendingEnabled);
+	invalidateParentRecordedCommands();
 }
 
 DrawableNode::BlendingFactor DrawableNode::srcBlendingFactor() const
@@ -172,11 +178,13 @@ void DrawableNode::setBlendingPreset(BlendingPreset blendingPreset)
 			renderCommand_->material().setBlendingFactors(toGlBlendingFactor(BlendingFactor::DST_COLOR), toGlBlendingFactor(BlendingFactor::ZERO));
 			break;
 	}
+	invalidateParentRecordedCommands();
 }
 
 void DrawableNode::setBlendingFactors(BlendingFactor srcBlendingFactor, BlendingFactor destBlendingFactor)
 {
 	renderCommand_->material().setBlendingFactors(toGlBlendingFactor(srcBlendingFactor), toGlBlendingFactor(destBlendingFactor));
+	invalidateParentRecordedCommands();
 }
 
 unsigned short DrawableNode::layer() const
@@ -188,6 +196,7 @@ unsigned short DrawableNode::layer() const
 void DrawableNode::setLayer(unsigned short layer)
 {
 	renderCommand_->setLayer(layer);
+	invalidateParentRecordedCommands();
 }
 
 ///////////////////////////////////////////////////////////
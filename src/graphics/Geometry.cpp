@@ -12,7 +12,7 @@ namespace ncine {
 Geometry::Geometry()
     : primitiveType_(GL_TRIANGLES), firstVertex_(0), numVertices_(0),
       numElementsPerVertex_(2), firstIndex_(0), numIndices_(0),
-      hostVertexPointer_(nullptr), hostIndexPointer_(nullptr),
+      hostVertexPointer_(nullptr), hostIndexPointer_(nullptr), hasInstanceAttributes_(false),
       vboUsageFlags_(0), sharedVboParams_(nullptr),
       iboUsageFlags_(0), sharedIboParams_(nullptr)
 {
@@ -184,7 +184,11 @@ void Geometry::bind()
 
 void Geometry::draw(GLsizei numInstances)
 {
-	const GLint vboOffset = static_cast<GLint>(vboParams().offset / numElementsPerVertex_ / sizeof(GLfloat)) + firstVertex_;
+	// When the VBO contains per-instance attributes its offset is applied as a base instance
+	const GLint vboOffset = hasInstanceAttributes_
+	                            ? firstVertex_
+	                            : static_cast<GLint>(vboParams().offset / numElementsPerVertex_ / sizeof(GLfloat)) + firstVertex_;
+	const GLuint baseInstance = hasInstanceAttributes_ ? static_cast<GLuint>(vboParams().offset / numElementsPerVertex_ / sizeof(GLfloat)) : 0;
 
 	void *iboOffsetPtr = nullptr;
 	if (numIndices_ > 0)
@@ -210,7 +214,21 @@ void Geometry::draw(GLsizei numInstances)
 			glDrawElementsInstancedBaseVertex(primitiveType_, numIndices_, GL_UNSIGNED_SHORT, iboOffsetPtr, numInstances, vboOffset);
 #endif
 		else
+#if defined(__ANDROID__) || defined(WITH_ANGLE) || defined(__EMSCRIPTEN__) || defined(__APPLE__)
+		{
+			// Instanced batching is disabled when there is no base instance support
+			ASSERT(baseInstance == 0);
 			glDrawArraysInstanced(primitiveType_, vboOffset, numVertices_, numInstances);
+		}
+#else
+		{
+			// The base instance entry point is only available with OpenGL 4.2 or `GL_ARB_base_instance`
+			if (baseInstance > 0)
+				glDrawArraysInstancedBaseInstance(primitiveType_, vboOffset, numVertices_, numInstances, baseInstance);
+			else
+				glDrawArraysInstanced(primitiveType_, vboOffset, numVertices_, numInstances);
+		}
+#endif
 	}
 }
 
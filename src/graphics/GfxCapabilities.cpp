@@ -90,12 +90,14 @@ void GfxCapabilities::init()
 #ifndef __EMSCRIPTEN__
 	const char *extensionNames[GLExtensions::COUNT] = {
 		"GL_KHR_debug", "GL_ARB_texture_storage", "GL_EXT_texture_compression_s3tc", "GL_OES_compressed_ETC1_RGB8_texture",
-		"GL_AMD_compressed_ATC_texture", "GL_IMG_texture_compression_pvrtc", "GL_KHR_texture_compression_astc_ldr"
+		"GL_AMD_compressed_ATC_texture", "GL_IMG_texture_compression_pvrtc", "GL_KHR_texture_compression_astc_ldr",
+		"GL_ARB_get_program_binary", "GL_EXT_disjoint_timer_query", "GL_ARB_base_instance"
 	};
 #else
 	const char *extensionNames[GLExtensions::COUNT] = {
 		"GL_KHR_debug", "GL_ARB_texture_storage", "WEBGL_compressed_texture_s3tc", "WEBGL_compressed_texture_etc1",
-		"WEBGL_compressed_texture_atc", "WEBGL_compressed_texture_pvrtc", "WEBGL_compressed_texture_astc"
+		"WEBGL_compressed_texture_atc", "WEBGL_compressed_texture_pvrtc", "WEBGL_compressed_texture_astc",
+		"GL_ARB_get_program_binary", "EXT_disjoint_timer_query_webgl2", "GL_ARB_base_instance"
 	};
 #endif
 
@@ -144,6 +146,9 @@ void GfxCapabilities::logGLCaps() const
 	LOGI_X("GL_AMD_compressed_ATC_texture: %d", glExtensions_[GLExtensions::AMD_COMPRESSED_ATC_TEXTURE]);
 	LOGI_X("GL_IMG_texture_compression_pvrtc: %d", glExtensions_[GLExtensions::IMG_TEXTURE_COMPRESSION_PVRTC]);
 	LOGI_X("GL_KHR_texture_compression_astc_ldr: %d", glExtensions_[GLExtensions::KHR_TEXTURE_COMPRESSION_ASTC_LDR]);
+	LOGI_X("GL_ARB_get_program_binary: %d", glExtensions_[GLExtensions::ARB_GET_PROGRAM_BINARY]);
+	LOGI_X("GL_EXT_disjoint_timer_query: %d", glExtensions_[GLExtensions::EXT_DISJOINT_TIMER_QUERY]);
+	LOGI_X("GL_ARB_base_instance: %d", glExtensions_[GLExtensions::ARB_BASE_INSTANCE]);
 	LOGI("--- OpenGL device capabilities ---");
 }
 
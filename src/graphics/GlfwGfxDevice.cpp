@@ -107,8 +107,9 @@ bool GlfwGfxDevice::setVideoMode(unsigned int index)
 
 void GlfwGfxDevice::updateVideoModes()
 {
-	int count;
-	const GLFWvidmode *modes = glfwGetVideoModes(glfwGetPrimaryMonitor(), &count);
+	int count = 0;
+	GLFWmonitor *primaryMonitor = glfwGetPrimaryMonitor();
+	const GLFWvidmode *modes = (primaryMonitor != nullptr) ? glfwGetVideoModes(primaryMonitor, &count) : nullptr;
 	numVideoModes_ = (count < MaxVideoModes) ? count : MaxVideoModes;
 
 	for (unsigned int i = 0; i < numVideoModes_; i++)
@@ -127,6 +128,11 @@ void GlfwGfxDevice::initGraphics()
 {
 #if GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 3
 	glfwInitHint(GLFW_JOYSTICK_HAT_BUTTONS, GLFW_FALSE);
+#endif
+#ifdef GLFW_PLATFORM_NULL
+	// The null platform does not need a display server, contexts are created through EGL
+	if (isHeadless_)
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
 #endif
 	glfwSetErrorCallback(errorCallback);
 	FATAL_ASSERT_MSG(glfwInit() == GL_TRUE, "glfwInit() failed");
@@ -137,13 +143,24 @@ void GlfwGfxDevice::initDevice()
 	// asking for a video mode that does not change current screen resolution
 	if (width_ == 0 || height_ == 0)
 	{
-		const GLFWvidmode *vidMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
-		width_ = vidMode->width;
-		height_ = vidMode->height;
+		GLFWmonitor *primaryMonitor = glfwGetPrimaryMonitor();
+		const GLFWvidmode *vidMode = (primaryMonitor != nullptr) ? glfwGetVideoMode(primaryMonitor) : nullptr;
+		if (vidMode != nullptr)
+		{
+			width_ = vidMode->width;
+			height_ = vidMode->height;
+		}
+		else
+		{
+			width_ = DefaultHeadlessWidth;
+			height_ = DefaultHeadlessHeight;
+		}
 	}
 
 	GLFWmonitor *monitor = nullptr;
-	if (isFullScreen_)
+	if (isHeadless_)
+		isFullScreen_ = false;
+	else if (isFullScreen_)
 		monitor = glfwGetPrimaryMonitor();
 
 	// setting window hints and creating a window with GLFW
@@ -167,6 +184,13 @@ void GlfwGfxDevice::initDevice()
 	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, glContextInfo_.forwardCompatible ? GLFW_TRUE : GLFW_FALSE);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, glContextInfo_.coreProfile ? GLFW_OPENGL_CORE_PROFILE : GLFW_OPENGL_COMPAT_PROFILE);
 #endif
+	if (isHeadless_)
+	{
+		// With Mesa the EGL context can be surfaceless and rendered by llvmpipe (`EGL_PLATFORM=surfaceless`)
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_FOCUSED, GLFW_FALSE);
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+	}
 
 	windowHandle_ = glfwCreateWindow(width_, height_, "", monitor, nullptr);
 	FATAL_ASSERT_MSG(windowHandle_, "glfwCreateWindow() failed");
@@ -177,7 +201,8 @@ void GlfwGfxDevice::initDevice()
 	glfwSwapInterval(interval);
 
 #ifdef WITH_GLEW
-	const GLenum err = glewInit();
+	// There is no GLX display to query extensions from when the context has been created through EGL
+	const GLenum err = isHeadless_ ? glewContextInit() : glewInit();
 	FATAL_ASSERT_MSG_X(err == GLEW_OK, "GLEW error: %s", glewGetErrorString(err));
 
 	glContextInfo_.debugContext = glContextInfo_.debugContext && glewIsSupported("GL_ARB_debug_output");
@@ -53,7 +53,7 @@ EM_BOOL IGfxDevice::focus_callback(int eventType, const EmscriptenFocusEvent *ev
 IGfxDevice::IGfxDevice(const WindowMode &windowMode, const GLContextInfo &glContextInfo, const DisplayMode &displayMode)
     : width_(windowMode.width), height_(windowMode.height),
       isFullScreen_(windowMode.isFullScreen), isResizable_(windowMode.isResizable),
-      glContextInfo_(glContextInfo), displayMode_(displayMode), numVideoModes_(0)
+      isHeadless_(windowMode.isHeadless), glContextInfo_(glContextInfo), displayMode_(displayMode), numVideoModes_(0)
 {
 #ifdef __EMSCRIPTEN__
 	double cssWidth = 0.0;
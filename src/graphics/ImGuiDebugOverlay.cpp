@@ -1,6 +1,9 @@
 #include "imgui.h"
 #include "ImGuiDebugOverlay.h"
 #include "Application.h"
+#include "FramePacer.h"
+#include "FrameProfiler.h"
+#include "MemoryStatistics.h"
 #include "IInputManager.h"
 #include "InputEvents.h"
 
@@ -11,11 +14,16 @@
 
 #ifdef WITH_AUDIO
 	#include "IAudioPlayer.h"
+	#include "AudioStreamPlayer.h"
+	#include "AudioMixer.h"
 #endif
 
 #include "RenderStatistics.h"
 #ifdef WITH_LUA
+	#include <nctl/algorithms.h>
 	#include "LuaStatistics.h"
+	#include "LuaProfiler.h"
+	#include "FileSystem.h"
 #endif
 
 #ifdef WITH_RENDERDOC
@@ -55,6 +63,18 @@ namespace {
 		}
 	}
 
+#ifdef WITH_LUA
+	bool moreSelfTime(unsigned int a, unsigned int b)
+	{
+		return LuaProfiler::function(a).selfTicks > LuaProfiler::function(b).selfTicks;
+	}
+
+	bool moreAllocatedBytes(unsigned int a, unsigned int b)
+	{
+		return LuaProfiler::allocationSite(a).allocatedBytes > LuaProfiler::allocationSite(b).allocatedBytes;
+	}
+#endif
+
 }
 
 ///////////////////////////////////////////////////////////
@@ -267,6 +287,9 @@ void ImGuiDebugOverlay::guiWindow()
 		guiWindowSettings();
 		guiAudioPlayers();
 		guiInputState();
+		guiFrameProfiler();
+		guiMemoryStatistics();
+		guiLuaProfiler();
 		guiRenderDoc();
 		guiNodeInspector();
 	}
@@ -473,6 +496,12 @@ void ImGuiDebugOverlay::guiPreprocessorDefines()
 #ifdef WITH_TRACY
 			ImGui::Text("WITH_TRACY");
 #endif
+#ifdef WITH_FRAME_PROFILER
+			ImGui::Text("WITH_FRAME_PROFILER");
+#endif
+#ifdef WITH_MEMORY_TAGS
+			ImGui::Text("WITH_MEMORY_TAGS");
+#endif
 #ifdef WITH_RENDERDOC
 			ImGui::Text("WITH_RENDERDOC");
 #endif
@@ -511,6 +540,7 @@ void ImGuiDebugOverlay::guiInitTimes()
 
 		ImGui::Text("Pre-Init Time: %.2fs", timings[Application::Timings::PRE_INIT]);
 		ImGui::Text("Init Time: %.2fs", timings[Application::Timings::INIT_COMMON]);
+		ImGui::Text("Render Resources Time: %.2fs", timings[Application::Timings::RENDER_RESOURCES]);
 		ImGui::Text("Application Init Time: %.2fs", timings[Application::Timings::APP_INIT]);
 	}
 }
@@ -566,6 +596,9 @@ void ImGuiDebugOverlay::guiGraphicsCapabilities()
 		ImGui::Text("GL_AMD_compressed_ATC_texture: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::AMD_COMPRESSED_ATC_TEXTURE));
 		ImGui::Text("GL_IMG_texture_compression_pvrtc: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::IMG_TEXTURE_COMPRESSION_PVRTC));
 		ImGui::Text("GL_KHR_texture_compression_astc_ldr: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::KHR_TEXTURE_COMPRESSION_ASTC_LDR));
+		ImGui::Text("GL_ARB_get_program_binary: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::ARB_GET_PROGRAM_BINARY));
+		ImGui::Text("GL_EXT_disjoint_timer_query: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::EXT_DISJOINT_TIMER_QUERY));
+		ImGui::Text("GL_ARB_base_instance: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::ARB_BASE_INSTANCE));
 	}
 }
 
@@ -590,6 +623,12 @@ void ImGuiDebugOverlay::guiApplicationConfiguration()
 		ImGui::Text("Full Screen: %s", appCfg.inFullscreen ? "true" : "false");
 		ImGui::Text("Resizable: %s", appCfg.isResizable ? "true" : "false");
 		ImGui::Text("Frame Limit: %u", appCfg.frameLimit);
+		ImGui::Text("Headless: %s", appCfg.isHeadless ? "true" : "false");
+		ImGui::Text("Fixed timestep: %f", appCfg.fixedTimestep);
+		ImGui::Text("Benchmark frames: %u", appCfg.benchmarkFrames);
+		ImGui::Text("Benchmark file: %s", appCfg.benchmarkFile.data());
+		ImGui::Text("Replay record file: %s", appCfg.replayRecordFile.data());
+		ImGui::Text("Replay playback file: %s", appCfg.replayPlaybackFile.data());
 
 		ImGui::Separator();
 		ImGui::Text("Window title: %s", appCfg.windowTitle.data());
@@ -598,14 +637,18 @@ void ImGuiDebugOverlay::guiApplicationConfiguration()
 		ImGui::Separator();
 		ImGui::Text("Buffer mapping: %s", appCfg.useBufferMapping ? "true" : "false");
 		ImGui::Text("Defer shader queries: %s", appCfg.deferShaderQueries ? "true" : "false");
+		ImGui::Text("Binary shader cache: %s (%s)", appCfg.useBinaryShaderCache ? "true" : "false", appCfg.shaderCacheDirname.data());
 		ImGui::Text("VBO size: %lu", appCfg.vboSize);
 		ImGui::Text("IBO size: %lu", appCfg.iboSize);
 		ImGui::Text("Vao pool size: %u", appCfg.vaoPoolSize);
+		ImGui::Text("Audio stream buffers: %u of %lu bytes", appCfg.audioStreamNumBuffers, appCfg.audioStreamBufferSize);
+		ImGui::Text("Audio mixer voices: %u", appCfg.audioMixerVoices);
 
 		ImGui::Separator();
 		ImGui::Text("Debug Overlay: %s", appCfg.withDebugOverlay ? "true" : "false");
 		ImGui::Text("Audio: %s", appCfg.withAudio ? "true" : "false");
 		ImGui::Text("Threads: %s", appCfg.withThreads ? "true" : "false");
+		ImGui::Text("Audio stream thread: %s", appCfg.withAudioStreamThread ? "true" : "false");
 		ImGui::Text("Scenegraph: %s", appCfg.withScenegraph ? "true" : "false");
 		ImGui::Text("VSync: %s", appCfg.withVSync ? "true" : "false");
 		ImGui::Text("OpenGL Debug Context: %s", appCfg.withGlDebugContext ? "true" : "false");
@@ -624,7 +667,24 @@ void ImGuiDebugOverlay::guiRenderingSettings()
 		ImGui::SameLine();
 		ImGui::Checkbox("Batching with indices", &settings.batchingWithIndices);
 		ImGui::SameLine();
+		ImGui::Checkbox("Batching with instancing", &settings.batchingWithInstancing);
+		ImGui::SameLine();
+		ImGui::Checkbox("Batching with reordering", &settings.batchingWithReordering);
+		ImGui::SameLine();
 		ImGui::Checkbox("Culling", &settings.cullingEnabled);
+#ifdef WITH_THREADS
+		if (theApplication().appConfiguration().withThreads)
+		{
+			ImGui::SameLine();
+			ImGui::Checkbox("Parallel visit", &settings.parallelVisit);
+		}
+#endif
+		ImGui::Checkbox("GPU timing", &settings.gpuTimingEnabled);
+		if (settings.gpuTimingEnabled)
+		{
+			ImGui::SameLine();
+			ImGui::Checkbox("Per command type", &settings.gpuTimingPerCommandType);
+		}
 		ImGui::DragIntRange2("Batch size", &minBatchSize, &maxBatchSize, 1.0f, 0, 512);
 
 		settings.minBatchSize = minBatchSize;
@@ -714,6 +774,10 @@ void ImGuiDebugOverlay::guiAudioPlayers()
 		ImGui::Text("Device Name: %s", theServiceLocator().audioDevice().name());
 		ImGui::Text("Listener Gain: %f", theServiceLocator().audioDevice().gain());
 
+		const AudioMixer *mixer = theServiceLocator().audioDevice().mixer();
+		if (mixer != nullptr)
+			ImGui::Text("Mixer Voices: %u / %u", mixer->numActiveVoices(), mixer->maxVoices());
+
 		unsigned int numPlayers = theServiceLocator().audioDevice().numPlayers();
 		ImGui::Text("Active Players: %d", numPlayers);
 
@@ -739,6 +803,12 @@ void ImGuiDebugOverlay::guiAudioPlayers()
 				ImGui::Text("Channels: %d", player->numChannels());
 				ImGui::Text("Frequency: %dHz", player->frequency());
 				ImGui::Text("Buffer Size: %lu bytes", player->bufferSize());
+				if (player->type() == Object::ObjectType::AUDIOSTREAM_PLAYER)
+				{
+					const AudioStreamPlayer *streamPlayer = static_cast<const AudioStreamPlayer *>(player);
+					ImGui::Text("Decoded Buffers: %u / %u", streamPlayer->numDecodedBuffers(), streamPlayer->numStreamBuffers());
+					ImGui::Text("Underruns: %u", streamPlayer->numUnderruns());
+				}
 				ImGui::NewLine();
 
 				ImGui::Text("State: %s", audioPlayerStateToString(player->state()));
@@ -884,6 +954,164 @@ void ImGuiDebugOverlay::guiInputState()
 	}
 }
 
+void ImGuiDebugOverlay::guiFrameProfiler()
+{
+	if (ImGui::CollapsingHeader("Frame Profiler"))
+	{
+		bool profilingEnabled = FrameProfiler::isEnabled();
+		if (ImGui::Checkbox("Enable profiling", &profilingEnabled))
+			FrameProfiler::setEnabled(profilingEnabled);
+		ImGui::SameLine();
+		if (ImGui::Button("Export frame capture"))
+			theApplication().exportFrameCapture();
+
+		ImGui::Text("Recording threads: %u", FrameProfiler::numThreads());
+		ImGui::Text("Marked frames: %lu (the last %u are exported)", FrameProfiler::numFrames(), FrameProfiler::MaxFrames);
+		ImGui::Text("Dropped zones: %u", FrameProfiler::numDroppedZones());
+#ifndef WITH_FRAME_PROFILER
+		ImGui::Text("Engine zones are not recorded, only the ones created by the application");
+#endif
+	}
+}
+
+void ImGuiDebugOverlay::guiMemoryStatistics()
+{
+	if (ImGui::CollapsingHeader("Memory Statistics"))
+	{
+		if (MemoryStatistics::isTrackingOperatorNew() == false)
+			ImGui::Text("Only the memory of Lua states with statistics is accounted, compile with NCINE_WITH_MEMORY_TAGS to track operator new");
+
+		ImGui::Columns(6, "###MemoryTags");
+		ImGui::Text("Tag");
+		ImGui::NextColumn();
+		ImGui::Text("Current Kb");
+		ImGui::NextColumn();
+		ImGui::Text("Peak Kb");
+		ImGui::NextColumn();
+		ImGui::Text("Allocations");
+		ImGui::NextColumn();
+		ImGui::Text("Frame allocs");
+		ImGui::NextColumn();
+		ImGui::Text("Frame frees");
+		ImGui::NextColumn();
+		ImGui::Separator();
+		for (unsigned int i = 0; i <= MemoryStatistics::Tags::COUNT; i++)
+		{
+			// The last row shows the statistics aggregated for all tags
+			const bool isTotal = (i == MemoryStatistics::Tags::COUNT);
+			const MemoryStatistics::Tags::Enum tag = static_cast<MemoryStatistics::Tags::Enum>(i);
+			const MemoryStatistics::TagStatistics stats = isTotal ? MemoryStatistics::allStatistics() : MemoryStatistics::statistics(tag);
+			if (isTotal)
+				ImGui::Separator();
+
+			ImGui::Text("%s", isTotal ? "total" : MemoryStatistics::tagName(tag));
+			ImGui::NextColumn();
+			ImGui::Text("%.2f", stats.currentBytes / 1024.0f);
+			ImGui::NextColumn();
+			ImGui::Text("%.2f", stats.peakBytes / 1024.0f);
+			ImGui::NextColumn();
+			ImGui::Text("%lld", static_cast<long long>(stats.allocations));
+			ImGui::NextColumn();
+			ImGui::Text("%u", stats.frameAllocations);
+			ImGui::NextColumn();
+			ImGui::Text("%u", stats.frameDeallocations);
+			ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+}
+
+void ImGuiDebugOverlay::guiLuaProfiler()
+{
+#ifdef WITH_LUA
+	if (LuaStatistics::numRegistered() == 0)
+		return;
+
+	if (ImGui::CollapsingHeader("Lua Profiler"))
+	{
+		bool profilingEnabled = LuaStatistics::isProfilingEnabled();
+		if (ImGui::Checkbox("Enable profiling", &profilingEnabled))
+			LuaStatistics::setProfilingEnabled(profilingEnabled);
+		ImGui::SameLine();
+		if (ImGui::Button("Reset"))
+			LuaProfiler::reset();
+		ImGui::SameLine();
+		if (ImGui::Button("Export flame graph"))
+		{
+			const nctl::String filename = fs::joinPath(fs::savePath(), "lua_profile.folded");
+			LuaProfiler::exportFoldedStacks(filename.data());
+		}
+
+		if (ImGui::TreeNodeEx("Callbacks", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			for (unsigned int i = 0; i < LuaProfiler::numCallbacks(); i++)
+			{
+				const LuaProfiler::CallbackEntry &callback = LuaProfiler::callback(i);
+				ImGui::Text("%s: %u calls, last %.3f ms, max %.3f ms, average %.3f ms",
+				            LuaProfiler::function(callback.functionIndex).name.data(), callback.numCalls,
+				            LuaProfiler::ticksToMilliseconds(callback.lastTicks), LuaProfiler::ticksToMilliseconds(callback.maxTicks),
+				            LuaProfiler::ticksToMilliseconds(callback.totalTicks) / callback.numCalls);
+			}
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNode("Functions"))
+		{
+			luaProfilerIndices_.clear();
+			for (unsigned int i = 0; i < LuaProfiler::numFunctions(); i++)
+				luaProfilerIndices_.pushBack(i);
+			nctl::quicksort(luaProfilerIndices_.begin(), luaProfilerIndices_.end(), moreSelfTime);
+
+			ImGui::Columns(5, "###LuaFunctions");
+			ImGui::Text("Function");
+			ImGui::NextColumn();
+			ImGui::Text("Self ms");
+			ImGui::NextColumn();
+			ImGui::Text("Total ms");
+			ImGui::NextColumn();
+			ImGui::Text("Samples");
+			ImGui::NextColumn();
+			ImGui::Text("Allocations");
+			ImGui::NextColumn();
+			ImGui::Separator();
+			const unsigned int numRows = nctl::min(luaProfilerIndices_.size(), MaxLuaProfilerRows);
+			for (unsigned int i = 0; i < numRows; i++)
+			{
+				const LuaProfiler::FunctionEntry &function = LuaProfiler::function(luaProfilerIndices_[i]);
+				ImGui::Text("%s", function.name.data());
+				ImGui::NextColumn();
+				ImGui::Text("%.3f", LuaProfiler::ticksToMilliseconds(function.selfTicks));
+				ImGui::NextColumn();
+				ImGui::Text("%.3f", LuaProfiler::ticksToMilliseconds(function.totalTicks));
+				ImGui::NextColumn();
+				ImGui::Text("%u", function.numSamples);
+				ImGui::NextColumn();
+				ImGui::Text("%u (%zu Kb)", function.numAllocations, function.allocatedBytes / 1024);
+				ImGui::NextColumn();
+			}
+			ImGui::Columns(1);
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNode("Allocation Sites"))
+		{
+			luaProfilerIndices_.clear();
+			for (unsigned int i = 0; i < LuaProfiler::numAllocationSites(); i++)
+				luaProfilerIndices_.pushBack(i);
+			nctl::quicksort(luaProfilerIndices_.begin(), luaProfilerIndices_.end(), moreAllocatedBytes);
+
+			const unsigned int numRows = nctl::min(luaProfilerIndices_.size(), MaxLuaProfilerRows);
+			for (unsigned int i = 0; i < numRows; i++)
+			{
+				const LuaProfiler::AllocationSite &site = LuaProfiler::allocationSite(luaProfilerIndices_[i]);
+				ImGui::Text("%s: %u allocations, %zu Kb", site.location.data(), site.numAllocations, site.allocatedBytes / 1024);
+			}
+			ImGui::TreePop();
+		}
+	}
+#endif
+}
+
 void ImGuiDebugOverlay::guiRenderDoc()
 {
 #ifdef WITH_RENDERDOC
@@ -1172,6 +1400,7 @@ void ImGuiDebugOverlay::guiNodeInspector()
 void ImGuiDebugOverlay::guiTopLeft()
 {
 	const RenderStatistics::VaoPool &vaoPool = RenderStatistics::vaoPool();
+	const RenderStatistics::StateChanges &stateChanges = RenderStatistics::allStateChanges();
 	const RenderStatistics::Textures &textures = RenderStatistics::textures();
 	const RenderStatistics::CustomBuffers &customVbos = RenderStatistics::customVBOs();
 	const RenderStatistics::CustomBuffers &customIbos = RenderStatistics::customIBOs();
@@ -1195,7 +1424,14 @@ void ImGuiDebugOverlay::guiTopLeft()
 			ImGui::PlotLines("", plotValues_[ValuesType::CULLED_NODES].get(), numValues_, 0, nullptr, 0.0f, FLT_MAX);
 		}
 
-		ImGui::Text("%u/%u VAOs (%u reuses, %u bindings)", vaoPool.size, vaoPool.capacity, vaoPool.reuses, vaoPool.bindings);
+		ImGui::Text("%u/%u VAOs (%u hits, %u reuses, %u bindings)", vaoPool.size, vaoPool.capacity, vaoPool.hits, vaoPool.reuses, vaoPool.bindings);
+		ImGui::Text("%u state changes (%u skipped)", stateChanges.issued, stateChanges.skipped);
+		if (theApplication().renderingSettings().batchingWithReordering)
+		{
+			const RenderStatistics::Reordering &reordering = RenderStatistics::reordering();
+			ImGui::Text("%u/%u transparent batches after/before reordering (%u moved)", reordering.batchesAfter, reordering.batchesBefore, reordering.movedCommands);
+		}
+		ImGui::Text("%u text lines relaid (%u reused)", RenderStatistics::relaidTextLines(), RenderStatistics::reusedTextLines());
 		ImGui::Text("%.2f Kb in %u Texture(s)", textures.dataSize / 1024.0f, textures.count);
 		ImGui::Text("%.2f Kb in %u custom VBO(s)", customVbos.dataSize / 1024.0f, customVbos.count);
 		ImGui::Text("%.2f Kb in %u custom IBO(s)", customIbos.dataSize / 1024.0f, customIbos.count);
@@ -1235,6 +1471,13 @@ void ImGuiDebugOverlay::guiTopRight()
 	if (showTopRightOverlay_ && ImGui::Begin("###Top-Right", nullptr, windowFlags))
 	{
 		ImGui::Text("FPS: %.0f (%.2fms)", 1.0f / theApplication().interval(), theApplication().interval() * 1000.0f);
+		ImGui::Text("Frame time deviation: %.2fms (max %.2fms)", theApplication().intervalDeviation() * 1000.0f, theApplication().maxInterval() * 1000.0f);
+		const FramePacer *framePacer = theApplication().framePacer();
+		if (framePacer)
+		{
+			ImGui::Text("Pacing: %u FPS, %lu missed, %.2fms sleep overshoot", framePacer->targetFps(),
+			            framePacer->numMissedDeadlines(), framePacer->sleepOvershoot() * 1000.0f);
+		}
 		ImGui::Text("Num Frames: %lu", theApplication().numFrames());
 
 		const AppConfiguration &appCfg = theApplication().appConfiguration();
@@ -1300,6 +1543,27 @@ void ImGuiDebugOverlay::guiTopRight()
 				ImGui::SameLine();
 				ImGui::PlotLines("", plotValues_[ValuesType::TOTAL_VERTICES].get(), numValues_, 0, nullptr, 0.0f, FLT_MAX);
 			}
+
+			const RenderStatistics::GpuTimes &gpuTimes = RenderStatistics::gpuTimes();
+			if (gpuTimes.available)
+			{
+				// The GPU is the bottleneck when it takes longer to render the queue than the CPU to update, visit and draw it
+				const float *timings = theApplication().timings();
+				const float cpuTime = (timings[Application::Timings::UPDATE] + timings[Application::Timings::VISIT] +
+				                       timings[Application::Timings::DRAW]) * 1000.0f;
+				ImGui::Text("GPU: %.2fms vs CPU: %.2fms (%u frames ago), %s-bound", gpuTimes.total, cpuTime,
+				            gpuTimes.latency, (gpuTimes.total > cpuTime) ? "GPU" : "CPU");
+				ImGui::Text("GPU phases: %.2fms commit, %.2fms opaques, %.2fms transparents",
+				            gpuTimes.phases[RenderStatistics::GpuPhases::COMMIT], gpuTimes.phases[RenderStatistics::GpuPhases::OPAQUES],
+				            gpuTimes.phases[RenderStatistics::GpuPhases::TRANSPARENTS]);
+				if (theApplication().renderingSettings().gpuTimingPerCommandType)
+				{
+					ImGui::Text("GPU types: %.2fms sprites, %.2fms mesh sprites, %.2fms particles, %.2fms text, %.2fms ImGui",
+					            gpuTimes.commandTypes[RenderCommand::CommandTypes::SPRITE], gpuTimes.commandTypes[RenderCommand::CommandTypes::MESH_SPRITE],
+					            gpuTimes.commandTypes[RenderCommand::CommandTypes::PARTICLE], gpuTimes.commandTypes[RenderCommand::CommandTypes::TEXT],
+					            gpuTimes.commandTypes[RenderCommand::CommandTypes::IMGUI]);
+				}
+			}
 		}
 		ImGui::End();
 	}
@@ -1342,7 +1606,7 @@ void ImGuiDebugOverlay::guiBottomRight()
 	if (showBottomRightOverlay_ && ImGui::Begin("###Bottom-Right", nullptr, windowFlags))
 	{
 		ImGui::Text("%u Lua state(s) with %u tracked userdata", LuaStatistics::numRegistered(), LuaStatistics::numTrackedUserDatas());
-		ImGui::Text("Used memory: %zu Kb", LuaStatistics::usedMemory() / 1024);
+		ImGui::Text("Used memory: %zu Kb, Pools: %zu Kb", LuaStatistics::usedMemory() / 1024, LuaStatistics::poolsMemory() / 1024);
 		if (plotOverlayValues_)
 		{
 			ImGui::SameLine();
@@ -1356,6 +1620,9 @@ void ImGuiDebugOverlay::guiBottomRight()
 			ImGui::PlotLines("", plotValues_[ValuesType::LUA_OPERATIONS].get(), numValues_, 0, nullptr, 0.0f, FLT_MAX);
 		}
 
+		ImGui::Text("GC: %.2f ms/frame, max pause: %.2f ms, %u cycles",
+		            LuaStatistics::gcFrameTime(), LuaStatistics::maxGcPause(), LuaStatistics::numGcCycles());
+
 		ImGui::Text("Textures: %u, Sprites: %u, Mesh sprites: %u",
 		            LuaStatistics::numTypedUserDatas(LuaTypes::UserDataType::TEXTURE),
 		            LuaStatistics::numTypedUserDatas(LuaTypes::UserDataType::SPRITE),
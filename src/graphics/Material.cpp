@@ -35,6 +35,16 @@ void Material::setBlendingFactors(GLenum srcBlendingFactor, GLenum destBlendingF
 	destBlendingFactor_ = destBlendingFactor;
 }
 
+namespace {
+
+	void setInstanceAttribute(GLVertexFormat::Attribute *attribute, size_t offset)
+	{
+		attribute->setVboParameters(sizeof(RenderResources::InstanceFormatSprite), reinterpret_cast<void *>(offset));
+		attribute->setDivisor(1);
+	}
+
+}
+
 void Material::setShaderProgramType(ShaderProgramType shaderProgramType)
 {
 	switch (shaderProgramType)
@@ -57,6 +67,12 @@ void Material::setShaderProgramType(ShaderProgramType shaderProgramType)
 		case ShaderProgramType::TEXTNODE_RED:
 			setShaderProgram(RenderResources::textnodeRedShaderProgram());
 			break;
+		case ShaderProgramType::TEXTNODE_SDF:
+			setShaderProgram(RenderResources::textnodeSdfShaderProgram());
+			break;
+		case ShaderProgramType::TEXTNODE_MSDF:
+			setShaderProgram(RenderResources::textnodeMsdfShaderProgram());
+			break;
 		case ShaderProgramType::BATCHED_SPRITES:
 			setShaderProgram(RenderResources::batchedSpritesShaderProgram());
 			break;
@@ -75,6 +91,18 @@ void Material::setShaderProgramType(ShaderProgramType shaderProgramType)
 		case ShaderProgramType::BATCHED_TEXTNODES_RED:
 			setShaderProgram(RenderResources::batchedTextnodesRedShaderProgram());
 			break;
+		case ShaderProgramType::BATCHED_TEXTNODES_SDF:
+			setShaderProgram(RenderResources::batchedTextnodesSdfShaderProgram());
+			break;
+		case ShaderProgramType::BATCHED_TEXTNODES_MSDF:
+			setShaderProgram(RenderResources::batchedTextnodesMsdfShaderProgram());
+			break;
+		case ShaderProgramType::INSTANCED_SPRITES:
+			setShaderProgram(RenderResources::instancedSpritesShaderProgram());
+			break;
+		case ShaderProgramType::INSTANCED_SPRITES_GRAY:
+			setShaderProgram(RenderResources::instancedSpritesGrayShaderProgram());
+			break;
 		case ShaderProgramType::CUSTOM:
 			break;
 	}
@@ -95,6 +123,8 @@ void Material::setShaderProgramType(ShaderProgramType shaderProgramType)
 			break;
 		case ShaderProgramType::TEXTNODE_ALPHA:
 		case ShaderProgramType::TEXTNODE_RED:
+		case ShaderProgramType::TEXTNODE_SDF:
+		case ShaderProgramType::TEXTNODE_MSDF:
 			setUniformsDataPointer(nullptr);
 			uniform("uTexture")->setIntValue(0); // GL_TEXTURE0
 			attribute("aPosition")->setVboParameters(sizeof(RenderResources::VertexFormatPos2Tex2), reinterpret_cast<void *>(offsetof(RenderResources::VertexFormatPos2Tex2, position)));
@@ -113,11 +143,25 @@ void Material::setShaderProgramType(ShaderProgramType shaderProgramType)
 			break;
 		case ShaderProgramType::BATCHED_TEXTNODES_ALPHA:
 		case ShaderProgramType::BATCHED_TEXTNODES_RED:
+		case ShaderProgramType::BATCHED_TEXTNODES_SDF:
+		case ShaderProgramType::BATCHED_TEXTNODES_MSDF:
 			attribute("aPosition")->setVboParameters(sizeof(RenderResources::VertexFormatPos2Tex2Index), reinterpret_cast<void *>(offsetof(RenderResources::VertexFormatPos2Tex2Index, position)));
 			attribute("aTexCoords")->setVboParameters(sizeof(RenderResources::VertexFormatPos2Tex2Index), reinterpret_cast<void *>(offsetof(RenderResources::VertexFormatPos2Tex2Index, texcoords)));
 			attribute("aMeshIndex")->setVboParameters(sizeof(RenderResources::VertexFormatPos2Tex2Index), reinterpret_cast<void *>(offsetof(RenderResources::VertexFormatPos2Tex2Index, drawindex)));
 			// Uniforms data pointer not set at this time
 			break;
+		case ShaderProgramType::INSTANCED_SPRITES:
+		case ShaderProgramType::INSTANCED_SPRITES_GRAY:
+			setUniformsDataPointer(nullptr);
+			uniform("uTexture")->setIntValue(0); // GL_TEXTURE0
+			setInstanceAttribute(attribute("aModelView0"), offsetof(RenderResources::InstanceFormatSprite, modelView));
+			setInstanceAttribute(attribute("aModelView1"), offsetof(RenderResources::InstanceFormatSprite, modelView) + 4 * sizeof(GLfloat));
+			setInstanceAttribute(attribute("aModelView2"), offsetof(RenderResources::InstanceFormatSprite, modelView) + 8 * sizeof(GLfloat));
+			setInstanceAttribute(attribute("aModelView3"), offsetof(RenderResources::InstanceFormatSprite, modelView) + 12 * sizeof(GLfloat));
+			setInstanceAttribute(attribute("aColor"), offsetof(RenderResources::InstanceFormatSprite, color));
+			setInstanceAttribute(attribute("aTexRect"), offsetof(RenderResources::InstanceFormatSprite, texRect));
+			setInstanceAttribute(attribute("aSpriteSize"), offsetof(RenderResources::InstanceFormatSprite, spriteSize));
+			break;
 		case ShaderProgramType::CUSTOM:
 			break;
 	}
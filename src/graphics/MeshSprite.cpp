@@ -78,6 +78,7 @@ void MeshSprite::copyVertices(unsigned int numVertices, const Vertex *vertices)
 	numVertices_ = numVertices;
 	renderCommand_->geometry().setNumVertices(numVertices);
 	renderCommand_->geometry().setHostVertexPointer(reinterpret_cast<const float *>(vertexDataPointer_));
+	invalidateParentRecordedCommands();
 }
 
 void MeshSprite::copyVertices(const MeshSprite &meshSprite)
@@ -95,6 +96,7 @@ void MeshSprite::setVertices(unsigned int numVertices, const Vertex *vertices)
 	numVertices_ = numVertices;
 	renderCommand_->geometry().setNumVertices(numVertices);
 	renderCommand_->geometry().setHostVertexPointer(reinterpret_cast<const float *>(vertexDataPointer_));
+	invalidateParentRecordedCommands();
 }
 
 void MeshSprite::setVertices(const MeshSprite &meshSprite)
@@ -154,6 +156,7 @@ void MeshSprite::createVerticesFromTexels(unsigned int numVertices, const Vector
 	numVertices_ = numVertices;
 	renderCommand_->geometry().setNumVertices(numVertices);
 	renderCommand_->geometry().setHostVertexPointer(reinterpret_cast<const float *>(vertexDataPointer_));
+	invalidateParentRecordedCommands();
 }
 
 void MeshSprite::createVerticesFromTexels(unsigned int numVertices, const Vector2f *points)
@@ -171,6 +174,7 @@ void MeshSprite::copyIndices(unsigned int numIndices, const unsigned short *indi
 	numIndices_ = numIndices;
 	renderCommand_->geometry().setNumIndices(numIndices_);
 	renderCommand_->geometry().setHostIndexPointer(indexDataPointer_);
+	invalidateParentRecordedCommands();
 }
 
 void MeshSprite::copyIndices(const MeshSprite &meshSprite)
@@ -186,6 +190,7 @@ void MeshSprite::setIndices(unsigned int numIndices, const unsigned short *indic
 	numIndices_ = numIndices;
 	renderCommand_->geometry().setNumIndices(numIndices_);
 	renderCommand_->geometry().setHostIndexPointer(indexDataPointer_);
+	invalidateParentRecordedCommands();
 }
 
 void MeshSprite::setIndices(const MeshSprite &meshSprite)
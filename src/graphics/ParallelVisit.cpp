@@ -0,0 +1,116 @@
+#include "ParallelVisit.h"
+#include "SceneNode.h"
+#include "RenderQueue.h"
+#include "ServiceLocator.h"
+#include "MemoryStatistics.h"
+#include "tracy.h"
+
+namespace ncine {
+
+/// The thread command that visits a range of root children on a worker thread
+class ParallelVisit::VisitCommand : public IThreadCommand
+{
+  public:
+	VisitCommand(ParallelVisit &parallelVisit, unsigned int jobIndex)
+	    : parallelVisit_(parallelVisit), jobIndex_(jobIndex) {}
+
+	void execute() override
+	{
+		ZoneScopedN("Visit job");
+		MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::SCENEGRAPH);
+		parallelVisit_.visitChildren(jobIndex_, *parallelVisit_.jobQueues_[jobIndex_ - 1]);
+		parallelVisit_.signalJobDone();
+	}
+
+  private:
+	ParallelVisit &parallelVisit_;
+	unsigned int jobIndex_;
+};
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+ParallelVisit::ParallelVisit(unsigned int maxJobs)
+    : jobQueues_(maxJobs > 1 ? maxJobs - 1 : 1), rootNode_(nullptr), childrenPerJob_(0), pendingJobs_(0)
+{
+	for (unsigned int i = 1; i < maxJobs; i++)
+		jobQueues_.pushBack(nctl::makeUnique<RenderQueue>(false));
+}
+
+ParallelVisit::~ParallelVisit() = default;
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void ParallelVisit::visit(SceneNode &rootNode, RenderQueue &renderQueue)
+{
+	const unsigned int numChildren = rootNode.children().size();
+	unsigned int numJobs = numChildren / MinChildrenPerJob;
+	if (numJobs > jobQueues_.size() + 1)
+		numJobs = jobQueues_.size() + 1;
+
+	if (numJobs <= 1)
+	{
+		rootNode.visit(renderQueue);
+		return;
+	}
+
+	rootNode_ = &rootNode;
+	childrenPerJob_ = (numChildren + numJobs - 1) / numJobs;
+	pendingJobs_ = numJobs - 1;
+
+	IThreadPool &threadPool = theServiceLocator().threadPool();
+	for (unsigned int i = 1; i < numJobs; i++)
+		threadPool.enqueueCommand(nctl::makeUnique<VisitCommand>(*this, i));
+
+	// The calling thread takes care of the first job
+	visitChildren(0, renderQueue);
+
+	jobsMutex_.lock();
+	while (pendingJobs_ > 0)
+		jobsCV_.wait(jobsMutex_);
+	jobsMutex_.unlock();
+
+	// Merging in job order keeps the queue content independent from the workers scheduling
+	for (unsigned int i = 1; i < numJobs; i++)
+	{
+		renderQueue.appendCommands(*jobQueues_[i - 1]);
+		jobQueues_[i - 1]->clearCommands();
+	}
+
+	rootNode_ = nullptr;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void ParallelVisit::visitChildren(unsigned int jobIndex, RenderQueue &renderQueue)
+{
+	const nctl::Array<SceneNode *> &children = rootNode_->children();
+	const unsigned int firstChild = jobIndex * childrenPerJob_;
+	const unsigned int lastChild = (firstChild + childrenPerJob_ < children.size()) ? firstChild + childrenPerJob_ : children.size();
+
+	for (unsigned int i = firstChild; i < lastChild; i++)
+	{
+		SceneNode *child = children[i];
+		if (child->drawEnabled())
+		{
+			child->draw(renderQueue);
+			child->visit(renderQueue);
+		}
+	}
+}
+
+void ParallelVisit::signalJobDone()
+{
+	jobsMutex_.lock();
+	pendingJobs_--;
+	if (pendingJobs_ == 0)
+		jobsCV_.signal();
+	jobsMutex_.unlock();
+}
+
+}
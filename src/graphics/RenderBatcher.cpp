@@ -1,6 +1,8 @@
 #include <cstring> // for memcpy()
+#include <nctl/algorithms.h>
 #include "RenderBatcher.h"
 #include "RenderResources.h" // TODO: Remove dependency?
+#include "RenderStatistics.h"
 #include "Application.h"
 
 namespace ncine {
@@ -16,11 +18,20 @@ unsigned int RenderBatcher::UboMaxSize = 0;
 ///////////////////////////////////////////////////////////
 
 RenderBatcher::RenderBatcher()
-    : buffers_(1), freeCommandsPool_(16), usedCommandsPool_(16)
+    : buffers_(1), freeCommandsPool_(16), usedCommandsPool_(16), reorderedFlags_(16), skippedIndices_(16),
+      hasBaseInstance_(false)
 {
 	const IGfxCapabilities &gfxCaps = theServiceLocator().gfxCapabilities();
 	const int maxUniformBlockSize = gfxCaps.value(IGfxCapabilities::GLIntValues::MAX_UNIFORM_BLOCK_SIZE);
 
+#if !defined(__ANDROID__) && !defined(WITH_ANGLE) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+	const int glMajorVersion = gfxCaps.glVersion(IGfxCapabilities::GLVersion::MAJOR);
+	const int glMinorVersion = gfxCaps.glVersion(IGfxCapabilities::GLVersion::MINOR);
+	// Base instance is core since OpenGL 4.2
+	hasBaseInstance_ = (glMajorVersion > 4 || (glMajorVersion == 4 && glMinorVersion >= 2)) ||
+	                   gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::ARB_BASE_INSTANCE);
+#endif
+
 	// Clamping the value as some drivers report a maximum size similar to SSBO one
 	UboMaxSize = maxUniformBlockSize <= 64 * 1024 ? maxUniformBlockSize : 64 * 1024;
 
@@ -41,7 +52,15 @@ namespace {
 		        type == Material::ShaderProgramType::MESH_SPRITE ||
 		        type == Material::ShaderProgramType::MESH_SPRITE_GRAY ||
 		        type == Material::ShaderProgramType::TEXTNODE_ALPHA ||
-		        type == Material::ShaderProgramType::TEXTNODE_RED);
+		        type == Material::ShaderProgramType::TEXTNODE_RED ||
+		        type == Material::ShaderProgramType::TEXTNODE_SDF ||
+		        type == Material::ShaderProgramType::TEXTNODE_MSDF);
+	}
+
+	bool isInstanceableType(Material::ShaderProgramType type)
+	{
+		return (type == Material::ShaderProgramType::SPRITE ||
+		        type == Material::ShaderProgramType::SPRITE_GRAY);
 	}
 
 	bool isBatchedSprite(Material::ShaderProgramType type)
@@ -59,9 +78,46 @@ namespace {
 	bool isBatchedTextnode(Material::ShaderProgramType type)
 	{
 		return (type == Material::ShaderProgramType::BATCHED_TEXTNODES_ALPHA ||
-		        type == Material::ShaderProgramType::BATCHED_TEXTNODES_RED);
+		        type == Material::ShaderProgramType::BATCHED_TEXTNODES_RED ||
+		        type == Material::ShaderProgramType::BATCHED_TEXTNODES_SDF ||
+		        type == Material::ShaderProgramType::BATCHED_TEXTNODES_MSDF);
+	}
+
+	/// Returns true if the two commands can be part of the same batch
+	bool areCompatible(const RenderCommand &prevCommand, const RenderCommand &command)
+	{
+		const Material &prevMaterial = prevCommand.material();
+		const Material &material = command.material();
+
+		// Always false for the opaque queue as blending is not enabled for any of the commands
+		const bool blendingDiffers = material.isBlendingEnabled() && prevMaterial.isBlendingEnabled() &&
+		                             (prevMaterial.srcBlendingFactor() != material.srcBlendingFactor() ||
+		                              prevMaterial.destBlendingFactor() != material.destBlendingFactor());
+
+		// Not compatible if the shader differs or if it's the same but texture, blending or primitive type aren't
+		return (prevMaterial.shaderProgramType() == material.shaderProgramType() &&
+		        prevMaterial.texture() == material.texture() &&
+		        prevCommand.geometry().primitiveType() == command.geometry().primitiveType() &&
+		        blendingDiffers == false);
 	}
 
+	/// Counts the runs of commands that could be collected in a batch, without considering the batch sizes
+	unsigned int countBatches(const nctl::Array<RenderCommand *> &queue)
+	{
+		unsigned int numBatches = queue.isEmpty() ? 0 : 1;
+		for (unsigned int i = 1; i < queue.size(); i++)
+		{
+			if (isSupportedType(queue[i]->material().shaderProgramType()) == false || areCompatible(*queue[i - 1], *queue[i]) == false)
+				numBatches++;
+		}
+		return numBatches;
+	}
+
+	/// Maximum number of commands following a batch candidate that are searched for compatible ones
+	const unsigned int ReorderingWindow = 64;
+	/// Maximum number of commands that a compatible command can be moved before
+	const unsigned int MaxSkippedCommands = 16;
+
 }
 
 void RenderBatcher::createBatches(const nctl::Array<RenderCommand *> &srcQueue, nctl::Array<RenderCommand *> &destQueue)
@@ -74,40 +130,27 @@ void RenderBatcher::createBatches(const nctl::Array<RenderCommand *> &srcQueue,
 	const unsigned int minBatchSize = theApplication().renderingSettings().minBatchSize;
 	const unsigned int maxBatchSize = theApplication().renderingSettings().maxBatchSize;
 #endif
+	// Per-instance attributes are offset in the common VBO with a base instance, not in the VAO definition
+	const bool batchingWithInstancing = theApplication().renderingSettings().batchingWithInstancing && hasBaseInstance_;
 
 	unsigned int lastSplit = 0;
 
 	for (unsigned int i = 1; i < srcQueue.size(); i++)
 	{
 		const RenderCommand *command = srcQueue[i];
-		const Material::ShaderProgramType type = command->material().shaderProgramType();
-		const GLTexture *texture = command->material().texture();
-		const bool isBlendingEnabled = command->material().isBlendingEnabled();
-		const GLenum srcBlendingFactor = command->material().srcBlendingFactor();
-		const GLenum destBlendingFactor = command->material().destBlendingFactor();
-		const GLenum primitive = command->geometry().primitiveType();
-
 		const RenderCommand *prevCommand = srcQueue[i - 1];
 		const Material::ShaderProgramType prevType = prevCommand->material().shaderProgramType();
-		const GLTexture *prevTexture = prevCommand->material().texture();
-		const bool prevIsBlendingEnabled = prevCommand->material().isBlendingEnabled();
-		const GLenum prevSrcBlendingFactor = prevCommand->material().srcBlendingFactor();
-		const GLenum prevDestBlendingFactor = prevCommand->material().destBlendingFactor();
-		const GLenum prevPrimitive = prevCommand->geometry().primitiveType();
-
-		// Always false for the opaque queue as blending is not enabled for any of the commands
-		const bool blendingDiffers = isBlendingEnabled && prevIsBlendingEnabled &&
-		                             (prevSrcBlendingFactor != srcBlendingFactor || prevDestBlendingFactor != destBlendingFactor);
 
-		// Should split if the shader differs or if it's the same but texture, blending or primitive type aren't
-		const bool shouldSplit = prevType != type || prevTexture != texture || prevPrimitive != primitive || blendingDiffers;
+		const bool shouldSplit = (areCompatible(*prevCommand, *command) == false);
 
 		// Also collect the very last command if it can be batched with the previous one
 		unsigned int endSplit = (i == srcQueue.size() - 1 && !shouldSplit) ? i + 1 : i;
 
 		const unsigned int batchSize = endSplit - lastSplit;
+		// Instanced batches are only limited by the amount of per-instance data a VBO can hold
+		const bool instancedBatch = batchingWithInstancing && isInstanceableType(prevType);
 		// Split point if last command or split condition
-		if (i == srcQueue.size() - 1 || shouldSplit || batchSize > maxBatchSize - 1)
+		if (i == srcQueue.size() - 1 || shouldSplit || (instancedBatch == false && batchSize > maxBatchSize - 1))
 		{
 			if (isSupportedType(prevType) && batchSize >= minBatchSize)
 			{
@@ -115,8 +158,8 @@ void RenderBatcher::createBatches(const nctl::Array<RenderCommand *> &srcQueue,
 				nctl::Array<RenderCommand *>::ConstIterator end = srcQueue.cBegin() + endSplit;
 				while (start != end)
 				{
-					// Handling early splits while collecting (not enough UBO free space)
-					RenderCommand *batchCommand = collectCommands(start, end, start);
+					// Handling early splits while collecting (not enough UBO or VBO free space)
+					RenderCommand *batchCommand = instancedBatch ? collectInstances(start, end, start) : collectCommands(start, end, start);
 					destQueue.pushBack(batchCommand);
 				}
 
@@ -142,6 +185,85 @@ void RenderBatcher::createBatches(const nctl::Array<RenderCommand *> &srcQueue,
 		destQueue.pushBack(srcQueue[0]);
 }
 
+/*! Commands are moved before the ones they have been sorted after only if their bounding boxes don't overlap,
+ *  preserving the result of blending. A command without a bounding box is never moved and no command is moved before it. */
+void RenderBatcher::reorderCommands(const nctl::Array<RenderCommand *> &srcQueue, nctl::Array<RenderCommand *> &destQueue)
+{
+	reorderedFlags_.clear();
+	for (unsigned int i = 0; i < srcQueue.size(); i++)
+		reorderedFlags_.pushBack(false);
+
+	unsigned int numMovedCommands = 0;
+	for (unsigned int i = 0; i < srcQueue.size(); i++)
+	{
+		if (reorderedFlags_[i])
+			continue;
+
+		const RenderCommand *firstCommand = srcQueue[i];
+		destQueue.pushBack(srcQueue[i]);
+		reorderedFlags_[i] = true;
+		if (isSupportedType(firstCommand->material().shaderProgramType()) == false)
+			continue;
+
+		skippedIndices_.clear();
+		// The union of the bounding boxes of skipped commands quickly accepts the ones that don't overlap
+		Rectf skippedAabb;
+		const unsigned int windowEnd = nctl::min(i + 1 + ReorderingWindow, srcQueue.size());
+		for (unsigned int j = i + 1; j < windowEnd; j++)
+		{
+			if (reorderedFlags_[j])
+				continue;
+
+			RenderCommand *command = srcQueue[j];
+			bool canBeMoved = areCompatible(*firstCommand, *command);
+			if (canBeMoved && skippedIndices_.isEmpty() == false)
+			{
+				canBeMoved = command->hasAabb();
+				if (canBeMoved && command->aabb().overlaps(skippedAabb))
+				{
+					for (unsigned int k = 0; k < skippedIndices_.size(); k++)
+					{
+						if (command->aabb().overlaps(srcQueue[skippedIndices_[k]]->aabb()))
+						{
+							canBeMoved = false;
+							break;
+						}
+					}
+				}
+			}
+
+			if (canBeMoved)
+			{
+				destQueue.pushBack(command);
+				reorderedFlags_[j] = true;
+				if (skippedIndices_.isEmpty() == false)
+					numMovedCommands++;
+			}
+			else
+			{
+				// A command without a bounding box could overlap any other, nothing can be moved before it
+				if (command->hasAabb() == false || skippedIndices_.size() >= MaxSkippedCommands)
+					break;
+
+				const Rectf &aabb = command->aabb();
+				if (skippedIndices_.isEmpty())
+					skippedAabb = aabb;
+				else
+				{
+					const float minX = nctl::min(skippedAabb.x, aabb.x);
+					const float minY = nctl::min(skippedAabb.y, aabb.y);
+					const float maxX = nctl::max(skippedAabb.x + skippedAabb.w, aabb.x + aabb.w);
+					const float maxY = nctl::max(skippedAabb.y + skippedAabb.h, aabb.y + aabb.h);
+					skippedAabb.set(minX, minY, maxX - minX, maxY - minY);
+				}
+				skippedIndices_.pushBack(j);
+			}
+		}
+	}
+
+	RenderStatistics::addReordering(countBatches(srcQueue), countBatches(destQueue), numMovedCommands);
+}
+
 void RenderBatcher::reset()
 {
 	for (nctl::UniquePtr<RenderCommand> &command : usedCommandsPool_)
@@ -204,6 +326,16 @@ RenderCommand *RenderBatcher::collectCommands(
 		batchCommand = retrieveCommandFromPool(Material::ShaderProgramType::BATCHED_TEXTNODES_RED);
 		singleInstanceBlockSize = (*start)->material().uniformBlock("TextnodeBlock")->size();
 	}
+	else if (refCommand->material().shaderProgramType() == Material::ShaderProgramType::TEXTNODE_SDF)
+	{
+		batchCommand = retrieveCommandFromPool(Material::ShaderProgramType::BATCHED_TEXTNODES_SDF);
+		singleInstanceBlockSize = (*start)->material().uniformBlock("TextnodeBlock")->size();
+	}
+	else if (refCommand->material().shaderProgramType() == Material::ShaderProgramType::TEXTNODE_MSDF)
+	{
+		batchCommand = retrieveCommandFromPool(Material::ShaderProgramType::BATCHED_TEXTNODES_MSDF);
+		singleInstanceBlockSize = (*start)->material().uniformBlock("TextnodeBlock")->size();
+	}
 	else
 		FATAL_MSG("Unsupported shader for batch element");
 
@@ -403,6 +535,67 @@ RenderCommand *RenderBatcher::collectCommands(
 	return batchCommand;
 }
 
+RenderCommand *RenderBatcher::collectInstances(
+    nctl::Array<RenderCommand *>::ConstIterator start,
+    nctl::Array<RenderCommand *>::ConstIterator end,
+    nctl::Array<RenderCommand *>::ConstIterator &nextStart)
+{
+	ASSERT(end > start);
+
+	const RenderCommand *refCommand = *start;
+	RenderCommand *batchCommand = nullptr;
+
+	if (refCommand->material().shaderProgramType() == Material::ShaderProgramType::SPRITE)
+		batchCommand = retrieveCommandFromPool(Material::ShaderProgramType::INSTANCED_SPRITES);
+	else if (refCommand->material().shaderProgramType() == Material::ShaderProgramType::SPRITE_GRAY)
+		batchCommand = retrieveCommandFromPool(Material::ShaderProgramType::INSTANCED_SPRITES_GRAY);
+	else
+		FATAL_MSG("Unsupported shader for instanced batch element");
+
+	batchCommand->setType(refCommand->type());
+
+	// Don't request more bytes than a common VBO can hold
+	const unsigned long maxVertexDataSize = RenderResources::buffersManager().specs(RenderBuffersManager::BufferTypes::ARRAY).maxSize;
+	const unsigned int maxInstances = static_cast<unsigned int>(maxVertexDataSize / sizeof(RenderResources::InstanceFormatSprite));
+	const unsigned int numInstances = (static_cast<unsigned int>(end - start) > maxInstances) ? maxInstances : static_cast<unsigned int>(end - start);
+	nextStart = start + numInstances;
+
+	batchCommand->material().uniform("projection")->setFloatVector(RenderResources::projectionMatrix().data());
+
+	const unsigned int numFloatsPerInstance = sizeof(RenderResources::InstanceFormatSprite) / sizeof(GLfloat);
+	const unsigned int numFloats = numInstances * numFloatsPerInstance;
+	// Aligning the data to the instance size so that its offset is a whole number of instances
+	RenderResources::InstanceFormatSprite *destInstance = reinterpret_cast<RenderResources::InstanceFormatSprite *>(batchCommand->geometry().acquireVertexPointer(numFloats, numFloatsPerInstance));
+
+	nctl::Array<RenderCommand *>::ConstIterator it = start;
+	while (it != nextStart)
+	{
+		RenderCommand *command = *it;
+		command->commitTransformation();
+
+		// The per-instance attributes structure mirrors the beginning of the sprite uniform block
+		const GLUniformBlockCache *spriteBlock = command->material().uniformBlock("SpriteBlock");
+		ASSERT(spriteBlock->size() >= static_cast<GLint>(sizeof(RenderResources::InstanceFormatSprite)));
+		memcpy(destInstance, spriteBlock->dataPointer(), sizeof(RenderResources::InstanceFormatSprite));
+		destInstance++;
+
+		++it;
+	}
+
+	batchCommand->geometry().releaseVertexPointer();
+
+	batchCommand->material().setTexture(refCommand->material().texture());
+	batchCommand->material().setBlendingEnabled(refCommand->material().isBlendingEnabled());
+	batchCommand->material().setBlendingFactors(refCommand->material().srcBlendingFactor(), refCommand->material().destBlendingFactor());
+	batchCommand->setBatchSize(numInstances);
+	batchCommand->setNumInstances(numInstances);
+	batchCommand->geometry().setHasInstanceAttributes(true);
+	batchCommand->geometry().setNumElementsPerVertex(numFloatsPerInstance);
+	batchCommand->geometry().setDrawParameters(GL_TRIANGLE_STRIP, 0, 4);
+
+	return batchCommand;
+}
+
 RenderCommand *RenderBatcher::retrieveCommandFromPool(Material::ShaderProgramType shaderProgramType)
 {
 	RenderCommand *retrievedCommand = nullptr;
@@ -1,3 +1,4 @@
+#include <cmath>
 #include "RenderCommand.h"
 #include "GLShaderProgram.h"
 #include "GLScissorTest.h"
@@ -15,7 +16,11 @@ namespace {
 		        type == Material::ShaderProgramType::BATCHED_MESH_SPRITES ||
 		        type == Material::ShaderProgramType::BATCHED_MESH_SPRITES_GRAY ||
 		        type == Material::ShaderProgramType::BATCHED_TEXTNODES_ALPHA ||
-		        type == Material::ShaderProgramType::BATCHED_TEXTNODES_RED);
+		        type == Material::ShaderProgramType::BATCHED_TEXTNODES_RED ||
+		        type == Material::ShaderProgramType::BATCHED_TEXTNODES_SDF ||
+		        type == Material::ShaderProgramType::BATCHED_TEXTNODES_MSDF ||
+		        type == Material::ShaderProgramType::INSTANCED_SPRITES ||
+		        type == Material::ShaderProgramType::INSTANCED_SPRITES_GRAY);
 	}
 
 }
@@ -26,7 +31,7 @@ namespace {
 
 RenderCommand::RenderCommand(CommandTypes::Enum profilingType)
     : materialSortKey_(0), layer_(DrawableNode::LayerBase::LOWEST), numInstances_(0), batchSize_(0),
-      uniformBlocksCommitted_(false), verticesCommitted_(false), indicesCommitted_(false),
+      uniformBlocksCommitted_(false), verticesCommitted_(false), indicesCommitted_(false), hasAabb_(false),
       profilingType_(profilingType), modelView_(Matrix4x4f::Identity)
 {
 }
@@ -92,6 +97,16 @@ void RenderCommand::setScissor(GLint x, GLint y, GLsizei width, GLsizei height)
 	scissor_.height = height;
 }
 
+void RenderCommand::setAabb(const Rectf &aabb)
+{
+	// The bounding box of a node with a negative scale has a negative size
+	aabb_.x = (aabb.w >= 0.0f) ? aabb.x : aabb.x + aabb.w;
+	aabb_.y = (aabb.h >= 0.0f) ? aabb.y : aabb.y + aabb.h;
+	aabb_.w = fabsf(aabb.w);
+	aabb_.h = fabsf(aabb.h);
+	hasAabb_ = true;
+}
+
 void RenderCommand::commitTransformation()
 {
 	// `near` and `far` planes should be consistent with the projection matrix
@@ -113,7 +128,9 @@ void RenderCommand::commitTransformation()
 		         shaderProgramType == Material::ShaderProgramType::MESH_SPRITE_GRAY)
 			material_.uniformBlock("MeshSpriteBlock")->uniform("modelView")->setFloatVector(modelView_.data());
 		else if (shaderProgramType == Material::ShaderProgramType::TEXTNODE_ALPHA ||
-		         shaderProgramType == Material::ShaderProgramType::TEXTNODE_RED)
+		         shaderProgramType == Material::ShaderProgramType::TEXTNODE_RED ||
+		         shaderProgramType == Material::ShaderProgramType::TEXTNODE_SDF ||
+		         shaderProgramType == Material::ShaderProgramType::TEXTNODE_MSDF)
 			material_.uniformBlock("TextnodeBlock")->uniform("modelView")->setFloatVector(modelView_.data());
 		else if (!isBatchedType(shaderProgramType) && shaderProgramType != Material::ShaderProgramType::CUSTOM)
 			material_.uniform("modelView")->setFloatVector(modelView_.data());
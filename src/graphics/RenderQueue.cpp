@@ -2,6 +2,7 @@
 #include "RenderQueue.h"
 #include "RenderResources.h"
 #include "RenderStatistics.h"
+#include "RenderTimerQueries.h"
 #include "GLDebug.h"
 #include "Application.h"
 #include "GLScissorTest.h"
@@ -16,11 +17,23 @@ namespace ncine {
 ///////////////////////////////////////////////////////////
 
 RenderQueue::RenderQueue()
+    : RenderQueue(true)
+{
+}
+
+RenderQueue::RenderQueue(bool withBatcher)
     : debugGroupString_(64),
-      opaqueQueue_(16), opaqueBatchedQueue_(16), transparentQueue_(16), transparentBatchedQueue_(16)
+      opaqueQueue_(16), opaqueBatchedQueue_(16), transparentQueue_(16), transparentReorderedQueue_(16), transparentBatchedQueue_(16)
 {
+	if (withBatcher)
+	{
+		batcher_ = nctl::makeUnique<RenderBatcher>();
+		timerQueries_ = nctl::makeUnique<RenderTimerQueries>();
+	}
 }
 
+RenderQueue::~RenderQueue() = default;
+
 ///////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
@@ -36,6 +49,18 @@ void RenderQueue::addCommand(RenderCommand *command)
 		transparentQueue_.pushBack(command);
 }
 
+void RenderQueue::appendCommands(const RenderQueue &other)
+{
+	opaqueQueue_.insertRange(opaqueQueue_.size(), other.opaqueQueue_.data(), other.opaqueQueue_.data() + other.opaqueQueue_.size());
+	transparentQueue_.insertRange(transparentQueue_.size(), other.transparentQueue_.data(), other.transparentQueue_.data() + other.transparentQueue_.size());
+}
+
+void RenderQueue::clearCommands()
+{
+	opaqueQueue_.clear();
+	transparentQueue_.clear();
+}
+
 namespace {
 
 	bool descendingOrder(const RenderCommand *a, const RenderCommand *b)
@@ -75,10 +100,13 @@ namespace {
 
 void RenderQueue::draw()
 {
-	const bool batchingEnabled = theApplication().renderingSettings().batchingEnabled;
+	ASSERT(batcher_);
+	const Application::RenderingSettings &settings = theApplication().renderingSettings();
+	const bool batchingEnabled = settings.batchingEnabled;
 
 	// Reset all rendering statistics
 	ncine::RenderStatistics::reset();
+	timerQueries_->beginFrame(settings.gpuTimingEnabled, settings.gpuTimingPerCommandType);
 
 	// Sorting the queues with the relevant orders
 	nctl::quicksort(opaqueQueue_.begin(), opaqueQueue_.end(), descendingOrder);
@@ -91,14 +119,21 @@ void RenderQueue::draw()
 	{
 		ZoneScopedN("Batching");
 		// Always create batches after sorting
-		batcher_.createBatches(opaqueQueue_, opaqueBatchedQueue_);
+		batcher_->createBatches(opaqueQueue_, opaqueBatchedQueue_);
 		opaques = &opaqueBatchedQueue_;
 
-		batcher_.createBatches(transparentQueue_, transparentBatchedQueue_);
+		if (settings.batchingWithReordering)
+		{
+			batcher_->reorderCommands(transparentQueue_, transparentReorderedQueue_);
+			batcher_->createBatches(transparentReorderedQueue_, transparentBatchedQueue_);
+		}
+		else
+			batcher_->createBatches(transparentQueue_, transparentBatchedQueue_);
 		transparents = &transparentBatchedQueue_;
 	}
 
 	// Avoid GPU stalls by uploading to VBOs, IBOs and UBOs before drawing
+	timerQueries_->beginPhase(RenderStatistics::GpuPhases::COMMIT);
 	if (opaques->isEmpty() == false)
 	{
 		ZoneScopedN("Commit opaques");
@@ -127,8 +162,10 @@ void RenderQueue::draw()
 
 	// Now that UBOs and VBOs have been updated, they can be flushed and unmapped
 	RenderResources::buffersManager().flushUnmap();
+	timerQueries_->endPhase();
 
 	unsigned int commandIndex = 0;
+	timerQueries_->beginPhase(RenderStatistics::GpuPhases::OPAQUES);
 	// Rendering opaque nodes front to back
 	for (RenderCommand *opaqueRenderCommand : *opaques)
 	{
@@ -149,11 +186,15 @@ void RenderQueue::draw()
 		commandIndex++;
 
 		RenderStatistics::gatherStatistics(*opaqueRenderCommand);
+		timerQueries_->beginCommand(opaqueRenderCommand->type());
 		opaqueRenderCommand->issue();
+		timerQueries_->endCommand();
 	}
+	timerQueries_->endPhase();
 
 	GLBlending::enable();
 	GLDepthTest::disableDepthMask();
+	timerQueries_->beginPhase(RenderStatistics::GpuPhases::TRANSPARENTS);
 	// Rendering transparent nodes back to front
 	for (RenderCommand *transparentRenderCommand : *transparents)
 	{
@@ -174,9 +215,12 @@ void RenderQueue::draw()
 		commandIndex++;
 
 		RenderStatistics::gatherStatistics(*transparentRenderCommand);
+		timerQueries_->beginCommand(transparentRenderCommand->type());
 		GLBlending::blendFunc(transparentRenderCommand->material().srcBlendingFactor(), transparentRenderCommand->material().destBlendingFactor());
 		transparentRenderCommand->issue();
+		timerQueries_->endCommand();
 	}
+	timerQueries_->endPhase();
 	// Depth mask has to be enabled again before exiting this method
 	// or glClear(GL_DEPTH_BUFFER_BIT) won't have any effect
 	GLDepthTest::enableDepthMask();
@@ -187,11 +231,14 @@ void RenderQueue::draw()
 	opaqueQueue_.clear();
 	opaqueBatchedQueue_.clear();
 	transparentQueue_.clear();
+	transparentReorderedQueue_.clear();
 	transparentBatchedQueue_.clear();
 
 	RenderResources::clearDirtyProjectionFlag(batchingEnabled);
+	RenderResources::saveDeferredShaderBinaries();
 	RenderResources::buffersManager().remap();
-	batcher_.reset();
+	batcher_->reset();
+	timerQueries_->endFrame();
 	GLDebug::reset();
 }
 
@@ -1,5 +1,6 @@
 #include "RenderResources.h"
 #include "Application.h"
+#include "BinaryShaderCache.h"
 
 #ifdef WITH_EMBEDDED_SHADERS
 	#include "shader_strings.h"
@@ -21,12 +22,19 @@ nctl::UniquePtr<GLShaderProgram> RenderResources::meshSpriteShaderProgram_;
 nctl::UniquePtr<GLShaderProgram> RenderResources::meshSpriteGrayShaderProgram_;
 nctl::UniquePtr<GLShaderProgram> RenderResources::textnodeAlphaShaderProgram_;
 nctl::UniquePtr<GLShaderProgram> RenderResources::textnodeRedShaderProgram_;
+nctl::UniquePtr<GLShaderProgram> RenderResources::textnodeSdfShaderProgram_;
+nctl::UniquePtr<GLShaderProgram> RenderResources::textnodeMsdfShaderProgram_;
 nctl::UniquePtr<GLShaderProgram> RenderResources::batchedSpritesShaderProgram_;
 nctl::UniquePtr<GLShaderProgram> RenderResources::batchedSpritesGrayShaderProgram_;
 nctl::UniquePtr<GLShaderProgram> RenderResources::batchedMeshSpritesShaderProgram_;
 nctl::UniquePtr<GLShaderProgram> RenderResources::batchedMeshSpritesGrayShaderProgram_;
 nctl::UniquePtr<GLShaderProgram> RenderResources::batchedTextnodesRedShaderProgram_;
 nctl::UniquePtr<GLShaderProgram> RenderResources::batchedTextnodesAlphaShaderProgram_;
+nctl::UniquePtr<GLShaderProgram> RenderResources::batchedTextnodesSdfShaderProgram_;
+nctl::UniquePtr<GLShaderProgram> RenderResources::batchedTextnodesMsdfShaderProgram_;
+nctl::UniquePtr<GLShaderProgram> RenderResources::instancedSpritesShaderProgram_;
+nctl::UniquePtr<GLShaderProgram> RenderResources::instancedSpritesGrayShaderProgram_;
+nctl::UniquePtr<BinaryShaderCache> RenderResources::binaryShaderCache_;
 Matrix4x4f RenderResources::projectionMatrix_ = Matrix4x4f::Identity;
 bool RenderResources::projectionHasChanged_ = false;
 bool RenderResources::projectionHasChangedBatching_ = false;
@@ -43,6 +51,16 @@ void RenderResources::clearDirtyProjectionFlag(bool batchingEnabled)
 		projectionHasChanged_ = false;
 }
 
+void RenderResources::saveDeferredShaderBinaries()
+{
+	if (binaryShaderCache_ == nullptr)
+		return;
+
+	binaryShaderCache_->savePendingToCache();
+	if (binaryShaderCache_->hasPendingPrograms() == false)
+		binaryShaderCache_.reset(nullptr);
+}
+
 void RenderResources::createMinimal()
 {
 	LOGI("Creating a minimal set of rendering resources...");
@@ -93,12 +111,18 @@ void RenderResources::create()
 		{ RenderResources::meshSpriteGrayShaderProgram_, "meshsprite_vs.glsl", "sprite_gray_fs.glsl", GLShaderProgram::Introspection::ENABLED },
 		{ RenderResources::textnodeAlphaShaderProgram_, "textnode_vs.glsl", "textnode_alpha_fs.glsl", GLShaderProgram::Introspection::ENABLED },
 		{ RenderResources::textnodeRedShaderProgram_, "textnode_vs.glsl", "textnode_red_fs.glsl", GLShaderProgram::Introspection::ENABLED },
+		{ RenderResources::textnodeSdfShaderProgram_, "textnode_sdf_vs.glsl", "textnode_sdf_fs.glsl", GLShaderProgram::Introspection::ENABLED },
+		{ RenderResources::textnodeMsdfShaderProgram_, "textnode_sdf_vs.glsl", "textnode_msdf_fs.glsl", GLShaderProgram::Introspection::ENABLED },
 		{ RenderResources::batchedSpritesShaderProgram_, "batched_sprites_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
 		{ RenderResources::batchedSpritesGrayShaderProgram_, "batched_sprites_vs.glsl", "sprite_gray_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
 		{ RenderResources::batchedMeshSpritesShaderProgram_, "batched_meshsprites_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
 		{ RenderResources::batchedMeshSpritesGrayShaderProgram_, "batched_meshsprites_vs.glsl", "sprite_gray_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
 		{ RenderResources::batchedTextnodesAlphaShaderProgram_, "batched_textnodes_vs.glsl", "textnode_alpha_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
-		{ RenderResources::batchedTextnodesRedShaderProgram_, "batched_textnodes_vs.glsl", "textnode_red_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS }
+		{ RenderResources::batchedTextnodesRedShaderProgram_, "batched_textnodes_vs.glsl", "textnode_red_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
+		{ RenderResources::batchedTextnodesSdfShaderProgram_, "batched_textnodes_sdf_vs.glsl", "textnode_sdf_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
+		{ RenderResources::batchedTextnodesMsdfShaderProgram_, "batched_textnodes_sdf_vs.glsl", "textnode_msdf_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
+		{ RenderResources::instancedSpritesShaderProgram_, "instanced_sprites_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::ENABLED },
+		{ RenderResources::instancedSpritesGrayShaderProgram_, "instanced_sprites_vs.glsl", "sprite_gray_fs.glsl", GLShaderProgram::Introspection::ENABLED }
 #else
 		{ RenderResources::spriteShaderProgram_, ShaderStrings::sprite_vs, ShaderStrings::sprite_fs, GLShaderProgram::Introspection::ENABLED },
 		{ RenderResources::spriteGrayShaderProgram_, ShaderStrings::sprite_vs, ShaderStrings::sprite_gray_fs, GLShaderProgram::Introspection::ENABLED },
@@ -106,16 +130,24 @@ void RenderResources::create()
 		{ RenderResources::meshSpriteGrayShaderProgram_, ShaderStrings::meshsprite_vs, ShaderStrings::sprite_gray_fs, GLShaderProgram::Introspection::ENABLED },
 		{ RenderResources::textnodeAlphaShaderProgram_, ShaderStrings::textnode_vs, ShaderStrings::textnode_alpha_fs, GLShaderProgram::Introspection::ENABLED },
 		{ RenderResources::textnodeRedShaderProgram_, ShaderStrings::textnode_vs, ShaderStrings::textnode_red_fs, GLShaderProgram::Introspection::ENABLED },
+		{ RenderResources::textnodeSdfShaderProgram_, ShaderStrings::textnode_sdf_vs, ShaderStrings::textnode_sdf_fs, GLShaderProgram::Introspection::ENABLED },
+		{ RenderResources::textnodeMsdfShaderProgram_, ShaderStrings::textnode_sdf_vs, ShaderStrings::textnode_msdf_fs, GLShaderProgram::Introspection::ENABLED },
 		{ RenderResources::batchedSpritesShaderProgram_, ShaderStrings::batched_sprites_vs, ShaderStrings::sprite_fs, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
 		{ RenderResources::batchedSpritesGrayShaderProgram_, ShaderStrings::batched_sprites_vs, ShaderStrings::sprite_gray_fs, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
 		{ RenderResources::batchedMeshSpritesShaderProgram_, ShaderStrings::batched_meshsprites_vs, ShaderStrings::sprite_fs, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
 		{ RenderResources::batchedMeshSpritesGrayShaderProgram_, ShaderStrings::batched_meshsprites_vs, ShaderStrings::sprite_gray_fs, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
 		{ RenderResources::batchedTextnodesAlphaShaderProgram_, ShaderStrings::batched_textnodes_vs, ShaderStrings::textnode_alpha_fs, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
-		{ RenderResources::batchedTextnodesRedShaderProgram_, ShaderStrings::batched_textnodes_vs, ShaderStrings::textnode_red_fs, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS }
+		{ RenderResources::batchedTextnodesRedShaderProgram_, ShaderStrings::batched_textnodes_vs, ShaderStrings::textnode_red_fs, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
+		{ RenderResources::batchedTextnodesSdfShaderProgram_, ShaderStrings::batched_textnodes_sdf_vs, ShaderStrings::textnode_sdf_fs, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
+		{ RenderResources::batchedTextnodesMsdfShaderProgram_, ShaderStrings::batched_textnodes_sdf_vs, ShaderStrings::textnode_msdf_fs, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS },
+		{ RenderResources::instancedSpritesShaderProgram_, ShaderStrings::instanced_sprites_vs, ShaderStrings::sprite_fs, GLShaderProgram::Introspection::ENABLED },
+		{ RenderResources::instancedSpritesGrayShaderProgram_, ShaderStrings::instanced_sprites_vs, ShaderStrings::sprite_gray_fs, GLShaderProgram::Introspection::ENABLED }
 #endif
 	};
 
 	const GLShaderProgram::QueryPhase queryPhase = appCfg.deferShaderQueries ? GLShaderProgram::QueryPhase::DEFERRED : GLShaderProgram::QueryPhase::IMMEDIATE;
+	binaryShaderCache_ = nctl::makeUnique<BinaryShaderCache>(appCfg.useBinaryShaderCache, appCfg.shaderCacheDirname.data());
+	BinaryShaderCache &binaryShaderCache = *binaryShaderCache_;
 	const unsigned int numShaderToLoad = (sizeof(shadersToLoad) / sizeof(*shadersToLoad));
 	for (unsigned int i = 0; i < numShaderToLoad; i++)
 	{
@@ -123,16 +155,45 @@ void RenderResources::create()
 
 		shaderToLoad.shaderProgram = nctl::makeUnique<GLShaderProgram>(queryPhase);
 #ifndef WITH_EMBEDDED_SHADERS
-		shaderToLoad.shaderProgram->attachShader(GL_VERTEX_SHADER, (fs::dataPath() + "shaders/" + shaderToLoad.vertexShader).data());
-		shaderToLoad.shaderProgram->attachShader(GL_FRAGMENT_SHADER, (fs::dataPath() + "shaders/" + shaderToLoad.fragmentShader).data());
+		const nctl::String vertexShaderPath = fs::dataPath() + "shaders/" + shaderToLoad.vertexShader;
+		const nctl::String fragmentShaderPath = fs::dataPath() + "shaders/" + shaderToLoad.fragmentShader;
+#endif
+
+		nctl::hash_t sourcesHash = 0;
+		if (binaryShaderCache.isAvailable())
+		{
+#ifndef WITH_EMBEDDED_SHADERS
+			sourcesHash = binaryShaderCache.hashFiles(vertexShaderPath.data(), fragmentShaderPath.data());
+#else
+			sourcesHash = binaryShaderCache.hashSources(shaderToLoad.vertexShader, shaderToLoad.fragmentShader);
+#endif
+			if (binaryShaderCache.loadFromCache(sourcesHash, *shaderToLoad.shaderProgram, shaderToLoad.introspection))
+				continue;
+
+			// A rejected binary leaves the program object in an unusable state
+			shaderToLoad.shaderProgram = nctl::makeUnique<GLShaderProgram>(queryPhase);
+			shaderToLoad.shaderProgram->setBinaryRetrievableHint();
+		}
+
+#ifndef WITH_EMBEDDED_SHADERS
+		shaderToLoad.shaderProgram->attachShader(GL_VERTEX_SHADER, vertexShaderPath.data());
+		shaderToLoad.shaderProgram->attachShader(GL_FRAGMENT_SHADER, fragmentShaderPath.data());
 #else
 		shaderToLoad.shaderProgram->attachShaderFromString(GL_VERTEX_SHADER, shaderToLoad.vertexShader);
 		shaderToLoad.shaderProgram->attachShaderFromString(GL_FRAGMENT_SHADER, shaderToLoad.fragmentShader);
 #endif
 		shaderToLoad.shaderProgram->link(shaderToLoad.introspection);
 		FATAL_ASSERT(shaderToLoad.shaderProgram->status() != GLShaderProgram::Status::LINKING_FAILED);
+
+		// With deferred queries the binary is saved after the link status check, when the program is first used
+		binaryShaderCache.saveToCacheWhenLinked(sourcesHash, *shaderToLoad.shaderProgram);
 	}
 
+	if (binaryShaderCache.isAvailable())
+		LOGI_X("Binary shader cache: %u hits, %u misses", binaryShaderCache.numHits(), binaryShaderCache.numMisses());
+	if (binaryShaderCache.hasPendingPrograms() == false)
+		binaryShaderCache_.reset(nullptr);
+
 	// Calculating a common projection matrix for all shader programs
 	const float width = theApplication().width();
 	const float height = theApplication().height();
@@ -147,12 +208,20 @@ void RenderResources::create()
 
 void RenderResources::dispose()
 {
+	// Pending programs are about to be destroyed
+	binaryShaderCache_.reset(nullptr);
+	instancedSpritesGrayShaderProgram_.reset(nullptr);
+	instancedSpritesShaderProgram_.reset(nullptr);
+	batchedTextnodesMsdfShaderProgram_.reset(nullptr);
+	batchedTextnodesSdfShaderProgram_.reset(nullptr);
 	batchedTextnodesRedShaderProgram_.reset(nullptr);
 	batchedTextnodesAlphaShaderProgram_.reset(nullptr);
 	batchedMeshSpritesGrayShaderProgram_.reset(nullptr);
 	batchedMeshSpritesShaderProgram_.reset(nullptr);
 	batchedSpritesGrayShaderProgram_.reset(nullptr);
 	batchedSpritesShaderProgram_.reset(nullptr);
+	textnodeMsdfShaderProgram_.reset(nullptr);
+	textnodeSdfShaderProgram_.reset(nullptr);
 	textnodeRedShaderProgram_.reset(nullptr);
 	textnodeAlphaShaderProgram_.reset(nullptr);
 	meshSpriteGrayShaderProgram_.reset(nullptr);
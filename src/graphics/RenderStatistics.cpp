@@ -15,8 +15,14 @@ RenderStatistics::Textures RenderStatistics::textures_;
 RenderStatistics::CustomBuffers RenderStatistics::customVbos_;
 RenderStatistics::CustomBuffers RenderStatistics::customIbos_;
 unsigned int RenderStatistics::index_ = 0;
-unsigned int RenderStatistics::culledNodes_[2] = { 0, 0 };
+nctl::Atomic32 RenderStatistics::culledNodes_[2];
+nctl::Atomic32 RenderStatistics::relaidTextLines_[2];
+nctl::Atomic32 RenderStatistics::reusedTextLines_[2];
 RenderStatistics::VaoPool RenderStatistics::vaoPool_;
+RenderStatistics::Reordering RenderStatistics::reordering_;
+RenderStatistics::StateChanges RenderStatistics::allStateChanges_;
+RenderStatistics::StateChanges RenderStatistics::typedStateChanges_[RenderStatistics::StateTypes::COUNT];
+RenderStatistics::GpuTimes RenderStatistics::gpuTimes_;
 
 ///////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
@@ -34,11 +40,23 @@ void RenderStatistics::reset()
 	for (unsigned int i = 0; i < RenderBuffersManager::BufferTypes::COUNT; i++)
 		typedBuffers_[i].reset();
 
+	TracyPlot("Relaid Text Lines", static_cast<int64_t>(relaidTextLines_[index_].load()));
+
 	// Ping pong index for last and current frame
 	index_ = (index_ + 1) % 2;
 	culledNodes_[index_] = 0;
+	relaidTextLines_[index_] = 0;
+	reusedTextLines_[index_] = 0;
 
 	vaoPool_.reset();
+	reordering_.reset();
+
+	TracyPlot("Issued State Changes", static_cast<int64_t>(allStateChanges_.issued));
+	TracyPlot("Skipped State Changes", static_cast<int64_t>(allStateChanges_.skipped));
+
+	for (unsigned int i = 0; i < StateTypes::COUNT; i++)
+		typedStateChanges_[i].reset();
+	allStateChanges_.reset();
 }
 
 void RenderStatistics::gatherStatistics(const RenderCommand &command)
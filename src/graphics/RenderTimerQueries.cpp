@@ -0,0 +1,269 @@
+#include "common_macros.h"
+#include "RenderTimerQueries.h"
+#include "IGfxCapabilities.h"
+#include "ServiceLocator.h"
+#include "tracy.h"
+
+#if ((defined(__ANDROID__) && __ANDROID_API__ >= 21) || defined(WITH_ANGLE)) && !defined(__APPLE__) && !defined(__EMSCRIPTEN__) && GL_ES_VERSION_3_0
+	#define GL_TIME_ELAPSED GL_TIME_ELAPSED_EXT
+	#define GL_GPU_DISJOINT GL_GPU_DISJOINT_EXT
+	#define glGetQueryObjectui64v glGetQueryObjectui64vEXT
+#endif
+
+#if (!defined(__ANDROID__) && !defined(__EMSCRIPTEN__)) || (GL_ES_VERSION_3_0 && __ANDROID_API__ >= 21)
+	#define WITH_TIMER_QUERIES
+#endif
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+RenderTimerQueries::RenderTimerQueries()
+    : isSupported_(false), isEnabled_(false), isMeasuring_(false), perCommandType_(false),
+      isQueryActive_(false), currentPhase_(RenderStatistics::GpuPhases::COMMIT), frameIndex_(0), numFrames_(0)
+{
+	for (unsigned int i = 0; i < MaxPendingFrames; i++)
+	{
+		FrameQueries &frame = frames_[i];
+		for (unsigned int j = 0; j < RenderStatistics::GpuPhases::COUNT; j++)
+		{
+			frame.phaseIds[j] = 0;
+			frame.phaseIssued[j] = false;
+		}
+		frame.numCommands = 0;
+		frame.lastId = 0;
+		frame.frameNumber = 0;
+		frame.isPending = false;
+	}
+
+#if defined(WITH_TIMER_QUERIES)
+	#if defined(GL_GPU_DISJOINT)
+	const IGfxCapabilities &gfxCaps = theServiceLocator().gfxCapabilities();
+	isSupported_ = gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::EXT_DISJOINT_TIMER_QUERY);
+	#else
+	// Time elapsed queries are core since OpenGL 3.3
+	isSupported_ = true;
+	#endif
+#endif
+}
+
+RenderTimerQueries::~RenderTimerQueries()
+{
+	deleteQueries();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void RenderTimerQueries::beginFrame(bool enabled, bool perCommandType)
+{
+	isMeasuring_ = false;
+	if (isSupported_ == false)
+		return;
+
+	if (enabled == false)
+	{
+		if (isEnabled_)
+		{
+			discardPendingFrames();
+			deleteQueries();
+			RenderStatistics::gpuTimes_.reset();
+			isEnabled_ = false;
+		}
+		return;
+	}
+
+	if (isEnabled_ == false)
+	{
+		for (unsigned int i = 0; i < MaxPendingFrames; i++)
+			glGenQueries(RenderStatistics::GpuPhases::COUNT, frames_[i].phaseIds);
+		isEnabled_ = true;
+	}
+
+	readBackFrames();
+
+	// Never wait for the GPU, the frame is not measured if all the queries are still pending
+	FrameQueries &frame = frames_[frameIndex_];
+	if (frame.isPending)
+		return;
+
+	for (unsigned int i = 0; i < RenderStatistics::GpuPhases::COUNT; i++)
+		frame.phaseIssued[i] = false;
+	frame.numCommands = 0;
+	frame.lastId = 0;
+	frame.frameNumber = numFrames_;
+	isMeasuring_ = true;
+	perCommandType_ = perCommandType;
+}
+
+void RenderTimerQueries::endFrame()
+{
+	if (isMeasuring_)
+	{
+		ASSERT(isQueryActive_ == false);
+		FrameQueries &frame = frames_[frameIndex_];
+		frame.isPending = (frame.lastId != 0);
+		frameIndex_ = (frameIndex_ + 1) % MaxPendingFrames;
+		isMeasuring_ = false;
+	}
+	numFrames_++;
+}
+
+void RenderTimerQueries::beginPhase(RenderStatistics::GpuPhases::Enum phase)
+{
+	currentPhase_ = phase;
+	// Commands of the drawing phases are measured one by one instead
+	if (isMeasuring_ == false || (perCommandType_ && phase != RenderStatistics::GpuPhases::COMMIT))
+		return;
+
+#if defined(WITH_TIMER_QUERIES)
+	FrameQueries &frame = frames_[frameIndex_];
+	ASSERT(isQueryActive_ == false);
+	glBeginQuery(GL_TIME_ELAPSED, frame.phaseIds[phase]);
+	frame.phaseIssued[phase] = true;
+	frame.lastId = frame.phaseIds[phase];
+	isQueryActive_ = true;
+#endif
+}
+
+void RenderTimerQueries::endPhase()
+{
+	if (isMeasuring_ == false || isQueryActive_ == false)
+		return;
+
+#if defined(WITH_TIMER_QUERIES)
+	glEndQuery(GL_TIME_ELAPSED);
+	isQueryActive_ = false;
+#endif
+}
+
+void RenderTimerQueries::beginCommand(RenderCommand::CommandTypes::Enum type)
+{
+	if (isMeasuring_ == false || perCommandType_ == false)
+		return;
+
+#if defined(WITH_TIMER_QUERIES)
+	FrameQueries &frame = frames_[frameIndex_];
+	ASSERT(isQueryActive_ == false);
+	if (frame.numCommands == frame.commands.size())
+	{
+		CommandQuery query;
+		glGenQueries(1, &query.id);
+		frame.commands.pushBack(query);
+	}
+
+	CommandQuery &query = frame.commands[frame.numCommands];
+	query.type = static_cast<uint8_t>(type);
+	query.phase = static_cast<uint8_t>(currentPhase_);
+	frame.numCommands++;
+
+	glBeginQuery(GL_TIME_ELAPSED, query.id);
+	frame.lastId = query.id;
+	isQueryActive_ = true;
+#endif
+}
+
+void RenderTimerQueries::endCommand()
+{
+	if (perCommandType_)
+		endPhase();
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void RenderTimerQueries::readBackFrames()
+{
+#if defined(WITH_TIMER_QUERIES)
+	#if defined(GL_GPU_DISJOINT)
+	// Results of queries in flight during a disjoint operation, like a frequency change, are not reliable
+	GLint disjointOccurred = GL_FALSE;
+	glGetIntegerv(GL_GPU_DISJOINT, &disjointOccurred);
+	if (disjointOccurred)
+	{
+		discardPendingFrames();
+		return;
+	}
+	#endif
+
+	// Reading back from the oldest frame and stopping at the first one that is not complete
+	for (unsigned int i = 0; i < MaxPendingFrames; i++)
+	{
+		FrameQueries &frame = frames_[(frameIndex_ + i) % MaxPendingFrames];
+		if (frame.isPending && readBackFrame(frame) == false)
+			break;
+	}
+#endif
+}
+
+bool RenderTimerQueries::readBackFrame(FrameQueries &frame)
+{
+#if defined(WITH_TIMER_QUERIES)
+	GLuint available = GL_FALSE;
+	glGetQueryObjectuiv(frame.lastId, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available == GL_FALSE)
+		return false;
+
+	RenderStatistics::GpuTimes &gpuTimes = RenderStatistics::gpuTimes_;
+	gpuTimes.reset();
+
+	GLuint64 elapsedTime = 0;
+	for (unsigned int i = 0; i < RenderStatistics::GpuPhases::COUNT; i++)
+	{
+		if (frame.phaseIssued[i])
+		{
+			glGetQueryObjectui64v(frame.phaseIds[i], GL_QUERY_RESULT, &elapsedTime);
+			gpuTimes.phases[i] += elapsedTime / 1000000.0f;
+		}
+	}
+
+	for (unsigned int i = 0; i < frame.numCommands; i++)
+	{
+		const CommandQuery &query = frame.commands[i];
+		glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &elapsedTime);
+		gpuTimes.commandTypes[query.type] += elapsedTime / 1000000.0f;
+		gpuTimes.phases[query.phase] += elapsedTime / 1000000.0f;
+	}
+
+	for (unsigned int i = 0; i < RenderStatistics::GpuPhases::COUNT; i++)
+		gpuTimes.total += gpuTimes.phases[i];
+	gpuTimes.latency = static_cast<unsigned int>(numFrames_ - frame.frameNumber);
+	gpuTimes.available = true;
+	frame.isPending = false;
+
+	TracyPlot("GPU ms", gpuTimes.total);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void RenderTimerQueries::discardPendingFrames()
+{
+	for (unsigned int i = 0; i < MaxPendingFrames; i++)
+		frames_[i].isPending = false;
+}
+
+void RenderTimerQueries::deleteQueries()
+{
+#if defined(WITH_TIMER_QUERIES)
+	if (isEnabled_ == false)
+		return;
+
+	for (unsigned int i = 0; i < MaxPendingFrames; i++)
+	{
+		FrameQueries &frame = frames_[i];
+		glDeleteQueries(RenderStatistics::GpuPhases::COUNT, frame.phaseIds);
+		for (const CommandQuery &query : frame.commands)
+			glDeleteQueries(1, &query.id);
+		frame.commands.clear();
+		frame.numCommands = 0;
+	}
+#endif
+}
+
+}
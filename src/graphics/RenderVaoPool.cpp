@@ -10,7 +10,8 @@ namespace ncine {
 ///////////////////////////////////////////////////////////
 
 RenderVaoPool::RenderVaoPool(unsigned int vaoPoolSize)
-    : vaoPool_(vaoPoolSize, nctl::ArrayMode::FIXED_CAPACITY)
+    : vaoPool_(vaoPoolSize, nctl::ArrayMode::FIXED_CAPACITY),
+      hashIndices_(vaoPoolSize * 2), lruHead_(InvalidIndex), lruTail_(InvalidIndex)
 {
 	// Start with a VAO bound to the OpenGL context
 	GLVertexFormat format;
@@ -23,32 +24,30 @@ RenderVaoPool::RenderVaoPool(unsigned int vaoPoolSize)
 
 void RenderVaoPool::bindVao(const GLVertexFormat &vertexFormat)
 {
-	bool vaoFound = false;
-	for (VaoBinding &binding : vaoPool_)
+	const nctl::hash_t hash = vertexFormat.hash();
+	const unsigned int foundIndex = findBinding(vertexFormat, hash);
+
+	if (foundIndex != InvalidIndex)
 	{
-		if (binding.format == vertexFormat)
+		GLDebug::pushGroup("Bind VAO");
+		VaoBinding &binding = vaoPool_[foundIndex];
+		const bool bindChanged = binding.object->bind();
+		const GLuint iboHandle = vertexFormat.ibo() ? vertexFormat.ibo()->glHandle() : 0;
+		if (bindChanged)
 		{
-			GLDebug::pushGroup("Bind VAO");
-			vaoFound = true;
-			const bool bindChanged = binding.object->bind();
-			const GLuint iboHandle = vertexFormat.ibo() ? vertexFormat.ibo()->glHandle() : 0;
-			if (bindChanged)
-			{
-				// Binding a VAO changes the current bound element array buffer
-				GLBufferObject::setBoundHandle(GL_ELEMENT_ARRAY_BUFFER, iboHandle);
-			}
-			else
-			{
-				// The VAO was already bound but it is not known if the bound element array buffer changed in the meantime
-				GLBufferObject::bindHandle(GL_ELEMENT_ARRAY_BUFFER, iboHandle);
-			}
-			binding.lastBindTime = TimeStamp::now();
-			RenderStatistics::addVaoPoolBinding();
-			break;
+			// Binding a VAO changes the current bound element array buffer
+			GLBufferObject::setBoundHandle(GL_ELEMENT_ARRAY_BUFFER, iboHandle);
 		}
+		else
+		{
+			// The VAO was already bound but it is not known if the bound element array buffer changed in the meantime
+			GLBufferObject::bindHandle(GL_ELEMENT_ARRAY_BUFFER, iboHandle);
+		}
+		moveToLruHead(foundIndex);
+		RenderStatistics::addVaoPoolHit();
+		RenderStatistics::addVaoPoolBinding();
 	}
-
-	if (vaoFound == false)
+	else
 	{
 		unsigned int index = 0;
 		if (vaoPool_.size() < vaoPool_.capacity())
@@ -56,19 +55,15 @@ void RenderVaoPool::bindVao(const GLVertexFormat &vertexFormat)
 			GLDebug::pushGroup("Create and define VAO");
 			index = vaoPool_.size();
 			vaoPool_[index].object = nctl::makeUnique<GLVertexArrayObject>();
+			vaoPool_[index].nextSameHash = InvalidIndex;
+			vaoPool_[index].lruPrev = InvalidIndex;
+			vaoPool_[index].lruNext = InvalidIndex;
 		}
 		else
 		{
-			// Find the least recently used VAO
-			TimeStamp time = vaoPool_[0].lastBindTime;
-			for (unsigned int i = 1; i < vaoPool_.size(); i++)
-			{
-				if (vaoPool_[i].lastBindTime < time)
-				{
-					index = i;
-					time = vaoPool_[i].lastBindTime;
-				}
-			}
+			// The least recently used VAO is at the tail of the list
+			index = lruTail_;
+			unlinkHash(index);
 
 			GLDebug::pushGroup("Reuse and define VAO");
 			RenderStatistics::addVaoPoolReuse();
@@ -81,7 +76,9 @@ void RenderVaoPool::bindVao(const GLVertexFormat &vertexFormat)
 		GLBufferObject::setBoundHandle(GL_ELEMENT_ARRAY_BUFFER, oldIboHandle);
 		vaoPool_[index].format = vertexFormat;
 		vaoPool_[index].format.define();
-		vaoPool_[index].lastBindTime = TimeStamp::now();
+		vaoPool_[index].formatHash = hash;
+		linkHash(index);
+		moveToLruHead(index);
 		RenderStatistics::addVaoPoolBinding();
 	}
 	GLDebug::popGroup();
@@ -89,4 +86,88 @@ void RenderVaoPool::bindVao(const GLVertexFormat &vertexFormat)
 	RenderStatistics::gatherVaoPoolStatistics(vaoPool_.size(), vaoPool_.capacity());
 }
 
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+unsigned int RenderVaoPool::findBinding(const GLVertexFormat &vertexFormat, nctl::hash_t hash) const
+{
+	const unsigned int *firstIndex = hashIndices_.find(hash);
+	if (firstIndex == nullptr)
+		return InvalidIndex;
+
+	// Different formats can have the same hash
+	for (unsigned int index = *firstIndex; index != InvalidIndex; index = vaoPool_[index].nextSameHash)
+	{
+		if (vaoPool_[index].format == vertexFormat)
+			return index;
+	}
+
+	return InvalidIndex;
+}
+
+void RenderVaoPool::linkHash(unsigned int index)
+{
+	VaoBinding &binding = vaoPool_[index];
+	unsigned int *firstIndex = hashIndices_.find(binding.formatHash);
+	if (firstIndex != nullptr)
+	{
+		binding.nextSameHash = *firstIndex;
+		*firstIndex = index;
+	}
+	else
+	{
+		binding.nextSameHash = InvalidIndex;
+		hashIndices_.insert(binding.formatHash, index);
+	}
+}
+
+void RenderVaoPool::unlinkHash(unsigned int index)
+{
+	VaoBinding &binding = vaoPool_[index];
+	unsigned int *firstIndex = hashIndices_.find(binding.formatHash);
+	ASSERT(firstIndex != nullptr);
+
+	if (*firstIndex == index)
+	{
+		if (binding.nextSameHash != InvalidIndex)
+			*firstIndex = binding.nextSameHash;
+		else
+			hashIndices_.remove(binding.formatHash);
+	}
+	else
+	{
+		unsigned int prevIndex = *firstIndex;
+		while (vaoPool_[prevIndex].nextSameHash != index)
+			prevIndex = vaoPool_[prevIndex].nextSameHash;
+		vaoPool_[prevIndex].nextSameHash = binding.nextSameHash;
+	}
+	binding.nextSameHash = InvalidIndex;
+}
+
+void RenderVaoPool::moveToLruHead(unsigned int index)
+{
+	if (index == lruHead_)
+		return;
+
+	VaoBinding &binding = vaoPool_[index];
+	// A binding that is not the head of the list has a previous one only if it is already in the list
+	if (binding.lruPrev != InvalidIndex)
+	{
+		vaoPool_[binding.lruPrev].lruNext = binding.lruNext;
+		if (binding.lruNext != InvalidIndex)
+			vaoPool_[binding.lruNext].lruPrev = binding.lruPrev;
+		else
+			lruTail_ = binding.lruPrev;
+	}
+
+	binding.lruPrev = InvalidIndex;
+	binding.lruNext = lruHead_;
+	if (lruHead_ != InvalidIndex)
+		vaoPool_[lruHead_].lruPrev = index;
+	else
+		lruTail_ = index;
+	lruHead_ = index;
+}
+
 }
@@ -1,12 +1,33 @@
 #include "SceneNode.h"
+#include "RenderQueue.h"
+#include "Application.h"
 
 namespace ncine {
 
+/// The render commands recorded by a node visit, together with the state they depend on
+class SceneNode::CommandsRecording
+{
+  public:
+	CommandsRecording()
+	    : queue(false), isRecorded(false), isDirty(false), cullingEnabled(false) {}
+
+	/// A collect-only queue with the recorded commands
+	RenderQueue queue;
+	bool isRecorded;
+	bool isDirty;
+	Matrix4x4f worldMatrix;
+	Color absColor;
+	Rectf screenRect;
+	bool cullingEnabled;
+};
+
 ///////////////////////////////////////////////////////////
 // STATIC DEFINITIONS
 ///////////////////////////////////////////////////////////
 
 const float SceneNode::MinRotation = 0.5f;
+unsigned int SceneNode::numRecordingNodes_ = 0;
+unsigned int SceneNode::recordingUpdateDepth_ = 0;
 
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
@@ -19,7 +40,7 @@ SceneNode::SceneNode(SceneNode *parent, float xx, float yy)
       anchorPoint_(0.0f, 0.0f), scaleFactor_(1.0f, 1.0f), rotation_(0.0f),
       absX_(0.0f), absY_(0.0f), absScaleFactor_(1.0f, 1.0f), absRotation_(0.0f),
       worldMatrix_(Matrix4x4f::Identity), localMatrix_(Matrix4x4f::Identity),
-      shouldDeleteChildrenOnDestruction_(true)
+      shouldDeleteChildrenOnDestruction_(true), commandsRecording_(nullptr)
 {
 	setParent(parent);
 }
@@ -55,6 +76,7 @@ SceneNode::~SceneNode()
 	}
 
 	setParent(nullptr);
+	setRecordCommands(false);
 }
 
 ///////////////////////////////////////////////////////////
@@ -70,7 +92,10 @@ void SceneNode::setParent(SceneNode *parentNode)
 	if (parent_)
 		parent_->removeChildNode(this);
 	if (parentNode)
+	{
 		parentNode->children_.pushBack(this);
+		parentNode->invalidateRecordedCommands();
+	}
 	parent_ = parentNode;
 }
 
@@ -85,6 +110,7 @@ void SceneNode::addChildNode(SceneNode *childNode)
 
 	children_.pushBack(childNode);
 	childNode->parent_ = this;
+	invalidateRecordedCommands();
 }
 
 /*! \return True if the node has been removed */
@@ -122,6 +148,7 @@ bool SceneNode::removeChildNodeAt(unsigned int index)
 	children_[index]->parent_ = nullptr;
 	// Fast removal without preserving the order
 	children_.unorderedRemoveAt(index);
+	invalidateRecordedCommands();
 	return true;
 }
 
@@ -153,6 +180,10 @@ void SceneNode::update(float interval)
 {
 	// Early return not needed, the first call to this method is on the root node
 
+	// Descendants of a recording node check their transformation for changes, the other nodes do not pay for it
+	if (commandsRecording_)
+		recordingUpdateDepth_++;
+
 	for (SceneNode *child : children_)
 	{
 		if (child->updateEnabled_)
@@ -161,19 +192,68 @@ void SceneNode::update(float interval)
 			child->update(interval);
 		}
 	}
+
+	if (commandsRecording_)
+		recordingUpdateDepth_--;
 }
 
 void SceneNode::visit(RenderQueue &renderQueue)
 {
 	// Early return not needed, the first call to this method is on the root node
 
-	for (SceneNode *child : children_)
+	if (commandsRecording_)
 	{
-		if (child->drawEnabled_)
+		CommandsRecording &recording = *commandsRecording_;
+		const Rectf screenRect = theApplication().gfxDevice().screenRect();
+		const bool cullingEnabled = theApplication().renderingSettings().cullingEnabled;
+
+		const bool stateChanged = (recording.worldMatrix == worldMatrix_ && recording.absColor == absColor_ &&
+		                           recording.screenRect == screenRect && recording.cullingEnabled == cullingEnabled) == false;
+		if (recording.isRecorded == false || recording.isDirty || stateChanged)
 		{
-			child->draw(renderQueue);
-			child->visit(renderQueue);
+			recording.queue.clearCommands();
+			visitChildren(recording.queue);
+
+			recording.isRecorded = true;
+			recording.isDirty = false;
+			recording.worldMatrix = worldMatrix_;
+			recording.absColor = absColor_;
+			recording.screenRect = screenRect;
+			recording.cullingEnabled = cullingEnabled;
 		}
+
+		// Replaying the recorded commands without drawing the descendants again
+		renderQueue.appendCommands(recording.queue);
+	}
+	else
+		visitChildren(renderQueue);
+}
+
+void SceneNode::setRecordCommands(bool recordCommands)
+{
+	if (recordCommands && commandsRecording_ == nullptr)
+	{
+		commandsRecording_ = nctl::makeUnique<CommandsRecording>();
+		numRecordingNodes_++;
+	}
+	else if (recordCommands == false && commandsRecording_ != nullptr)
+	{
+		commandsRecording_.reset(nullptr);
+		numRecordingNodes_--;
+	}
+}
+
+bool SceneNode::recordedCommandsAreDirty() const
+{
+	return (commandsRecording_ != nullptr && commandsRecording_->isDirty);
+}
+
+void SceneNode::invalidateRecordedCommands()
+{
+	for (SceneNode *node = this; node != nullptr; node = node->parent_)
+	{
+		if (node->commandsRecording_)
+			node->commandsRecording_->isDirty = true;
 	}
 }
 
@@ -183,6 +263,16 @@ void SceneNode::visit(RenderQueue &renderQueue)
 
 void SceneNode::transform()
 {
+	// The previous state is only needed when the node is updated as part of a recorded subtree
+	const bool checkChanges = (recordingUpdateDepth_ > 0 && parent_ != nullptr);
+	Matrix4x4f prevWorldMatrix;
+	Color prevAbsColor;
+	if (checkChanges)
+	{
+		prevWorldMatrix = worldMatrix_;
+		prevAbsColor = absColor_;
+	}
+
 	// Calculating world and local matrices
 	localMatrix_ = Matrix4x4f::translation(x, y, 0.0f);
 	localMatrix_.rotateZ(rotation_);
@@ -206,6 +296,25 @@ void SceneNode::transform()
 
 	absX_ = worldMatrix_[3][0];
 	absY_ = worldMatrix_[3][1];
+
+	if (checkChanges && (worldMatrix_ == prevWorldMatrix && absColor_ == prevAbsColor) == false)
+		parent_->invalidateRecordedCommands();
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void SceneNode::visitChildren(RenderQueue &renderQueue)
+{
+	for (SceneNode *child : children_)
+	{
+		if (child->drawEnabled_)
+		{
+			child->draw(renderQueue);
+			child->visit(renderQueue);
+		}
+	}
 }
 
 }
@@ -137,6 +137,15 @@ void SdlGfxDevice::updateVideoModes()
 
 void SdlGfxDevice::initGraphics()
 {
+	// The offscreen driver does not need a display server, contexts are created through EGL
+	if (isHeadless_)
+	{
+#ifdef SDL_HINT_VIDEODRIVER
+		SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+#else
+		SDL_setenv("SDL_VIDEODRIVER", "offscreen", 1);
+#endif
+	}
 	const int err = SDL_Init(SDL_INIT_VIDEO);
 	FATAL_ASSERT_MSG_X(!err, "SDL_Init(SDL_INIT_VIDEO) failed: %s", SDL_GetError());
 }
@@ -149,6 +158,16 @@ void SdlGfxDevice::initDevice()
 		width_ = 0;
 		height_ = 0;
 	}
+	// there is no desktop to take the resolution from when running offscreen
+	if (isHeadless_)
+	{
+		isFullScreen_ = false;
+		if (width_ == 0 || height_ == 0)
+		{
+			width_ = DefaultHeadlessWidth;
+			height_ = DefaultHeadlessHeight;
+		}
+	}
 
 	// setting OpenGL attributes
 	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, displayMode_.redBits());
@@ -176,7 +195,9 @@ void SdlGfxDevice::initDevice()
 		SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);
 
 	Uint32 flags = SDL_WINDOW_OPENGL;
-	if (isFullScreen_)
+	if (isHeadless_)
+		flags |= SDL_WINDOW_HIDDEN;
+	else if (isFullScreen_)
 		flags |= SDL_WINDOW_FULLSCREEN;
 	else if (width_ == 0 || height_ == 0)
 		flags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
@@ -198,7 +219,8 @@ void SdlGfxDevice::initDevice()
 	SDL_GL_SetSwapInterval(interval);
 
 #ifdef WITH_GLEW
-	const GLenum err = glewInit();
+	// There is no GLX display to query extensions from when the context has been created through EGL
+	const GLenum err = isHeadless_ ? glewContextInit() : glewInit();
 	FATAL_ASSERT_MSG_X(err == GLEW_OK, "GLEW error: %s", glewGetErrorString(err));
 
 	glContextInfo_.debugContext = glContextInfo_.debugContext && glewIsSupported("GL_ARB_debug_output");
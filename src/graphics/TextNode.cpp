@@ -1,8 +1,11 @@
+#include <cstring> // for `memcmp()`
 #include "TextNode.h"
+#include <nctl/algorithms.h>
+#include <nctl/Utf8.h>
 #include "FontGlyph.h"
 #include "Texture.h"
 #include "RenderCommand.h"
-#include "GLDebug.h"
+#include "RenderStatistics.h"
 #include "tracy.h"
 
 namespace ncine {
@@ -20,8 +23,9 @@ TextNode::TextNode(SceneNode *parent, Font *font, unsigned int maxStringLength)
     : DrawableNode(parent, 0.0f, 0.0f), string_(maxStringLength), dirtyDraw_(true),
       dirtyBoundaries_(true), withKerning_(true), font_(font),
       interleavedVertices_(maxStringLength * 4 + (maxStringLength - 1) * 2),
-      xAdvance_(0.0f), yAdvance_(0.0f), lineLengths_(4),
-      alignment_(Alignment::LEFT), textnodeBlock_(nullptr)
+      lines_(4), newLines_(4), numGlyphs_(0),
+      alignment_(Alignment::LEFT), outlineWidth_(0.0f), outlineColor_(0.0f, 0.0f, 0.0f, 0.0f),
+      shadowOffset_(Vector2f::Zero), shadowColor_(0.0f, 0.0f, 0.0f, 0.0f), shadowSoftness_(0.0f), textnodeBlock_(nullptr)
 {
 	ASSERT(font);
 	ASSERT(maxStringLength > 0);
@@ -30,14 +34,22 @@ TextNode::TextNode(SceneNode *parent, Font *font, unsigned int maxStringLength)
 	setLayer(DrawableNode::LayerBase::HUD);
 	renderCommand_->setType(RenderCommand::CommandTypes::TEXT);
 	renderCommand_->material().setBlendingEnabled(true);
-	const Material::ShaderProgramType shaderProgramType = font_->renderMode() == Font::RenderMode::GLYPH_IN_RED
-	                                                          ? Material::ShaderProgramType::TEXTNODE_RED
-	                                                          : Material::ShaderProgramType::TEXTNODE_ALPHA;
+	Material::ShaderProgramType shaderProgramType = Material::ShaderProgramType::TEXTNODE_ALPHA;
+	switch (font_->renderMode())
+	{
+		case Font::RenderMode::GLYPH_IN_RED: shaderProgramType = Material::ShaderProgramType::TEXTNODE_RED; break;
+		case Font::RenderMode::GLYPH_IN_ALPHA: shaderProgramType = Material::ShaderProgramType::TEXTNODE_ALPHA; break;
+		case Font::RenderMode::GLYPH_SDF: shaderProgramType = Material::ShaderProgramType::TEXTNODE_SDF; break;
+		case Font::RenderMode::GLYPH_MSDF: shaderProgramType = Material::ShaderProgramType::TEXTNODE_MSDF; break;
+	}
 	renderCommand_->material().setShaderProgramType(shaderProgramType);
 	textnodeBlock_ = renderCommand_->material().uniformBlock("TextnodeBlock");
 	renderCommand_->material().setTexture(*font_->texture());
 	renderCommand_->geometry().setPrimitiveType(GL_TRIANGLE_STRIP);
 	renderCommand_->geometry().setNumElementsPerVertex(sizeof(Vertex) / sizeof(float));
+
+	// An empty string is made of a single empty line
+	splitLines(string_.data(), 0, 0, lines_);
 }
 
 ///////////////////////////////////////////////////////////
@@ -73,8 +85,10 @@ void TextNode::enableKerning(bool withKerning)
 	if (withKerning != withKerning_)
 	{
 		withKerning_ = withKerning;
+		invalidateLines();
 		dirtyDraw_ = true;
 		dirtyBoundaries_ = true;
+		invalidateParentRecordedCommands();
 	}
 }
 
@@ -85,17 +99,98 @@ void TextNode::setAlignment(Alignment alignment)
 		alignment_ = alignment;
 		dirtyDraw_ = true;
 		dirtyBoundaries_ = true;
+		invalidateParentRecordedCommands();
 	}
 }
 
+void TextNode::setOutline(float width, const Colorf &color)
+{
+	outlineWidth_ = (width > 0.0f) ? width : 0.0f;
+	outlineColor_ = color;
+	invalidateParentRecordedCommands();
+}
+
+void TextNode::setShadow(const Vector2f &offset, const Colorf &color, float softness)
+{
+	shadowOffset_ = offset;
+	shadowColor_ = color;
+	shadowSoftness_ = (softness > 0.0f) ? softness : 0.0f;
+	invalidateParentRecordedCommands();
+}
+
 void TextNode::setString(const nctl::String &string)
 {
 	if (string_ != string)
 	{
+		// The assignment will truncate the string to the capacity of the current one
+		const unsigned int newLength = nctl::min(string.length(), string_.capacity() - 1);
+		newLines_.clear();
+		splitLines(string.data(), 0, newLength, newLines_);
+
+		// A line keeps its glyph vertices if an identical one was at the same index, or at the same index
+		// counting from the end, like when a log drops its first line to make room for a new one
+		const int shift = static_cast<int>(lines_.size()) - static_cast<int>(newLines_.size());
+		for (unsigned int i = 0; i < newLines_.size(); i++)
+		{
+			Line &newLine = newLines_[i];
+			const int candidates[2] = { static_cast<int>(i), static_cast<int>(i) + shift };
+			const unsigned int numCandidates = (shift != 0) ? 2 : 1;
+
+			for (unsigned int j = 0; j < numCandidates; j++)
+			{
+				if (candidates[j] < 0 || candidates[j] >= static_cast<int>(lines_.size()))
+					continue;
+
+				Line &oldLine = lines_[candidates[j]];
+				if (oldLine.dirty == false && oldLine.length == newLine.length &&
+				    memcmp(string_.data() + oldLine.start, string.data() + newLine.start, newLine.length) == 0)
+				{
+					nctl::swap(newLine.vertices, oldLine.vertices);
+					newLine.width = oldLine.width;
+					newLine.dirty = false;
+					// The cached vertices have been moved and cannot be reused twice
+					oldLine.dirty = true;
+					break;
+				}
+			}
+		}
+
 		string_ = string;
+		nctl::swap(lines_, newLines_);
 		dirtyDraw_ = true;
 		dirtyBoundaries_ = true;
+		invalidateParentRecordedCommands();
+	}
+}
+
+void TextNode::appendString(const nctl::String &string)
+{
+	const unsigned int oldLength = string_.length();
+	string_.append(string);
+	const unsigned int newLength = string_.length();
+
+	if (newLength == oldLength)
+		return;
+
+	// Extending the last line up to the first appended new line character
+	const char *data = string_.data();
+	unsigned int position = oldLength;
+	while (position < newLength && data[position] != '\n')
+		position++;
+
+	Line &lastLine = lines_[lines_.size() - 1];
+	if (position > oldLength)
+	{
+		lastLine.length = position - lastLine.start;
+		lastLine.dirty = true;
 	}
+
+	if (position < newLength)
+		splitLines(data, position + 1, newLength, lines_);
+
+	dirtyDraw_ = true;
+	dirtyBoundaries_ = true;
+	invalidateParentRecordedCommands();
 }
 
 void TextNode::transform()
@@ -113,47 +208,35 @@ void TextNode::draw(RenderQueue &renderQueue)
 
 	if (dirtyDraw_)
 	{
-		GLDebug::ScopedGroup scoped("Processing TextNode glyphs");
+		// No OpenGL debug group here, the node could be drawn by a worker thread of a parallel visit
+		ZoneScopedN("Processing TextNode glyphs");
 
+		calculateBoundaries();
 		// Clear every previous quad before drawing again
 		interleavedVertices_.clear();
 
-		unsigned int currentLine = 0;
-		xAdvance_ = calculateAlignment(currentLine) - width_ * 0.5f;
-		yAdvance_ = 0.0f - height_ * 0.5f;
-		const unsigned int length = string_.length();
-		for (unsigned int i = 0; i < length; i++)
+		// Cached line vertices are translated to their final position and joined by degenerate vertices
+		unsigned int glyphIndex = 0;
+		for (unsigned int i = 0; i < lines_.size(); i++)
 		{
-			if (string_[i] == '\n')
-			{
-				currentLine++;
-				xAdvance_ = calculateAlignment(currentLine) - width_ * 0.5f;
-				yAdvance_ += font_->base();
-			}
-			else
+			const Line &line = lines_[i];
+			const float xOrigin = calculateAlignment(i) - width_ * 0.5f;
+			const float yOrigin = height_ * 0.5f - i * static_cast<float>(font_->base());
+
+			for (unsigned int j = 0; j < line.vertices.size(); j += 4)
 			{
-				const FontGlyph *glyph = font_->glyph(static_cast<unsigned int>(string_[i]));
-				if (glyph)
-				{
-					Degenerate degen = Degenerate::NONE;
-					if (length > 1)
-					{
-						if (i == 0)
-							degen = Degenerate::END;
-						else if (i == length - 1)
-							degen = Degenerate::START;
-						else
-							degen = Degenerate::START_END;
-					}
-					processGlyph(glyph, degen);
-
-					if (withKerning_)
-					{
-						// font kerning
-						if (i < length - 1)
-							xAdvance_ += glyph->kerning(static_cast<unsigned int>(string_[i + 1]));
-					}
-				}
+				const Vertex *quad = &line.vertices[j];
+
+				if (glyphIndex > 0)
+					interleavedVertices_.pushBack(Vertex(quad[0].x + xOrigin, quad[0].y + yOrigin, quad[0].u, quad[0].v));
+
+				for (unsigned int k = 0; k < 4; k++)
+					interleavedVertices_.pushBack(Vertex(quad[k].x + xOrigin, quad[k].y + yOrigin, quad[k].u, quad[k].v));
+
+				if (glyphIndex < numGlyphs_ - 1)
+					interleavedVertices_.pushBack(Vertex(quad[3].x + xOrigin, quad[3].y + yOrigin, quad[3].u, quad[3].v));
+
+				glyphIndex++;
 			}
 		}
 
@@ -178,51 +261,35 @@ void TextNode::calculateBoundaries() const
 		const float oldWidth = width_;
 		const float oldHeight = height_;
 
-		lineLengths_.clear();
 		float xAdvanceMax = 0.0f; // longest line
-		xAdvance_ = 0.0f;
-		yAdvance_ = 0.0f;
-		for (unsigned int i = 0; i < string_.length(); i++)
+		unsigned int numRelaidLines = 0;
+		numGlyphs_ = 0;
+		for (unsigned int i = 0; i < lines_.size(); i++)
 		{
-			if (string_[i] == '\n')
-			{
-				lineLengths_.pushBack(xAdvance_);
-				if (xAdvance_ > xAdvanceMax)
-					xAdvanceMax = xAdvance_;
-				xAdvance_ = 0.0f;
-				yAdvance_ += font_->base();
-			}
-			else
+			Line &line = lines_[i];
+			if (line.dirty)
 			{
-				const FontGlyph *glyph = font_->glyph(static_cast<unsigned int>(string_[i]));
-				if (glyph)
-				{
-					xAdvance_ += glyph->xAdvance();
-					if (withKerning_)
-					{
-						// font kerning
-						if (i < string_.length() - 1)
-							xAdvance_ += glyph->kerning(static_cast<unsigned int>(string_[i + 1]));
-					}
-				}
+				layoutLine(line);
+				numRelaidLines++;
 			}
-		}
 
-		// If the string does not end with a new line character,
-		// last line height has not been taken into account before
-		if (!string_.isEmpty() && string_[string_.length() - 1] != '\n')
-			yAdvance_ += font_->base();
+			if (line.width > xAdvanceMax)
+				xAdvanceMax = line.width;
+			numGlyphs_ += line.vertices.size() / 4;
+		}
+		RenderStatistics::addTextLines(numRelaidLines, lines_.size() - numRelaidLines);
 
-		lineLengths_.pushBack(xAdvance_);
-		if (xAdvance_ > xAdvanceMax)
-			xAdvanceMax = xAdvance_;
+		// If the string ends with a new line character, the last empty line has no height
+		unsigned int numLines = lines_.size();
+		if (string_.isEmpty() || string_[string_.length() - 1] == '\n')
+			numLines--;
 
 		// Update node size and anchor points
 		TextNode *mutableNode = const_cast<TextNode *>(this);
 		// Total advance on the X-axis for the longest line (horizontal boundary)
 		mutableNode->width_ = xAdvanceMax;
 		// Total advance on the Y-axis for the entire string (vertical boundary)
-		mutableNode->height_ = yAdvance_;
+		mutableNode->height_ = static_cast<float>(numLines * font_->base());
 
 		if (oldWidth > 0.0f && oldHeight > 0.0f)
 		{
@@ -244,52 +311,102 @@ float TextNode::calculateAlignment(unsigned int lineIndex) const
 			alignOffset = 0.0f;
 			break;
 		case Alignment::CENTER:
-			alignOffset = (width_ - lineLengths_[lineIndex]) * 0.5f;
+			alignOffset = (width_ - lines_[lineIndex].width) * 0.5f;
 			break;
 		case Alignment::RIGHT:
-			alignOffset = width_ - lineLengths_[lineIndex];
+			alignOffset = width_ - lines_[lineIndex].width;
 			break;
 	}
 
 	return alignOffset;
 }
 
-void TextNode::processGlyph(const FontGlyph *glyph, Degenerate degen)
+void TextNode::layoutLine(Line &line) const
 {
-	const Vector2i size = glyph->size();
-	const Vector2i offset = glyph->offset();
+	line.vertices.clear();
+	float xAdvance = 0.0f;
 
-	const float leftPos = xAdvance_ + offset.x;
-	const float rightPos = leftPos + size.x;
-	const float topPos = -yAdvance_ - offset.y;
-	const float bottomPos = topPos - size.y;
-
-	const Vector2i texSize = font_->texture()->size();
-	const Recti texRect = glyph->texRect();
+	const char *data = string_.data() + line.start;
+	const unsigned int length = line.length;
+	unsigned int position = 0;
+	while (position < length)
+	{
+		unsigned int codePoint = 0;
+		const unsigned int nextPosition = position + nctl::Utf8::decode(data + position, length - position, codePoint);
 
-	const float leftCoord = float(texRect.x) / float(texSize.x);
-	const float rightCoord = float(texRect.x + texRect.w) / float(texSize.x);
-	const float bottomCoord = float(texRect.y + texRect.h) / float(texSize.y);
-	const float topCoord = float(texRect.y) / float(texSize.y);
+		const FontGlyph *glyph = font_->glyph(codePoint);
+		if (glyph)
+		{
+			// Glyph quads are shared by every node using the same font
+			const FontGlyph::Quad &quad = glyph->quad();
+			line.vertices.pushBack(Vertex(xAdvance + quad.left, quad.bottom, quad.leftCoord, quad.bottomCoord));
+			line.vertices.pushBack(Vertex(xAdvance + quad.left, quad.top, quad.leftCoord, quad.topCoord));
+			line.vertices.pushBack(Vertex(xAdvance + quad.right, quad.bottom, quad.rightCoord, quad.bottomCoord));
+			line.vertices.pushBack(Vertex(xAdvance + quad.right, quad.top, quad.rightCoord, quad.topCoord));
+			xAdvance += glyph->xAdvance();
+
+			if (withKerning_)
+			{
+				// font kerning
+				if (nextPosition < length)
+				{
+					unsigned int nextCodePoint = 0;
+					nctl::Utf8::decode(data + nextPosition, length - nextPosition, nextCodePoint);
+					xAdvance += font_->kerning(codePoint, nextCodePoint);
+				}
+			}
+		}
 
-	if (degen == Degenerate::START || degen == Degenerate::START_END)
-		interleavedVertices_.pushBack(Vertex(leftPos, bottomPos, leftCoord, bottomCoord));
+		position = nextPosition;
+	}
 
-	interleavedVertices_.pushBack(Vertex(leftPos, bottomPos, leftCoord, bottomCoord));
-	interleavedVertices_.pushBack(Vertex(leftPos, topPos, leftCoord, topCoord));
-	interleavedVertices_.pushBack(Vertex(rightPos, bottomPos, rightCoord, bottomCoord));
-	interleavedVertices_.pushBack(Vertex(rightPos, topPos, rightCoord, topCoord));
+	line.width = xAdvance;
+	line.dirty = false;
+}
 
-	if (degen == Degenerate::START_END || degen == Degenerate::END)
-		interleavedVertices_.pushBack(Vertex(rightPos, topPos, rightCoord, topCoord));
+void TextNode::splitLines(const char *data, unsigned int start, unsigned int end, nctl::Array<Line> &lines) const
+{
+	unsigned int lineStart = start;
+	for (unsigned int i = start; i <= end; i++)
+	{
+		if (i == end || data[i] == '\n')
+		{
+			// Elements past the array size are recycled together with their vertex storage
+			Line &line = lines[lines.size()];
+			line.start = lineStart;
+			line.length = i - lineStart;
+			line.width = 0.0f;
+			line.vertices.clear();
+			line.dirty = true;
+			lineStart = i + 1;
+		}
+	}
+}
 
-	xAdvance_ += glyph->xAdvance();
+void TextNode::invalidateLines()
+{
+	for (unsigned int i = 0; i < lines_.size(); i++)
+		lines_[i].dirty = true;
 }
 
 void TextNode::updateRenderCommand()
 {
 	renderCommand_->transformation() = worldMatrix_;
-	textnodeBlock_->uniform("color")->setFloatVector(Colorf(absColor()).data());
+	const Colorf color(absColor());
+	textnodeBlock_->uniform("color")->setFloatVector(color.data());
+
+	if (font_->hasDistanceField())
+	{
+		// Pixel distances are normalized to the range of values stored in the atlas
+		const float range = static_cast<float>(font_->distanceRange());
+		const float outlineWidth = nctl::min(outlineWidth_ / range, 0.5f);
+		const Colorf outlineColor(outlineColor_.r(), outlineColor_.g(), outlineColor_.b(), outlineColor_.a() * color.a());
+		const Colorf shadowColor(shadowColor_.r(), shadowColor_.g(), shadowColor_.b(), shadowColor_.a() * color.a());
+
+		textnodeBlock_->uniform("outlineColor")->setFloatVector(outlineColor.data());
+		textnodeBlock_->uniform("shadowColor")->setFloatVector(shadowColor.data());
+		textnodeBlock_->uniform("sdfParams")->setFloatValue(outlineWidth, shadowOffset_.x, shadowOffset_.y, shadowSoftness_ / range);
+	}
 }
 
 }
@@ -5,6 +5,7 @@
 #include "ITextureLoader.h"
 #include "GLTexture.h"
 #include "RenderStatistics.h"
+#include "MemoryStatistics.h"
 #include "tracy.h"
 
 namespace ncine {
@@ -25,6 +26,7 @@ Texture::Texture(const char *filename, int width, int height)
 {
 	ZoneScoped;
 	ZoneText(filename, strnlen(filename, nctl::String::MaxCStringLength));
+	MemoryStatistics::ScopedTag memoryTag(MemoryStatistics::Tags::TEXTURES);
 	glTexture_->bind();
 	setGLTextureLabel(filename);
 
@@ -36,14 +36,25 @@ bool TextureSaverPng::saveToFile(const Properties &properties, const PngProperti
 
 bool TextureSaverPng::saveToFile(const Properties &properties, const PngProperties &pngProperties, nctl::UniquePtr<IFile> fileHandle)
 {
-	const unsigned int bpp = (properties.format == Format::RGB8) ? 3 : 4;
+	unsigned int bpp = 4;
+	unsigned int pngColorType = PNG_COLOR_TYPE_RGB_ALPHA;
+	if (properties.format == Format::R8)
+	{
+		bpp = 1;
+		pngColorType = PNG_COLOR_TYPE_GRAY;
+	}
+	else if (properties.format == Format::RGB8)
+	{
+		bpp = 3;
+		pngColorType = PNG_COLOR_TYPE_RGB;
+	}
 
 	FATAL_ASSERT(properties.width > 0);
 	FATAL_ASSERT(properties.height > 0);
 	FATAL_ASSERT_MSG(properties.height <= PNG_SIZE_MAX / (properties.width * bpp), "Image data buffer would be too large");
 	FATAL_ASSERT_MSG(properties.height <= PNG_UINT_32_MAX / sizeof(png_bytep), "Image is too tall to process in memory");
 	FATAL_ASSERT(properties.pixels != nullptr);
-	ASSERT(properties.format == Format::RGB8 || properties.format == Format::RGBA8);
+	ASSERT(properties.format == Format::R8 || properties.format == Format::RGB8 || properties.format == Format::RGBA8);
 
 	LOGI_X("Saving \"%s\"", fileHandle->filename());
 	fileHandle->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
@@ -81,7 +92,6 @@ bool TextureSaverPng::saveToFile(const Properties &properties, const PngProperti
 
 	png_init_io(pngPtr, fileHandle->filePointer_);
 
-	const unsigned int pngColorType = (properties.format == Format::RGB8) ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_RGB_ALPHA;
 	// Write header (8 bit colour depth)
 	png_set_IHDR(pngPtr, infoPtr, properties.width, properties.height,
 	             8, pngColorType, PNG_INTERLACE_NONE,
@@ -1,4 +1,5 @@
 #include "GLBufferObject.h"
+#include "RenderStatistics.h"
 #include "tracy_opengl.h"
 
 namespace ncine {
@@ -41,9 +42,11 @@ bool GLBufferObject::bind() const
 	if (boundBuffers_[target_] != glHandle_)
 	{
 		glBindBuffer(target_, glHandle_);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::BUFFER);
 		boundBuffers_[target_] = glHandle_;
 		return true;
 	}
+	RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::BUFFER);
 	return false;
 }
 
@@ -52,9 +55,11 @@ bool GLBufferObject::unbind() const
 	if (boundBuffers_[target_] != 0)
 	{
 		glBindBuffer(target_, 0);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::BUFFER);
 		boundBuffers_[target_] = 0;
 		return true;
 	}
+	RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::BUFFER);
 	return false;
 }
 
@@ -97,7 +102,10 @@ void GLBufferObject::bindBufferBase(GLuint index)
 		boundBufferRange_[index].ptrsize = 0;
 		boundIndexBase_[index] = glHandle_;
 		glBindBufferBase(target_, index, glHandle_);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::BUFFER);
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::BUFFER);
 }
 
 void GLBufferObject::bindBufferRange(GLuint index, GLintptr offset, GLsizei ptrsize)
@@ -116,7 +124,10 @@ void GLBufferObject::bindBufferRange(GLuint index, GLintptr offset, GLsizei ptrs
 		boundBufferRange_[index].offset = offset;
 		boundBufferRange_[index].ptrsize = ptrsize;
 		glBindBufferRange(target_, index, glHandle_, offset, ptrsize);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::BUFFER);
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::BUFFER);
 }
 
 void *GLBufferObject::mapBufferRange(GLintptr offset, GLsizeiptr length, GLbitfield access)
@@ -159,9 +170,11 @@ bool GLBufferObject::bindHandle(GLenum target, GLuint glHandle)
 	if (boundBuffers_[target] != glHandle)
 	{
 		glBindBuffer(target, glHandle);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::BUFFER);
 		boundBuffers_[target] = glHandle;
 		return true;
 	}
+	RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::BUFFER);
 	return false;
 }
 
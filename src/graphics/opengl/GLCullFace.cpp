@@ -1,5 +1,6 @@
 #include "common_macros.h"
 #include "GLCullFace.h"
+#include "RenderStatistics.h"
 
 namespace ncine {
 
@@ -23,8 +24,11 @@ void GLCullFace::enable()
 	if (enabled_ == false)
 	{
 		glEnable(GL_CULL_FACE);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::CULL_FACE);
 		enabled_ = true;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::CULL_FACE);
 }
 
 void GLCullFace::disable()
@@ -32,8 +36,11 @@ void GLCullFace::disable()
 	if (enabled_ == true)
 	{
 		glDisable(GL_CULL_FACE);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::CULL_FACE);
 		enabled_ = false;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::CULL_FACE);
 }
 
 void GLCullFace::set(GLenum mode)
@@ -41,8 +48,11 @@ void GLCullFace::set(GLenum mode)
 	if (mode != mode_)
 	{
 		glCullFace(mode);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::CULL_FACE);
 		mode_ = mode;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::CULL_FACE);
 }
 
 void GLCullFace::pushState()
@@ -1,5 +1,6 @@
 #include "common_macros.h"
 #include "GLDepthTest.h"
+#include "RenderStatistics.h"
 
 namespace ncine {
 
@@ -23,8 +24,11 @@ void GLDepthTest::enable()
 	if (enabled_ == false)
 	{
 		glEnable(GL_DEPTH_TEST);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::DEPTH);
 		enabled_ = true;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::DEPTH);
 }
 
 void GLDepthTest::disable()
@@ -32,8 +36,11 @@ void GLDepthTest::disable()
 	if (enabled_ == true)
 	{
 		glDisable(GL_DEPTH_TEST);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::DEPTH);
 		enabled_ = false;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::DEPTH);
 }
 
 void GLDepthTest::enableDepthMask()
@@ -41,8 +48,11 @@ void GLDepthTest::enableDepthMask()
 	if (depthMaskEnabled_ == false)
 	{
 		glDepthMask(GL_TRUE);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::DEPTH);
 		depthMaskEnabled_ = true;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::DEPTH);
 }
 
 void GLDepthTest::disableDepthMask()
@@ -50,8 +60,11 @@ void GLDepthTest::disableDepthMask()
 	if (depthMaskEnabled_ == true)
 	{
 		glDepthMask(GL_FALSE);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::DEPTH);
 		depthMaskEnabled_ = false;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::DEPTH);
 }
 
 void GLDepthTest::pushState()
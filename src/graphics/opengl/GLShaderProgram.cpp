@@ -1,6 +1,7 @@
 #include "GLShaderProgram.h"
 #include "GLShader.h"
 #include "GLDebug.h"
+#include "RenderStatistics.h"
 #include <nctl/String.h>
 #include <cstring> // for strnlen()
 #include "tracy.h"
@@ -118,8 +119,59 @@ void GLShaderProgram::use()
 	{
 		deferredQueries();
 		glUseProgram(glHandle_);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::PROGRAM);
 		boundProgram_ = glHandle_;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::PROGRAM);
+}
+
+void GLShaderProgram::setBinaryRetrievableHint()
+{
+#ifndef __EMSCRIPTEN__
+	glProgramParameteri(glHandle_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+}
+
+int GLShaderProgram::binaryLength() const
+{
+	GLint length = 0;
+#ifndef __EMSCRIPTEN__
+	// The binary is not retrieved until the deferred link status check has succeeded
+	if (status_ == Status::LINKED || status_ == Status::LINKED_WITH_INTROSPECTION)
+		glGetProgramiv(glHandle_, GL_PROGRAM_BINARY_LENGTH, &length);
+#endif
+	return length;
+}
+
+bool GLShaderProgram::retrieveBinary(int bufferSize, unsigned int &binaryFormat, void *buffer) const
+{
+	GLsizei length = 0;
+#ifndef __EMSCRIPTEN__
+	if ((status_ == Status::LINKED || status_ == Status::LINKED_WITH_INTROSPECTION) && bufferSize > 0)
+	{
+		GLenum format = 0;
+		glGetProgramBinary(glHandle_, bufferSize, &length, &format, buffer);
+		binaryFormat = format;
+	}
+#endif
+	return (length > 0);
+}
+
+bool GLShaderProgram::loadBinary(unsigned int binaryFormat, const void *buffer, int bufferSize, Introspection introspection)
+{
+#ifndef __EMSCRIPTEN__
+	introspection_ = introspection;
+	glProgramBinary(glHandle_, binaryFormat, buffer, bufferSize);
+
+	// There are no shaders to check, the link status is queried immediately regardless of the query phase
+	if (checkLinking())
+	{
+		performIntrospection();
+		return true;
+	}
+#endif
+	return false;
 }
 
 ///////////////////////////////////////////////////////////
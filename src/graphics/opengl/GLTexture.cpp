@@ -1,4 +1,5 @@
 #include "GLTexture.h"
+#include "RenderStatistics.h"
 #include "tracy_opengl.h"
 
 namespace ncine {
@@ -39,15 +40,21 @@ void GLTexture::bind(unsigned int textureUnit) const
 	if (boundUnit_ != textureUnit)
 	{
 		glActiveTexture(GL_TEXTURE0 + textureUnit);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::TEXTURE);
 		boundUnit_ = textureUnit;
 		textureUnit_ = textureUnit;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::TEXTURE);
 
 	if (boundTextures_[textureUnit][target_] != glHandle_)
 	{
 		glBindTexture(target_, glHandle_);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::TEXTURE);
 		boundTextures_[textureUnit][target_] = glHandle_;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::TEXTURE);
 }
 
 void GLTexture::unbind() const
@@ -55,14 +62,20 @@ void GLTexture::unbind() const
 	if (boundUnit_ != textureUnit_)
 	{
 		glActiveTexture(GL_TEXTURE0 + textureUnit_);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::TEXTURE);
 		boundUnit_ = textureUnit_;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::TEXTURE);
 
 	if (boundTextures_[textureUnit_][target_] != 0)
 	{
 		glBindTexture(target_, 0);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::TEXTURE);
 		boundTextures_[textureUnit_][target_] = 0;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::TEXTURE);
 }
 
 void GLTexture::texImage2D(GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *data)
@@ -132,15 +145,20 @@ bool GLTexture::bindHandle(GLenum target, GLuint glHandle, unsigned int textureU
 	if (boundUnit_ != textureUnit)
 	{
 		glActiveTexture(GL_TEXTURE0 + textureUnit);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::TEXTURE);
 		boundUnit_ = textureUnit;
 	}
+	else
+		RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::TEXTURE);
 
 	if (boundTextures_[textureUnit][target] != glHandle)
 	{
 		glBindTexture(target, glHandle);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::TEXTURE);
 		boundTextures_[textureUnit][target] = glHandle;
 		return true;
 	}
+	RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::TEXTURE);
 	return false;
 }
 
@@ -1,4 +1,5 @@
 #include "GLVertexArrayObject.h"
+#include "RenderStatistics.h"
 
 namespace ncine {
 
@@ -35,9 +36,11 @@ bool GLVertexArrayObject::bind() const
 	if (boundVAO_ != glHandle_)
 	{
 		glBindVertexArray(glHandle_);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::VAO);
 		boundVAO_ = glHandle_;
 		return true;
 	}
+	RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::VAO);
 	return false;
 }
 
@@ -46,9 +49,11 @@ bool GLVertexArrayObject::unbind() const
 	if (boundVAO_ != 0)
 	{
 		glBindVertexArray(0);
+		RenderStatistics::addStateChange(RenderStatistics::StateTypes::VAO);
 		boundVAO_ = 0;
 		return true;
 	}
+	RenderStatistics::addSkippedStateChange(RenderStatistics::StateTypes::VAO);
 	return false;
 }
 
@@ -4,6 +4,24 @@
 
 namespace ncine {
 
+namespace {
+	const nctl::hash_t FnvOffsetBasis = 2166136261U;
+	const nctl::hash_t FnvPrime = 16777619U;
+
+	/// Mixes the bytes of a value in a FNV-1a hash
+	template <class T>
+	nctl::hash_t hashValue(nctl::hash_t hash, const T &value)
+	{
+		const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+		for (unsigned int i = 0; i < sizeof(T); i++)
+		{
+			hash ^= static_cast<nctl::hash_t>(bytes[i]);
+			hash *= FnvPrime;
+		}
+		return hash;
+	}
+}
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
@@ -28,7 +46,11 @@ bool GLVertexFormat::Attribute::operator==(const Attribute &other) const
 	         other.normalized_ == normalized_ &&
 	         other.stride_ == stride_ &&
 	         other.pointer_ == pointer_ &&
-	         other.baseOffset_ == baseOffset_));
+#if (defined(__ANDROID__) && !GL_ES_VERSION_3_2) || defined(WITH_ANGLE) || defined(__EMSCRIPTEN__)
+	         // The base offset is only part of the VAO state when it is added to the attribute pointer
+	         other.baseOffset_ == baseOffset_ &&
+#endif
+	         other.divisor_ == divisor_));
 }
 
 bool GLVertexFormat::Attribute::operator!=(const Attribute &other) const
@@ -47,6 +69,7 @@ void GLVertexFormat::Attribute::init(unsigned int index, GLint size, GLenum type
 	stride_ = 0;
 	pointer_ = nullptr;
 	baseOffset_ = 0;
+	divisor_ = 0;
 }
 
 void GLVertexFormat::define()
@@ -82,6 +105,8 @@ void GLVertexFormat::define()
 					glVertexAttribPointer(attributes_[i].index_, attributes_[i].size_, attributes_[i].type_, attributes_[i].normalized_, attributes_[i].stride_, pointer);
 					break;
 			}
+			// Always specified, as a reused VAO might have been defined with a different divisor
+			glVertexAttribDivisor(attributes_[i].index_, attributes_[i].divisor_);
 		}
 	}
 
@@ -121,4 +146,34 @@ bool GLVertexFormat::operator!=(const GLVertexFormat &other) const
 	return !operator==(other);
 }
 
+nctl::hash_t GLVertexFormat::hash() const
+{
+	nctl::hash_t hash = hashValue(FnvOffsetBasis, ibo_);
+	for (unsigned int i = 0; i < MaxAttributes; i++)
+	{
+		const Attribute &attribute = attributes_[i];
+		// Disabled attributes are all equal, whatever the value of the other members
+		hash = hashValue(hash, attribute.enabled_);
+		if (attribute.enabled_)
+		{
+			// Like in the equality operator, buffers are compared by their OpenGL handle
+			const GLuint vboHandle = attribute.vbo_ ? attribute.vbo_->glHandle() : 0;
+			hash = hashValue(hash, vboHandle);
+			hash = hashValue(hash, attribute.index_);
+			hash = hashValue(hash, attribute.size_);
+			hash = hashValue(hash, attribute.type_);
+			hash = hashValue(hash, attribute.normalized_);
+			hash = hashValue(hash, attribute.stride_);
+			hash = hashValue(hash, attribute.pointer_);
+#if (defined(__ANDROID__) && !GL_ES_VERSION_3_2) || defined(WITH_ANGLE) || defined(__EMSCRIPTEN__)
+			hash = hashValue(hash, attribute.baseOffset_);
+#endif
+			hash = hashValue(hash, attribute.divisor_);
+		}
+	}
+
+	// The null hash marks empty buckets in the hashmaps
+	return (hash != nctl::NullHash) ? hash : 0;
+}
+
 }
@@ -7,9 +7,18 @@
 #include "IAudioDevice.h"
 #include <nctl/List.h>
 #include <nctl/StaticArray.h>
+#include <nctl/UniquePtr.h>
+
+#ifdef WITH_THREADS
+	#include "Thread.h"
+	#include "ThreadSync.h"
+#endif
 
 namespace ncine {
 
+class AudioStream;
+class ALAudioSink;
+
 /// It represents the interface to the OpenAL audio device
 class ALAudioDevice : public IAudioDevice
 {
@@ -35,11 +44,25 @@ class ALAudioDevice : public IAudioDevice
 
 	unsigned int nextAvailableSource() override;
 	void registerPlayer(IAudioPlayer *player) override;
+	void unregisterPlayer(IAudioPlayer *player) override;
 	void updatePlayers() override;
 
+	inline AudioMixer *mixer() override { return mixer_.get(); }
+
+	/// Returns true if audio streams are decoded by a dedicated thread
+	bool hasDecodeThread() const;
+	/// Returns the sink streaming the software mixer output, if any
+	inline const ALAudioSink *mixerSink() const { return mixerSink_.get(); }
+
   private:
 	/// Maximum number of OpenAL sources (HACK: should use a query)
 	static const unsigned int MaxSources = 16;
+	/// Output frequency of the software mixer
+	static const int MixerFrequency = 44100;
+	/// Number of OpenAL buffers streaming the software mixer output
+	static const unsigned int MixerNumBuffers = 4;
+	/// Number of frames in every buffer streaming the software mixer output
+	static const unsigned int MixerFramesPerBuffer = 1024;
 
 	/// The OpenAL device
 	ALCdevice *device_;
@@ -55,6 +78,42 @@ class ALAudioDevice : public IAudioDevice
 	/// The OpenAL device name string
 	const char *deviceName_;
 
+	/// The software mixer for voices that do not use an OpenAL source each
+	nctl::UniquePtr<AudioMixer> mixer_;
+	/// The sink streaming the mixer output through a dedicated OpenAL source
+	nctl::UniquePtr<ALAudioSink> mixerSink_;
+
+#ifdef WITH_THREADS
+	/// The thread decoding audio streams in the background
+	Thread decodeThread_;
+	/// The mutex protecting the array of streams to decode and the running flag
+	Mutex decodeMutex_;
+	/// The condition variable signalled when streams might need new decoded buffers
+	CondVariable decodeCondVar_;
+	/// The condition variable signalled when the decode thread has finished decoding a stream
+	CondVariable streamDecodedCondVar_;
+	/// The array of audio streams that the decode thread fills
+	nctl::StaticArray<AudioStream *, MaxSources> decodingStreams_;
+	/// The stream being decoded without holding the mutex, it cannot be destroyed until the decoding has finished
+	const AudioStream *currentDecodingStream_;
+	/// The flag is `false` when the decode thread has to terminate
+	bool decodeThreadRunning_;
+	/// The flag is `true` if the decode thread has been created
+	bool hasDecodeThread_;
+
+	/// The function run by the decode thread
+	static void decodeThreadFunction(void *arg);
+	/// Returns true if the stream is still in the array of streams to decode, the mutex should be held
+	bool isDecodingStream(const AudioStream *stream) const;
+	/// Waits until the decode thread is not decoding the stream anymore, or any stream if `nullptr`, the mutex should be held
+	void waitForStreamDecoded(const AudioStream *stream);
+#endif
+
+	/// Removes the player at the specified index and its stream from the decoding ones
+	void removePlayerAt(unsigned int index);
+	/// Removes every player and every stream from the decoding ones
+	void removeAllPlayers();
+
 	/// Deleted copy constructor
 	ALAudioDevice(const ALAudioDevice &) = delete;
 	/// Deleted assignment operator
@@ -0,0 +1,58 @@
+#ifndef CLASS_NCINE_ALAUDIOSINK
+#define CLASS_NCINE_ALAUDIOSINK
+
+#include "IAudioSink.h"
+#include <nctl/UniquePtr.h>
+
+namespace ncine {
+
+/// An audio sink that streams the mixer output through a dedicated OpenAL source
+class ALAudioSink : public IAudioSink
+{
+  public:
+	ALAudioSink(int frequency, unsigned int numBuffers, unsigned int framesPerBuffer);
+	~ALAudioSink() override;
+
+	/// Returns the OpenAL id of the dedicated source
+	inline unsigned int sourceId() const { return sourceId_; }
+	/// Returns the number of times the source has run out of queued buffers
+	inline unsigned int numUnderruns() const { return numUnderruns_; }
+
+	/// Unqueues the processed buffers and returns the frames that can be written to the free ones
+	unsigned int numWritableFrames() override;
+	void write(const int16_t *frames, unsigned int numFrames) override;
+
+	/// Pauses the dedicated source
+	void pause();
+	/// Resumes the dedicated source
+	void resume();
+
+  private:
+	int frequency_;
+	unsigned int numBuffers_;
+	unsigned int framesPerBuffer_;
+
+	unsigned int sourceId_;
+	nctl::UniquePtr<unsigned int[]> buffersIds_;
+	/// Index of the next available OpenAL buffer
+	unsigned int nextAvailableBufferIndex_;
+
+	/// Frames accumulated until a whole buffer can be queued
+	nctl::UniquePtr<int16_t[]> pendingFrames_;
+	unsigned int numPendingFrames_;
+	bool isSourceStarted_;
+	bool isPaused_;
+	unsigned int numUnderruns_;
+
+	/// Queues the pending frames into the next available buffer
+	void queuePendingFrames();
+
+	/// Deleted copy constructor
+	ALAudioSink(const ALAudioSink &) = delete;
+	/// Deleted assignment operator
+	ALAudioSink &operator=(const ALAudioSink &) = delete;
+};
+
+}
+
+#endif
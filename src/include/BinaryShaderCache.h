@@ -0,0 +1,84 @@
+#ifndef CLASS_NCINE_BINARYSHADERCACHE
+#define CLASS_NCINE_BINARYSHADERCACHE
+
+#include <nctl/String.h>
+#include <nctl/Array.h>
+#include <nctl/HashFunctions.h>
+#include "GLShaderProgram.h"
+
+namespace ncine {
+
+/// A class that stores linked shader program binaries on disk and loads them back
+/*! Cache entries are keyed by the hash of the shader sources, the OpenGL vendor, renderer
+ *  and version strings, and the fixed batch size. Every mismatch or rejected binary is a miss. */
+class BinaryShaderCache
+{
+  public:
+	BinaryShaderCache(bool enabled, const char *dirname);
+
+	/// Returns true if the cache is enabled and program binaries are supported
+	inline bool isAvailable() const { return isAvailable_; }
+	/// Returns the number of programs loaded from the cache
+	inline unsigned int numHits() const { return numHits_; }
+	/// Returns the number of programs that had to be compiled
+	inline unsigned int numMisses() const { return numMisses_; }
+
+	/// Returns the hash of the vertex and fragment shader sources
+	nctl::hash_t hashSources(const char *vertexSource, const char *fragmentSource) const;
+	/// Returns the hash of the vertex and fragment shader sources read from files
+	nctl::hash_t hashFiles(const char *vertexFile, const char *fragmentFile) const;
+
+	/// Loads the program binary with the specified sources hash, returns false on a miss
+	bool loadFromCache(nctl::hash_t sourcesHash, GLShaderProgram &program, GLShaderProgram::Introspection introspection);
+	/// Saves the binary of a linked program with the specified sources hash
+	bool saveToCache(nctl::hash_t sourcesHash, const GLShaderProgram &program);
+	/// Saves the binary of a program now or, if its link status has not been checked yet, when `savePendingToCache()` finds it linked
+	void saveToCacheWhenLinked(nctl::hash_t sourcesHash, const GLShaderProgram &program);
+	/// Saves the binaries of the pending programs whose deferred link status check has completed
+	void savePendingToCache();
+	/// Returns true if some programs are still waiting for their deferred link status check
+	inline bool hasPendingPrograms() const { return pendingPrograms_.isEmpty() == false; }
+
+  private:
+	/// The header that precedes the binary data in every cache file
+	struct Header
+	{
+		uint32_t signature;
+		uint32_t version;
+		uint32_t platformHash;
+		uint32_t sourcesHash;
+		uint32_t batchSize;
+		uint32_t binaryFormat;
+		uint32_t binaryLength;
+	};
+
+	/// A program that will be saved once its deferred link status check has completed
+	struct PendingProgram
+	{
+		PendingProgram()
+		    : sourcesHash(0), program(nullptr) {}
+		PendingProgram(nctl::hash_t hash, const GLShaderProgram *prog)
+		    : sourcesHash(hash), program(prog) {}
+
+		nctl::hash_t sourcesHash;
+		const GLShaderProgram *program;
+	};
+
+	static const uint32_t Signature = 0x4E435342; // "NCSB"
+	static const uint32_t Version = 1;
+
+	bool isAvailable_;
+	nctl::hash_t platformHash_;
+	unsigned int batchSize_;
+	unsigned int numHits_;
+	unsigned int numMisses_;
+	nctl::String path_;
+	nctl::Array<PendingProgram> pendingPrograms_;
+
+	/// Returns the path of the cache file for the specified sources hash
+	nctl::String cacheFilePath(nctl::hash_t sourcesHash) const;
+};
+
+}
+
+#endif
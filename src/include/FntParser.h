@@ -2,6 +2,7 @@
 #define CLASS_NCINE_FNTPARSER
 
 #include <nctl/String.h>
+#include <nctl/Array.h>
 
 namespace ncine {
 
@@ -106,6 +107,23 @@ class DLL_PUBLIC FntParser
 		int amount = 0;
 	};
 
+	enum class FieldType : unsigned char
+	{
+		NONE = 0,
+		/// Single channel signed distance field
+		SDF = 1,
+		/// Multi-channel signed distance field, the distance is the median of the RGB channels
+		MSDF = 2
+	};
+
+	/// Non-standard tag describing a distance field atlas
+	struct DistanceFieldTag
+	{
+		FieldType fieldType = FieldType::NONE;
+		/// Distance in texels covered by the full range of channel values
+		int distanceRange = 0;
+	};
+
 	/// Loads a FNT file in a memory buffer then parses it
 	explicit FntParser(const char *fntFilename);
 	/// Parses a FNT file from a memory buffer of the specified size
@@ -115,6 +133,9 @@ class DLL_PUBLIC FntParser
 	const InfoTag &infoTag() const { return infoTag_; }
 	/// Returns the "common" tag structure from a parsed FNT file
 	const CommonTag &commonTag() const { return commonTag_; }
+	/// Returns the "distanceField" tag structure from a parsed FNT file
+	/*! \note The field type is `NONE` if the tag is missing */
+	const DistanceFieldTag &distanceFieldTag() const { return distanceFieldTag_; }
 	/// Returns the number of parsed "page" tag structures
 	unsigned int numPageTags() const { return numPageTags_; }
 	/// Returns the specified "page" tag structure from a parsed FNT file
@@ -146,23 +167,23 @@ class DLL_PUBLIC FntParser
 
   private:
 	static const int MaxPageTags = 1;
-	static const int MaxCharTags = 256;
-	static const int MaxKerningTags = 512;
 
 	/// Parsed "info" tag from the FNT file
 	InfoTag infoTag_;
 	/// Parsed "common" tag from the FNT file
 	CommonTag commonTag_;
+	/// Parsed "distanceField" tag from the FNT file
+	DistanceFieldTag distanceFieldTag_;
 	/// Parsed "page" tags from the FNT file
 	PageTag pageTags_[MaxPageTags];
 	/// Parsed "chars" tag from the FNT file
 	CharsTag charsTag_;
 	/// Parsed "char" tags from the FNT file
-	CharTag charTags_[MaxCharTags];
+	nctl::Array<CharTag> charTags_;
 	/// Parsed "kernings" tag from the FNT file
 	KerningsTag kerningsTag_;
 	/// Parsed "kerning" tags from the FNT file
-	KerningTag kerningTags_[MaxKerningTags];
+	nctl::Array<KerningTag> kerningTags_;
 
 	unsigned int numPageTags_;
 	unsigned int numCharTags_;
@@ -175,6 +196,7 @@ class DLL_PUBLIC FntParser
 
 	void parseInfoTag(const char *buffer);
 	void parseCommonTag(const char *buffer);
+	void parseDistanceFieldTag(const char *buffer);
 	void parsePageTag(const char *buffer, unsigned int index);
 	void parseCharsTag(const char *buffer);
 	void parseCharTag(const char *buffer, unsigned int index);
@@ -184,6 +206,7 @@ class DLL_PUBLIC FntParser
 	/// Goes to the next field in a tag, skipping white spaces
 	const char *nextField(const char *buffer) const;
 	/// Extracts a value containing spaces into a string
+	/*! \note The value is truncated to the string capacity without splitting a UTF-8 sequence */
 	bool extractValueWithSpaces(const char *buffer, nctl::String &string) const;
 };
 
@@ -1,7 +1,6 @@
 #ifndef CLASS_NCINE_FONTGLYPH
 #define CLASS_NCINE_FONTGLYPH
 
-#include <nctl/Array.h>
 #include "Rect.h"
 
 namespace ncine {
@@ -10,6 +9,19 @@ namespace ncine {
 class FontGlyph
 {
   public:
+	/// Glyph quad positions relative to the pen, with normalized texture coordinates
+	struct Quad
+	{
+		float left = 0.0f;
+		float top = 0.0f;
+		float right = 0.0f;
+		float bottom = 0.0f;
+		float leftCoord = 0.0f;
+		float topCoord = 0.0f;
+		float rightCoord = 0.0f;
+		float bottomCoord = 0.0f;
+	};
+
 	FontGlyph();
 	FontGlyph(unsigned int x, unsigned int y, unsigned int width, unsigned int height,
 	          int xOffset, int yOffset, int xAdvance);
@@ -26,28 +38,13 @@ class FontGlyph
 	inline Vector2i offset() const { return Vector2i(xOffset_, yOffset_); }
 	/// Returns the X offset to advance in order to start rendering the next glyph
 	inline int xAdvance() const { return xAdvance_; }
+	/// Returns the glyph quad, precalculated once for every text node using the font
+	inline const Quad &quad() const { return quad_; }
 
-	/// Adds the kerning amount for a subsequent glyph
-	inline void addKerning(unsigned int secondGlyph, int amount) { kernings_.pushBack(Kerning(secondGlyph, amount)); }
-	/// Returns the kerning amount for a subsequent glyph
-	int kerning(unsigned int secondGlyph) const;
+	/// Precalculates the glyph quad for a texture atlas of the specified size
+	void updateQuad(unsigned int texWidth, unsigned int texHeight);
 
   private:
-	/// A structure holding glyph pairs kerning offsets
-	struct Kerning
-	{
-		unsigned int secondGlyph_;
-		int amount_;
-
-		Kerning()
-		    : secondGlyph_(0), amount_(0) {}
-		Kerning(unsigned int secondGlyph, int amount)
-		{
-			secondGlyph_ = secondGlyph;
-			amount_ = amount;
-		}
-	};
-
 	unsigned int x_;
 	unsigned int y_;
 	unsigned int width_;
@@ -55,7 +52,7 @@ class FontGlyph
 	int xOffset_;
 	int yOffset_;
 	int xAdvance_;
-	nctl::Array<Kerning> kernings_;
+	Quad quad_;
 };
 
 inline void FontGlyph::set(unsigned int x, unsigned int y, unsigned int width, unsigned int height,
@@ -0,0 +1,51 @@
+#ifndef CLASS_NCINE_FRAMEBENCHMARK
+#define CLASS_NCINE_FRAMEBENCHMARK
+
+#include <nctl/UniquePtr.h>
+#include <nctl/String.h>
+
+namespace ncine {
+
+class IFile;
+
+/// A class that writes the timings and the rendering statistics of a fixed number of frames in a CSV file
+class FrameBenchmark
+{
+  public:
+	/// Opens the file and writes the header line
+	FrameBenchmark(const char *filename, unsigned int numFrames);
+	~FrameBenchmark();
+
+	/// Returns true if the file could be opened
+	bool isOpened() const;
+
+	/// Writes a line with the duration of the frame, the application timings and the rendering statistics
+	/*! \return True when all the frames have been recorded */
+	bool recordFrame(float frameTime, const float *timings);
+
+	/// Returns the number of frames to record
+	inline unsigned int numFrames() const { return numFrames_; }
+	/// Returns the number of frames recorded so far
+	inline unsigned int numRecordedFrames() const { return numRecordedFrames_; }
+
+  private:
+	nctl::UniquePtr<IFile> fileHandle_;
+	/// The string used to format every line of the file
+	nctl::String line_;
+	unsigned int numFrames_;
+	unsigned int numRecordedFrames_;
+
+	/// Sum of the frame durations to log the average at the end
+	double frameTimeSum_;
+	/// Longest frame duration to log at the end
+	float maxFrameTime_;
+
+	/// Deleted copy constructor
+	FrameBenchmark(const FrameBenchmark &) = delete;
+	/// Deleted assignment operator
+	FrameBenchmark &operator=(const FrameBenchmark &) = delete;
+};
+
+}
+
+#endif
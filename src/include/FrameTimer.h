@@ -29,6 +29,10 @@ class FrameTimer
 	inline float frameInterval() const { return frameStart_.secondsSince(); }
 	/// Returns the average FPS during the update interval
 	inline float averageFps() const { return fps_; }
+	/// Returns the standard deviation in seconds of the frame intervals during the update interval
+	inline float frameIntervalDeviation() const { return frameIntervalDeviation_; }
+	/// Returns the longest frame interval in seconds during the update interval
+	inline float maxFrameInterval() const { return maxFrameInterval_; }
 
   private:
 	/// Number of seconds between two log events (user defined)
@@ -57,6 +61,17 @@ class FrameTimer
 
 	/// Average FPS calulated during the specified interval
 	float fps_;
+
+	/// Sum of the frame intervals since the last average FPS calculation
+	double intervalSum_;
+	/// Sum of the squared frame intervals since the last average FPS calculation
+	double intervalSquaresSum_;
+	/// Longest frame interval since the last average FPS calculation
+	float intervalMax_;
+	/// Standard deviation of the frame intervals calculated during the specified interval
+	float frameIntervalDeviation_;
+	/// Longest frame interval during the specified interval
+	float maxFrameInterval_;
 };
 
 }
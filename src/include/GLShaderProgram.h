@@ -58,6 +58,16 @@ class GLShaderProgram
 	void link(Introspection introspection);
 	void use();
 
+	/// Hints the implementation that the program binary will be retrieved after linking
+	void setBinaryRetrievableHint();
+	/// Returns the length in bytes of the linked program binary, or zero if it is not available
+	int binaryLength() const;
+	/// Retrieves the linked program binary and its format, returns false on failure
+	bool retrieveBinary(int bufferSize, unsigned int &binaryFormat, void *buffer) const;
+	/// Loads a previously retrieved program binary instead of compiling and linking shaders
+	/*! \returns False if the implementation rejects the binary, as it happens after a driver update */
+	bool loadBinary(unsigned int binaryFormat, const void *buffer, int bufferSize, Introspection introspection);
+
   private:
 	/// Max number of discoverable uniforms
 	static const int MaxNumUniforms = 32;
@@ -5,6 +5,7 @@
 #include "common_headers.h"
 
 #include <nctl/StaticArray.h>
+#include <nctl/HashFunctions.h>
 
 namespace ncine {
 
@@ -21,7 +22,7 @@ class GLVertexFormat
 	{
 	  public:
 		Attribute()
-		    : enabled_(false), vbo_(nullptr), index_(0), size_(-1), type_(GL_FLOAT), stride_(0), pointer_(nullptr), baseOffset_(0) {}
+		    : enabled_(false), vbo_(nullptr), index_(0), size_(-1), type_(GL_FLOAT), stride_(0), pointer_(nullptr), baseOffset_(0), divisor_(0) {}
 
 		void init(unsigned int index, GLint size, GLenum type);
 		bool operator==(const Attribute &other) const;
@@ -38,6 +39,8 @@ class GLVertexFormat
 		inline void setSize(GLint size) { size_ = size; }
 		inline void setType(GLenum type) { type_ = type; }
 		inline void setNormalized(bool normalized) { normalized_ = normalized; }
+		/// Sets the number of instances that will pass between updates of the attribute, zero for a per-vertex attribute
+		inline void setDivisor(GLuint divisor) { divisor_ = divisor; }
 
 	  private:
 		bool enabled_;
@@ -50,6 +53,8 @@ class GLVertexFormat
 		const GLvoid *pointer_;
 		/// Used to simulate missing `glDrawElementsBaseVertex()` on OpenGL ES 3.0
 		unsigned int baseOffset_;
+		/// The attribute divisor for instanced rendering
+		GLuint divisor_;
 
 		friend class GLVertexFormat;
 	};
@@ -69,6 +74,10 @@ class GLVertexFormat
 	bool operator==(const GLVertexFormat &other) const;
 	bool operator!=(const GLVertexFormat &other) const;
 
+	/// Returns a hash of the format, equal formats have the same hash
+	/*! \note The returned value is never `nctl::NullHash` */
+	nctl::hash_t hash() const;
+
   private:
 	nctl::StaticArray<Attribute, MaxAttributes> attributes_;
 	const GLBufferObject *ibo_;
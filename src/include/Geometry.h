@@ -54,6 +54,11 @@ class Geometry
 	/// Shares the VBO of another `Geometry` object
 	void shareVbo(const Geometry *geometry);
 
+	/// Returns true if the VBO contains per-instance attributes instead of per-vertex ones
+	inline bool hasInstanceAttributes() const { return hasInstanceAttributes_; }
+	/// Sets the flag that marks the VBO as containing per-instance attributes instead of per-vertex ones
+	inline void setHasInstanceAttributes(bool hasInstanceAttributes) { hasInstanceAttributes_ = hasInstanceAttributes; }
+
 	/// Returns the number of indices used to render the geometry
 	inline unsigned int numIndices() const { return numIndices_; }
 	/// Sets the index number of the first index to draw
@@ -86,6 +91,7 @@ class Geometry
 	unsigned int numIndices_;
 	const float *hostVertexPointer_;
 	const GLushort *hostIndexPointer_;
+	bool hasInstanceAttributes_;
 
 	nctl::UniquePtr<GLBufferObject> vbo_;
 	GLenum vboUsageFlags_;
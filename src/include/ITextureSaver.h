@@ -13,6 +13,7 @@ class ITextureSaver
   public:
 	enum class Format
 	{
+		R8,
 		RGB8,
 		RGBA8,
 		RGB_FLOAT
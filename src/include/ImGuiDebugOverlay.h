@@ -4,6 +4,7 @@
 #include "IDebugOverlay.h"
 #include <nctl/UniquePtr.h>
 #include <nctl/String.h>
+#include <nctl/Array.h>
 
 namespace ncine {
 
@@ -78,6 +79,14 @@ class ImGuiDebugOverlay : public IDebugOverlay
 	bool plotOverlayValues_;
 	nctl::String comboVideoModes_;
 
+#ifdef WITH_LUA
+	/// Maximum number of rows shown in the Lua profiler lists
+	const unsigned int MaxLuaProfilerRows = 32;
+
+	/// Entries of the Lua profiler lists, sorted every frame
+	nctl::Array<unsigned int> luaProfilerIndices_;
+#endif
+
 #ifdef WITH_RENDERDOC
 	const unsigned int MaxRenderDocPathLength = 128;
 	const unsigned int MaxRenderDocCommentsLength = 512;
@@ -100,6 +109,9 @@ class ImGuiDebugOverlay : public IDebugOverlay
 	void guiWindowSettings();
 	void guiAudioPlayers();
 	void guiInputState();
+	void guiFrameProfiler();
+	void guiMemoryStatistics();
+	void guiLuaProfiler();
 	void guiRenderDoc();
 	void guiRescursiveChildrenNodes(SceneNode *node, unsigned int childId);
 	void guiNodeInspector();
@@ -65,7 +65,8 @@ class JoyMapping
 	bool addMappingFromString(const char *mappingString);
 	void addMappingsFromStrings(const char **mappingStrings);
 	void addMappingsFromFile(const char *filename);
-	inline unsigned int numMappings() const { return mappings_.size(); }
+	/// Returns the number of mappings, counting the database entries that have not been parsed yet
+	inline unsigned int numMappings() const { return mappings_.size() + numUnparsedDbEntries_; }
 
 	void onJoyButtonPressed(const JoyButtonEvent &event);
 	void onJoyButtonReleased(const JoyButtonEvent &event);
@@ -102,6 +103,7 @@ class JoyMapping
 			void fromString(const char *string);
 
 			bool operator==(const Guid &guid) const;
+			bool operator<(const Guid &guid) const;
 
 		  private:
 			uint32_t array_[4];
@@ -115,12 +117,25 @@ class JoyMapping
 		MappedJoystick();
 	};
 
+	/// An entry of the compiled-in database, its string is only parsed when a joystick with the same GUID connects
+	struct DbEntry
+	{
+		MappedJoystick::Guid guid;
+		unsigned int stringIndex;
+		/// The index in `mappings_` after parsing, `-1` if not parsed yet or `-2` if the string is not valid
+		int mappingIndex;
+	};
+
 	static const char *AxesStrings[JoyMappedState::NumAxes];
 	static const char *ButtonsStrings[JoyMappedState::NumButtons];
 
 	static const int MaxNumJoysticks = 4;
 	int mappingIndex_[MaxNumJoysticks];
+	/// The mappings added at runtime and the ones parsed from the database
 	nctl::Array<MappedJoystick> mappings_;
+	/// Database entries sorted by GUID
+	nctl::Array<DbEntry> dbEntries_;
+	unsigned int numUnparsedDbEntries_;
 
 	static JoyMappedStateImpl nullMappedJoyState_;
 	static nctl::StaticArray<JoyMappedStateImpl, MaxNumJoysticks> mappedJoyStates_;
@@ -133,6 +148,11 @@ class JoyMapping
 	void checkConnectedJoystics();
 	int findMappingByGuid(const MappedJoystick::Guid &guid);
 	int findMappingByName(const char *name);
+	/// Parses the first valid database entry with the specified GUID and returns its index in `mappings_`
+	int loadDbMappingByGuid(const MappedJoystick::Guid &guid);
+	int loadDbMappingByName(const char *name);
+	int loadDbMapping(DbEntry &entry);
+	static bool dbEntryLess(const DbEntry &a, const DbEntry &b);
 	bool parseMappingFromString(const char *mappingString, MappedJoystick &map);
 	bool parsePlatformKeyword(const char *start, const char *end) const;
 	bool parsePlatformName(const char *start, const char *end) const;
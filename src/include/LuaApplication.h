@@ -32,6 +32,11 @@ class LuaApplication
 	static int setAutoSuspension(lua_State *L);
 
 	static int quit(lua_State *L);
+
+	static int exportFrameCapture(lua_State *L);
+
+	static int gpuTimes(lua_State *L);
+	static int memoryStatistics(lua_State *L);
 };
 
 }
@@ -33,24 +33,16 @@ int LuaClassTracker<T>::deleteObject(lua_State *L)
 {
 	LuaStateManager *stateManager = LuaStateManager::manager(L);
 
-	LuaStateManager::UserDataWrapper *wrapper = reinterpret_cast<LuaStateManager::UserDataWrapper *>(lua_touserdata(L, -1));
+	LuaStateManager::UserDataWrapper *wrapper = LuaStateManager::retrieveUserDataWrapper(L, -1);
 
 	T *object = reinterpret_cast<T *>(wrapper->object);
 	FATAL_ASSERT(object);
 	FATAL_ASSERT(wrapper->type == LuaTypes::classToUserDataType(object));
 
-	nctl::Array<LuaStateManager::UserDataWrapper> &array = stateManager->trackedUserDatas();
-	const unsigned int newSize = array.size() - 1;
-
-	// If not deleting the last element of the array
-	if (wrapper->arrayIndex != newSize)
-	{
-		array[wrapper->arrayIndex].object = array[newSize].object;
-		array[wrapper->arrayIndex].type = array[newSize].type;
-		// The `arrayIndex` should not be copied
-	}
-
-	array.setSize(newSize);
+	// The slot is recycled without moving any other wrapper, the handles to this object are invalidated
+	stateManager->trackedUserDatas().release(*wrapper);
+	// Shared handles to the same object would be left dangling
+	stateManager->untrackedUserDatas().releaseShared(object);
 	delete object;
 
 	return 0;
@@ -61,17 +53,10 @@ void LuaClassTracker<T>::wrapTrackedUserData(lua_State *L, T *object)
 {
 	LuaStateManager *stateManager = LuaStateManager::manager(L);
 
-	nctl::Array<LuaStateManager::UserDataWrapper> &array = stateManager->trackedUserDatas();
-
-	const unsigned int oldSize = array.size();
-	array.setSize(oldSize + 1);
-	LuaStateManager::UserDataWrapper &wrapper = array[oldSize];
-
-	wrapper.object = object;
-	wrapper.type = LuaTypes::classToUserDataType(object);
-	wrapper.arrayIndex = oldSize;
+	LuaUserDataPool &pool = stateManager->trackedUserDatas();
+	LuaStateManager::UserDataWrapper &wrapper = pool.acquire(object, LuaTypes::classToUserDataType(object));
 
-	lua_pushlightuserdata(L, reinterpret_cast<void *>(&wrapper));
+	lua_pushlightuserdata(L, pool.handle(wrapper));
 }
 
 }
@@ -19,7 +19,9 @@ class LuaDrawableNode
 	static int width(lua_State *L);
 	static int height(lua_State *L);
 	static int size(lua_State *L);
+	static int sizeXY(lua_State *L);
 	static int anchorPoint(lua_State *L);
+	static int anchorPointXY(lua_State *L);
 	static int setAnchorPoint(lua_State *L);
 
 	static int isBlendingEnabled(lua_State *L);
@@ -0,0 +1,57 @@
+#ifndef CLASS_NCINE_LUAMEMORYPOOL
+#define CLASS_NCINE_LUAMEMORYPOOL
+
+#include <cstddef>
+#include <cstdint>
+#include <nctl/Array.h>
+
+namespace ncine {
+
+/// A size-class pool allocator dedicated to a single Lua state
+/*! \note Small blocks are carved from large pages and recycled through per-class free lists, larger ones go to `realloc()`.
+ *  There are no block headers: the size class is derived from the block size that Lua passes back on every call. */
+class LuaMemoryPool
+{
+  public:
+	/// Blocks bigger than this size are not pooled
+	static const unsigned int MaxPooledSize = 256;
+	static const unsigned int Granularity = 16;
+	static const unsigned int NumSizeClasses = MaxPooledSize / Granularity;
+	static const unsigned int PageSize = 64 * 1024;
+
+	LuaMemoryPool();
+	~LuaMemoryPool();
+
+	/// Implements the `lua_Alloc` contract, with `oldSize` being the size of the block when `ptr` is not null
+	void *reallocate(void *ptr, size_t oldSize, size_t newSize);
+
+	inline unsigned int numPages() const { return pages_.size(); }
+	/// Returns the memory reserved by the pages, used or not
+	inline size_t pagesMemory() const { return pages_.size() * static_cast<size_t>(PageSize); }
+
+  private:
+	struct FreeBlock
+	{
+		FreeBlock *next;
+	};
+
+	FreeBlock *freeLists_[NumSizeClasses];
+	nctl::Array<uint8_t *> pages_;
+	uint8_t *pageCursor_;
+	uint8_t *pageEnd_;
+
+	static inline bool isPooled(size_t size) { return size <= MaxPooledSize; }
+	static inline unsigned int sizeClass(size_t size) { return static_cast<unsigned int>((size - 1) / Granularity); }
+
+	void *allocate(size_t size);
+	void deallocate(void *ptr, size_t size);
+
+	/// Deleted copy constructor
+	LuaMemoryPool(const LuaMemoryPool &) = delete;
+	/// Deleted assignment operator
+	LuaMemoryPool &operator=(const LuaMemoryPool &) = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef CLASS_NCINE_LUAPROFILER
+#define CLASS_NCINE_LUAPROFILER
+
+#include <cstdint>
+#include <nctl/Array.h>
+#include <nctl/HashMap.h>
+#include <nctl/String.h>
+
+struct lua_State;
+struct lua_Debug;
+
+namespace ncine {
+
+/// A sampling profiler for Lua scripts
+/*! \note Call stacks are sampled from the count hook and each sample is weighted with the time elapsed since the previous one.
+ *  Allocations are only counted by the allocator and attributed to the source line executing at the next sample. */
+class LuaProfiler
+{
+  public:
+	/// Profiling information about a Lua or C function
+	struct FunctionEntry
+	{
+		nctl::String name;
+		/// Time spent in the function itself
+		uint64_t selfTicks;
+		/// Time spent in the function and in the ones it called
+		uint64_t totalTicks;
+		unsigned int numSamples;
+		unsigned int numAllocations;
+		size_t allocatedBytes;
+	};
+
+	/// Allocation statistics about a source line
+	struct AllocationSite
+	{
+		nctl::String location;
+		unsigned int numAllocations;
+		size_t allocatedBytes;
+	};
+
+	/// Timings of a function called by the engine, like `on_frame_start()`
+	struct CallbackEntry
+	{
+		unsigned int functionIndex;
+		unsigned int numCalls;
+		uint64_t lastTicks;
+		uint64_t maxTicks;
+		uint64_t totalTicks;
+	};
+
+	/// Number of virtual machine instructions between two samples
+	static const int SampleCount = 200;
+
+	static inline bool isEnabled() { return enabled_; }
+	/// Discards all the collected data
+	static void reset();
+
+	static inline unsigned int numFunctions() { return functions_.size(); }
+	static inline const FunctionEntry &function(unsigned int index) { return functions_[index]; }
+	static inline unsigned int numAllocationSites() { return allocationSites_.size(); }
+	static inline const AllocationSite &allocationSite(unsigned int index) { return allocationSites_[index]; }
+	static inline unsigned int numCallbacks() { return callbacks_.size(); }
+	static inline const CallbackEntry &callback(unsigned int index) { return callbacks_[index]; }
+
+	static float ticksToMilliseconds(uint64_t ticks);
+
+	/// Writes the sampled call stacks in the folded format read by flame graph tools, with microseconds as values
+	static bool exportFoldedStacks(const char *filename);
+
+  private:
+	/// A node of the call tree, the path from the root identifies a call stack
+	struct Node
+	{
+		unsigned int functionIndex;
+		unsigned int parent;
+		unsigned int firstChild;
+		unsigned int nextSibling;
+		uint64_t selfTicks;
+	};
+
+	/// Deeper call stacks are truncated to their innermost levels
+	static const unsigned int MaxStackDepth = 64;
+	static const unsigned int InvalidIndex = ~0u;
+
+	static bool enabled_;
+	/// The state executing the current callback, if any
+	static lua_State *currentState_;
+	static uint64_t callbackStartTicks_;
+	static uint64_t lastSampleTicks_;
+	/// The call tree node of the last sample, charged with the time left when the callback returns
+	static unsigned int lastNode_;
+	static unsigned int sampleId_;
+	/// Allocations made since the last sample, still to be attributed to a function and a source line
+	static unsigned int pendingAllocations_;
+	static size_t pendingAllocatedBytes_;
+
+	static nctl::Array<FunctionEntry> functions_;
+	/// The identifier of the last sample that added time to the total of a function, to skip recursive calls
+	static nctl::Array<unsigned int> functionSampleIds_;
+	static nctl::HashMap<uint64_t, unsigned int> functionIndices_;
+	static nctl::Array<AllocationSite> allocationSites_;
+	static nctl::HashMap<uint64_t, unsigned int> allocationSiteIndices_;
+	static nctl::Array<CallbackEntry> callbacks_;
+	static nctl::Array<Node> nodes_;
+
+	static void setEnabled(bool enabled);
+
+	static void onCall(lua_State *L);
+	static void onReturn(lua_State *L);
+	static void onSample(lua_State *L);
+	/// Called by the allocator, it only accumulates the bytes as the Lua stack cannot be inspected from there
+	static void onAllocation(size_t bytes);
+	/// Attributes the pending allocations to the function and the source line currently executing
+	static void attributeAllocations(lua_State *L);
+
+	static void sample(lua_State *L, uint64_t ticks);
+	/// Adds time to a call tree node and to all the functions in its path
+	static void chargeNode(unsigned int nodeIndex, uint64_t ticks);
+	static unsigned int childNode(unsigned int parent, unsigned int functionIndex);
+	/// Returns the index of the function described by the `lua_Debug` structure, adding a new entry if needed
+	static unsigned int retrieveFunction(const lua_Debug &ar);
+	static unsigned int retrieveAllocationSite(const lua_Debug &ar);
+
+	friend class LuaStateManager;
+	friend class LuaStatistics;
+};
+
+}
+
+#endif
@@ -29,10 +29,13 @@ class LuaSceneNode
 	static int setEnabled(lua_State *L);
 
 	static int position(lua_State *L);
+	static int positionXY(lua_State *L);
 	static int setPosition(lua_State *L);
 	static int absAnchorPoint(lua_State *L);
+	static int absAnchorPointXY(lua_State *L);
 	static int setAbsAnchorPoint(lua_State *L);
 	static int scale(lua_State *L);
+	static int scaleXY(lua_State *L);
 	static int setScaleX(lua_State *L);
 	static int setScaleY(lua_State *L);
 	static int setScale(lua_State *L);
@@ -26,6 +26,19 @@ class LuaStatistics
 	static inline unsigned int numTypedUserDatas(LuaTypes::UserDataType type) { return numTypedUserDatas_[type]; }
 	static inline size_t usedMemory() { return usedMemory_; }
 	static inline int operations() { return operations_[(index_ + 1) % 2]; }
+	/// Returns the memory reserved by the allocator pools of all states
+	static inline size_t poolsMemory() { return poolsMemory_; }
+
+	/// Returns the time spent collecting garbage during the last frame, in milliseconds
+	static inline float gcFrameTime() { return gcFrameTime_; }
+	/// Returns the longest garbage collection pause of the last second, in milliseconds
+	static inline float maxGcPause() { return maxGcPause_; }
+	/// Returns the number of collection cycles completed by the frame budgeted steps
+	static inline unsigned int numGcCycles() { return numGcCycles_; }
+
+	/// Enables the sampling profiler on all the states that track statistics
+	static void setProfilingEnabled(bool enabled);
+	static bool isProfilingEnabled();
 
   private:
 	static const int OperationsCount = 1000;
@@ -37,13 +50,23 @@ class LuaStatistics
 	static TimeStamp lastOpsUpdateTime_;
 	static unsigned int index_;
 	static int operations_[2];
+	static size_t poolsMemory_;
+	static float gcFrameTime_;
+	static float currentGcFrameTime_;
+	static float maxGcPause_;
+	static float currentMaxGcPause_;
+	static TimeStamp lastGcPauseUpdateTime_;
+	static unsigned int numGcCycles_;
 
 	static void registerState(LuaStateManager *manager);
 	static void unregisterState(LuaStateManager *manager);
 
 	static inline void allocMemory(size_t bytes) { usedMemory_ += bytes; }
 	static inline void freeMemory(size_t bytes) { usedMemory_ -= (usedMemory_ >= bytes) ? bytes : usedMemory_; }
-	static void countOperations();
+	static void countOperations(int count);
+	static void addGcPause(float milliseconds, bool cycleCompleted);
+	/// Installs the hook needed by operations counting and, if enabled, by the profiler
+	static void setHook(LuaStateManager *manager);
 
 	friend class LuaStateManager;
 };
@@ -29,10 +29,15 @@ class LuaTextNode
 	static int alignment(lua_State *L);
 	static int setAlignment(lua_State *L);
 
+	static int hasDistanceField(lua_State *L);
+	static int setOutline(lua_State *L);
+	static int setShadow(lua_State *L);
+
 	static int fontBase(lua_State *L);
 	static int fontLineHeight(lua_State *L);
 
 	static int setString(lua_State *L);
+	static int appendString(lua_State *L);
 };
 
 }
@@ -32,6 +32,10 @@ class Material
 		TEXTNODE_ALPHA,
 		/// Shader program for TextNode classes with glyph data in red channel
 		TEXTNODE_RED,
+		/// Shader program for TextNode classes with a signed distance field in red channel
+		TEXTNODE_SDF,
+		/// Shader program for TextNode classes with a multi-channel signed distance field
+		TEXTNODE_MSDF,
 		/// Shader program for a batch of Sprite classes
 		BATCHED_SPRITES,
 		/// Shader program for a batch of Sprite classes with grayscale font texture
@@ -44,6 +48,14 @@ class Material
 		BATCHED_TEXTNODES_ALPHA,
 		/// Shader program for a batch of TextNode classes with grayscale font texture
 		BATCHED_TEXTNODES_RED,
+		/// Shader program for a batch of TextNode classes with a signed distance field font texture
+		BATCHED_TEXTNODES_SDF,
+		/// Shader program for a batch of TextNode classes with a multi-channel signed distance field font texture
+		BATCHED_TEXTNODES_MSDF,
+		/// Shader program for instanced Sprite classes with per-instance attributes
+		INSTANCED_SPRITES,
+		/// Shader program for instanced Sprite classes with per-instance attributes and grayscale font texture
+		INSTANCED_SPRITES_GRAY,
 		/// A custom shader program
 		CUSTOM
 	};
@@ -0,0 +1,47 @@
+#ifndef CLASS_NCINE_MEMORYFILE
+#define CLASS_NCINE_MEMORYFILE
+
+#include "IFile.h"
+
+namespace ncine {
+
+/// The class handling reading from a memory buffer as if it was a file
+/*! \note The buffer is not copied and should live as long as the file object */
+class MemoryFile : public IFile
+{
+  public:
+	/// Constructs a memory file object
+	/*! \param bufferName The name of the buffer, like the name of the file it has been loaded from */
+	MemoryFile(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize);
+	~MemoryFile() override;
+
+	/// Static method to return class type
+	inline static FileType sType() { return FileType::MEMORY; }
+
+	/// Opens the memory file, it can only be read
+	void open(unsigned char mode) override;
+	/// Closes the memory file
+	void close() override;
+	long int seek(long int offset, int whence) const override;
+	long int tell() const override;
+	unsigned long int read(void *buffer, unsigned long int bytes) const override;
+	/// Writing is not supported, it always returns zero
+	unsigned long int write(void *buffer, unsigned long int bytes) override;
+
+	bool isOpened() const override;
+
+  private:
+	const unsigned char *bufferPtr_;
+	/// The read position is changed by the constant `read()` and `seek()` methods
+	mutable unsigned long int seekOffset_;
+	bool isFileOpened_;
+
+	/// Deleted copy constructor
+	MemoryFile(const MemoryFile &) = delete;
+	/// Deleted assignment operator
+	MemoryFile &operator=(const MemoryFile &) = delete;
+};
+
+}
+
+#endif
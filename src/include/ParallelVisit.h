@@ -0,0 +1,54 @@
+#ifndef CLASS_NCINE_PARALLELVISIT
+#define CLASS_NCINE_PARALLELVISIT
+
+#include <nctl/Array.h>
+#include <nctl/UniquePtr.h>
+#include "ThreadSync.h"
+
+namespace ncine {
+
+class SceneNode;
+class RenderQueue;
+
+/// A class that splits the scenegraph visit among the thread pool workers
+/*! Every job visits a contiguous range of root children and collects commands in its own queue.
+ *  Queues are merged in job order before sorting, so the result does not depend on scheduling. */
+class ParallelVisit
+{
+  public:
+	/// Creates the object with the maximum number of concurrent jobs, the calling thread included
+	explicit ParallelVisit(unsigned int maxJobs);
+	~ParallelVisit();
+
+	/// Visits the scenegraph from the root node and collects render commands in the queue
+	void visit(SceneNode &rootNode, RenderQueue &renderQueue);
+
+  private:
+	/// Minimum number of root children for a job to be worth dispatching
+	static const unsigned int MinChildrenPerJob = 16;
+
+	class VisitCommand;
+
+	/// One queue for each job but the first, that collects directly in the main queue
+	nctl::Array<nctl::UniquePtr<RenderQueue>> jobQueues_;
+	SceneNode *rootNode_;
+	unsigned int childrenPerJob_;
+
+	Mutex jobsMutex_;
+	CondVariable jobsCV_;
+	unsigned int pendingJobs_;
+
+	/// Visits the range of root children assigned to a job
+	void visitChildren(unsigned int jobIndex, RenderQueue &renderQueue);
+	/// Called by a worker thread when its job is done
+	void signalJobDone();
+
+	/// Deleted copy constructor
+	ParallelVisit(const ParallelVisit &) = delete;
+	/// Deleted assignment operator
+	ParallelVisit &operator=(const ParallelVisit &) = delete;
+};
+
+}
+
+#endif
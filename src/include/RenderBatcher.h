@@ -13,8 +13,9 @@ class RenderBatcher
   public:
 	RenderBatcher();
 
-	void collectInstances(const nctl::Array<RenderCommand *> &srcQueue, nctl::Array<RenderCommand *> &destQueue);
 	void createBatches(const nctl::Array<RenderCommand *> &srcQueue, nctl::Array<RenderCommand *> &destQueue);
+	/// Moves commands of a sorted queue next to compatible ones, but only before commands they don't overlap
+	void reorderCommands(const nctl::Array<RenderCommand *> &srcQueue, nctl::Array<RenderCommand *> &destQueue);
 	void reset();
 
   private:
@@ -35,7 +36,15 @@ class RenderBatcher
 	nctl::Array<nctl::UniquePtr<RenderCommand>> freeCommandsPool_;
 	nctl::Array<nctl::UniquePtr<RenderCommand>> usedCommandsPool_;
 
+	/// Flags for the commands of the source queue already moved to the destination one when reordering
+	nctl::Array<bool> reorderedFlags_;
+	/// Indices of the commands that a reordered command has been moved before
+	nctl::Array<unsigned int> skippedIndices_;
+	/// True if instanced draws can start from a base instance, needed by the instanced batching path
+	bool hasBaseInstance_;
+
 	RenderCommand *collectCommands(nctl::Array<RenderCommand *>::ConstIterator start, nctl::Array<RenderCommand *>::ConstIterator end, nctl::Array<RenderCommand *>::ConstIterator &nextStart);
+	RenderCommand *collectInstances(nctl::Array<RenderCommand *>::ConstIterator start, nctl::Array<RenderCommand *>::ConstIterator end, nctl::Array<RenderCommand *>::ConstIterator &nextStart);
 	RenderCommand *retrieveCommandFromPool(Material::ShaderProgramType shaderProgramType);
 
 	unsigned char *acquireMemory(unsigned int bytes);
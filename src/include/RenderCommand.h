@@ -2,6 +2,7 @@
 #define CLASS_NCINE_RENDERCOMMAND
 
 #include "Matrix4x4.h"
+#include "Rect.h"
 #include "Material.h"
 #include "Geometry.h"
 #include "Texture.h"
@@ -81,6 +82,13 @@ class RenderCommand
 
 	void setScissor(GLint x, GLint y, GLsizei width, GLsizei height);
 
+	/// Returns true if the bounding box of the command is known
+	inline bool hasAabb() const { return hasAabb_; }
+	/// Returns the axis-aligned bounding box of the command in scene coordinates
+	inline const Rectf &aabb() const { return aabb_; }
+	/// Sets the axis-aligned bounding box of the command, making its size positive
+	void setAabb(const Rectf &aabb);
+
 	inline Matrix4x4f &transformation() { return modelView_; }
 	inline const Material &material() const { return material_; }
 	inline const Geometry &geometry() const { return geometry_; }
@@ -122,11 +130,15 @@ class RenderCommand
 	bool uniformBlocksCommitted_;
 	bool verticesCommitted_;
 	bool indicesCommitted_;
+	/// Only the commands of drawable nodes have a bounding box
+	bool hasAabb_;
 
 	/// Command type for profiling counter
 	CommandTypes::Enum profilingType_;
 
 	ScissorState scissor_;
+	/// Used to know if two commands can be drawn in a different order
+	Rectf aabb_;
 
 	Matrix4x4f modelView_;
 	Material material_;
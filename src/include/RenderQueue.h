@@ -4,17 +4,27 @@
 #include "RenderCommand.h"
 #include "RenderBatcher.h"
 #include <nctl/Array.h>
+#include <nctl/UniquePtr.h>
 
 namespace ncine {
 
+class RenderTimerQueries;
+
 /// A class that sorts and issues the render commands collected by the scenegraph visit
 class RenderQueue
 {
   public:
 	RenderQueue();
+	~RenderQueue();
+	/// Creates a queue that can only collect commands, without a batcher, if `withBatcher` is false
+	explicit RenderQueue(bool withBatcher);
 
 	/// Adds a draw command to the queue
 	void addCommand(RenderCommand *command);
+	/// Appends the commands collected by another queue at the end of this one
+	void appendCommands(const RenderQueue &other);
+	/// Removes every collected command without drawing
+	void clearCommands();
 	/// Sorts the queues then issues every render command in order
 	void draw();
 
@@ -28,10 +38,14 @@ class RenderQueue
 	nctl::Array<RenderCommand *> opaqueBatchedQueue_;
 	/// Array of transparent render command pointers
 	nctl::Array<RenderCommand *> transparentQueue_;
+	/// Array of transparent render command pointers reordered to be batched across layers
+	nctl::Array<RenderCommand *> transparentReorderedQueue_;
 	/// Array of transparent batched render command pointers
 	nctl::Array<RenderCommand *> transparentBatchedQueue_;
 
-	RenderBatcher batcher_;
+	nctl::UniquePtr<RenderBatcher> batcher_;
+	/// The GPU timer queries, only created for a queue that draws
+	nctl::UniquePtr<RenderTimerQueries> timerQueries_;
 };
 
 }
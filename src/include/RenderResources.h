@@ -10,6 +10,8 @@
 
 namespace ncine {
 
+class BinaryShaderCache;
+
 /// The class that creates and handles application common OpenGL rendering resources
 class RenderResources
 {
@@ -35,6 +37,16 @@ class RenderResources
 		int drawindex;
 	};
 
+	/// A per-instance attributes structure for instanced sprites
+	/*! \note It mirrors the first members of the `std140` layout of the sprite uniform block */
+	struct InstanceFormatSprite
+	{
+		GLfloat modelView[16];
+		GLfloat color[4];
+		GLfloat texRect[4];
+		GLfloat spriteSize[2];
+	};
+
 	static inline RenderBuffersManager &buffersManager() { return *buffersManager_; }
 	static inline RenderVaoPool &vaoPool() { return *vaoPool_; }
 	static inline GLShaderProgram *spriteShaderProgram() { return spriteShaderProgram_.get(); }
@@ -43,15 +55,23 @@ class RenderResources
 	static inline GLShaderProgram *meshSpriteGrayShaderProgram() { return meshSpriteGrayShaderProgram_.get(); }
 	static inline GLShaderProgram *textnodeAlphaShaderProgram() { return textnodeAlphaShaderProgram_.get(); }
 	static inline GLShaderProgram *textnodeRedShaderProgram() { return textnodeRedShaderProgram_.get(); }
+	static inline GLShaderProgram *textnodeSdfShaderProgram() { return textnodeSdfShaderProgram_.get(); }
+	static inline GLShaderProgram *textnodeMsdfShaderProgram() { return textnodeMsdfShaderProgram_.get(); }
 	static inline GLShaderProgram *batchedSpritesShaderProgram() { return batchedSpritesShaderProgram_.get(); }
 	static inline GLShaderProgram *batchedSpritesGrayShaderProgram() { return batchedSpritesGrayShaderProgram_.get(); }
 	static inline GLShaderProgram *batchedMeshSpritesShaderProgram() { return batchedMeshSpritesShaderProgram_.get(); }
 	static inline GLShaderProgram *batchedMeshSpritesGrayShaderProgram() { return batchedMeshSpritesGrayShaderProgram_.get(); }
 	static inline GLShaderProgram *batchedTextnodesAlphaShaderProgram() { return batchedTextnodesAlphaShaderProgram_.get(); }
 	static inline GLShaderProgram *batchedTextnodesRedShaderProgram() { return batchedTextnodesRedShaderProgram_.get(); }
+	static inline GLShaderProgram *batchedTextnodesSdfShaderProgram() { return batchedTextnodesSdfShaderProgram_.get(); }
+	static inline GLShaderProgram *batchedTextnodesMsdfShaderProgram() { return batchedTextnodesMsdfShaderProgram_.get(); }
+	static inline GLShaderProgram *instancedSpritesShaderProgram() { return instancedSpritesShaderProgram_.get(); }
+	static inline GLShaderProgram *instancedSpritesGrayShaderProgram() { return instancedSpritesGrayShaderProgram_.get(); }
 	static inline const Matrix4x4f &projectionMatrix() { return projectionMatrix_; }
 	static inline bool hasProjectionChanged(bool batchingEnabled) { return (batchingEnabled) ? projectionHasChangedBatching_ : projectionHasChanged_; }
 	static void clearDirtyProjectionFlag(bool batchingEnabled);
+	/// Saves the binaries of the shader programs that have been linked with deferred queries and used since
+	static void saveDeferredShaderBinaries();
 
 	static void createMinimal();
 
@@ -64,12 +84,21 @@ class RenderResources
 	static nctl::UniquePtr<GLShaderProgram> meshSpriteGrayShaderProgram_;
 	static nctl::UniquePtr<GLShaderProgram> textnodeAlphaShaderProgram_;
 	static nctl::UniquePtr<GLShaderProgram> textnodeRedShaderProgram_;
+	static nctl::UniquePtr<GLShaderProgram> textnodeSdfShaderProgram_;
+	static nctl::UniquePtr<GLShaderProgram> textnodeMsdfShaderProgram_;
 	static nctl::UniquePtr<GLShaderProgram> batchedSpritesShaderProgram_;
 	static nctl::UniquePtr<GLShaderProgram> batchedSpritesGrayShaderProgram_;
 	static nctl::UniquePtr<GLShaderProgram> batchedMeshSpritesShaderProgram_;
 	static nctl::UniquePtr<GLShaderProgram> batchedMeshSpritesGrayShaderProgram_;
 	static nctl::UniquePtr<GLShaderProgram> batchedTextnodesAlphaShaderProgram_;
 	static nctl::UniquePtr<GLShaderProgram> batchedTextnodesRedShaderProgram_;
+	static nctl::UniquePtr<GLShaderProgram> batchedTextnodesSdfShaderProgram_;
+	static nctl::UniquePtr<GLShaderProgram> batchedTextnodesMsdfShaderProgram_;
+	static nctl::UniquePtr<GLShaderProgram> instancedSpritesShaderProgram_;
+	static nctl::UniquePtr<GLShaderProgram> instancedSpritesGrayShaderProgram_;
+
+	/// The binary shader cache, kept after creation only while some programs wait for their deferred link check
+	static nctl::UniquePtr<BinaryShaderCache> binaryShaderCache_;
 
 	static Matrix4x4f projectionMatrix_;
 	static bool projectionHasChanged_;
@@ -2,6 +2,7 @@
 #define CLASS_NCINE_RENDERSTATISTICS
 
 #include <nctl/String.h>
+#include <nctl/Atomic.h>
 #include "RenderCommand.h"
 
 namespace ncine {
@@ -10,6 +11,37 @@ namespace ncine {
 class RenderStatistics
 {
   public:
+	/// The categories of OpenGL state changes tracked by the wrapper classes
+	struct StateTypes
+	{
+		enum Enum
+		{
+			PROGRAM,
+			TEXTURE,
+			VAO,
+			BUFFER,
+			BLENDING,
+			DEPTH,
+			SCISSOR,
+			CULL_FACE,
+
+			COUNT
+		};
+	};
+
+	/// The phases of the render queue measured by GPU timer queries
+	struct GpuPhases
+	{
+		enum Enum
+		{
+			COMMIT,
+			OPAQUES,
+			TRANSPARENTS,
+
+			COUNT
+		};
+	};
+
 	class Commands
 	{
 	  public:
@@ -95,23 +127,103 @@ class RenderStatistics
 	  public:
 		unsigned int size;
 		unsigned int capacity;
+		/// Number of bindings of a VAO already defined with the requested format
+		unsigned int hits;
+		/// Number of least recently used VAOs redefined with a different format
 		unsigned int reuses;
 		unsigned int bindings;
 
 		VaoPool()
-		    : size(0), capacity(0), reuses(0), bindings(0) {}
+		    : size(0), capacity(0), hits(0), reuses(0), bindings(0) {}
 
 	  private:
 		void reset()
 		{
 			size = 0;
 			capacity = 0;
+			hits = 0;
 			reuses = 0;
 			bindings = 0;
 		}
 		friend RenderStatistics;
 	};
 
+	class Reordering
+	{
+	  public:
+		/// Number of runs of transparent commands that can be batched together, before reordering
+		/*! \note The minimum and maximum batch sizes are not considered */
+		unsigned int batchesBefore;
+		/// Number of runs of transparent commands that can be batched together, after reordering
+		unsigned int batchesAfter;
+		/// Number of transparent commands moved before others to join a batch
+		unsigned int movedCommands;
+
+		Reordering()
+		    : batchesBefore(0), batchesAfter(0), movedCommands(0) {}
+
+	  private:
+		void reset()
+		{
+			batchesBefore = 0;
+			batchesAfter = 0;
+			movedCommands = 0;
+		}
+		friend RenderStatistics;
+	};
+
+	class StateChanges
+	{
+	  public:
+		/// Number of state changes that reached OpenGL
+		unsigned int issued;
+		/// Number of redundant state changes that have been skipped
+		unsigned int skipped;
+
+		StateChanges()
+		    : issued(0), skipped(0) {}
+
+	  private:
+		void reset()
+		{
+			issued = 0;
+			skipped = 0;
+		}
+		friend RenderStatistics;
+	};
+
+	class GpuTimes
+	{
+	  public:
+		/// True if the times have been read back from a measured frame
+		bool available;
+		/// Number of frames between the measurement and the read back of the times
+		unsigned int latency;
+		/// Time spent by the GPU in all phases, in milliseconds
+		float total;
+		/// Time spent by the GPU in every phase, in milliseconds
+		float phases[GpuPhases::COUNT];
+		/// Time spent by the GPU for every command type, in milliseconds
+		/*! \note It is only measured when timing per command type */
+		float commandTypes[RenderCommand::CommandTypes::COUNT];
+
+		GpuTimes() { reset(); }
+
+	  private:
+		void reset()
+		{
+			available = false;
+			latency = 0;
+			total = 0.0f;
+			for (unsigned int i = 0; i < GpuPhases::COUNT; i++)
+				phases[i] = 0.0f;
+			for (unsigned int i = 0; i < RenderCommand::CommandTypes::COUNT; i++)
+				commandTypes[i] = 0.0f;
+		}
+		friend RenderStatistics;
+		friend class RenderTimerQueries;
+	};
+
 	/// Returns the aggregated command statistics for all types
 	static inline const Commands &allCommands() { return allCommands_; }
 	/// Returns the commnad statistics for the specified type
@@ -130,11 +242,27 @@ class RenderStatistics
 	static inline const CustomBuffers &customIBOs() { return customIbos_; }
 
 	/// Returns the number of `DrawableNodes` culled because outside of the screen
-	static inline unsigned int culled() { return culledNodes_[(index_ + 1) % 2]; }
+	static inline unsigned int culled() { return static_cast<unsigned int>(culledNodes_[(index_ + 1) % 2].load()); }
+
+	/// Returns the number of text lines whose glyphs have been laid out again in the last frame
+	static inline unsigned int relaidTextLines() { return static_cast<unsigned int>(relaidTextLines_[(index_ + 1) % 2].load()); }
+	/// Returns the number of text lines whose cached glyph vertices have been reused in the last frame
+	static inline unsigned int reusedTextLines() { return static_cast<unsigned int>(reusedTextLines_[(index_ + 1) % 2].load()); }
 
 	/// Returns statistics about the VAO pool
 	static inline const VaoPool &vaoPool() { return vaoPool_; }
 
+	/// Returns statistics about the reordering of transparent commands before batching
+	static inline const Reordering &reordering() { return reordering_; }
+
+	/// Returns the aggregated state change statistics for all types
+	static inline const StateChanges &allStateChanges() { return allStateChanges_; }
+	/// Returns the state change statistics for the specified type
+	static inline const StateChanges &stateChanges(StateTypes::Enum type) { return typedStateChanges_[type]; }
+
+	/// Returns the GPU times of the last frame whose timer queries have been read back
+	static inline const GpuTimes &gpuTimes() { return gpuTimes_; }
+
   private:
 	/// The string used to output OpenGL debug group information
 	static nctl::String debugString_;
@@ -146,8 +274,16 @@ class RenderStatistics
 	static CustomBuffers customVbos_;
 	static CustomBuffers customIbos_;
 	static unsigned int index_;
-	static unsigned int culledNodes_[2];
+	/// Atomic counters as nodes can be culled by the worker threads of a parallel visit
+	static nctl::Atomic32 culledNodes_[2];
+	/// Atomic counters as text nodes can be laid out by the worker threads of a parallel visit
+	static nctl::Atomic32 relaidTextLines_[2];
+	static nctl::Atomic32 reusedTextLines_[2];
 	static VaoPool vaoPool_;
+	static Reordering reordering_;
+	static StateChanges allStateChanges_;
+	static StateChanges typedStateChanges_[StateTypes::COUNT];
+	static GpuTimes gpuTimes_;
 
 	static void reset();
 	static void gatherStatistics(const RenderCommand &command);
@@ -187,16 +323,49 @@ class RenderStatistics
 		customIbos_.count--;
 		customIbos_.dataSize -= datasize;
 	}
-	static inline void addCulledNode() { culledNodes_[index_]++; }
+	static inline void addCulledNode() { culledNodes_[index_].fetchAdd(1, nctl::Atomic32::MemoryModel::RELAXED); }
+	static inline void addTextLines(unsigned int relaid, unsigned int reused)
+	{
+		relaidTextLines_[index_].fetchAdd(static_cast<int32_t>(relaid), nctl::Atomic32::MemoryModel::RELAXED);
+		reusedTextLines_[index_].fetchAdd(static_cast<int32_t>(reused), nctl::Atomic32::MemoryModel::RELAXED);
+	}
+	static inline void addReordering(unsigned int batchesBefore, unsigned int batchesAfter, unsigned int movedCommands)
+	{
+		reordering_.batchesBefore += batchesBefore;
+		reordering_.batchesAfter += batchesAfter;
+		reordering_.movedCommands += movedCommands;
+	}
+	static inline void addVaoPoolHit() { vaoPool_.hits++; }
 	static inline void addVaoPoolReuse() { vaoPool_.reuses++; }
 	static inline void addVaoPoolBinding() { vaoPool_.bindings++; }
+	static inline void addStateChange(StateTypes::Enum type)
+	{
+		typedStateChanges_[type].issued++;
+		allStateChanges_.issued++;
+	}
+	static inline void addSkippedStateChange(StateTypes::Enum type)
+	{
+		typedStateChanges_[type].skipped++;
+		allStateChanges_.skipped++;
+	}
 
 	friend class RenderQueue;
+	friend class RenderBatcher;
+	friend class RenderTimerQueries;
 	friend class RenderBuffersManager;
 	friend class Texture;
 	friend class Geometry;
 	friend class DrawableNode;
+	friend class TextNode;
 	friend class RenderVaoPool;
+	friend class GLShaderProgram;
+	friend class GLTexture;
+	friend class GLVertexArrayObject;
+	friend class GLBufferObject;
+	friend class GLBlending;
+	friend class GLDepthTest;
+	friend class GLScissorTest;
+	friend class GLCullFace;
 };
 
 }
@@ -0,0 +1,91 @@
+#ifndef CLASS_NCINE_RENDERTIMERQUERIES
+#define CLASS_NCINE_RENDERTIMERQUERIES
+
+#define NCINE_INCLUDE_OPENGL
+#include "common_headers.h"
+
+#include <cstdint>
+#include <nctl/Array.h>
+#include "RenderStatistics.h"
+
+namespace ncine {
+
+/// A class that measures the GPU time of the render queue phases with timer queries
+/*! \note Results are read back some frames later, when they are available, and published in `RenderStatistics`.
+ *  As time elapsed queries cannot be nested, when timing per command type the phases are the sum of their commands. */
+class RenderTimerQueries
+{
+  public:
+	RenderTimerQueries();
+	~RenderTimerQueries();
+
+	/// Returns true if timer queries are supported by the device
+	inline bool isSupported() const { return isSupported_; }
+
+	/// Reads back the results of completed frames and starts measuring a new one if enabled
+	void beginFrame(bool enabled, bool perCommandType);
+	/// Marks the queries of the current frame as waiting for their results
+	void endFrame();
+
+	/// Starts measuring a render queue phase
+	void beginPhase(RenderStatistics::GpuPhases::Enum phase);
+	/// Stops measuring the current render queue phase
+	void endPhase();
+
+	/// Starts measuring a single command, only when timing per command type
+	void beginCommand(RenderCommand::CommandTypes::Enum type);
+	/// Stops measuring the current command
+	void endCommand();
+
+  private:
+	/// Number of frames whose queries can wait for their results at the same time
+	static const unsigned int MaxPendingFrames = 4;
+
+	struct CommandQuery
+	{
+		GLuint id;
+		uint8_t type;
+		uint8_t phase;
+	};
+
+	struct FrameQueries
+	{
+		GLuint phaseIds[RenderStatistics::GpuPhases::COUNT];
+		bool phaseIssued[RenderStatistics::GpuPhases::COUNT];
+		/// The pool of command queries only grows, `numCommands` of them are used by the frame
+		nctl::Array<CommandQuery> commands;
+		unsigned int numCommands;
+		/// The last query issued, the first ones are complete when it is
+		GLuint lastId;
+		unsigned long int frameNumber;
+		bool isPending;
+	};
+
+	bool isSupported_;
+	bool isEnabled_;
+	/// True if the current frame is being measured
+	bool isMeasuring_;
+	bool perCommandType_;
+	/// True if a query is active on the time elapsed target
+	bool isQueryActive_;
+	RenderStatistics::GpuPhases::Enum currentPhase_;
+
+	FrameQueries frames_[MaxPendingFrames];
+	/// Index of the frame that is being measured
+	unsigned int frameIndex_;
+	unsigned long int numFrames_;
+
+	/// Deleted copy constructor
+	RenderTimerQueries(const RenderTimerQueries &) = delete;
+	/// Deleted assignment operator
+	RenderTimerQueries &operator=(const RenderTimerQueries &) = delete;
+
+	void readBackFrames();
+	bool readBackFrame(FrameQueries &frame);
+	void discardPendingFrames();
+	void deleteQueries();
+};
+
+}
+
+#endif
@@ -2,8 +2,8 @@
 #define CLASS_NCINE_RENDERVAOPOOL
 
 #include <nctl/Array.h>
+#include <nctl/HashMap.h>
 #include <nctl/UniquePtr.h>
-#include <TimeStamp.h>
 #include "GLVertexArrayObject.h"
 #include "GLVertexFormat.h"
 
@@ -12,6 +12,7 @@ namespace ncine {
 class GLVertexArrayObject;
 
 /// The class that creates and handles the pool of VAOs
+/*! VAOs are found by the hash of their vertex format and reused in least recently bound order */
 class RenderVaoPool
 {
   public:
@@ -19,14 +20,39 @@ class RenderVaoPool
 	void bindVao(const GLVertexFormat &vertexFormat);
 
   private:
+	/// The index that terminates the LRU list and the chains of bindings with the same hash
+	static const unsigned int InvalidIndex = ~0U;
+
 	struct VaoBinding
 	{
 		nctl::UniquePtr<GLVertexArrayObject> object;
 		GLVertexFormat format;
-		TimeStamp lastBindTime;
+		/// The hash of the format, computed when the VAO is defined
+		nctl::hash_t formatHash;
+		/// The next binding with the same format hash
+		unsigned int nextSameHash;
+		/// The binding that has been bound just after this one
+		unsigned int lruPrev;
+		/// The binding that has been bound just before this one
+		unsigned int lruNext;
 	};
 
 	nctl::Array<VaoBinding> vaoPool_;
+	/// Maps a format hash to the index of the first binding with that hash
+	nctl::HashMap<nctl::hash_t, unsigned int, nctl::IdentityHashFunc<nctl::hash_t>> hashIndices_;
+	/// The index of the most recently bound VAO
+	unsigned int lruHead_;
+	/// The index of the least recently bound VAO, the first one to be reused
+	unsigned int lruTail_;
+
+	/// Returns the index of the binding with the specified format, or `InvalidIndex`
+	unsigned int findBinding(const GLVertexFormat &vertexFormat, nctl::hash_t hash) const;
+	/// Adds a binding to the chain of the ones with the same format hash
+	void linkHash(unsigned int index);
+	/// Removes a binding from the chain of the ones with the same format hash
+	void unlinkHash(unsigned int index);
+	/// Moves a binding at the head of the LRU list, adding it if not yet there
+	void moveToLruHead(unsigned int index);
 };
 
 }
@@ -13,6 +13,12 @@ namespace {
 
 #include "JoyMappingDb.h"
 
+#ifndef __EMSCRIPTEN__
+	const unsigned int GuidNumCharacters = 32;
+#else
+	const unsigned int GuidNumCharacters = 7; // "default"
+#endif
+
 }
 
 ///////////////////////////////////////////////////////////
@@ -76,26 +82,33 @@ JoyMapping::MappedJoystick::Guid::Guid()
 }
 
 JoyMapping::JoyMapping()
-    : mappings_(256), inputManager_(nullptr), inputEventHandler_(nullptr)
+    : mappings_(16), numUnparsedDbEntries_(0), inputManager_(nullptr), inputEventHandler_(nullptr)
 {
 	for (unsigned int i = 0; i < MaxNumJoysticks; i++)
 		mappingIndex_[i] = -1;
 
 	unsigned int numStrings = 0;
+	while (ControllerMappings[numStrings])
+		numStrings++;
 
-	// Add mappings from the database, without searching for duplicates
-	const char **mappingStrings = ControllerMappings;
-	while (*mappingStrings)
+	// Only the GUIDs of the database are decoded, the mappings are parsed when a joystick connects
+	dbEntries_.setCapacity(numStrings);
+	for (unsigned int i = 0; i < numStrings; i++)
 	{
-		numStrings++;
-		const unsigned int size = mappings_.size();
-		const bool parsed = parseMappingFromString(*mappingStrings, mappings_[size]);
-		if (parsed == false)
-			mappings_.setSize(size);
-		mappingStrings++;
+		const char *mappingString = ControllerMappings[i];
+		const char *guidEnd = strchr(mappingString, ',');
+		if (guidEnd == nullptr || static_cast<unsigned int>(guidEnd - mappingString) != GuidNumCharacters)
+			continue;
+
+		DbEntry &entry = dbEntries_[dbEntries_.size()];
+		entry.guid.fromString(mappingString);
+		entry.stringIndex = i;
+		entry.mappingIndex = -1;
 	}
+	nctl::quicksort(dbEntries_.begin(), dbEntries_.end(), dbEntryLess);
+	numUnparsedDbEntries_ = dbEntries_.size();
 
-	LOGI_X("Parsed %u strings for %u mappings", numStrings, mappings_.size());
+	LOGI_X("Indexed %u strings for %u database entries", numStrings, dbEntries_.size());
 }
 
 ///////////////////////////////////////////////////////////
@@ -122,6 +135,16 @@ bool JoyMapping::MappedJoystick::Guid::operator==(const Guid &guid) const
 	       array_[2] == guid.array_[2] && array_[3] == guid.array_[3];
 }
 
+bool JoyMapping::MappedJoystick::Guid::operator<(const Guid &guid) const
+{
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		if (array_[i] != guid.array_[i])
+			return array_[i] < guid.array_[i];
+	}
+	return false;
+}
+
 void JoyMapping::init(const IInputManager *inputManager)
 {
 	ASSERT(inputManager);
@@ -326,7 +349,9 @@ bool JoyMapping::onJoyConnected(const JoyConnectionEvent &event)
 	if (joyGuid != nullptr)
 	{
 		MappedJoystick::Guid guid(joyGuid);
-		const int index = findMappingByGuid(guid);
+		int index = findMappingByGuid(guid);
+		if (index == -1)
+			index = loadDbMappingByGuid(guid);
 		if (index != -1)
 		{
 			mappingIndex_[event.joyId] = index;
@@ -335,7 +360,9 @@ bool JoyMapping::onJoyConnected(const JoyConnectionEvent &event)
 	}
 	else
 	{
-		const int index = findMappingByName(joyName);
+		int index = findMappingByName(joyName);
+		if (index == -1)
+			index = loadDbMappingByName(joyName);
 		if (index != -1)
 		{
 			mappingIndex_[event.joyId] = index;
@@ -441,6 +468,82 @@ int JoyMapping::findMappingByName(const char *name)
 	return index;
 }
 
+int JoyMapping::loadDbMappingByGuid(const MappedJoystick::Guid &guid)
+{
+	// Binary search of the first entry with the specified GUID
+	unsigned int first = 0;
+	unsigned int last = dbEntries_.size();
+	while (first < last)
+	{
+		const unsigned int middle = first + (last - first) / 2;
+		if (dbEntries_[middle].guid < guid)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	// Entries with the same GUID are sorted by their order in the database, the first valid one is used
+	for (unsigned int i = first; i < dbEntries_.size() && dbEntries_[i].guid == guid; i++)
+	{
+		const int index = loadDbMapping(dbEntries_[i]);
+		if (index != -1)
+			return index;
+	}
+
+	return -1;
+}
+
+int JoyMapping::loadDbMappingByName(const char *name)
+{
+	for (DbEntry &entry : dbEntries_)
+	{
+		if (entry.mappingIndex == -2)
+			continue;
+
+		const char *nameStart = strchr(ControllerMappings[entry.stringIndex], ',') + 1;
+		const char *nameEnd = strchr(nameStart, ',');
+		if (nameEnd == nullptr)
+			continue;
+		trimSpaces(&nameStart, &nameEnd);
+
+		const unsigned int nameLength = nctl::min(static_cast<unsigned int>(nameEnd - nameStart), MaxNameLength);
+		if (strncmp(nameStart, name, nameLength) == 0 && name[nameLength] == '\0')
+		{
+			const int index = loadDbMapping(entry);
+			if (index != -1)
+				return index;
+		}
+	}
+
+	return -1;
+}
+
+int JoyMapping::loadDbMapping(DbEntry &entry)
+{
+	if (entry.mappingIndex == -1)
+	{
+		MappedJoystick newMapping;
+		const bool parsed = parseMappingFromString(ControllerMappings[entry.stringIndex], newMapping);
+		if (parsed)
+		{
+			entry.mappingIndex = static_cast<int>(mappings_.size());
+			mappings_.pushBack(newMapping);
+		}
+		else
+			entry.mappingIndex = -2;
+		numUnparsedDbEntries_--;
+	}
+
+	return (entry.mappingIndex >= 0) ? entry.mappingIndex : -1;
+}
+
+bool JoyMapping::dbEntryLess(const DbEntry &a, const DbEntry &b)
+{
+	if (a.guid == b.guid)
+		return a.stringIndex < b.stringIndex;
+	return a.guid < b.guid;
+}
+
 bool JoyMapping::parseMappingFromString(const char *mappingString, MappedJoystick &map)
 {
 	// Early out if the string is empty or a comment
@@ -466,11 +569,6 @@ bool JoyMapping::parseMappingFromString(const char *mappingString, MappedJoystic
 	}
 	unsigned int subLength = static_cast<unsigned int>(subEnd - subStart);
 
-#ifndef __EMSCRIPTEN__
-	const unsigned int GuidNumCharacters = 32;
-#else
-	const unsigned int GuidNumCharacters = 7; // "default"
-#endif
 	if (subLength != GuidNumCharacters)
 	{
 		LOGE_X("GUID length is %u instead of %u characters", subLength, GuidNumCharacters);
@@ -0,0 +1,118 @@
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "MemoryStatistics.h"
+#ifdef WITH_TRACY
+	#include "Tracy.hpp"
+#endif
+
+// The operators replaced in a DLL or in a two-level namespace dylib would not be used by the application
+#if !defined(NCINE_STATIC) && (defined(_WIN32) || defined(__APPLE__))
+	#error "Memory tags need the static version of the library on Windows and macOS"
+#endif
+
+namespace {
+	/// The header stored before every allocation, its size preserves the alignment guaranteed by `malloc()`
+	struct alignas(alignof(std::max_align_t)) AllocationHeader
+	{
+		size_t size;
+		/// The tag the allocation has been accounted for, or `Untracked`
+		unsigned char tag;
+	};
+
+	const unsigned char Untracked = 0xFF;
+
+	void *allocate(std::size_t count)
+	{
+		AllocationHeader *header = static_cast<AllocationHeader *>(malloc(sizeof(AllocationHeader) + count));
+		if (header == nullptr)
+			return nullptr;
+
+		header->size = count;
+		header->tag = Untracked;
+		// Allocations made before the counters are initialized, or while accounting is disabled, are not tracked
+		if (ncine::MemoryStatistics::isEnabled())
+		{
+			const ncine::MemoryStatistics::Tags::Enum tag = ncine::MemoryStatistics::currentTag();
+			ncine::MemoryStatistics::addAllocation(tag, count);
+			header->tag = static_cast<unsigned char>(tag);
+		}
+
+		void *ptr = header + 1;
+#ifdef WITH_TRACY
+		TracyAllocS(ptr, count, 5);
+#endif
+		return ptr;
+	}
+
+	void deallocate(void *ptr)
+	{
+		if (ptr == nullptr)
+			return;
+
+#ifdef WITH_TRACY
+		TracyFreeS(ptr, 5);
+#endif
+		AllocationHeader *header = static_cast<AllocationHeader *>(ptr) - 1;
+		if (header->tag != Untracked)
+			ncine::MemoryStatistics::addDeallocation(static_cast<ncine::MemoryStatistics::Tags::Enum>(header->tag), header->size);
+		free(header);
+	}
+}
+
+void *operator new(std::size_t count)
+{
+	void *ptr = allocate(count);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void *operator new[](std::size_t count)
+{
+	void *ptr = allocate(count);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void *operator new(std::size_t count, const std::nothrow_t &) noexcept
+{
+	return allocate(count);
+}
+
+void *operator new[](std::size_t count, const std::nothrow_t &) noexcept
+{
+	return allocate(count);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	deallocate(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	deallocate(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+	deallocate(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+	deallocate(ptr);
+}
+
+// Always replaced, as libraries compiled with a newer standard could call them
+void operator delete(void *ptr, std::size_t) noexcept
+{
+	deallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+	deallocate(ptr);
+}
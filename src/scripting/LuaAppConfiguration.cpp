@@ -16,25 +16,39 @@ namespace AppConfiguration {
 	static const char *consoleLogLevel = "console_log_level";
 	static const char *fileLogLevel = "file_log_level";
 	static const char *frameTimerLogInterval = "log_interval";
+	static const char *withAsyncLogging = "async_logging";
+	static const char *frameCaptureKey = "frame_capture_key";
 
 	static const char *resolution = "resolution";
 	static const char *inFullscreen = "fullscreen";
 	static const char *isResizable = "resizable";
 	static const char *frameLimit = "frame_limit";
+	static const char *isHeadless = "headless";
+	static const char *fixedTimestep = "fixed_timestep";
+	static const char *benchmarkFrames = "benchmark_frames";
+	static const char *benchmarkFile = "benchmark_file";
+	static const char *replayRecordFile = "replay_record_file";
+	static const char *replayPlaybackFile = "replay_playback_file";
 
 	static const char *windowTitle = "window_title";
 	static const char *windowIconFilename = "window_icon";
 
 	static const char *useBufferMapping = "buffer_mapping";
 	static const char *deferShaderQueries = "defer_shader_queries";
+	static const char *useBinaryShaderCache = "binary_shader_cache";
+	static const char *shaderCacheDirname = "shader_cache_dirname";
 	static const char *fixedBatchSize = "fixed_batch_size";
 	static const char *vboSize = "vbo_size";
 	static const char *iboSize = "ibo_size";
 	static const char *vaoPoolSize = "vao_pool_size";
+	static const char *audioStreamNumBuffers = "audio_stream_buffers";
+	static const char *audioStreamBufferSize = "audio_stream_buffer_size";
+	static const char *audioMixerVoices = "audio_mixer_voices";
 
 	static const char *withDebugOverlay = "debug_overlay";
 	static const char *withAudio = "audio";
 	static const char *withThreads = "threads";
+	static const char *withAudioStreamThread = "audio_stream_thread";
 	static const char *withScenegraph = "scenegraph";
 	static const char *withVSync = "vsync";
 	static const char *withGlDebugContext = "gl_debug_context";
@@ -46,32 +60,46 @@ namespace AppConfiguration {
 
 void LuaAppConfiguration::push(lua_State *L, const AppConfiguration &appCfg)
 {
-	lua_createtable(L, 24, 0);
+	lua_createtable(L, 37, 0);
 
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::dataPath, appCfg.dataPath().data());
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::logFile, appCfg.logFile.data());
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::consoleLogLevel, static_cast<int64_t>(appCfg.consoleLogLevel));
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::fileLogLevel, static_cast<int64_t>(appCfg.fileLogLevel));
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::frameTimerLogInterval, appCfg.frameTimerLogInterval);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::withAsyncLogging, appCfg.withAsyncLogging);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::frameCaptureKey, static_cast<int64_t>(appCfg.frameCaptureKey));
 
 	LuaVector2iUtils::pushField(L, LuaNames::AppConfiguration::resolution, appCfg.resolution);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::inFullscreen, appCfg.inFullscreen);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::isResizable, appCfg.isResizable);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::frameLimit, appCfg.frameLimit);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::isHeadless, appCfg.isHeadless);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::fixedTimestep, appCfg.fixedTimestep);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::benchmarkFrames, appCfg.benchmarkFrames);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::benchmarkFile, appCfg.benchmarkFile.data());
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::replayRecordFile, appCfg.replayRecordFile.data());
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::replayPlaybackFile, appCfg.replayPlaybackFile.data());
 
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::windowTitle, appCfg.windowTitle.data());
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::windowIconFilename, appCfg.windowIconFilename.data());
 
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::useBufferMapping, appCfg.useBufferMapping);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::deferShaderQueries, appCfg.deferShaderQueries);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::useBinaryShaderCache, appCfg.useBinaryShaderCache);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::shaderCacheDirname, appCfg.shaderCacheDirname.data());
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::fixedBatchSize, appCfg.fixedBatchSize);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::vboSize, static_cast<int64_t>(appCfg.vboSize));
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::iboSize, static_cast<int64_t>(appCfg.iboSize));
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::vaoPoolSize, appCfg.vaoPoolSize);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::audioStreamNumBuffers, appCfg.audioStreamNumBuffers);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::audioStreamBufferSize, static_cast<int64_t>(appCfg.audioStreamBufferSize));
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::audioMixerVoices, appCfg.audioMixerVoices);
 
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withDebugOverlay, appCfg.withDebugOverlay);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withAudio, appCfg.withAudio);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withThreads, appCfg.withThreads);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::withAudioStreamThread, appCfg.withAudioStreamThread);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withScenegraph, appCfg.withScenegraph);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withVSync, appCfg.withVSync);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withGlDebugContext, appCfg.withGlDebugContext);
@@ -92,6 +120,10 @@ void LuaAppConfiguration::retrieveAndSet(lua_State *L, AppConfiguration &appCfg)
 	appCfg.fileLogLevel = fileLogLevel;
 	const float logInterval = LuaUtils::retrieveField<float>(L, -1, LuaNames::AppConfiguration::frameTimerLogInterval);
 	appCfg.frameTimerLogInterval = logInterval;
+	const bool withAsyncLogging = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withAsyncLogging);
+	appCfg.withAsyncLogging = withAsyncLogging;
+	const KeySym frameCaptureKey = static_cast<KeySym>(LuaUtils::retrieveField<int64_t>(L, -1, LuaNames::AppConfiguration::frameCaptureKey));
+	appCfg.frameCaptureKey = frameCaptureKey;
 
 	const Vector2i resolution = LuaVector2iUtils::retrieveTableField(L, -1, LuaNames::AppConfiguration::resolution);
 	appCfg.resolution = resolution;
@@ -101,6 +133,18 @@ void LuaAppConfiguration::retrieveAndSet(lua_State *L, AppConfiguration &appCfg)
 	appCfg.isResizable = isResizable;
 	const unsigned int frameLimit = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::frameLimit);
 	appCfg.frameLimit = frameLimit;
+	const bool isHeadless = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::isHeadless);
+	appCfg.isHeadless = isHeadless;
+	const float fixedTimestep = LuaUtils::retrieveField<float>(L, -1, LuaNames::AppConfiguration::fixedTimestep);
+	appCfg.fixedTimestep = fixedTimestep;
+	const unsigned int benchmarkFrames = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::benchmarkFrames);
+	appCfg.benchmarkFrames = benchmarkFrames;
+	const char *benchmarkFile = LuaUtils::retrieveField<const char *>(L, -1, LuaNames::AppConfiguration::benchmarkFile);
+	appCfg.benchmarkFile = benchmarkFile;
+	const char *replayRecordFile = LuaUtils::retrieveField<const char *>(L, -1, LuaNames::AppConfiguration::replayRecordFile);
+	appCfg.replayRecordFile = replayRecordFile;
+	const char *replayPlaybackFile = LuaUtils::retrieveField<const char *>(L, -1, LuaNames::AppConfiguration::replayPlaybackFile);
+	appCfg.replayPlaybackFile = replayPlaybackFile;
 
 	const char *windowTitle = LuaUtils::retrieveField<const char *>(L, -1, LuaNames::AppConfiguration::windowTitle);
 	appCfg.windowTitle = windowTitle;
@@ -111,6 +155,10 @@ void LuaAppConfiguration::retrieveAndSet(lua_State *L, AppConfiguration &appCfg)
 	appCfg.useBufferMapping = useBufferMapping;
 	const bool deferShaderQueries = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::deferShaderQueries);
 	appCfg.deferShaderQueries = deferShaderQueries;
+	const bool useBinaryShaderCache = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::useBinaryShaderCache);
+	appCfg.useBinaryShaderCache = useBinaryShaderCache;
+	const char *shaderCacheDirname = LuaUtils::retrieveField<const char *>(L, -1, LuaNames::AppConfiguration::shaderCacheDirname);
+	appCfg.shaderCacheDirname = shaderCacheDirname;
 	const unsigned int fixedBatchSize = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::fixedBatchSize);
 	appCfg.fixedBatchSize = fixedBatchSize;
 	const unsigned long vboSize = LuaUtils::retrieveField<uint64_t>(L, -1, LuaNames::AppConfiguration::vboSize);
@@ -119,6 +167,12 @@ void LuaAppConfiguration::retrieveAndSet(lua_State *L, AppConfiguration &appCfg)
 	appCfg.iboSize = iboSize;
 	const unsigned int vaoPoolSize = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::vaoPoolSize);
 	appCfg.vaoPoolSize = vaoPoolSize;
+	const unsigned int audioStreamNumBuffers = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::audioStreamNumBuffers);
+	appCfg.audioStreamNumBuffers = audioStreamNumBuffers;
+	const unsigned long audioStreamBufferSize = LuaUtils::retrieveField<uint64_t>(L, -1, LuaNames::AppConfiguration::audioStreamBufferSize);
+	appCfg.audioStreamBufferSize = audioStreamBufferSize;
+	const unsigned int audioMixerVoices = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::audioMixerVoices);
+	appCfg.audioMixerVoices = audioMixerVoices;
 
 	const bool withDebugOverlay = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withDebugOverlay);
 	appCfg.withDebugOverlay = withDebugOverlay;
@@ -126,6 +180,8 @@ void LuaAppConfiguration::retrieveAndSet(lua_State *L, AppConfiguration &appCfg)
 	appCfg.withAudio = withAudio;
 	const bool withThreads = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withThreads);
 	appCfg.withThreads = withThreads;
+	const bool withAudioStreamThread = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withAudioStreamThread);
+	appCfg.withAudioStreamThread = withAudioStreamThread;
 	const bool withScenegraph = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withScenegraph);
 	appCfg.withScenegraph = withScenegraph;
 	const bool withVSync = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withVSync);
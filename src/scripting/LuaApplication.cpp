@@ -5,6 +5,8 @@
 #include "LuaClassWrapper.h"
 #include "LuaVector2Utils.h"
 #include "Application.h"
+#include "RenderStatistics.h"
+#include "MemoryStatistics.h"
 #include "FileSystem.h"
 
 namespace ncine {
@@ -34,14 +36,42 @@ namespace Application {
 
 	static const char *quit = "quit";
 
+	static const char *exportFrameCapture = "export_frame_capture";
+
+	static const char *gpuTimes = "get_gpu_times";
+	static const char *memoryStatistics = "get_memory_statistics";
+
 	namespace RenderingSettings {
 		static const char *batchingEnabled = "batching";
 		static const char *batchingWithIndices = "batching_with_indices";
+		static const char *batchingWithInstancing = "batching_with_instancing";
+		static const char *batchingWithReordering = "batching_with_reordering";
 		static const char *cullingEnabled = "culling";
+		static const char *parallelVisit = "parallel_visit";
+		static const char *gpuTimingEnabled = "gpu_timing";
+		static const char *gpuTimingPerCommandType = "gpu_timing_per_command_type";
 		static const char *minBatchSize = "min_batch_size";
 		static const char *maxBatchSize = "max_batch_size";
 	}
 
+	namespace GpuTimes {
+		static const char *available = "available";
+		static const char *latency = "latency";
+		static const char *total = "total";
+		static const char *commit = "commit";
+		static const char *opaques = "opaques";
+		static const char *transparents = "transparents";
+	}
+
+	namespace MemoryStatistics {
+		static const char *total = "total";
+		static const char *currentBytes = "current_bytes";
+		static const char *peakBytes = "peak_bytes";
+		static const char *allocations = "allocations";
+		static const char *frameAllocations = "frame_allocations";
+		static const char *frameDeallocations = "frame_deallocations";
+	}
+
 	namespace DebugOverlaySettings {
 		static const char *showProfilerGraphs = "profiler_graphs";
 		static const char *showInfoText = "info_text";
@@ -49,6 +79,18 @@ namespace Application {
 	}
 }}
 
+namespace {
+	void pushTagStatistics(lua_State *L, const MemoryStatistics::TagStatistics &stats)
+	{
+		lua_createtable(L, 5, 0);
+		LuaUtils::pushField(L, LuaNames::Application::MemoryStatistics::currentBytes, stats.currentBytes);
+		LuaUtils::pushField(L, LuaNames::Application::MemoryStatistics::peakBytes, stats.peakBytes);
+		LuaUtils::pushField(L, LuaNames::Application::MemoryStatistics::allocations, stats.allocations);
+		LuaUtils::pushField(L, LuaNames::Application::MemoryStatistics::frameAllocations, stats.frameAllocations);
+		LuaUtils::pushField(L, LuaNames::Application::MemoryStatistics::frameDeallocations, stats.frameDeallocations);
+	}
+}
+
 ///////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
@@ -78,6 +120,11 @@ void LuaApplication::expose(lua_State *L)
 
 	LuaUtils::addFunction(L, LuaNames::Application::quit, quit);
 
+	LuaUtils::addFunction(L, LuaNames::Application::exportFrameCapture, exportFrameCapture);
+
+	LuaUtils::addFunction(L, LuaNames::Application::gpuTimes, gpuTimes);
+	LuaUtils::addFunction(L, LuaNames::Application::memoryStatistics, memoryStatistics);
+
 	lua_setfield(L, -2, LuaNames::Application::Application);
 }
 
@@ -89,10 +136,15 @@ int LuaApplication::renderingSettings(lua_State *L)
 {
 	const Application::RenderingSettings &settings = theApplication().renderingSettings();
 
-	lua_createtable(L, 5, 0);
+	lua_createtable(L, 10, 0);
 	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::batchingEnabled, settings.batchingEnabled);
 	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::batchingWithIndices, settings.batchingWithIndices);
+	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::batchingWithInstancing, settings.batchingWithInstancing);
+	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::batchingWithReordering, settings.batchingWithReordering);
 	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::cullingEnabled, settings.cullingEnabled);
+	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::parallelVisit, settings.parallelVisit);
+	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::gpuTimingEnabled, settings.gpuTimingEnabled);
+	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::gpuTimingPerCommandType, settings.gpuTimingPerCommandType);
 	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::minBatchSize, settings.minBatchSize);
 	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::maxBatchSize, settings.maxBatchSize);
 
@@ -108,7 +160,12 @@ int LuaApplication::setRenderingSettings(lua_State *L)
 
 	settings.batchingEnabled = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::batchingEnabled);
 	settings.batchingWithIndices = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::batchingWithIndices);
+	settings.batchingWithInstancing = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::batchingWithInstancing);
+	settings.batchingWithReordering = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::batchingWithReordering);
 	settings.cullingEnabled = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::cullingEnabled);
+	settings.parallelVisit = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::parallelVisit);
+	settings.gpuTimingEnabled = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::gpuTimingEnabled);
+	settings.gpuTimingPerCommandType = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::gpuTimingPerCommandType);
 	settings.minBatchSize = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::Application::RenderingSettings::minBatchSize);
 	settings.maxBatchSize = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::Application::RenderingSettings::maxBatchSize);
 
@@ -205,4 +262,41 @@ int LuaApplication::quit(lua_State *L)
 	return 0;
 }
 
+int LuaApplication::exportFrameCapture(lua_State *L)
+{
+	LuaUtils::push(L, theApplication().exportFrameCapture());
+	return 1;
+}
+
+int LuaApplication::gpuTimes(lua_State *L)
+{
+	const RenderStatistics::GpuTimes &times = RenderStatistics::gpuTimes();
+
+	lua_createtable(L, 6, 0);
+	LuaUtils::pushField(L, LuaNames::Application::GpuTimes::available, times.available);
+	LuaUtils::pushField(L, LuaNames::Application::GpuTimes::latency, times.latency);
+	LuaUtils::pushField(L, LuaNames::Application::GpuTimes::total, times.total);
+	LuaUtils::pushField(L, LuaNames::Application::GpuTimes::commit, times.phases[RenderStatistics::GpuPhases::COMMIT]);
+	LuaUtils::pushField(L, LuaNames::Application::GpuTimes::opaques, times.phases[RenderStatistics::GpuPhases::OPAQUES]);
+	LuaUtils::pushField(L, LuaNames::Application::GpuTimes::transparents, times.phases[RenderStatistics::GpuPhases::TRANSPARENTS]);
+
+	return 1;
+}
+
+int LuaApplication::memoryStatistics(lua_State *L)
+{
+	// One table for each tag, plus the aggregated statistics of all tags
+	lua_createtable(L, 0, MemoryStatistics::Tags::COUNT + 1);
+	for (unsigned int i = 0; i < MemoryStatistics::Tags::COUNT; i++)
+	{
+		const MemoryStatistics::Tags::Enum tag = static_cast<MemoryStatistics::Tags::Enum>(i);
+		pushTagStatistics(L, MemoryStatistics::statistics(tag));
+		lua_setfield(L, -2, MemoryStatistics::tagName(tag));
+	}
+	pushTagStatistics(L, MemoryStatistics::allStatistics());
+	lua_setfield(L, -2, LuaNames::Application::MemoryStatistics::total);
+
+	return 1;
+}
+
 }
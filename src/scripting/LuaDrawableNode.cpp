@@ -45,7 +45,9 @@ namespace DrawableNode {
 	static const char *width = "get_width";
 	static const char *height = "get_height";
 	static const char *size = "get_size";
+	static const char *sizeXY = "get_size_xy";
 	static const char *anchorPoint = "get_anchor_point";
+	static const char *anchorPointXY = "get_anchor_point_xy";
 	static const char *setAnchorPoint = "set_anchor_point";
 
 	static const char *isBlendingEnabled = "is_blending_enabled";
@@ -116,7 +118,9 @@ void LuaDrawableNode::exposeFunctions(lua_State *L)
 	LuaUtils::addFunction(L, LuaNames::DrawableNode::width, width);
 	LuaUtils::addFunction(L, LuaNames::DrawableNode::height, height);
 	LuaUtils::addFunction(L, LuaNames::DrawableNode::size, size);
+	LuaUtils::addFunction(L, LuaNames::DrawableNode::sizeXY, sizeXY);
 	LuaUtils::addFunction(L, LuaNames::DrawableNode::anchorPoint, anchorPoint);
+	LuaUtils::addFunction(L, LuaNames::DrawableNode::anchorPointXY, anchorPointXY);
 	LuaUtils::addFunction(L, LuaNames::DrawableNode::setAnchorPoint, setAnchorPoint);
 
 	LuaUtils::addFunction(L, LuaNames::DrawableNode::isBlendingEnabled, isBlendingEnabled);
@@ -160,6 +164,16 @@ int LuaDrawableNode::size(lua_State *L)
 	return 1;
 }
 
+int LuaDrawableNode::sizeXY(lua_State *L)
+{
+	DrawableNode *node = LuaClassWrapper<DrawableNode>::unwrapUserData(L, -1);
+
+	const Vector2f size = node->size();
+	LuaVector2fUtils::pushParams(L, size);
+
+	return 2;
+}
+
 int LuaDrawableNode::anchorPoint(lua_State *L)
 {
 	DrawableNode *node = LuaClassWrapper<DrawableNode>::unwrapUserData(L, -1);
@@ -170,6 +184,16 @@ int LuaDrawableNode::anchorPoint(lua_State *L)
 	return 1;
 }
 
+int LuaDrawableNode::anchorPointXY(lua_State *L)
+{
+	DrawableNode *node = LuaClassWrapper<DrawableNode>::unwrapUserData(L, -1);
+
+	const Vector2f &anchorPoint = node->anchorPoint();
+	LuaVector2fUtils::pushParams(L, anchorPoint);
+
+	return 2;
+}
+
 int LuaDrawableNode::setAnchorPoint(lua_State *L)
 {
 	int vectorIndex = 0;
@@ -189,7 +189,7 @@ int LuaJoystickEvents::isButtonPressed(lua_State *L)
 {
 	bool isButtonPressed = false;
 
-	LuaStateManager::UserDataWrapper *wrapper = LuaUtils::retrieveUserData<LuaStateManager::UserDataWrapper>(L, -2);
+	LuaStateManager::UserDataWrapper *wrapper = LuaStateManager::retrieveUserDataWrapper(L, -2);
 	if (wrapper->type == LuaTypes::JOYSTICKSTATE)
 	{
 		const JoystickState *state = LuaClassWrapper<JoystickState>::unwrapUserData(L, -2);
@@ -214,7 +214,7 @@ int LuaJoystickEvents::hatState(lua_State *L)
 {
 	unsigned char hatState = HatState::CENTERED;
 
-	LuaStateManager::UserDataWrapper *wrapper = LuaUtils::retrieveUserData<LuaStateManager::UserDataWrapper>(L, -2);
+	LuaStateManager::UserDataWrapper *wrapper = LuaStateManager::retrieveUserDataWrapper(L, -2);
 	if (wrapper->type == LuaTypes::JOYSTICKSTATE)
 	{
 		const JoystickState *state = LuaClassWrapper<JoystickState>::unwrapUserData(L, -2);
@@ -233,7 +233,7 @@ int LuaJoystickEvents::axisValue(lua_State *L)
 {
 	float axisValue = 0.0f;
 
-	LuaStateManager::UserDataWrapper *wrapper = LuaUtils::retrieveUserData<LuaStateManager::UserDataWrapper>(L, -2);
+	LuaStateManager::UserDataWrapper *wrapper = LuaStateManager::retrieveUserDataWrapper(L, -2);
 	if (wrapper->type == LuaTypes::JOYSTICKSTATE)
 	{
 		const JoystickState *state = LuaClassWrapper<JoystickState>::unwrapUserData(L, -2);
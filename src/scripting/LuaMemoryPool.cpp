@@ -0,0 +1,107 @@
+#include <cstdlib> // for malloc()
+#include <cstring> // for memcpy()
+#include "common_macros.h"
+#include "LuaMemoryPool.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+LuaMemoryPool::LuaMemoryPool()
+    : pages_(4), pageCursor_(nullptr), pageEnd_(nullptr)
+{
+	for (unsigned int i = 0; i < NumSizeClasses; i++)
+		freeLists_[i] = nullptr;
+}
+
+LuaMemoryPool::~LuaMemoryPool()
+{
+	for (uint8_t *page : pages_)
+		free(page);
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void *LuaMemoryPool::reallocate(void *ptr, size_t oldSize, size_t newSize)
+{
+	if (newSize == 0)
+	{
+		if (ptr != nullptr)
+			deallocate(ptr, oldSize);
+		return nullptr;
+	}
+
+	if (ptr == nullptr)
+		return allocate(newSize);
+
+	if (isPooled(oldSize) == false && isPooled(newSize) == false)
+		return realloc(ptr, newSize);
+	else if (isPooled(oldSize) && isPooled(newSize) && sizeClass(oldSize) == sizeClass(newSize))
+		return ptr;
+
+	void *newPtr = allocate(newSize);
+	if (newPtr == nullptr)
+	{
+		// Lua assumes that shrinking never fails, the old block is big enough to keep being used
+		return (newSize < oldSize) ? ptr : nullptr;
+	}
+
+	memcpy(newPtr, ptr, (oldSize < newSize) ? oldSize : newSize);
+	deallocate(ptr, oldSize);
+	return newPtr;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void *LuaMemoryPool::allocate(size_t size)
+{
+	if (isPooled(size) == false)
+		return malloc(size);
+
+	const unsigned int index = sizeClass(size);
+	if (freeLists_[index] != nullptr)
+	{
+		FreeBlock *block = freeLists_[index];
+		freeLists_[index] = block->next;
+		return block;
+	}
+
+	const size_t blockSize = (index + 1) * Granularity;
+	if (pageCursor_ == nullptr || pageCursor_ + blockSize > pageEnd_)
+	{
+		uint8_t *page = static_cast<uint8_t *>(malloc(PageSize));
+		if (page == nullptr)
+			return nullptr;
+
+		// The unused tail of the previous page is wasted, it is always smaller than the biggest class
+		pages_.pushBack(page);
+		pageCursor_ = page;
+		pageEnd_ = page + PageSize;
+	}
+
+	void *block = pageCursor_;
+	pageCursor_ += blockSize;
+	return block;
+}
+
+void LuaMemoryPool::deallocate(void *ptr, size_t size)
+{
+	if (isPooled(size) == false)
+	{
+		free(ptr);
+		return;
+	}
+
+	FreeBlock *block = static_cast<FreeBlock *>(ptr);
+	const unsigned int index = sizeClass(size);
+	block->next = freeLists_[index];
+	freeLists_[index] = block;
+}
+
+}
@@ -0,0 +1,398 @@
+#define NCINE_INCLUDE_LUA
+#include "common_headers.h"
+#include "common_macros.h"
+
+#include <nctl/UniquePtr.h>
+#include "LuaProfiler.h"
+#include "IFile.h"
+#include "Clock.h"
+
+namespace ncine {
+
+namespace {
+	const unsigned int MaxNameLength = 128;
+	/// The hashmaps are rehashed when exceeding this load factor
+	const float MaxLoadFactor = 0.75f;
+
+	/// Combines a string address with a line number, the address of Lua source strings is stable while the function exists
+	uint64_t combineKey(const void *pointer, int line)
+	{
+		return (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer)) << 16) ^ static_cast<uint64_t>(line & 0xFFFF);
+	}
+
+	bool isCFunction(const lua_Debug &ar)
+	{
+		return ar.what[0] == 'C';
+	}
+
+	void growIfNeeded(nctl::HashMap<uint64_t, unsigned int> &hashMap)
+	{
+		if (hashMap.loadFactor() >= MaxLoadFactor)
+			hashMap.rehash(hashMap.capacity() * 2);
+	}
+
+	void writeString(IFile &file, const char *string, unsigned int length)
+	{
+		file.write(const_cast<char *>(string), length);
+	}
+}
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+bool LuaProfiler::enabled_ = false;
+lua_State *LuaProfiler::currentState_ = nullptr;
+uint64_t LuaProfiler::callbackStartTicks_ = 0;
+uint64_t LuaProfiler::lastSampleTicks_ = 0;
+unsigned int LuaProfiler::lastNode_ = LuaProfiler::InvalidIndex;
+unsigned int LuaProfiler::sampleId_ = 0;
+unsigned int LuaProfiler::pendingAllocations_ = 0;
+size_t LuaProfiler::pendingAllocatedBytes_ = 0;
+
+nctl::Array<LuaProfiler::FunctionEntry> LuaProfiler::functions_(64);
+nctl::Array<unsigned int> LuaProfiler::functionSampleIds_(64);
+nctl::HashMap<uint64_t, unsigned int> LuaProfiler::functionIndices_(128);
+nctl::Array<LuaProfiler::AllocationSite> LuaProfiler::allocationSites_(64);
+nctl::HashMap<uint64_t, unsigned int> LuaProfiler::allocationSiteIndices_(128);
+nctl::Array<LuaProfiler::CallbackEntry> LuaProfiler::callbacks_(8);
+nctl::Array<LuaProfiler::Node> LuaProfiler::nodes_(256);
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void LuaProfiler::reset()
+{
+	currentState_ = nullptr;
+	lastNode_ = InvalidIndex;
+	sampleId_ = 0;
+	pendingAllocations_ = 0;
+	pendingAllocatedBytes_ = 0;
+
+	functions_.clear();
+	functionSampleIds_.clear();
+	functionIndices_.clear();
+	allocationSites_.clear();
+	allocationSiteIndices_.clear();
+	callbacks_.clear();
+
+	// The root node does not belong to any function
+	nodes_.clear();
+	Node &root = nodes_[0];
+	root.functionIndex = InvalidIndex;
+	root.parent = InvalidIndex;
+	root.firstChild = InvalidIndex;
+	root.nextSibling = InvalidIndex;
+	root.selfTicks = 0;
+}
+
+float LuaProfiler::ticksToMilliseconds(uint64_t ticks)
+{
+	return static_cast<float>(ticks * 1000.0 / clock().frequency());
+}
+
+bool LuaProfiler::exportFoldedStacks(const char *filename)
+{
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+	fileHandle->setExitOnFailToOpen(false);
+	fileHandle->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+	{
+		LOGW_X("Cannot open the file \"%s\" to export the Lua profile", filename);
+		return false;
+	}
+
+	unsigned int path[MaxStackDepth];
+	nctl::String value(32);
+	unsigned int numStacks = 0;
+	for (unsigned int i = 1; i < nodes_.size(); i++)
+	{
+		const uint64_t microseconds = nodes_[i].selfTicks * 1000000 / clock().frequency();
+		if (microseconds == 0)
+			continue;
+
+		unsigned int depth = 0;
+		for (unsigned int nodeIndex = i; nodeIndex != 0 && depth < MaxStackDepth; nodeIndex = nodes_[nodeIndex].parent)
+			path[depth++] = nodeIndex;
+
+		// Stack frames are written from the outermost one, separated by semicolons
+		for (int j = static_cast<int>(depth) - 1; j >= 0; j--)
+		{
+			const nctl::String &name = functions_[nodes_[path[j]].functionIndex].name;
+			writeString(*fileHandle, name.data(), name.length());
+			if (j > 0)
+				writeString(*fileHandle, ";", 1);
+		}
+		value.format(" %llu\n", static_cast<unsigned long long>(microseconds));
+		writeString(*fileHandle, value.data(), value.length());
+		numStacks++;
+	}
+
+	LOGI_X("Exported %u Lua call stacks to \"%s\"", numStacks, filename);
+	return true;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void LuaProfiler::setEnabled(bool enabled)
+{
+	if (enabled && nodes_.isEmpty())
+		reset();
+
+	enabled_ = enabled;
+	currentState_ = nullptr;
+	lastNode_ = InvalidIndex;
+	pendingAllocations_ = 0;
+	pendingAllocatedBytes_ = 0;
+}
+
+void LuaProfiler::onCall(lua_State *L)
+{
+	lua_Debug ar;
+	// Only a function without a caller is a callback from the engine.
+	// A callback left by an error is never returned from, the same state can start a new one.
+	if (lua_getstack(L, 1, &ar) == 0 && (currentState_ == nullptr || currentState_ == L))
+	{
+		currentState_ = L;
+		callbackStartTicks_ = clock().now();
+		lastSampleTicks_ = callbackStartTicks_;
+		lastNode_ = InvalidIndex;
+		pendingAllocations_ = 0;
+		pendingAllocatedBytes_ = 0;
+	}
+}
+
+void LuaProfiler::onReturn(lua_State *L)
+{
+	lua_Debug ar;
+	if (L != currentState_ || lua_getstack(L, 1, &ar) != 0)
+		return;
+
+	const uint64_t now = clock().now();
+	attributeAllocations(L);
+	// The time after the last sample is charged to the last sampled call stack
+	if (lastNode_ != InvalidIndex)
+		chargeNode(lastNode_, now - lastSampleTicks_);
+	else
+		sample(L, now - lastSampleTicks_);
+
+	lua_getstack(L, 0, &ar);
+	lua_getinfo(L, "Sn", &ar);
+	const unsigned int functionIndex = retrieveFunction(ar);
+
+	CallbackEntry *callback = nullptr;
+	for (CallbackEntry &entry : callbacks_)
+	{
+		if (entry.functionIndex == functionIndex)
+		{
+			callback = &entry;
+			break;
+		}
+	}
+	if (callback == nullptr)
+	{
+		callback = &callbacks_[callbacks_.size()];
+		callback->functionIndex = functionIndex;
+		callback->numCalls = 0;
+		callback->maxTicks = 0;
+		callback->totalTicks = 0;
+	}
+
+	const uint64_t elapsedTicks = now - callbackStartTicks_;
+	callback->numCalls++;
+	callback->lastTicks = elapsedTicks;
+	callback->totalTicks += elapsedTicks;
+	if (elapsedTicks > callback->maxTicks)
+		callback->maxTicks = elapsedTicks;
+
+	currentState_ = nullptr;
+	lastNode_ = InvalidIndex;
+}
+
+void LuaProfiler::onSample(lua_State *L)
+{
+	const uint64_t now = clock().now();
+	// Profiling has been enabled in the middle of a callback
+	if (currentState_ == nullptr)
+	{
+		currentState_ = L;
+		callbackStartTicks_ = now;
+	}
+	else
+	{
+		attributeAllocations(L);
+		sample(L, now - lastSampleTicks_);
+	}
+
+	lastSampleTicks_ = now;
+}
+
+void LuaProfiler::onAllocation(size_t bytes)
+{
+	if (currentState_ == nullptr)
+		return;
+
+	// Inspecting the stack from here could access the memory being reallocated
+	pendingAllocations_++;
+	pendingAllocatedBytes_ += bytes;
+}
+
+void LuaProfiler::attributeAllocations(lua_State *L)
+{
+	if (pendingAllocations_ == 0)
+		return;
+
+	const unsigned int numAllocations = pendingAllocations_;
+	const size_t allocatedBytes = pendingAllocatedBytes_;
+	pendingAllocations_ = 0;
+	pendingAllocatedBytes_ = 0;
+
+	lua_Debug ar;
+	if (lua_getstack(L, 0, &ar) == 0)
+		return;
+
+	lua_getinfo(L, "Snl", &ar);
+	FunctionEntry &function = functions_[retrieveFunction(ar)];
+	function.numAllocations += numAllocations;
+	function.allocatedBytes += allocatedBytes;
+
+	// An allocation made by a C function is attributed to the Lua line calling it
+	if (isCFunction(ar) && lua_getstack(L, 1, &ar))
+		lua_getinfo(L, "Sl", &ar);
+
+	AllocationSite &site = allocationSites_[retrieveAllocationSite(ar)];
+	site.numAllocations += numAllocations;
+	site.allocatedBytes += allocatedBytes;
+}
+
+void LuaProfiler::sample(lua_State *L, uint64_t ticks)
+{
+	unsigned int stack[MaxStackDepth];
+	unsigned int depth = 0;
+
+	lua_Debug ar;
+	while (depth < MaxStackDepth && lua_getstack(L, static_cast<int>(depth), &ar))
+	{
+		lua_getinfo(L, "Sn", &ar);
+		stack[depth++] = retrieveFunction(ar);
+	}
+	if (depth == 0)
+		return;
+
+	unsigned int nodeIndex = 0;
+	for (int i = static_cast<int>(depth) - 1; i >= 0; i--)
+		nodeIndex = childNode(nodeIndex, stack[i]);
+
+	functions_[stack[0]].numSamples++;
+	chargeNode(nodeIndex, ticks);
+	lastNode_ = nodeIndex;
+}
+
+void LuaProfiler::chargeNode(unsigned int nodeIndex, uint64_t ticks)
+{
+	ASSERT(nodeIndex != 0 && nodeIndex < nodes_.size());
+	nodes_[nodeIndex].selfTicks += ticks;
+	functions_[nodes_[nodeIndex].functionIndex].selfTicks += ticks;
+
+	sampleId_++;
+	for (unsigned int i = nodeIndex; i != 0; i = nodes_[i].parent)
+	{
+		const unsigned int functionIndex = nodes_[i].functionIndex;
+		// Recursive functions appear more than once in the same stack
+		if (functionSampleIds_[functionIndex] != sampleId_)
+		{
+			functionSampleIds_[functionIndex] = sampleId_;
+			functions_[functionIndex].totalTicks += ticks;
+		}
+	}
+}
+
+unsigned int LuaProfiler::childNode(unsigned int parent, unsigned int functionIndex)
+{
+	unsigned int lastChild = InvalidIndex;
+	for (unsigned int i = nodes_[parent].firstChild; i != InvalidIndex; i = nodes_[i].nextSibling)
+	{
+		if (nodes_[i].functionIndex == functionIndex)
+			return i;
+		lastChild = i;
+	}
+
+	const unsigned int nodeIndex = nodes_.size();
+	Node &node = nodes_[nodeIndex];
+	node.functionIndex = functionIndex;
+	node.parent = parent;
+	node.firstChild = InvalidIndex;
+	node.nextSibling = InvalidIndex;
+	node.selfTicks = 0;
+
+	if (lastChild == InvalidIndex)
+		nodes_[parent].firstChild = nodeIndex;
+	else
+		nodes_[lastChild].nextSibling = nodeIndex;
+
+	return nodeIndex;
+}
+
+unsigned int LuaProfiler::retrieveFunction(const lua_Debug &ar)
+{
+	// C functions have no source to tell them apart, the name used by the caller is the best available key
+	const uint64_t key = isCFunction(ar) ? combineKey(ar.name, -1) : combineKey(ar.source, ar.linedefined);
+	const unsigned int *foundIndex = functionIndices_.find(key);
+	if (foundIndex != nullptr)
+		return *foundIndex;
+
+	nctl::String name(MaxNameLength);
+	if (isCFunction(ar))
+		name.format("%s [C]", ar.name ? ar.name : "?");
+	else if (ar.what[0] == 'm')
+		name.format("main chunk <%s>", ar.short_src);
+	else if (ar.name != nullptr)
+		name.format("%s <%s:%d>", ar.name, ar.short_src, ar.linedefined);
+	else
+		name.format("<%s:%d>", ar.short_src, ar.linedefined);
+
+	const unsigned int index = functions_.size();
+	FunctionEntry &entry = functions_[index];
+	entry.name = nctl::move(name);
+	entry.selfTicks = 0;
+	entry.totalTicks = 0;
+	entry.numSamples = 0;
+	entry.numAllocations = 0;
+	entry.allocatedBytes = 0;
+	functionSampleIds_[index] = 0;
+
+	growIfNeeded(functionIndices_);
+	functionIndices_.insert(key, index);
+
+	return index;
+}
+
+unsigned int LuaProfiler::retrieveAllocationSite(const lua_Debug &ar)
+{
+	const uint64_t key = isCFunction(ar) ? combineKey(ar.name, -1) : combineKey(ar.source, ar.currentline);
+	const unsigned int *foundIndex = allocationSiteIndices_.find(key);
+	if (foundIndex != nullptr)
+		return *foundIndex;
+
+	nctl::String location(MaxNameLength);
+	if (isCFunction(ar))
+		location.format("%s [C]", ar.name ? ar.name : "?");
+	else
+		location.format("%s:%d", ar.short_src, ar.currentline);
+
+	const unsigned int index = allocationSites_.size();
+	AllocationSite &site = allocationSites_[index];
+	site.location = nctl::move(location);
+	site.numAllocations = 0;
+	site.allocatedBytes = 0;
+
+	growIfNeeded(allocationSiteIndices_);
+	allocationSiteIndices_.insert(key, index);
+
+	return index;
+}
+
+}
@@ -18,10 +18,13 @@ namespace SceneNode {
 	static const char *setEnabled = "set_enabled";
 
 	static const char *position = "get_position";
+	static const char *positionXY = "get_position_xy";
 	static const char *setPosition = "set_position";
 	static const char *absAnchorPoint = "get_abs_anchor_point";
+	static const char *absAnchorPointXY = "get_abs_anchor_point_xy";
 	static const char *setAbsAnchorPoint = "set_abs_anchor_point";
 	static const char *scale = "get_scale";
+	static const char *scaleXY = "get_scale_xy";
 	static const char *setScaleX = "set_scale_x";
 	static const char *setScaleY = "set_scale_y";
 	static const char *setScale = "set_scale";
@@ -50,10 +53,13 @@ void LuaSceneNode::exposeFunctions(lua_State *L)
 	LuaUtils::addFunction(L, LuaNames::SceneNode::setEnabled, setEnabled);
 
 	LuaUtils::addFunction(L, LuaNames::SceneNode::position, position);
+	LuaUtils::addFunction(L, LuaNames::SceneNode::positionXY, positionXY);
 	LuaUtils::addFunction(L, LuaNames::SceneNode::setPosition, setPosition);
 	LuaUtils::addFunction(L, LuaNames::SceneNode::absAnchorPoint, absAnchorPoint);
+	LuaUtils::addFunction(L, LuaNames::SceneNode::absAnchorPointXY, absAnchorPointXY);
 	LuaUtils::addFunction(L, LuaNames::SceneNode::setAbsAnchorPoint, setAbsAnchorPoint);
 	LuaUtils::addFunction(L, LuaNames::SceneNode::scale, scale);
+	LuaUtils::addFunction(L, LuaNames::SceneNode::scaleXY, scaleXY);
 	LuaUtils::addFunction(L, LuaNames::SceneNode::setScaleX, setScaleX);
 	LuaUtils::addFunction(L, LuaNames::SceneNode::setScaleY, setScaleY);
 	LuaUtils::addFunction(L, LuaNames::SceneNode::setScale, setScale);
@@ -148,6 +154,16 @@ int LuaSceneNode::position(lua_State *L)
 	return 1;
 }
 
+int LuaSceneNode::positionXY(lua_State *L)
+{
+	SceneNode *node = LuaClassWrapper<SceneNode>::unwrapUserData(L, -1);
+
+	const Vector2f &pos = node->position();
+	LuaVector2fUtils::pushParams(L, pos);
+
+	return 2;
+}
+
 int LuaSceneNode::setPosition(lua_State *L)
 {
 	int vectorIndex = 0;
@@ -169,6 +185,16 @@ int LuaSceneNode::absAnchorPoint(lua_State *L)
 	return 1;
 }
 
+int LuaSceneNode::absAnchorPointXY(lua_State *L)
+{
+	SceneNode *node = LuaClassWrapper<SceneNode>::unwrapUserData(L, -1);
+
+	const Vector2f &absAnchorPoint = node->absAnchorPoint();
+	LuaVector2fUtils::pushParams(L, absAnchorPoint);
+
+	return 2;
+}
+
 int LuaSceneNode::setAbsAnchorPoint(lua_State *L)
 {
 	int vectorIndex = 0;
@@ -190,6 +216,16 @@ int LuaSceneNode::scale(lua_State *L)
 	return 1;
 }
 
+int LuaSceneNode::scaleXY(lua_State *L)
+{
+	SceneNode *node = LuaClassWrapper<SceneNode>::unwrapUserData(L, -1);
+
+	const Vector2f &scale = node->scale();
+	LuaVector2fUtils::pushParams(L, scale);
+
+	return 2;
+}
+
 int LuaSceneNode::setScaleX(lua_State *L)
 {
 	SceneNode *node = LuaClassWrapper<SceneNode>::unwrapUserData(L, -2);
@@ -4,7 +4,11 @@
 
 #include "LuaStateManager.h"
 #include "LuaDebug.h"
+#include "LuaUtils.h"
 #include "LuaStatistics.h"
+#include "LuaProfiler.h"
+#include "LuaMemoryPool.h"
+#include "MemoryStatistics.h"
 #include "LuaNames.h"
 
 #include "LuaRect.h"
@@ -40,8 +44,12 @@
 #endif
 
 #include "Application.h"
-#include <cstring> // for memchr()
+#include <cstring> // for memchr() and memcpy()
+#include <nctl/algorithms.h>
 #include "IFile.h"
+#include "FileSystem.h"
+#include "TimeStamp.h"
+#include "tracy.h"
 
 #ifdef WITH_TRACY
 	#include "TracyLua.hpp"
@@ -84,6 +92,40 @@ namespace LuaNames {
 #endif
 }
 
+namespace {
+	/// Amount of allocation simulated by each incremental step, in kilobytes
+	const int GcStepSizeKb = 16;
+	/// A full collection is forced when memory grows by this factor since the last cycle
+	const int GcMaxMemoryGrowth = 4;
+	/// Below this amount of memory, in kilobytes, a full collection is never forced
+	const int GcMinMemoryKb = 1024;
+
+	const char BytecodeCacheMagic[4] = { 'N', 'C', 'L', 'C' };
+	/// To be increased when the layout of the cache files changes
+	const uint32_t BytecodeCacheVersion = 1;
+	const char *BytecodeCacheDirectory = "luacache";
+	const char *BytecodeCacheExtension = "luac";
+
+	uint64_t fnv1aHash(const char *buffer, unsigned long size)
+	{
+		uint64_t hash = 0xCBF29CE484222325ULL;
+		for (unsigned long i = 0; i < size; i++)
+			hash = (static_cast<unsigned char>(buffer[i]) ^ hash) * 0x100000001B3ULL;
+		return hash;
+	}
+
+	int bytecodeWriter(lua_State *L, const void *p, size_t size, void *ud)
+	{
+		nctl::Array<char> &bytecode = *static_cast<nctl::Array<char> *>(ud);
+		const unsigned int oldSize = bytecode.size();
+		if (oldSize + size > bytecode.capacity())
+			bytecode.setCapacity(nctl::max(bytecode.capacity() * 2, static_cast<unsigned int>(oldSize + size)));
+		bytecode.setSize(oldSize + size);
+		memcpy(bytecode.data() + oldSize, p, size);
+		return 0;
+	}
+}
+
 ///////////////////////////////////////////////////////////
 // STATIC DEFINITIONS
 ///////////////////////////////////////////////////////////
@@ -95,16 +137,20 @@ nctl::Array<LuaStateManager::StateToManager> LuaStateManager::managers_(2);
 ///////////////////////////////////////////////////////////
 
 LuaStateManager::LuaStateManager(ApiType apiType, StatisticsTracking statsTracking, StandardLibraries stdLibraries)
-    : LuaStateManager(lua_newstate(statsTracking == StatisticsTracking::ENABLED ? luaAllocatorWithStatistics : luaAllocator, nullptr),
-                      apiType, statsTracking, stdLibraries)
+    : LuaStateManager(createState(statsTracking), apiType, statsTracking, stdLibraries)
 {
 	closeOnDestruction_ = true;
+
+	// The state owns its memory pool through the manager, it is destroyed after `lua_close()`
+	void *userData = nullptr;
+	lua_getallocf(L_, &userData);
+	memoryPool_.reset(static_cast<LuaMemoryPool *>(userData));
 }
 
 LuaStateManager::LuaStateManager(lua_State *L, ApiType apiType, StatisticsTracking statsTracking, StandardLibraries stdLibraries)
     : L_(L), apiType_(apiType), statsTracking_(statsTracking), stdLibraries_(stdLibraries),
-      trackedUserDatas_(apiType == ApiType::FULL ? 16 : 1),
-      untrackedUserDatas_(16), closeOnDestruction_(false)
+      trackedUserDatas_(0), untrackedUserDatas_(1), closeOnDestruction_(false), gcFrameBudget_(0.0f), gcMemoryAfterCycle_(0),
+      bytecodeCacheEnabled_(false), bytecodeCachePath_(fs::MaxPathLength)
 {
 	ASSERT(L_);
 	if (stdLibraries == StandardLibraries::LOADED)
@@ -114,7 +160,7 @@ LuaStateManager::LuaStateManager(lua_State *L, ApiType apiType, StatisticsTracki
 	if (statsTracking == StatisticsTracking::ENABLED)
 	{
 		LuaStatistics::registerState(this);
-		lua_sethook(L_, luaCountHook, LUA_MASKCOUNT, LuaStatistics::OperationsCount);
+		LuaStatistics::setHook(this);
 	}
 
 #ifdef WITH_TRACY
@@ -143,10 +189,13 @@ void LuaStateManager::releaseTrackedMemory()
 	if (trackedUserDatas_.isEmpty() == false)
 		LOGW_X("Lua array of tracked userdata is not empty: %d elements", trackedUserDatas_.size());
 
-	for (unsigned int i = 0; i < trackedUserDatas_.size(); i++)
+	for (unsigned int i = 0; i < trackedUserDatas_.numSlots(); i++)
 	{
-		UserDataWrapper &wrapper = trackedUserDatas_[i];
-		ASSERT(wrapper.arrayIndex == i);
+		UserDataWrapper &wrapper = trackedUserDatas_.slot(i);
+		// Skip the slots of objects already deleted by the script
+		if (wrapper.object == nullptr)
+			continue;
+		untrackedUserDatas_.releaseShared(wrapper.object);
 
 		switch (wrapper.type)
 		{
@@ -261,7 +310,7 @@ bool LuaStateManager::runFromMemory(const char *buffer, unsigned long size, cons
 		size -= bufferRead - buffer;
 	}
 
-	const int loadError = luaL_loadbufferx(L_, bufferRead, size, filename, "bt");
+	const int loadError = loadBuffer(bufferRead, size, filename);
 	if (loadError != LUA_OK)
 	{
 		LOGE_X("Cannot load \"%s\" script: %s", filename, LuaDebug::errorToSting(loadError));
@@ -278,6 +327,88 @@ bool LuaStateManager::runFromMemory(const char *buffer, unsigned long size, cons
 	return true;
 }
 
+void LuaStateManager::setBytecodeCacheEnabled(bool enabled)
+{
+	if (enabled && bytecodeCachePath_.isEmpty())
+		bytecodeCachePath_ = fs::joinPath(fs::savePath(), BytecodeCacheDirectory);
+	bytecodeCacheEnabled_ = enabled;
+}
+
+void LuaStateManager::setBytecodeCachePath(const char *path)
+{
+	ASSERT(path);
+	bytecodeCachePath_ = path;
+}
+
+void LuaStateManager::setGcFrameBudget(float milliseconds)
+{
+	if (milliseconds < 0.0f)
+		milliseconds = 0.0f;
+
+	if (milliseconds > 0.0f && gcFrameBudget_ == 0.0f)
+	{
+		lua_gc(L_, LUA_GCSTOP, 0);
+		gcMemoryAfterCycle_ = lua_gc(L_, LUA_GCCOUNT, 0);
+	}
+	else if (milliseconds == 0.0f && gcFrameBudget_ > 0.0f)
+		lua_gc(L_, LUA_GCRESTART, 0);
+
+	gcFrameBudget_ = milliseconds;
+}
+
+void LuaStateManager::setGcParameters(int pause, int stepMultiplier)
+{
+	lua_gc(L_, LUA_GCSETPAUSE, pause);
+	lua_gc(L_, LUA_GCSETSTEPMUL, stepMultiplier);
+}
+
+void LuaStateManager::stepGarbageCollector()
+{
+	if (gcFrameBudget_ <= 0.0f)
+		return;
+
+	ZoneScoped;
+	const TimeStamp startTime = TimeStamp::now();
+	bool cycleCompleted = false;
+
+	// A full collection is the safety net for when the steps cannot keep up with the allocations
+	const int memoryKb = lua_gc(L_, LUA_GCCOUNT, 0);
+	if (memoryKb > gcMemoryAfterCycle_ * GcMaxMemoryGrowth && memoryKb > GcMinMemoryKb)
+	{
+		lua_gc(L_, LUA_GCCOLLECT, 0);
+		cycleCompleted = true;
+	}
+	else
+	{
+		do
+		{
+			cycleCompleted = (lua_gc(L_, LUA_GCSTEP, GcStepSizeKb) == 1);
+		} while (cycleCompleted == false && startTime.millisecondsSince() < gcFrameBudget_);
+	}
+
+	if (cycleCompleted)
+		gcMemoryAfterCycle_ = lua_gc(L_, LUA_GCCOUNT, 0);
+
+	if (statsTracking_ == StatisticsTracking::ENABLED)
+		LuaStatistics::addGcPause(startTime.millisecondsSince(), cycleCompleted);
+}
+
+LuaStateManager::UserDataWrapper *LuaStateManager::userDataWrapper(const void *handle)
+{
+	LuaUserDataPool &pool = (LuaUserDataPool::poolIndex(handle) == 0) ? trackedUserDatas_ : untrackedUserDatas_;
+	return pool.fromHandle(handle);
+}
+
+LuaStateManager::UserDataWrapper *LuaStateManager::retrieveUserDataWrapper(lua_State *L, int index)
+{
+	void *handle = LuaUtils::retrieveUserData(L, index);
+	UserDataWrapper *wrapper = manager(L)->userDataWrapper(handle);
+	if (wrapper == nullptr)
+		LuaDebug::traceError(L, "The object has already been deleted");
+
+	return wrapper;
+}
+
 LuaStateManager *LuaStateManager::manager(lua_State *L)
 {
 	LuaStateManager *stateManager = nullptr;
@@ -295,40 +426,189 @@ LuaStateManager *LuaStateManager::manager(lua_State *L)
 	return stateManager;
 }
 
+void LuaStateManager::stepGarbageCollectors()
+{
+	for (const StateToManager &manager : managers_)
+		manager.stateManager->stepGarbageCollector();
+}
+
+void LuaStateManager::releaseSharedUserData(const void *object)
+{
+	for (const StateToManager &manager : managers_)
+		manager.stateManager->untrackedUserDatas_.releaseShared(object);
+}
+
 ///////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
 ///////////////////////////////////////////////////////////
 
-void *LuaStateManager::luaAllocator(void *ud, void *ptr, size_t osize, size_t nsize)
+lua_State *LuaStateManager::createState(StatisticsTracking statsTracking)
 {
-	if (nsize == 0)
+	LuaMemoryPool *memoryPool = new LuaMemoryPool();
+	return lua_newstate(statsTracking == StatisticsTracking::ENABLED ? luaAllocatorWithStatistics : luaAllocator, memoryPool);
+}
+
+int LuaStateManager::loadBuffer(const char *buffer, unsigned long size, const char *filename)
+{
+	if (bytecodeCacheEnabled_ == false)
+		return luaL_loadbufferx(L_, buffer, size, filename, "bt");
+
+	ZoneScoped;
+	const TimeStamp startTime = TimeStamp::now();
+	const uint64_t sourceHash = fnv1aHash(buffer, size);
+
+	// Cache files are named after the hash of the script name, the source hash inside tells if they are stale
+	nctl::String cacheFilename(fs::MaxPathLength);
+	cacheFilename.format("%016llx.%s", static_cast<unsigned long long>(fnv1aHash(filename, strlen(filename))), BytecodeCacheExtension);
+	cacheFilename = fs::joinPath(bytecodeCachePath_, cacheFilename);
+
+	if (loadCachedBytecode(cacheFilename.data(), sourceHash, size, filename))
 	{
-		free(ptr);
-		return nullptr;
+		LOGI_X("Loaded \"%s\" from the bytecode cache in %.2f ms", filename, startTime.millisecondsSince());
+		return LUA_OK;
 	}
-	else
-		return realloc(ptr, nsize);
+
+	const int loadError = luaL_loadbufferx(L_, buffer, size, filename, "bt");
+	if (loadError == LUA_OK)
+	{
+		LOGI_X("Compiled \"%s\" in %.2f ms", filename, startTime.millisecondsSince());
+		saveCachedBytecode(cacheFilename.data(), sourceHash, size);
+	}
+	return loadError;
+}
+
+bool LuaStateManager::loadCachedBytecode(const char *cacheFilename, uint64_t sourceHash, unsigned long sourceSize, const char *filename)
+{
+	if (fs::isReadableFile(cacheFilename) == false)
+		return false;
+
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(cacheFilename);
+	fileHandle->setExitOnFailToOpen(false);
+	fileHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+		return false;
+
+	char magic[4];
+	uint32_t version = 0;
+	uint64_t cachedSourceHash = 0;
+	uint32_t cachedSourceSize = 0;
+	uint32_t bytecodeSize = 0;
+	fileHandle->read(magic, sizeof(magic));
+	fileHandle->read(&version, sizeof(uint32_t));
+	fileHandle->read(&cachedSourceHash, sizeof(uint64_t));
+	fileHandle->read(&cachedSourceSize, sizeof(uint32_t));
+	fileHandle->read(&bytecodeSize, sizeof(uint32_t));
+
+	if (memcmp(magic, BytecodeCacheMagic, sizeof(magic)) != 0 || version != BytecodeCacheVersion ||
+	    cachedSourceHash != sourceHash || cachedSourceSize != sourceSize || bytecodeSize == 0)
+	{
+		return false;
+	}
+
+	nctl::UniquePtr<char[]> bytecode = nctl::makeUnique<char[]>(bytecodeSize);
+	if (fileHandle->read(bytecode.get(), bytecodeSize) != bytecodeSize)
+		return false;
+
+	// Bytecode from a different Lua version or build is rejected by the loader
+	const int loadError = luaL_loadbufferx(L_, bytecode.get(), bytecodeSize, filename, "b");
+	if (loadError != LUA_OK)
+	{
+		LOGW_X("Cannot load cached bytecode for \"%s\": %s", filename, lua_tostring(L_, -1));
+		lua_pop(L_, 1);
+		return false;
+	}
+
+	return true;
+}
+
+void LuaStateManager::saveCachedBytecode(const char *cacheFilename, uint64_t sourceHash, unsigned long sourceSize)
+{
+	// The compiled function is on top of the stack, dumped with its debug information
+	nctl::Array<char> bytecode(static_cast<unsigned int>(sourceSize));
+	if (lua_dump(L_, bytecodeWriter, &bytecode, 0) != 0 || bytecode.isEmpty())
+		return;
+
+	if (fs::isDirectory(bytecodeCachePath_.data()) == false && fs::createDir(bytecodeCachePath_.data()) == false)
+	{
+		LOGW_X("Cannot create the bytecode cache directory \"%s\"", bytecodeCachePath_.data());
+		return;
+	}
+
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(cacheFilename);
+	fileHandle->setExitOnFailToOpen(false);
+	fileHandle->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+	{
+		LOGW_X("Cannot write the bytecode cache file \"%s\"", cacheFilename);
+		return;
+	}
+
+	uint32_t version = BytecodeCacheVersion;
+	uint32_t cachedSourceSize = static_cast<uint32_t>(sourceSize);
+	uint32_t bytecodeSize = bytecode.size();
+	fileHandle->write(const_cast<char *>(BytecodeCacheMagic), sizeof(BytecodeCacheMagic));
+	fileHandle->write(&version, sizeof(uint32_t));
+	fileHandle->write(&sourceHash, sizeof(uint64_t));
+	fileHandle->write(&cachedSourceSize, sizeof(uint32_t));
+	fileHandle->write(&bytecodeSize, sizeof(uint32_t));
+	fileHandle->write(bytecode.data(), bytecodeSize);
+}
+
+void *LuaStateManager::luaAllocator(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+	LuaMemoryPool *memoryPool = static_cast<LuaMemoryPool *>(ud);
+	return memoryPool->reallocate(ptr, osize, nsize);
 }
 
 void *LuaStateManager::luaAllocatorWithStatistics(void *ud, void *ptr, size_t osize, size_t nsize)
 {
+	LuaMemoryPool *memoryPool = static_cast<LuaMemoryPool *>(ud);
+
 	if (nsize == 0)
 	{
-		LuaStatistics::freeMemory(osize);
-		free(ptr);
-		return nullptr;
+		if (ptr != nullptr)
+		{
+			LuaStatistics::freeMemory(osize);
+			MemoryStatistics::addDeallocation(MemoryStatistics::Tags::LUA, osize);
+		}
+		return memoryPool->reallocate(ptr, osize, nsize);
 	}
 	else
 	{
-		LuaStatistics::allocMemory(nsize - osize);
-		return realloc(ptr, nsize);
+		// When `ptr` is null, `osize` encodes the type of the object being allocated
+		const size_t oldSize = (ptr != nullptr) ? osize : 0;
+		// The memory pool does not use the global `new` operator, a reallocation is accounted as a new allocation
+		if (ptr != nullptr)
+			MemoryStatistics::addDeallocation(MemoryStatistics::Tags::LUA, oldSize);
+		MemoryStatistics::addAllocation(MemoryStatistics::Tags::LUA, nsize);
+		if (nsize > oldSize)
+		{
+			LuaStatistics::allocMemory(nsize - oldSize);
+			if (LuaProfiler::isEnabled())
+				LuaProfiler::onAllocation(nsize - oldSize);
+		}
+		else
+			LuaStatistics::freeMemory(oldSize - nsize);
+		return memoryPool->reallocate(ptr, osize, nsize);
 	}
 }
 
-void LuaStateManager::luaCountHook(lua_State *L, lua_Debug *ar)
+void LuaStateManager::luaHook(lua_State *L, lua_Debug *ar)
 {
-	if (ar->event == LUA_HOOKCOUNT)
-		LuaStatistics::countOperations();
+	switch (ar->event)
+	{
+		case LUA_HOOKCOUNT:
+			LuaStatistics::countOperations(lua_gethookcount(L));
+			if (LuaProfiler::isEnabled())
+				LuaProfiler::onSample(L);
+			break;
+		case LUA_HOOKCALL:
+			LuaProfiler::onCall(L);
+			break;
+		case LUA_HOOKRET:
+			LuaProfiler::onReturn(L);
+			break;
+	}
 }
 
 void LuaStateManager::exposeApi()
@@ -1,6 +1,11 @@
+#define NCINE_INCLUDE_LUA
+#include "common_headers.h"
+
 #include <nctl/String.h>
 #include "LuaStatistics.h"
 #include "LuaStateManager.h"
+#include "LuaProfiler.h"
+#include "LuaMemoryPool.h"
 #include "tracy.h"
 
 namespace ncine {
@@ -16,6 +21,13 @@ size_t LuaStatistics::usedMemory_ = 0;
 TimeStamp LuaStatistics::lastOpsUpdateTime_;
 unsigned int LuaStatistics::index_ = 0;
 int LuaStatistics::operations_[2] = { 0, 0 };
+size_t LuaStatistics::poolsMemory_ = 0;
+float LuaStatistics::gcFrameTime_ = 0.0f;
+float LuaStatistics::currentGcFrameTime_ = 0.0f;
+float LuaStatistics::maxGcPause_ = 0.0f;
+float LuaStatistics::currentMaxGcPause_ = 0.0f;
+TimeStamp LuaStatistics::lastGcPauseUpdateTime_;
+unsigned int LuaStatistics::numGcCycles_ = 0;
 
 ///////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
@@ -26,15 +38,48 @@ void LuaStatistics::update()
 	numTrackedUserDatas_ = 0;
 	for (unsigned int i = 0; i < LuaTypes::UserDataType::UNKNOWN + 1; i++)
 		numTypedUserDatas_[i] = 0;
+	poolsMemory_ = 0;
+
+	// Collection happens at the end of the frame, the time reported is the one of the previous frame
+	gcFrameTime_ = currentGcFrameTime_;
+	currentGcFrameTime_ = 0.0f;
+	if (lastGcPauseUpdateTime_.secondsSince() >= 1.0f)
+	{
+		maxGcPause_ = currentMaxGcPause_;
+		currentMaxGcPause_ = 0.0f;
+		lastGcPauseUpdateTime_ = TimeStamp::now();
+	}
 
 	for (const LuaStateManager *manager : managers_)
 	{
 		numTrackedUserDatas_ += manager->trackedUserDatas_.size();
-		for (const LuaStateManager::UserDataWrapper &wrapper : manager->trackedUserDatas_)
-			numTypedUserDatas_[wrapper.type]++;
+		if (manager->memoryPool_ != nullptr)
+			poolsMemory_ += manager->memoryPool_->pagesMemory();
+		const LuaUserDataPool &pool = manager->trackedUserDatas_;
+		for (unsigned int i = 0; i < pool.numSlots(); i++)
+		{
+			const LuaStateManager::UserDataWrapper &wrapper = pool.slot(i);
+			if (wrapper.object != nullptr)
+				numTypedUserDatas_[wrapper.type]++;
+		}
 	}
 }
 
+void LuaStatistics::setProfilingEnabled(bool enabled)
+{
+	if (enabled == LuaProfiler::isEnabled())
+		return;
+
+	LuaProfiler::setEnabled(enabled);
+	for (LuaStateManager *manager : managers_)
+		setHook(manager);
+}
+
+bool LuaStatistics::isProfilingEnabled()
+{
+	return LuaProfiler::isEnabled();
+}
+
 ///////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
 ///////////////////////////////////////////////////////////
@@ -64,9 +109,9 @@ void LuaStatistics::unregisterState(LuaStateManager *stateManager)
 		managers_.unorderedRemoveAt(index);
 }
 
-void LuaStatistics::countOperations()
+void LuaStatistics::countOperations(int count)
 {
-	operations_[index_] += OperationsCount;
+	operations_[index_] += count;
 
 	const float secsSinceLastUpdate = lastOpsUpdateTime_.secondsSince();
 	if (secsSinceLastUpdate >= 1.0f)
@@ -81,4 +126,24 @@ void LuaStatistics::countOperations()
 	}
 }
 
+void LuaStatistics::addGcPause(float milliseconds, bool cycleCompleted)
+{
+	currentGcFrameTime_ += milliseconds;
+	if (milliseconds > currentMaxGcPause_)
+		currentMaxGcPause_ = milliseconds;
+	if (cycleCompleted)
+		numGcCycles_++;
+
+	TracyPlot("Lua GC ms", milliseconds);
+}
+
+void LuaStatistics::setHook(LuaStateManager *manager)
+{
+	// Sampling needs a shorter count interval and the call events to detect callbacks from the engine
+	if (LuaProfiler::isEnabled())
+		lua_sethook(manager->L_, LuaStateManager::luaHook, LUA_MASKCOUNT | LUA_MASKCALL | LUA_MASKRET, LuaProfiler::SampleCount);
+	else
+		lua_sethook(manager->L_, LuaStateManager::luaHook, LUA_MASKCOUNT, OperationsCount);
+}
+
 }
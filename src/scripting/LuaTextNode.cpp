@@ -3,6 +3,8 @@
 #include "LuaClassTracker.h"
 #include "LuaDrawableNode.h"
 #include "LuaUtils.h"
+#include "LuaColorUtils.h"
+#include "LuaVector2Utils.h"
 #include "TextNode.h"
 
 namespace ncine {
@@ -22,10 +24,15 @@ namespace TextNode {
 	static const char *alignment = "get_alignment";
 	static const char *setAlignment = "set_alignment";
 
+	static const char *hasDistanceField = "has_distance_field";
+	static const char *setOutline = "set_outline";
+	static const char *setShadow = "set_shadow";
+
 	static const char *fontBase = "get_fontbase";
 	static const char *fontLineHeight = "get_fontlineheight";
 
 	static const char *setString = "set_string";
+	static const char *appendString = "append_string";
 
 	static const char *LEFT = "LEFT";
 	static const char *CENTER = "CENTER";
@@ -59,10 +66,15 @@ void LuaTextNode::expose(LuaStateManager *stateManager)
 	LuaUtils::addFunction(L, LuaNames::TextNode::alignment, alignment);
 	LuaUtils::addFunction(L, LuaNames::TextNode::setAlignment, setAlignment);
 
+	LuaUtils::addFunction(L, LuaNames::TextNode::hasDistanceField, hasDistanceField);
+	LuaUtils::addFunction(L, LuaNames::TextNode::setOutline, setOutline);
+	LuaUtils::addFunction(L, LuaNames::TextNode::setShadow, setShadow);
+
 	LuaUtils::addFunction(L, LuaNames::TextNode::fontBase, fontBase);
 	LuaUtils::addFunction(L, LuaNames::TextNode::fontLineHeight, fontLineHeight);
 
 	LuaUtils::addFunction(L, LuaNames::TextNode::setString, setString);
+	LuaUtils::addFunction(L, LuaNames::TextNode::appendString, appendString);
 
 	LuaDrawableNode::exposeFunctions(L);
 
@@ -176,6 +188,41 @@ int LuaTextNode::setAlignment(lua_State *L)
 	return 0;
 }
 
+int LuaTextNode::hasDistanceField(lua_State *L)
+{
+	TextNode *textnode = LuaClassWrapper<TextNode>::unwrapUserData(L, -1);
+
+	LuaUtils::push(L, textnode->hasDistanceField());
+
+	return 1;
+}
+
+int LuaTextNode::setOutline(lua_State *L)
+{
+	int colorIndex = 0;
+	const Colorf color = LuaColorUtils::retrieve(L, -1, colorIndex);
+	const float width = LuaUtils::retrieve<float>(L, colorIndex - 1);
+	TextNode *textnode = LuaClassWrapper<TextNode>::unwrapUserData(L, colorIndex - 2);
+
+	textnode->setOutline(width, color);
+
+	return 0;
+}
+
+int LuaTextNode::setShadow(lua_State *L)
+{
+	int colorIndex = 0;
+	int vectorIndex = 0;
+	const float softness = LuaUtils::retrieve<float>(L, -1);
+	const Colorf color = LuaColorUtils::retrieve(L, -2, colorIndex);
+	const Vector2f offset = LuaVector2fUtils::retrieve(L, colorIndex - 1, vectorIndex);
+	TextNode *textnode = LuaClassWrapper<TextNode>::unwrapUserData(L, vectorIndex - 1);
+
+	textnode->setShadow(offset, color, softness);
+
+	return 0;
+}
+
 int LuaTextNode::fontBase(lua_State *L)
 {
 	TextNode *textnode = LuaClassWrapper<TextNode>::unwrapUserData(L, -1);
@@ -204,4 +251,14 @@ int LuaTextNode::setString(lua_State *L)
 	return 0;
 }
 
+int LuaTextNode::appendString(lua_State *L)
+{
+	TextNode *textnode = LuaClassWrapper<TextNode>::unwrapUserData(L, -2);
+	const char *string = LuaUtils::retrieve<const char *>(L, -1);
+
+	textnode->appendString(string);
+
+	return 0;
+}
+
 }
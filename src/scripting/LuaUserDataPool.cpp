@@ -0,0 +1,187 @@
+#include "common_macros.h"
+#include "LuaUserDataPool.h"
+
+namespace ncine {
+
+namespace {
+	/// Initial capacity of the shared wrappers hashmap
+	const unsigned int SharedSlotsCapacity = 64;
+	/// The shared wrappers hashmap is rehashed when exceeding this load factor
+	const float MaxSharedSlotsLoadFactor = 0.75f;
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+LuaUserDataPool::LuaUserDataPool(unsigned int poolIndex)
+    : poolIndex_(poolIndex), size_(0), numSlots_(0), chunks_(4), freeSlots_(16), firstFreeSlot_(0)
+{
+	ASSERT(poolIndex <= PoolIndexMask);
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void *LuaUserDataPool::handle(const Wrapper &wrapper) const
+{
+	const uintptr_t handle = (static_cast<uintptr_t>(wrapper.slotIndex) << SlotShift) | (wrapper.generation << GenerationShift) | poolIndex_;
+	return reinterpret_cast<void *>(handle);
+}
+
+LuaUserDataPool::Wrapper *LuaUserDataPool::fromHandle(const void *handle)
+{
+	const uintptr_t value = reinterpret_cast<uintptr_t>(handle);
+	const unsigned int slotIndex = static_cast<unsigned int>(value >> SlotShift);
+	const unsigned int generation = static_cast<unsigned int>(value >> GenerationShift) & GenerationMask;
+	if ((value & PoolIndexMask) != poolIndex_ || slotIndex >= numSlots_)
+		return nullptr;
+
+	Wrapper &wrapper = slot(slotIndex);
+	if (wrapper.generation != generation || wrapper.object == nullptr)
+		return nullptr;
+
+	return &wrapper;
+}
+
+LuaUserDataPool::Wrapper &LuaUserDataPool::acquire(void *object, LuaTypes::UserDataType type)
+{
+	ASSERT(object);
+	Wrapper &wrapper = acquireSlot();
+	wrapper.object = object;
+	wrapper.type = type;
+	wrapper.typeMask = LuaTypes::userDataTypeMask(type);
+
+	return wrapper;
+}
+
+LuaUserDataPool::Wrapper &LuaUserDataPool::acquireShared(void *object, LuaTypes::UserDataType type)
+{
+	if (sharedSlots_ == nullptr)
+		sharedSlots_ = nctl::makeUnique<nctl::HashMap<uintptr_t, unsigned int>>(SharedSlotsCapacity);
+
+	const uintptr_t key = reinterpret_cast<uintptr_t>(object);
+	const unsigned int *slotIndex = sharedSlots_->find(key);
+	if (slotIndex != nullptr)
+	{
+		Wrapper &wrapper = slot(*slotIndex);
+		ASSERT(wrapper.object == object);
+
+		const uint32_t typeMask = LuaTypes::userDataTypeMask(type);
+		if ((typeMask & wrapper.typeMask) == wrapper.typeMask)
+		{
+			// Promote the wrapper if the object is now known as a more derived type
+			wrapper.type = type;
+			wrapper.typeMask = typeMask;
+		}
+		else if ((wrapper.typeMask & typeMask) != typeMask)
+		{
+			// Neither a base nor a derived type, the address has been reused by a different object
+			resetWrapper(wrapper);
+			wrapper.object = object;
+			wrapper.type = type;
+			wrapper.typeMask = typeMask;
+		}
+
+		return wrapper;
+	}
+
+	if (sharedSlots_->loadFactor() >= MaxSharedSlotsLoadFactor)
+		sharedSlots_->rehash(sharedSlots_->capacity() * 2);
+
+	Wrapper &wrapper = acquire(object, type);
+	sharedSlots_->insert(key, wrapper.slotIndex);
+
+	return wrapper;
+}
+
+void LuaUserDataPool::release(Wrapper &wrapper)
+{
+	ASSERT(wrapper.slotIndex < numSlots_);
+	ASSERT(&slot(wrapper.slotIndex) == &wrapper);
+	ASSERT(size_ > 0);
+
+	resetWrapper(wrapper);
+	freeSlots_.pushBack(wrapper.slotIndex);
+	size_--;
+}
+
+bool LuaUserDataPool::releaseShared(const void *object)
+{
+	if (sharedSlots_ == nullptr || sharedSlots_->isEmpty())
+		return false;
+
+	const uintptr_t key = reinterpret_cast<uintptr_t>(object);
+	const unsigned int *slotIndex = sharedSlots_->find(key);
+	if (slotIndex == nullptr)
+		return false;
+
+	release(slot(*slotIndex));
+	sharedSlots_->remove(key);
+
+	return true;
+}
+
+void LuaUserDataPool::clear()
+{
+	// Generations are preserved, as the slots will be acquired again
+	for (unsigned int i = 0; i < numSlots_; i++)
+		resetWrapper(slot(i));
+
+	size_ = 0;
+	numSlots_ = 0;
+	freeSlots_.clear();
+	firstFreeSlot_ = 0;
+	if (sharedSlots_ != nullptr)
+		sharedSlots_->clear();
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+LuaUserDataPool::Wrapper &LuaUserDataPool::acquireSlot()
+{
+	unsigned int slotIndex = 0;
+	if (firstFreeSlot_ < freeSlots_.size())
+	{
+		// The slot released first is reused first, to let its generation wrap around as late as possible
+		slotIndex = freeSlots_[firstFreeSlot_++];
+		if (firstFreeSlot_ == freeSlots_.size())
+		{
+			freeSlots_.clear();
+			firstFreeSlot_ = 0;
+		}
+		else if (firstFreeSlot_ >= freeSlots_.size() / 2)
+		{
+			freeSlots_.removeRange(0, firstFreeSlot_);
+			firstFreeSlot_ = 0;
+		}
+	}
+	else
+	{
+		FATAL_ASSERT_MSG_X(numSlots_ < MaxSlots, "Cannot address more than %u userdata wrappers", MaxSlots);
+		slotIndex = numSlots_++;
+		// Chunks are kept allocated after a clear and reused
+		if ((slotIndex >> ChunkShift) >= chunks_.size())
+			chunks_.pushBack(nctl::makeUnique<Wrapper[]>(ChunkSize));
+	}
+
+	Wrapper &wrapper = slot(slotIndex);
+	wrapper.slotIndex = slotIndex;
+	size_++;
+
+	return wrapper;
+}
+
+void LuaUserDataPool::resetWrapper(Wrapper &wrapper)
+{
+	wrapper.object = nullptr;
+	wrapper.type = LuaTypes::UNKNOWN;
+	wrapper.typeMask = 0;
+	// Zero is skipped so that a handle is never a null pointer
+	wrapper.generation = (wrapper.generation < GenerationMask) ? wrapper.generation + 1 : 1;
+}
+
+}
@@ -0,0 +1,40 @@
+uniform mat4 projection;
+
+struct TextnodeInstance
+{
+	mat4 modelView;
+	vec4 color;
+	vec4 outlineColor;
+	vec4 shadowColor;
+	vec4 sdfParams;
+};
+
+layout (std140) uniform InstancesBlock
+{
+#ifdef WITH_FIXED_BATCH_SIZE
+	TextnodeInstance[BATCH_SIZE] instances;
+#else
+	TextnodeInstance[512] instances;
+#endif
+} block;
+
+in vec2 aPosition;
+in vec2 aTexCoords;
+in uint aMeshIndex;
+out vec2 vTexCoords;
+out vec4 vColor;
+out vec4 vOutlineColor;
+out vec4 vShadowColor;
+out vec4 vSdfParams;
+
+#define i block.instances[aMeshIndex]
+
+void main()
+{
+	gl_Position = projection * i.modelView * vec4(aPosition, 0.0, 1.0);
+	vTexCoords = aTexCoords;
+	vColor = i.color;
+	vOutlineColor = i.outlineColor;
+	vShadowColor = i.shadowColor;
+	vSdfParams = i.sdfParams;
+}
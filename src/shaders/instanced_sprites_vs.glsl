@@ -0,0 +1,23 @@
+uniform mat4 projection;
+
+in vec4 aModelView0;
+in vec4 aModelView1;
+in vec4 aModelView2;
+in vec4 aModelView3;
+in vec4 aColor;
+in vec4 aTexRect;
+in vec2 aSpriteSize;
+out vec2 vTexCoords;
+out vec4 vColor;
+
+void main()
+{
+	mat4 modelView = mat4(aModelView0, aModelView1, aModelView2, aModelView3);
+	vec2 aPosition = vec2(0.5 - float(gl_VertexID >> 1), -0.5 + float(gl_VertexID % 2));
+	vec2 aTexCoords = vec2(1.0 - float(gl_VertexID >> 1), 1.0 - float(gl_VertexID % 2));
+	vec4 position = vec4(aPosition.x * aSpriteSize.x, aPosition.y * aSpriteSize.y, 0.0, 1.0);
+
+	gl_Position = projection * modelView * position;
+	vTexCoords = vec2(aTexCoords.x * aTexRect.x + aTexRect.y, aTexCoords.y * aTexRect.z + aTexRect.w);
+	vColor = aColor;
+}
@@ -0,0 +1,38 @@
+#ifdef GL_ES
+precision mediump float;
+#endif
+
+uniform sampler2D uTexture;
+in vec2 vTexCoords;
+in vec4 vColor;
+in vec4 vOutlineColor;
+in vec4 vShadowColor;
+in vec4 vSdfParams; // outline width, shadow offset in texels, shadow softness
+out vec4 fragColor;
+
+float sampleDistance(vec2 texCoords)
+{
+	vec3 s = texture(uTexture, texCoords).rgb;
+	return max(min(s.r, s.g), min(max(s.r, s.g), s.b));
+}
+
+void main()
+{
+	float dist = sampleDistance(vTexCoords);
+	float smoothing = max(fwidth(dist), 0.0001);
+	float outlineEdge = 0.5 - vSdfParams.x;
+
+	float fillAlpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, dist);
+	float outlineAlpha = smoothstep(outlineEdge - smoothing, outlineEdge + smoothing, dist);
+
+	vec2 shadowTexCoords = vTexCoords - vSdfParams.yz / vec2(textureSize(uTexture, 0));
+	float shadowSmoothing = max(vSdfParams.w, smoothing);
+	float shadowAlpha = smoothstep(outlineEdge - shadowSmoothing, outlineEdge + shadowSmoothing, sampleDistance(shadowTexCoords));
+
+	// Premultiplied layers: the outline surrounds the fill and both are composited over the shadow
+	vec4 color = vec4(vColor.rgb * vColor.a, vColor.a) * fillAlpha;
+	color += vec4(vOutlineColor.rgb * vOutlineColor.a, vOutlineColor.a) * max(outlineAlpha - fillAlpha, 0.0);
+	color += vec4(vShadowColor.rgb * vShadowColor.a, vShadowColor.a) * shadowAlpha * (1.0 - color.a);
+
+	fragColor = vec4(color.rgb / max(color.a, 0.0001), color.a);
+}
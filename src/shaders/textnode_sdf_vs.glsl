@@ -0,0 +1,28 @@
+uniform mat4 projection;
+
+layout (std140) uniform TextnodeBlock
+{
+	mat4 modelView;
+	vec4 color;
+	vec4 outlineColor;
+	vec4 shadowColor;
+	vec4 sdfParams;
+};
+
+in vec2 aPosition;
+in vec2 aTexCoords;
+out vec2 vTexCoords;
+out vec4 vColor;
+out vec4 vOutlineColor;
+out vec4 vShadowColor;
+out vec4 vSdfParams;
+
+void main()
+{
+	gl_Position = projection * modelView * vec4(aPosition, 0.0, 1.0);
+	vTexCoords = aTexCoords;
+	vColor = color;
+	vOutlineColor = outlineColor;
+	vShadowColor = shadowColor;
+	vSdfParams = sdfParams;
+}
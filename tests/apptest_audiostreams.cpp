@@ -0,0 +1,151 @@
+#include <cmath>
+#include "apptest_audiostreams.h"
+#include <ncine/common_constants.h>
+#include <ncine/common_macros.h>
+#include <ncine/Application.h>
+#include <ncine/AppConfiguration.h>
+#include <ncine/ServiceLocator.h>
+#include <ncine/AudioStreamPlayer.h>
+#include <ncine/WavAudioSink.h>
+#include <ncine/FileSystem.h>
+#include <ncine/Random.h>
+
+namespace {
+
+const int Frequency = 44100;
+const unsigned int SoundFrames = Frequency / 2;
+const unsigned int ChunkFrames = 1024;
+const float ToneFrequency = 440.0f;
+/// Small buffers keep the decode thread busy
+const unsigned long StreamBufferSize = 4096;
+const unsigned int MaxActionsPerFrame = 4;
+const unsigned int LogInterval = 60;
+const char *WavFilename = "apptest_audiostreams.wav";
+
+enum class Action
+{
+	PLAY,
+	PAUSE,
+	STOP,
+	RECREATE,
+
+	COUNT
+};
+
+/// Writes a stereo tone to a WAV file, so that the test does not need any data
+bool writeToneFile(const char *filename)
+{
+	nc::WavAudioSink sink(filename, Frequency);
+	if (sink.isOpened() == false)
+		return false;
+
+	int16_t frames[ChunkFrames * 2];
+	for (unsigned int start = 0; start < SoundFrames; start += ChunkFrames)
+	{
+		const unsigned int numFrames = (SoundFrames - start < ChunkFrames) ? SoundFrames - start : ChunkFrames;
+		for (unsigned int i = 0; i < numFrames; i++)
+		{
+			const float sample = sinf(2.0f * nc::fPi * ToneFrequency * (start + i) / Frequency) * 0.25f;
+			frames[i * 2] = static_cast<int16_t>(sample * 32767.0f);
+			frames[i * 2 + 1] = frames[i * 2];
+		}
+		sink.write(frames, numFrames);
+	}
+
+	return true;
+}
+
+}
+
+nc::IAppEventHandler *createAppEventHandler()
+{
+	return new MyEventHandler;
+}
+
+void MyEventHandler::onPreInit(nc::AppConfiguration &config)
+{
+	// Streams are registered, removed and destroyed while the decode thread is running
+	config.withAudioStreamThread = true;
+	config.audioStreamBufferSize = StreamBufferSize;
+	config.windowTitle = "apptest_audiostreams";
+}
+
+void MyEventHandler::onInit()
+{
+	numFrames_ = 0;
+	numActions_ = 0;
+
+	const nctl::String &savePath = nc::fs::savePath();
+	if (nc::fs::isDirectory(savePath.data()) == false)
+		nc::fs::createDir(savePath.data());
+	filename_ = nc::fs::joinPath(savePath, WavFilename);
+	FATAL_ASSERT_MSG_X(writeToneFile(filename_.data()), "Cannot write the tone file \"%s\"", filename_.data());
+
+	for (unsigned int i = 0; i < NumPlayers; i++)
+	{
+		players_[i] = nctl::makeUnique<nc::AudioStreamPlayer>(filename_.data());
+		players_[i]->setLooping(i % 2 == 0);
+		players_[i]->play();
+	}
+
+	LOGI_X("APPTEST_AUDIOSTREAMS: %u players on \"%s\", decode thread: %s", NumPlayers,
+	       nc::theServiceLocator().audioDevice().name(), nc::theApplication().appConfiguration().withAudioStreamThread ? "yes" : "no");
+}
+
+void MyEventHandler::onFrameStart()
+{
+	const unsigned int numActions = nc::random().integer(0, MaxActionsPerFrame + 1);
+	for (unsigned int i = 0; i < numActions; i++)
+	{
+		const unsigned int index = nc::random().integer(0, NumPlayers);
+		const Action action = static_cast<Action>(nc::random().integer(0, static_cast<uint32_t>(Action::COUNT)));
+
+		switch (action)
+		{
+			case Action::PLAY:
+				players_[index]->play();
+				break;
+			case Action::PAUSE:
+				players_[index]->pause();
+				break;
+			case Action::STOP:
+				players_[index]->stop();
+				FATAL_ASSERT(players_[index]->isPlaying() == false);
+				break;
+			case Action::RECREATE:
+				// The old stream is destroyed while the decode thread could be working on it
+				players_[index]->play();
+				players_[index] = nctl::makeUnique<nc::AudioStreamPlayer>(filename_.data());
+				players_[index]->play();
+				break;
+			case Action::COUNT:
+				break;
+		}
+	}
+	numActions_ += numActions;
+
+	const unsigned int numPlayers = nc::theServiceLocator().audioDevice().numPlayers();
+	FATAL_ASSERT_MSG_X(numPlayers <= NumPlayers, "The device has %u players registered instead of %u at most", numPlayers, NumPlayers);
+
+	numFrames_++;
+	if (numFrames_ % LogInterval == 0)
+	{
+		unsigned int numUnderruns = 0;
+		for (unsigned int i = 0; i < NumPlayers; i++)
+			numUnderruns += players_[i]->numUnderruns();
+		LOGI_X("APPTEST_AUDIOSTREAMS: %u frames, %u actions, %u players registered, %u underruns", numFrames_, numActions_, numPlayers, numUnderruns);
+	}
+}
+
+void MyEventHandler::onShutdown()
+{
+	for (unsigned int i = 0; i < NumPlayers; i++)
+		players_[i].reset(nullptr);
+	nc::fs::deleteFile(filename_.data());
+}
+
+void MyEventHandler::onKeyReleased(const nc::KeyboardEvent &event)
+{
+	if (event.sym == nc::KeySym::ESCAPE || event.sym == nc::KeySym::Q)
+		nc::theApplication().quit();
+}
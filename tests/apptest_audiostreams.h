@@ -0,0 +1,40 @@
+#ifndef CLASS_MYEVENTHANDLER
+#define CLASS_MYEVENTHANDLER
+
+#include <ncine/IAppEventHandler.h>
+#include <ncine/IInputEventHandler.h>
+#include <nctl/UniquePtr.h>
+#include <nctl/String.h>
+
+namespace ncine {
+
+class AppConfiguration;
+class AudioStreamPlayer;
+
+}
+
+namespace nc = ncine;
+
+/// My nCine event handler
+class MyEventHandler :
+    public nc::IAppEventHandler,
+    public nc::IInputEventHandler
+{
+  public:
+	static const unsigned int NumPlayers = 8;
+
+	void onPreInit(nc::AppConfiguration &config) override;
+	void onInit() override;
+	void onFrameStart() override;
+	void onShutdown() override;
+
+	void onKeyReleased(const nc::KeyboardEvent &event) override;
+
+  private:
+	unsigned int numFrames_;
+	unsigned int numActions_;
+	nctl::String filename_;
+	nctl::UniquePtr<nc::AudioStreamPlayer> players_[NumPlayers];
+};
+
+#endif
@@ -0,0 +1,424 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <nctl/Array.h>
+#include <nctl/String.h>
+#include <nctl/algorithms.h>
+#include "FntParser.h"
+#include "ITextureLoader.h"
+#include "TextureSaverPng.h"
+#include "FileSystem.h"
+#include "IFile.h"
+
+/// Offline generator of single channel signed distance field font atlases
+/*! It reads an AngelCode's FNT file together with the bitmap atlas it references,
+ *  computes the distance field of every glyph at a higher resolution and packs
+ *  the downscaled results into a new gray PNG atlas with a matching FNT file. */
+
+using namespace ncine;
+
+namespace {
+
+	const unsigned int DefaultDistanceRange = 8;
+	const unsigned int DefaultDownscale = 1;
+	/// Coverage threshold to consider a source pixel inside a glyph
+	const unsigned char InsideThreshold = 128;
+	const float Infinity = 1e20f;
+
+	struct Options
+	{
+		const char *inputFnt = nullptr;
+		const char *outputFnt = nullptr;
+		unsigned int distanceRange = DefaultDistanceRange;
+		unsigned int downscale = DefaultDownscale;
+	};
+
+	/// A glyph distance field waiting to be packed in the output atlas
+	struct DistanceGlyph
+	{
+		unsigned int charIndex = 0;
+		int width = 0;
+		int height = 0;
+		int x = 0;
+		int y = 0;
+		nctl::Array<unsigned char> pixels;
+	};
+
+	void printUsage(const char *executable)
+	{
+		printf("Usage: %s <input.fnt> <output.fnt> [-r <distance range>] [-s <downscale factor>]\n", executable);
+		printf("\t-r\tDistance in output texels covered by the full range of values (default: %u)\n", DefaultDistanceRange);
+		printf("\t-s\tIntegral factor between the source bitmap and the output atlas (default: %u)\n", DefaultDownscale);
+	}
+
+	bool parseOptions(int argc, char **argv, Options &options)
+	{
+		int positional = 0;
+		for (int i = 1; i < argc; i++)
+		{
+			if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+				options.distanceRange = static_cast<unsigned int>(atoi(argv[++i]));
+			else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+				options.downscale = static_cast<unsigned int>(atoi(argv[++i]));
+			else if (positional == 0)
+			{
+				options.inputFnt = argv[i];
+				positional++;
+			}
+			else if (positional == 1)
+			{
+				options.outputFnt = argv[i];
+				positional++;
+			}
+			else
+				return false;
+		}
+
+		return (positional == 2 && options.distanceRange > 0 && options.downscale > 0);
+	}
+
+	/// Returns the index of the channel holding the glyph coverage in a source pixel
+	unsigned int coverageChannel(const FntParser::CommonTag &commonTag, int bpp)
+	{
+		if (bpp == 4)
+		{
+			// Glyphs are stored in the alpha channel unless the FNT file states otherwise
+			const bool glyphInRed = (commonTag.redChnl == FntParser::ChannelData::GLYPH && commonTag.alphaChnl != FntParser::ChannelData::GLYPH);
+			return glyphInRed ? 0 : 3;
+		}
+		else if (bpp == 2)
+			return 1;
+
+		return 0;
+	}
+
+	/// One dimensional squared Euclidean distance transform (Felzenszwalb and Huttenlocher)
+	void distanceTransform1D(const float *f, float *d, int n, int *v, float *z)
+	{
+		int k = 0;
+		v[0] = 0;
+		z[0] = -Infinity;
+		z[1] = Infinity;
+
+		for (int q = 1; q < n; q++)
+		{
+			float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+			while (s <= z[k])
+			{
+				k--;
+				s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+			}
+			k++;
+			v[k] = q;
+			z[k] = s;
+			z[k + 1] = Infinity;
+		}
+
+		k = 0;
+		for (int q = 0; q < n; q++)
+		{
+			while (z[k + 1] < q)
+				k++;
+			const float dist = static_cast<float>(q - v[k]);
+			d[q] = dist * dist + f[v[k]];
+		}
+	}
+
+	/// Two dimensional squared Euclidean distance transform, computed in place
+	void distanceTransform2D(nctl::Array<float> &grid, int width, int height)
+	{
+		const int maxSide = nctl::max(width, height);
+		nctl::Array<float> f(maxSide);
+		nctl::Array<float> d(maxSide);
+		nctl::Array<int> v(maxSide);
+		nctl::Array<float> z(maxSide + 1);
+		f.setSize(maxSide);
+		d.setSize(maxSide);
+		v.setSize(maxSide);
+		z.setSize(maxSide + 1);
+
+		for (int x = 0; x < width; x++)
+		{
+			for (int y = 0; y < height; y++)
+				f[y] = grid[y * width + x];
+			distanceTransform1D(f.data(), d.data(), height, v.data(), z.data());
+			for (int y = 0; y < height; y++)
+				grid[y * width + x] = d[y];
+		}
+
+		for (int y = 0; y < height; y++)
+		{
+			distanceTransform1D(&grid[y * width], d.data(), width, v.data(), z.data());
+			for (int x = 0; x < width; x++)
+				grid[y * width + x] = d[x];
+		}
+	}
+
+	/// Computes the downscaled distance field of a glyph, with a border of `padding` output texels
+	void computeDistanceField(const ITextureLoader &loader, unsigned int channel, const FntParser::CharTag &charTag,
+	                          const Options &options, int padding, DistanceGlyph &glyph)
+	{
+		const int scale = static_cast<int>(options.downscale);
+		const int outWidth = (charTag.width + scale - 1) / scale + padding * 2;
+		const int outHeight = (charTag.height + scale - 1) / scale + padding * 2;
+		const int srcWidth = outWidth * scale;
+		const int srcHeight = outHeight * scale;
+		const int srcPadding = padding * scale;
+
+		const unsigned int numSrcPixels = static_cast<unsigned int>(srcWidth * srcHeight);
+		nctl::Array<float> toInside(numSrcPixels);
+		nctl::Array<float> toOutside(numSrcPixels);
+		nctl::Array<bool> inside(numSrcPixels);
+		toInside.setSize(numSrcPixels);
+		toOutside.setSize(numSrcPixels);
+		inside.setSize(numSrcPixels);
+
+		const GLubyte *srcPixels = loader.pixels();
+		const int bpp = loader.bpp();
+		for (int y = 0; y < srcHeight; y++)
+		{
+			for (int x = 0; x < srcWidth; x++)
+			{
+				const int atlasX = charTag.x + x - srcPadding;
+				const int atlasY = charTag.y + y - srcPadding;
+				// Pixels outside of the glyph rectangle might belong to neighbouring glyphs in the source atlas
+				const bool inGlyphRect = (x >= srcPadding && x < srcPadding + charTag.width && y >= srcPadding && y < srcPadding + charTag.height &&
+				                          atlasX >= 0 && atlasX < loader.width() && atlasY >= 0 && atlasY < loader.height());
+
+				const unsigned int index = static_cast<unsigned int>(y * srcWidth + x);
+				inside[index] = inGlyphRect && srcPixels[(atlasY * loader.width() + atlasX) * bpp + channel] >= InsideThreshold;
+				toInside[index] = inside[index] ? 0.0f : Infinity;
+				toOutside[index] = inside[index] ? Infinity : 0.0f;
+			}
+		}
+
+		distanceTransform2D(toInside, srcWidth, srcHeight);
+		distanceTransform2D(toOutside, srcWidth, srcHeight);
+
+		glyph.width = outWidth;
+		glyph.height = outHeight;
+		glyph.pixels.setSize(static_cast<unsigned int>(outWidth * outHeight));
+		const float range = static_cast<float>(options.distanceRange);
+		for (int oy = 0; oy < outHeight; oy++)
+		{
+			for (int ox = 0; ox < outWidth; ox++)
+			{
+				// Box filtering of the high resolution signed distances, positive inside
+				float distance = 0.0f;
+				for (int sy = oy * scale; sy < (oy + 1) * scale; sy++)
+				{
+					for (int sx = ox * scale; sx < (ox + 1) * scale; sx++)
+					{
+						const unsigned int index = static_cast<unsigned int>(sy * srcWidth + sx);
+						// The edge lies half a pixel away from the center of the nearest pixel of the opposite kind
+						distance += inside[index] ? sqrtf(toOutside[index]) - 0.5f : 0.5f - sqrtf(toInside[index]);
+					}
+				}
+				distance /= static_cast<float>(scale * scale * scale);
+
+				const float value = nctl::clamp(0.5f + distance / range, 0.0f, 1.0f);
+				glyph.pixels[static_cast<unsigned int>(oy * outWidth + ox)] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+			}
+		}
+	}
+
+	bool isTaller(const DistanceGlyph *a, const DistanceGlyph *b)
+	{
+		return a->height > b->height;
+	}
+
+	/// Packs the glyphs in shelves of decreasing height, returns the power of two atlas size
+	Vector2i packGlyphs(nctl::Array<DistanceGlyph> &glyphs, int spacing)
+	{
+		nctl::Array<DistanceGlyph *> sorted(glyphs.size());
+		unsigned long int area = 0;
+		int maxWidth = 0;
+		for (unsigned int i = 0; i < glyphs.size(); i++)
+		{
+			sorted.pushBack(&glyphs[i]);
+			area += static_cast<unsigned long int>((glyphs[i].width + spacing) * (glyphs[i].height + spacing));
+			maxWidth = nctl::max(maxWidth, glyphs[i].width + spacing);
+		}
+		nctl::quicksort(sorted.begin(), sorted.end(), isTaller);
+
+		int atlasWidth = 64;
+		while (static_cast<unsigned long int>(atlasWidth) * atlasWidth < area || atlasWidth < maxWidth)
+			atlasWidth *= 2;
+
+		int shelfX = 0;
+		int shelfY = 0;
+		int shelfHeight = 0;
+		for (unsigned int i = 0; i < sorted.size(); i++)
+		{
+			DistanceGlyph &glyph = *sorted[i];
+			if (shelfX + glyph.width + spacing > atlasWidth)
+			{
+				shelfX = 0;
+				shelfY += shelfHeight;
+				shelfHeight = 0;
+			}
+
+			glyph.x = shelfX;
+			glyph.y = shelfY;
+			shelfX += glyph.width + spacing;
+			shelfHeight = nctl::max(shelfHeight, glyph.height + spacing);
+		}
+
+		int atlasHeight = 64;
+		while (atlasHeight < shelfY + shelfHeight)
+			atlasHeight *= 2;
+
+		return Vector2i(atlasWidth, atlasHeight);
+	}
+
+	int scaleValue(int value, unsigned int downscale)
+	{
+		return static_cast<int>(floorf(static_cast<float>(value) / downscale + 0.5f));
+	}
+
+	/// Writes a formatted line of text to an opened file
+	bool writeLine(IFile &fileHandle, const nctl::String &line)
+	{
+		return (fileHandle.write(const_cast<char *>(line.data()), line.length()) == line.length());
+	}
+
+	bool writeFnt(const char *filename, const FntParser &fntParser, const nctl::Array<DistanceGlyph> &glyphs,
+	              const Options &options, int padding, const Vector2i &atlasSize, const nctl::String &textureFilename)
+	{
+		const FntParser::InfoTag &infoTag = fntParser.infoTag();
+		const FntParser::CommonTag &commonTag = fntParser.commonTag();
+		const unsigned int scale = options.downscale;
+
+		nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+		fileHandle->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
+		if (fileHandle->isOpened() == false)
+			return false;
+
+		bool written = true;
+		nctl::String line(nctl::String::MaxCStringLength);
+		line.format("info face=\"%s\" size=%d bold=%d italic=%d charset=\"%s\" unicode=%d stretchH=%d smooth=1 aa=1 padding=0,0,0,0 spacing=0,0 outline=0\n",
+		            infoTag.face.data(), scaleValue(infoTag.size, scale), infoTag.bold ? 1 : 0, infoTag.italic ? 1 : 0,
+		            infoTag.charset.data(), infoTag.unicode ? 1 : 0, infoTag.stretchH);
+		written &= writeLine(*fileHandle, line);
+		line.format("common lineHeight=%d base=%d scaleW=%d scaleH=%d pages=1 packed=0 alphaChnl=0 redChnl=0 greenChnl=0 blueChnl=0\n",
+		            scaleValue(commonTag.lineHeight, scale), scaleValue(commonTag.base, scale), atlasSize.x, atlasSize.y);
+		written &= writeLine(*fileHandle, line);
+		line.format("distanceField fieldType=sdf distanceRange=%u\n", options.distanceRange);
+		written &= writeLine(*fileHandle, line);
+		line.format("page id=0 file=\"%s\"\n", textureFilename.data());
+		written &= writeLine(*fileHandle, line);
+		line.format("chars count=%u\n", glyphs.size());
+		written &= writeLine(*fileHandle, line);
+
+		for (unsigned int i = 0; i < glyphs.size(); i++)
+		{
+			const DistanceGlyph &glyph = glyphs[i];
+			const FntParser::CharTag &charTag = fntParser.charTag(glyph.charIndex);
+			line.format("char id=%d x=%d y=%d width=%d height=%d xoffset=%d yoffset=%d xadvance=%d page=0 chnl=15\n",
+			            charTag.id, glyph.x, glyph.y, glyph.width, glyph.height, scaleValue(charTag.xoffset, scale) - padding,
+			            scaleValue(charTag.yoffset, scale) - padding, scaleValue(charTag.xadvance, scale));
+			written &= writeLine(*fileHandle, line);
+		}
+
+		if (fntParser.numKerningTags() > 0)
+		{
+			line.format("kernings count=%u\n", fntParser.numKerningTags());
+			written &= writeLine(*fileHandle, line);
+			for (unsigned int i = 0; i < fntParser.numKerningTags(); i++)
+			{
+				const FntParser::KerningTag &kerningTag = fntParser.kerningTag(i);
+				line.format("kerning first=%d second=%d amount=%d\n", kerningTag.first, kerningTag.second, scaleValue(kerningTag.amount, scale));
+				written &= writeLine(*fileHandle, line);
+			}
+		}
+
+		fileHandle->close();
+		return written;
+	}
+
+}
+
+int main(int argc, char **argv)
+{
+	Options options;
+	if (parseOptions(argc, argv, options) == false)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	FntParser fntParser(options.inputFnt);
+	if (fntParser.numPageTags() == 0)
+	{
+		printf("The FNT file \"%s\" does not reference any texture page\n", options.inputFnt);
+		return EXIT_FAILURE;
+	}
+
+	const nctl::String inputDir = fs::dirName(options.inputFnt);
+	const nctl::String inputTexture = fs::joinPath(inputDir, fntParser.pageTag(0).file);
+	nctl::UniquePtr<ITextureLoader> loader = ITextureLoader::createFromFile(inputTexture.data());
+	if (loader->pixels() == nullptr || loader->texFormat().isCompressed())
+	{
+		printf("Cannot read uncompressed pixels from \"%s\"\n", inputTexture.data());
+		return EXIT_FAILURE;
+	}
+
+	// The border must contain the whole range of distances outside of the glyph
+	const int padding = static_cast<int>((options.distanceRange + 1) / 2);
+	const unsigned int channel = coverageChannel(fntParser.commonTag(), loader->bpp());
+
+	nctl::Array<DistanceGlyph> glyphs(fntParser.numCharTags());
+	for (unsigned int i = 0; i < fntParser.numCharTags(); i++)
+	{
+		const FntParser::CharTag &charTag = fntParser.charTag(i);
+		if (charTag.page != 0)
+			continue;
+
+		DistanceGlyph &glyph = glyphs[glyphs.size()];
+		glyph.charIndex = i;
+		computeDistanceField(*loader, channel, charTag, options, padding, glyph);
+	}
+
+	const int spacing = 1;
+	const Vector2i atlasSize = packGlyphs(glyphs, spacing);
+	nctl::Array<unsigned char> atlas(static_cast<unsigned int>(atlasSize.x * atlasSize.y));
+	atlas.setSize(static_cast<unsigned int>(atlasSize.x * atlasSize.y));
+	memset(atlas.data(), 0, atlas.size());
+	for (unsigned int i = 0; i < glyphs.size(); i++)
+	{
+		const DistanceGlyph &glyph = glyphs[i];
+		for (int y = 0; y < glyph.height; y++)
+			memcpy(&atlas[(glyph.y + y) * atlasSize.x + glyph.x], &glyph.pixels[y * glyph.width], glyph.width);
+	}
+
+	const nctl::String outputDir = fs::dirName(options.outputFnt);
+	nctl::String textureFilename = fs::baseName(options.outputFnt);
+	const int extensionPos = textureFilename.findLastChar('.');
+	if (extensionPos > 0)
+		textureFilename.setLength(static_cast<unsigned int>(extensionPos));
+	textureFilename.append(".png");
+
+	ITextureSaver::Properties properties;
+	properties.width = atlasSize.x;
+	properties.height = atlasSize.y;
+	properties.format = ITextureSaver::Format::R8;
+	properties.pixels = atlas.data();
+
+	TextureSaverPng saver;
+	const nctl::String outputTexture = fs::joinPath(outputDir, textureFilename);
+	if (saver.saveToFile(properties, outputTexture.data()) == false)
+	{
+		printf("Cannot write the distance field atlas to \"%s\"\n", outputTexture.data());
+		return EXIT_FAILURE;
+	}
+
+	if (writeFnt(options.outputFnt, fntParser, glyphs, options, padding, atlasSize, textureFilename) == false)
+	{
+		printf("Cannot write the FNT file \"%s\"\n", options.outputFnt);
+		return EXIT_FAILURE;
+	}
+
+	printf("Written %u glyphs in a %dx%d distance field atlas with a range of %u texels\n", glyphs.size(), atlasSize.x, atlasSize.y, options.distanceRange);
+	return EXIT_SUCCESS;
+}
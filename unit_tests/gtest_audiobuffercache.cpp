@@ -0,0 +1,256 @@
+#if defined(__APPLE__)
+	#include <OpenAL/alc.h>
+#else
+	#include <AL/alc.h>
+#endif
+#include <ncine/AudioBufferCache.h>
+#include <ncine/AudioBuffer.h>
+#include <ncine/AudioMixer.h>
+#include <ncine/WavAudioSink.h>
+#include <ncine/FileSystem.h>
+#include <ncine/IFile.h>
+#include <nctl/HashMap.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const int Frequency = 44100;
+const unsigned int SoundFrames = 64;
+const unsigned int ShortFrames = 1000;
+const unsigned int LongFrames = 2000;
+const char *ShortFilename = "gtest_audiobuffercache_short.wav";
+const char *ShortCopyFilename = "gtest_audiobuffercache_short_copy.wav";
+const char *LongFilename = "gtest_audiobuffercache_long.wav";
+const char *CollidingFilename = "gtest_audiobuffercache_colliding.wav";
+
+/// Continues the 32 bit FNV-1a hash used by the cache with the bytes of a value
+template <class T>
+uint32_t fnv1a(uint32_t hash, const T &value)
+{
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+	for (unsigned int i = 0; i < sizeof(T); i++)
+		hash = (bytes[i] ^ hash) * 0x01000193;
+	return hash;
+}
+
+class AudioBufferCacheTest : public ::testing::Test
+{
+  public:
+	AudioBufferCacheTest()
+	    : device_(nullptr), context_(nullptr) {}
+
+  protected:
+	ALCdevice *device_;
+	ALCcontext *context_;
+	nctl::String shortPath_;
+	nctl::String shortCopyPath_;
+	nctl::String longPath_;
+
+	void SetUp() override
+	{
+		device_ = alcOpenDevice(nullptr);
+		ASSERT_TRUE(device_ != nullptr);
+		context_ = alcCreateContext(device_, nullptr);
+		ASSERT_TRUE(context_ != nullptr);
+		alcMakeContextCurrent(context_);
+
+		shortPath_ = nc::fs::joinPath(nc::fs::currentDir(), ShortFilename);
+		shortCopyPath_ = nc::fs::joinPath(nc::fs::currentDir(), ShortCopyFilename);
+		longPath_ = nc::fs::joinPath(nc::fs::currentDir(), LongFilename);
+
+		// The same frames are rendered twice to have two files with the same content
+		writeWavFile(shortPath_.data(), ShortFrames);
+		writeWavFile(shortCopyPath_.data(), ShortFrames);
+		writeWavFile(longPath_.data(), LongFrames);
+	}
+
+	void TearDown() override
+	{
+		nc::fs::deleteFile(shortPath_.data());
+		nc::fs::deleteFile(shortCopyPath_.data());
+		nc::fs::deleteFile(longPath_.data());
+
+		alcMakeContextCurrent(nullptr);
+		alcDestroyContext(context_);
+		alcCloseDevice(device_);
+	}
+
+	static void readFile(const char *filename, nctl::Array<uint8_t> &bytes)
+	{
+		nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(filename);
+		fileHandle->open(nc::IFile::OpenMode::READ | nc::IFile::OpenMode::BINARY);
+		bytes.setSize(fileHandle->size());
+		fileHandle->read(bytes.data(), bytes.size());
+	}
+
+	static void writeFile(const char *filename, const nctl::Array<uint8_t> &bytes, uint64_t suffix)
+	{
+		nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(filename);
+		fileHandle->setExitOnFailToOpen(false);
+		fileHandle->open(nc::IFile::OpenMode::WRITE | nc::IFile::OpenMode::BINARY);
+		fileHandle->write(const_cast<uint8_t *>(bytes.data()), bytes.size());
+		fileHandle->write(&suffix, sizeof(uint64_t));
+	}
+
+	static void writeWavFile(const char *filename, unsigned int numFrames)
+	{
+		static int16_t ramp[SoundFrames];
+		for (unsigned int i = 0; i < SoundFrames; i++)
+			ramp[i] = static_cast<int16_t>(i * 256);
+
+		nc::AudioMixer mixer(Frequency, 1);
+		nc::AudioMixer::Sound sound(ramp, SoundFrames, 1, Frequency);
+		nc::WavAudioSink wavSink(filename, Frequency);
+		mixer.play(sound, 0, 1.0f, 1.0f, 0.0f, true);
+		mixer.render(wavSink, numFrames);
+	}
+};
+
+TEST_F(AudioBufferCacheTest, AcquireSameFileIsHit)
+{
+	nc::AudioBufferCache cache(1024 * 1024);
+	nc::AudioBuffer *first = cache.acquire(shortPath_.data());
+	nc::AudioBuffer *second = cache.acquire(shortPath_.data());
+
+	ASSERT_TRUE(first != nullptr);
+	ASSERT_EQ(first, second);
+	ASSERT_EQ(cache.numMisses(), 1u);
+	ASSERT_EQ(cache.numHits(), 1u);
+	ASSERT_EQ(cache.numBuffers(), 1u);
+	ASSERT_EQ(cache.memoryUsed(), first->bufferSize());
+
+	cache.release(first);
+	cache.release(second);
+}
+
+TEST_F(AudioBufferCacheTest, AcquireSameContentFromDifferentPathIsHit)
+{
+	nc::AudioBufferCache cache(1024 * 1024);
+	nc::AudioBuffer *first = cache.acquire(shortPath_.data());
+	nc::AudioBuffer *second = cache.acquire(shortCopyPath_.data());
+
+	ASSERT_EQ(first, second);
+	ASSERT_EQ(cache.numMisses(), 1u);
+	ASSERT_EQ(cache.numHits(), 1u);
+	ASSERT_EQ(cache.numBuffers(), 1u);
+
+	cache.release(first);
+	cache.release(second);
+}
+
+TEST_F(AudioBufferCacheTest, CollidingHashesDoNotShareBuffer)
+{
+	nctl::Array<uint8_t> bytes;
+	readFile(shortPath_.data(), bytes);
+	uint32_t prefixHash = 0x811C9DC5;
+	for (unsigned int i = 0; i < bytes.size(); i++)
+		prefixHash = fnv1a(prefixHash, bytes[i]);
+
+	// Searching two suffixes that give the same hash, the samples are not changed as bytes after the data chunk are ignored.
+	// The suffixes vary in all of their eight bytes, as the hash of four bytes appended to the same prefix never collides.
+	const unsigned int MaxSuffixes = 1 << 20;
+	const uint64_t SuffixMultiplier = 0x9E3779B97F4A7C15ULL;
+	nctl::HashMap<uint32_t, uint64_t> suffixes(MaxSuffixes * 2);
+	uint64_t firstSuffix = 0;
+	uint64_t secondSuffix = 0;
+	for (unsigned int i = 1; i < MaxSuffixes; i++)
+	{
+		const uint64_t suffix = i * SuffixMultiplier;
+		const uint32_t hash = fnv1a(prefixHash, suffix);
+		if (suffixes.contains(hash, firstSuffix))
+		{
+			secondSuffix = suffix;
+			break;
+		}
+		suffixes.insert(hash, suffix);
+	}
+	ASSERT_TRUE(secondSuffix != 0);
+
+	const nctl::String collidingPath = nc::fs::joinPath(nc::fs::currentDir(), CollidingFilename);
+	writeFile(shortPath_.data(), bytes, firstSuffix);
+	writeFile(collidingPath.data(), bytes, secondSuffix);
+
+	nc::AudioBufferCache cache(1024 * 1024);
+	nc::AudioBuffer *first = cache.acquire(shortPath_.data());
+	nc::AudioBuffer *second = cache.acquire(collidingPath.data());
+
+	ASSERT_TRUE(first != second);
+	ASSERT_EQ(cache.numMisses(), 2u);
+	ASSERT_EQ(cache.numBuffers(), 2u);
+
+	// Both entries are still found from their filenames
+	ASSERT_EQ(cache.acquire(collidingPath.data()), second);
+	ASSERT_EQ(cache.numHits(), 1u);
+
+	cache.release(first);
+	cache.release(second);
+	cache.release(second);
+	nc::fs::deleteFile(collidingPath.data());
+}
+
+TEST_F(AudioBufferCacheTest, AcquireMissingFileFails)
+{
+	nc::AudioBufferCache cache(1024 * 1024);
+	const nctl::String path = nc::fs::joinPath(nc::fs::currentDir(), "NonExistent.wav");
+
+	ASSERT_TRUE(cache.acquire(path.data()) == nullptr);
+	ASSERT_EQ(cache.numBuffers(), 0u);
+}
+
+TEST_F(AudioBufferCacheTest, ReleasedBufferIsKeptWithinBudget)
+{
+	nc::AudioBufferCache cache(1024 * 1024);
+	nc::AudioBuffer *buffer = cache.acquire(shortPath_.data());
+	cache.release(buffer);
+
+	ASSERT_EQ(cache.numBuffers(), 1u);
+	ASSERT_EQ(cache.numEvictions(), 0u);
+
+	// Acquiring it again does not decode the file
+	ASSERT_EQ(cache.acquire(shortPath_.data()), buffer);
+	ASSERT_EQ(cache.numMisses(), 1u);
+	ASSERT_EQ(cache.numHits(), 1u);
+	cache.release(buffer);
+}
+
+TEST_F(AudioBufferCacheTest, ReferencedBufferIsNotEvicted)
+{
+	nc::AudioBufferCache cache(1024 * 1024);
+	nc::AudioBuffer *buffer = cache.acquire(shortPath_.data());
+
+	cache.setMemoryBudget(0);
+	ASSERT_EQ(cache.numBuffers(), 1u);
+	ASSERT_EQ(cache.numEvictions(), 0u);
+
+	cache.release(buffer);
+	ASSERT_EQ(cache.numBuffers(), 0u);
+	ASSERT_EQ(cache.numEvictions(), 1u);
+	ASSERT_EQ(cache.memoryUsed(), 0u);
+}
+
+TEST_F(AudioBufferCacheTest, LeastRecentlyReleasedIsEvictedOverBudget)
+{
+	nc::AudioBufferCache cache(1024 * 1024);
+	nc::AudioBuffer *shortBuffer = cache.acquire(shortPath_.data());
+	nc::AudioBuffer *longBuffer = cache.acquire(longPath_.data());
+	const unsigned long shortSize = shortBuffer->bufferSize();
+	const unsigned long longSize = longBuffer->bufferSize();
+
+	// Only the long buffer fits in the new budget
+	cache.setMemoryBudget(longSize + shortSize / 2);
+	cache.release(shortBuffer);
+	cache.release(longBuffer);
+
+	ASSERT_EQ(cache.numBuffers(), 1u);
+	ASSERT_EQ(cache.numEvictions(), 1u);
+	ASSERT_EQ(cache.memoryUsed(), longSize);
+
+	// The evicted buffer is decoded again
+	shortBuffer = cache.acquire(shortCopyPath_.data());
+	ASSERT_EQ(cache.numMisses(), 3u);
+	cache.release(shortBuffer);
+}
+
+}
@@ -0,0 +1,189 @@
+#include <cmath>
+#include <ncine/AudioMixer.h>
+#include <ncine/IAudioSink.h>
+#include <ncine/WavAudioSink.h>
+#include <ncine/FileSystem.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const int Frequency = 44100;
+const unsigned int MaxVoices = 4;
+const unsigned int SoundFrames = 64;
+const char *WavFilename = "gtest_audiomixer.wav";
+/// The size of the RIFF header written before the samples
+const long int WavHeaderSize = 44;
+
+/// A sink that keeps the first frame it receives
+class FirstFrameSink : public nc::IAudioSink
+{
+  public:
+	FirstFrameSink()
+	    : left(0), right(0), hasFrame(false) {}
+
+	unsigned int numWritableFrames() override { return ~0U; }
+	void write(const int16_t *frames, unsigned int numFrames) override
+	{
+		if (hasFrame == false && numFrames > 0)
+		{
+			left = frames[0];
+			right = frames[1];
+			hasFrame = true;
+		}
+	}
+
+	int16_t left;
+	int16_t right;
+	bool hasFrame;
+};
+
+class AudioMixerTest : public ::testing::Test
+{
+  public:
+	AudioMixerTest()
+	    : mixer_(Frequency, MaxVoices), sound_(samples(), SoundFrames, 1, Frequency) {}
+
+  protected:
+	nc::AudioMixer mixer_;
+	nc::AudioMixer::Sound sound_;
+	nc::NullAudioSink sink_;
+
+	static const int16_t *samples()
+	{
+		static int16_t ramp[SoundFrames];
+		for (unsigned int i = 0; i < SoundFrames; i++)
+			ramp[i] = static_cast<int16_t>(i * 256);
+		return ramp;
+	}
+};
+
+TEST_F(AudioMixerTest, RenderSilenceToNullSink)
+{
+	mixer_.render(sink_, 1000);
+
+	ASSERT_EQ(mixer_.numActiveVoices(), 0u);
+	ASSERT_EQ(sink_.numFramesWritten(), 1000u);
+}
+
+TEST_F(AudioMixerTest, VoiceStopsAtTheEndOfTheSound)
+{
+	const unsigned int voice = mixer_.play(sound_);
+	ASSERT_TRUE(voice != nc::AudioMixer::InvalidVoice);
+	ASSERT_TRUE(mixer_.isPlaying(voice));
+
+	mixer_.render(sink_, SoundFrames / 2);
+	ASSERT_TRUE(mixer_.isPlaying(voice));
+	mixer_.render(sink_, SoundFrames);
+	ASSERT_FALSE(mixer_.isPlaying(voice));
+	ASSERT_EQ(mixer_.numActiveVoices(), 0u);
+	ASSERT_EQ(sink_.numFramesWritten(), SoundFrames / 2 + SoundFrames);
+}
+
+TEST_F(AudioMixerTest, LoopingVoiceKeepsPlaying)
+{
+	const unsigned int voice = mixer_.play(sound_, 0, 1.0f, 1.5f, 0.0f, true);
+	mixer_.render(sink_, SoundFrames * 10);
+
+	ASSERT_TRUE(mixer_.isPlaying(voice));
+	mixer_.stop(voice);
+	ASSERT_FALSE(mixer_.isPlaying(voice));
+}
+
+TEST_F(AudioMixerTest, NegativePitchIsClamped)
+{
+	const unsigned int voice = mixer_.play(sound_, 0, 1.0f, -1.0f, 0.0f, false);
+	ASSERT_TRUE(mixer_.isPlaying(voice));
+
+	// At the minimum pitch the voice still moves forward and eventually ends
+	const unsigned int numFrames = static_cast<unsigned int>(SoundFrames / nc::AudioMixer::MinPitch) + 1;
+	mixer_.render(sink_, numFrames);
+	ASSERT_FALSE(mixer_.isPlaying(voice));
+}
+
+TEST_F(AudioMixerTest, InvalidPitchesAreClamped)
+{
+	const float pitches[] = { 0.0f, NAN, -INFINITY, INFINITY, 1000.0f };
+	for (float pitch : pitches)
+	{
+		const unsigned int voice = mixer_.play(sound_);
+		mixer_.setPitch(voice, pitch);
+
+		const unsigned int numFrames = static_cast<unsigned int>(SoundFrames / nc::AudioMixer::MinPitch) + 1;
+		mixer_.render(sink_, numFrames);
+		ASSERT_FALSE(mixer_.isPlaying(voice));
+	}
+}
+
+TEST_F(AudioMixerTest, OutOfRangePanIsClamped)
+{
+	const float pans[] = { -2.0f, 2.0f };
+	for (float pan : pans)
+	{
+		// The second frame of the ramp is positive, the first one is zero
+		FirstFrameSink sink;
+		const unsigned int voice = mixer_.play(sound_, 0, 1.0f, 1.0f, pan, false);
+		mixer_.render(sink_, 1);
+		mixer_.render(sink, 1);
+		mixer_.stop(voice);
+
+		// A channel is silent at the extremes instead of having its phase inverted
+		ASSERT_TRUE(sink.hasFrame);
+		ASSERT_GE(sink.left, 0);
+		ASSERT_GE(sink.right, 0);
+		ASSERT_GT(sink.left + sink.right, 0);
+	}
+}
+
+TEST_F(AudioMixerTest, HandlesWorkAfterGenerationWrapsAround)
+{
+	// Every play reuses the first voice and increments its generation past the bits of the handle
+	const unsigned int numPlays = 70000;
+	unsigned int voice = nc::AudioMixer::InvalidVoice;
+	for (unsigned int i = 0; i < numPlays; i++)
+	{
+		voice = mixer_.play(sound_);
+		ASSERT_TRUE(mixer_.isPlaying(voice));
+		mixer_.stop(voice);
+		ASSERT_FALSE(mixer_.isPlaying(voice));
+	}
+
+	voice = mixer_.play(sound_, 0, 1.0f, 1.0f, 0.0f, true);
+	ASSERT_TRUE(mixer_.isPlaying(voice));
+	mixer_.stop(voice);
+	ASSERT_FALSE(mixer_.isPlaying(voice));
+	ASSERT_EQ(mixer_.numActiveVoices(), 0u);
+}
+
+TEST_F(AudioMixerTest, RenderToWavSink)
+{
+	const unsigned int numFrames = 1000;
+	const nctl::String path = nc::fs::joinPath(nc::fs::currentDir(), WavFilename);
+	{
+		nc::WavAudioSink wavSink(path.data(), Frequency);
+		ASSERT_TRUE(wavSink.isOpened());
+
+		mixer_.play(sound_, 0, 1.0f, 0.5f, -0.5f, true);
+		mixer_.render(wavSink, numFrames);
+		ASSERT_EQ(wavSink.numFramesWritten(), numFrames);
+	}
+
+	// The header is finalized when the sink is destroyed
+	ASSERT_TRUE(nc::fs::isFile(path.data()));
+	ASSERT_EQ(nc::fs::fileSize(path.data()), WavHeaderSize + numFrames * 2 * sizeof(int16_t));
+	nc::fs::deleteFile(path.data());
+}
+
+TEST_F(AudioMixerTest, WavSinkFailsToOpenWithoutExiting)
+{
+	const nctl::String path = nc::fs::joinPath(nc::fs::joinPath(nc::fs::currentDir(), "NonExistentDir"), WavFilename);
+	nc::WavAudioSink wavSink(path.data(), Frequency);
+	ASSERT_FALSE(wavSink.isOpened());
+
+	mixer_.play(sound_);
+	mixer_.render(wavSink, SoundFrames);
+	ASSERT_EQ(wavSink.numFramesWritten(), 0u);
+}
+
+}
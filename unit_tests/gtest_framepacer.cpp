@@ -0,0 +1,146 @@
+#include <ncine/FramePacer.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const uint32_t Frequency = 1000000; // microseconds
+const unsigned int TargetFps = 50;
+const uint64_t FrameTicks = Frequency / TargetFps;
+const unsigned int NumFrames = 100;
+
+/// A clock that only advances when the pacer sleeps or reads the time
+class FakeClock : public nc::IPacingClock
+{
+  public:
+	FakeClock()
+	    : now_(0), sleepOvershoot_(0), numSleeps_(0) {}
+
+	uint64_t now() const override
+	{
+		// Every reading takes a tick, so spinning always ends
+		return now_++;
+	}
+	uint32_t frequency() const override { return Frequency; }
+	void sleep(uint64_t ticks) override
+	{
+		numSleeps_++;
+		now_ += ticks + sleepOvershoot_;
+	}
+
+	inline void advance(uint64_t ticks) { now_ += ticks; }
+	inline uint64_t time() const { return now_; }
+	inline void setSleepOvershoot(uint64_t ticks) { sleepOvershoot_ = ticks; }
+	inline unsigned int numSleeps() const { return numSleeps_; }
+
+  private:
+	mutable uint64_t now_;
+	uint64_t sleepOvershoot_;
+	unsigned int numSleeps_;
+};
+
+class FramePacerTest : public ::testing::Test
+{
+  public:
+	FramePacerTest()
+	    : pacer_(clock_) {}
+
+  protected:
+	void SetUp() override { pacer_.setTargetFps(TargetFps); }
+
+	FakeClock clock_;
+	nc::FramePacer pacer_;
+};
+
+TEST_F(FramePacerTest, NoWaitingWithoutTarget)
+{
+	pacer_.setTargetFps(0);
+	const uint64_t startTime = clock_.time();
+	for (unsigned int i = 0; i < NumFrames; i++)
+		pacer_.wait();
+
+	ASSERT_EQ(clock_.time(), startTime);
+	ASSERT_EQ(clock_.numSleeps(), 0u);
+}
+
+TEST_F(FramePacerTest, FramesEndOnDeadlines)
+{
+	const uint64_t workTicks = FrameTicks / 4;
+	printf("Pacing %u frames at %u FPS with %llu ticks of work each\n", NumFrames, TargetFps, static_cast<unsigned long long>(workTicks));
+
+	pacer_.wait();
+	const uint64_t firstDeadline = clock_.time() - 1 + FrameTicks;
+	for (unsigned int i = 0; i < NumFrames; i++)
+	{
+		clock_.advance(workTicks);
+		pacer_.wait();
+
+		// The spin loop reads the clock one last time when the deadline is reached
+		const uint64_t deadline = firstDeadline + i * FrameTicks;
+		ASSERT_GE(clock_.time(), deadline);
+		ASSERT_LE(clock_.time(), deadline + 2);
+	}
+
+	ASSERT_EQ(pacer_.numMissedDeadlines(), 0u);
+	ASSERT_GE(clock_.numSleeps(), NumFrames);
+}
+
+TEST_F(FramePacerTest, SpinningIsShort)
+{
+	pacer_.wait();
+	for (unsigned int i = 0; i < NumFrames; i++)
+	{
+		clock_.advance(FrameTicks / 2);
+		pacer_.wait();
+
+		printf("Frame %u: slept for %.3fms, spun for %.3fms\n", i, pacer_.lastSleepTime() * 1000.0f, pacer_.lastSpinTime() * 1000.0f);
+		ASSERT_GT(pacer_.lastSleepTime(), 0.0f);
+		ASSERT_LT(pacer_.lastSpinTime(), pacer_.sleepOvershoot() + 0.001f);
+	}
+}
+
+TEST_F(FramePacerTest, SleepOvershootIsLearned)
+{
+	const uint64_t overshootTicks = 3000;
+	clock_.setSleepOvershoot(overshootTicks);
+
+	pacer_.wait();
+	for (unsigned int i = 0; i < NumFrames; i++)
+	{
+		clock_.advance(FrameTicks / 4);
+		pacer_.wait();
+	}
+
+	printf("Estimated sleep overshoot: %.3fms\n", pacer_.sleepOvershoot() * 1000.0f);
+	ASSERT_GE(pacer_.sleepOvershoot(), overshootTicks / static_cast<float>(Frequency));
+	ASSERT_LT(pacer_.lastSpinTime(), (overshootTicks + FrameTicks / 10) / static_cast<float>(Frequency));
+}
+
+TEST_F(FramePacerTest, LongFrameDoesNotCauseBurst)
+{
+	pacer_.wait();
+	clock_.advance(FrameTicks * 5);
+	pacer_.wait();
+	ASSERT_EQ(pacer_.numMissedDeadlines(), 1u);
+
+	// The next frame gets a whole frame duration instead of catching up
+	const uint64_t startTime = clock_.time();
+	pacer_.wait();
+	ASSERT_GE(clock_.time() - startTime, FrameTicks - 2);
+	ASSERT_EQ(pacer_.numMissedDeadlines(), 1u);
+}
+
+TEST_F(FramePacerTest, ResetDiscardsDeadline)
+{
+	pacer_.wait();
+	clock_.advance(FrameTicks * 10);
+	pacer_.reset();
+
+	const uint64_t startTime = clock_.time();
+	pacer_.wait();
+	ASSERT_LE(clock_.time() - startTime, 1u);
+	ASSERT_EQ(pacer_.numMissedDeadlines(), 0u);
+}
+
+}
@@ -0,0 +1,130 @@
+#include <cstdio>
+#include <cstring>
+#include <ncine/FrameProfiler.h>
+#include <ncine/FileSystem.h>
+#include <nctl/String.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const char *TraceFilename = "gtest_frameprofiler.json";
+const unsigned int NumFrames = 10;
+
+/// Reads the whole exported trace in a string
+nctl::String readTrace()
+{
+	nctl::String trace(2 * 1024 * 1024);
+	FILE *file = fopen(TraceFilename, "rb");
+	if (file != nullptr)
+	{
+		const size_t length = fread(trace.data(), 1, trace.capacity() - 1, file);
+		trace.data()[length] = '\0';
+		trace.setLength(static_cast<unsigned int>(length));
+		fclose(file);
+	}
+	return trace;
+}
+
+unsigned int countOccurrences(const nctl::String &trace, const char *substring)
+{
+	unsigned int count = 0;
+	for (const char *found = strstr(trace.data(), substring); found != nullptr; found = strstr(found + 1, substring))
+		count++;
+	return count;
+}
+
+class FrameProfilerTest : public ::testing::Test
+{
+  protected:
+	void SetUp() override { nc::FrameProfiler::setEnabled(true); }
+	void TearDown() override { nc::fs::deleteFile(TraceFilename); }
+};
+
+TEST_F(FrameProfilerTest, ExportValidTrace)
+{
+	nc::FrameProfiler::markFrame();
+	ASSERT_TRUE(nc::FrameProfiler::exportChromeTrace(TraceFilename));
+
+	const nctl::String trace = readTrace();
+	printf("Exported trace length: %u\n", trace.length());
+	ASSERT_EQ(strncmp(trace.data(), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 39), 0);
+	ASSERT_EQ(strcmp(trace.data() + trace.length() - 4, "\n]}\n"), 0);
+}
+
+TEST_F(FrameProfilerTest, NestedZonesAreExported)
+{
+	nc::FrameProfiler::setThreadName("Test \"thread\"");
+	nc::FrameProfiler::markFrame();
+	for (unsigned int i = 0; i < NumFrames; i++)
+	{
+		{
+			nc::FrameProfiler::ScopedZone outerZone("NestedOuter");
+			nc::FrameProfiler::ScopedZone innerZone("NestedInner");
+		}
+		nc::FrameProfiler::markFrame();
+	}
+	ASSERT_TRUE(nc::FrameProfiler::exportChromeTrace(TraceFilename));
+
+	const nctl::String trace = readTrace();
+	ASSERT_EQ(countOccurrences(trace, "\"NestedOuter\""), NumFrames);
+	ASSERT_EQ(countOccurrences(trace, "\"NestedInner\""), NumFrames);
+	ASSERT_EQ(countOccurrences(trace, "\"Test \\\"thread\\\"\""), 1u);
+	ASSERT_GE(nc::FrameProfiler::numThreads(), 1u);
+}
+
+TEST_F(FrameProfilerTest, DisabledProfilerRecordsNothing)
+{
+	nc::FrameProfiler::setEnabled(false);
+	nc::FrameProfiler::markFrame();
+	for (unsigned int i = 0; i < NumFrames; i++)
+	{
+		nc::FrameProfiler::ScopedZone zone("DisabledZone");
+		nc::FrameProfiler::markFrame();
+	}
+	ASSERT_TRUE(nc::FrameProfiler::exportChromeTrace(TraceFilename));
+
+	const nctl::String trace = readTrace();
+	ASSERT_EQ(countOccurrences(trace, "\"DisabledZone\""), 0u);
+}
+
+TEST_F(FrameProfilerTest, OnlyLastFramesAreExported)
+{
+	for (unsigned int i = 0; i < nc::FrameProfiler::MaxFrames; i++)
+	{
+		nc::FrameProfiler::ScopedZone zone("OldFrameZone");
+		nc::FrameProfiler::markFrame();
+	}
+	for (unsigned int i = 0; i < nc::FrameProfiler::MaxFrames; i++)
+	{
+		nc::FrameProfiler::ScopedZone zone("NewFrameZone");
+		nc::FrameProfiler::markFrame();
+	}
+	ASSERT_TRUE(nc::FrameProfiler::exportChromeTrace(TraceFilename));
+
+	const nctl::String trace = readTrace();
+	ASSERT_EQ(countOccurrences(trace, "\"OldFrameZone\""), 0u);
+	// Zones are closed after the frame mark, the first one ends inside the exported time range
+	ASSERT_EQ(countOccurrences(trace, "\"NewFrameZone\""), nc::FrameProfiler::MaxFrames);
+	// The first exported mark is only the start of the following frame
+	nctl::String frameEvent(64);
+	frameEvent.format("\"ph\":\"X\",\"pid\":0,\"tid\":%u,", nc::FrameProfiler::MaxThreads);
+	ASSERT_EQ(countOccurrences(trace, frameEvent.data()), nc::FrameProfiler::MaxFrames - 1);
+}
+
+TEST_F(FrameProfilerTest, RingBufferKeepsLastZones)
+{
+	nc::FrameProfiler::markFrame();
+	for (unsigned int i = 0; i < nc::FrameProfiler::MaxZonesPerThread; i++)
+		nc::FrameProfiler::ScopedZone zone("OverwrittenZone");
+	for (unsigned int i = 0; i < nc::FrameProfiler::MaxZonesPerThread; i++)
+		nc::FrameProfiler::ScopedZone zone("RingZone");
+	ASSERT_TRUE(nc::FrameProfiler::exportChromeTrace(TraceFilename));
+
+	const nctl::String trace = readTrace();
+	ASSERT_EQ(countOccurrences(trace, "\"OverwrittenZone\""), 0u);
+	ASSERT_EQ(countOccurrences(trace, "\"RingZone\""), nc::FrameProfiler::MaxZonesPerThread);
+}
+
+}
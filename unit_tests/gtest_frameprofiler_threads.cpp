@@ -0,0 +1,47 @@
+#include <ncine/FrameProfiler.h>
+#include "gtest/gtest.h"
+#include "test_thread_functions.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int NumThreads = 32;
+/// More threads than slots are run in total, the slots of the exited ones should be reused
+const unsigned int NumRounds = 2 * nc::FrameProfiler::MaxThreads / NumThreads + 1;
+const unsigned int NumZones = 100;
+
+class FrameProfilerThreadsTest : public ::testing::Test
+{
+  public:
+	FrameProfilerThreadsTest()
+	    : tr_(this) {}
+
+	ThreadRunner<NumThreads> tr_;
+
+  protected:
+	void SetUp() override { nc::FrameProfiler::setEnabled(true); }
+};
+
+TEST_F(FrameProfilerThreadsTest, BuffersAreReleasedWhenThreadsExit)
+{
+	const unsigned int numThreads = nc::FrameProfiler::numThreads();
+	const unsigned int numDroppedZones = nc::FrameProfiler::numDroppedZones();
+
+	for (unsigned int i = 0; i < NumRounds; i++)
+	{
+		tr_.runThreads([](void *arg) -> ThreadRunner<NumThreads>::threadFuncRet {
+			nc::FrameProfiler::setThreadName("Worker");
+			for (unsigned int j = 0; j < NumZones; j++)
+				nc::FrameProfiler::ScopedZone zone("WorkerZone");
+			return static_cast<FrameProfilerThreadsTest *>(arg)->tr_.retFunc();
+		});
+
+		printf("Round %u, recording threads: %u\n", i, nc::FrameProfiler::numThreads());
+		ASSERT_EQ(nc::FrameProfiler::numThreads(), numThreads);
+	}
+
+	ASSERT_EQ(nc::FrameProfiler::numDroppedZones(), numDroppedZones);
+}
+
+}
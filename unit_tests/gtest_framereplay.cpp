@@ -0,0 +1,195 @@
+#include <ncine/FrameReplay.h>
+#include <ncine/IFile.h>
+#include <ncine/FileSystem.h>
+#include <nctl/Array.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const char *ReplayFilename = "gtest_framereplay.bin";
+const uint64_t InitState = 0x1234;
+const uint64_t InitSequence = 0x5678;
+const float FirstInterval = 1.0f / 60.0f;
+const float SecondInterval = 1.0f / 30.0f;
+/// The size of the magic, the version and the two random seeds
+const unsigned int HeaderSize = 24;
+
+/// An application handler that counts the received events
+class CountingHandler : public nc::IInputEventHandler
+{
+  public:
+	CountingHandler()
+	    : numKeyPressed(0), numKeyReleased(0), numScrolls(0), lastSym(nc::KeySym::UNKNOWN), lastScrollY(0.0f) {}
+
+	void onKeyPressed(const nc::KeyboardEvent &event) override
+	{
+		numKeyPressed++;
+		lastSym = event.sym;
+	}
+	void onKeyReleased(const nc::KeyboardEvent &event) override
+	{
+		numKeyReleased++;
+		lastSym = event.sym;
+	}
+	void onScrollInput(const nc::ScrollEvent &event) override
+	{
+		numScrolls++;
+		lastScrollY = event.y;
+	}
+
+	unsigned int numKeyPressed;
+	unsigned int numKeyReleased;
+	unsigned int numScrolls;
+	nc::KeySym lastSym;
+	float lastScrollY;
+};
+
+class FrameReplayTest : public ::testing::Test
+{
+  protected:
+	nctl::String path_;
+
+	void SetUp() override
+	{
+		path_ = nc::fs::joinPath(nc::fs::currentDir(), ReplayFilename);
+		recordTwoFrames();
+	}
+
+	void TearDown() override
+	{
+		nc::fs::deleteFile(path_.data());
+	}
+
+	/// Records a frame with a key press and a frame with a scroll and a key release
+	void recordTwoFrames()
+	{
+		CountingHandler handler;
+		nc::FrameReplay replay(nc::FrameReplay::Mode::RECORD, path_.data(), &handler);
+		ASSERT_TRUE(replay.isValid());
+		ASSERT_EQ(nc::IInputManager::handler(), &replay);
+		replay.recordRandomSeeds(InitState, InitSequence);
+
+		nc::KeyboardEvent keyEvent;
+		keyEvent.sym = nc::KeySym::A;
+		replay.onKeyPressed(keyEvent);
+		replay.recordFrame(FirstInterval);
+
+		nc::ScrollEvent scrollEvent;
+		scrollEvent.x = 0.0f;
+		scrollEvent.y = 2.0f;
+		replay.onScrollInput(scrollEvent);
+		replay.onKeyReleased(keyEvent);
+		replay.recordFrame(SecondInterval);
+
+		// Events are forwarded while being recorded
+		ASSERT_EQ(handler.numKeyPressed, 1u);
+		ASSERT_EQ(handler.numKeyReleased, 1u);
+		ASSERT_EQ(handler.numScrolls, 1u);
+		ASSERT_EQ(replay.numFrames(), 2u);
+	}
+
+	void readFile(nctl::Array<uint8_t> &bytes)
+	{
+		nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(path_.data());
+		fileHandle->open(nc::IFile::OpenMode::READ | nc::IFile::OpenMode::BINARY);
+		bytes.setSize(fileHandle->size());
+		fileHandle->read(bytes.data(), bytes.size());
+	}
+
+	void writeFile(const nctl::Array<uint8_t> &bytes)
+	{
+		nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(path_.data());
+		fileHandle->setExitOnFailToOpen(false);
+		fileHandle->open(nc::IFile::OpenMode::WRITE | nc::IFile::OpenMode::BINARY);
+		fileHandle->write(const_cast<uint8_t *>(bytes.data()), bytes.size());
+	}
+};
+
+TEST_F(FrameReplayTest, PlaybackRecordedFrames)
+{
+	CountingHandler handler;
+	nc::FrameReplay replay(nc::FrameReplay::Mode::PLAYBACK, path_.data(), &handler);
+	ASSERT_TRUE(replay.isPlaying());
+	ASSERT_EQ(replay.randomInitState(), InitState);
+	ASSERT_EQ(replay.randomInitSequence(), InitSequence);
+
+	ASSERT_TRUE(replay.playFrame());
+	ASSERT_FLOAT_EQ(replay.interval(), FirstInterval);
+	ASSERT_EQ(handler.numKeyPressed, 1u);
+	ASSERT_EQ(handler.numKeyReleased, 0u);
+	ASSERT_EQ(handler.lastSym, nc::KeySym::A);
+
+	ASSERT_TRUE(replay.playFrame());
+	ASSERT_FLOAT_EQ(replay.interval(), SecondInterval);
+	ASSERT_EQ(handler.numKeyReleased, 1u);
+	ASSERT_EQ(handler.numScrolls, 1u);
+	ASSERT_FLOAT_EQ(handler.lastScrollY, 2.0f);
+
+	ASSERT_FALSE(replay.playFrame());
+	ASSERT_EQ(replay.numFrames(), 2u);
+}
+
+TEST_F(FrameReplayTest, DeviceEventsAreDiscardedDuringPlayback)
+{
+	CountingHandler handler;
+	nc::FrameReplay replay(nc::FrameReplay::Mode::PLAYBACK, path_.data(), &handler);
+
+	nc::KeyboardEvent keyEvent;
+	replay.onKeyPressed(keyEvent);
+	ASSERT_EQ(handler.numKeyPressed, 0u);
+}
+
+TEST_F(FrameReplayTest, TruncatedFileStopsPlayback)
+{
+	nctl::Array<uint8_t> bytes;
+	readFile(bytes);
+	bytes.setSize(bytes.size() - 1);
+	writeFile(bytes);
+
+	CountingHandler handler;
+	nc::FrameReplay replay(nc::FrameReplay::Mode::PLAYBACK, path_.data(), &handler);
+	ASSERT_TRUE(replay.playFrame());
+	ASSERT_EQ(handler.numKeyPressed, 1u);
+
+	// The events of the truncated frame are not dispatched
+	ASSERT_FALSE(replay.playFrame());
+	ASSERT_FALSE(replay.isValid());
+	ASSERT_EQ(handler.numScrolls, 0u);
+	ASSERT_EQ(handler.numKeyReleased, 0u);
+	ASSERT_EQ(replay.numFrames(), 1u);
+}
+
+TEST_F(FrameReplayTest, UnknownEventStopsPlayback)
+{
+	nctl::Array<uint8_t> bytes;
+	readFile(bytes);
+	// The type of the first event follows the interval and the size of the first frame
+	bytes[HeaderSize + sizeof(float) + sizeof(uint32_t)] = 0xFF;
+	writeFile(bytes);
+
+	CountingHandler handler;
+	nc::FrameReplay replay(nc::FrameReplay::Mode::PLAYBACK, path_.data(), &handler);
+	replay.playFrame();
+	ASSERT_FALSE(replay.isValid());
+	ASSERT_FALSE(replay.playFrame());
+	ASSERT_EQ(handler.numKeyPressed, 0u);
+	ASSERT_EQ(handler.numScrolls, 0u);
+}
+
+TEST_F(FrameReplayTest, FileWithoutMagicIsNotPlayedBack)
+{
+	nctl::Array<uint8_t> bytes;
+	readFile(bytes);
+	bytes[0] = 'X';
+	writeFile(bytes);
+
+	CountingHandler handler;
+	nc::FrameReplay replay(nc::FrameReplay::Mode::PLAYBACK, path_.data(), &handler);
+	ASSERT_FALSE(replay.isValid());
+	ASSERT_FALSE(replay.playFrame());
+	ASSERT_EQ(nc::IInputManager::handler(), &handler);
+}
+
+}
@@ -103,6 +103,25 @@ TEST_F(HashMapStringTest, RemoveElements)
 	ASSERT_FALSE(strHashmap_.contains(Keys[3], value));
 }
 
+TEST_F(HashMapStringTest, RemoveLongKeyFromIterator)
+{
+	printf("Removing an element with a key longer than the small buffer of a string\n");
+	const char *longKey = "a_key_longer_than_sixteen_characters";
+	strHashmap_.insert(longKey, "LONG");
+
+	nctl::String key(64);
+	for (nctl::StringHashMap<nctl::String>::ConstIterator i = strHashmap_.begin(); i != strHashmap_.end(); ++i)
+	{
+		if (i.value() == "LONG")
+			key = i.key();
+	}
+	ASSERT_STREQ(key.data(), longKey);
+
+	ASSERT_TRUE(strHashmap_.remove(key));
+	ASSERT_EQ(strHashmap_.size(), Size);
+	ASSERT_EQ(calcSize(strHashmap_), Size);
+}
+
 TEST_F(HashMapStringTest, CopyConstruction)
 {
 	printf("Creating a new hashmap with copy construction\n");
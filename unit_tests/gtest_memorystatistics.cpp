@@ -0,0 +1,102 @@
+#include <ncine/MemoryStatistics.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+/// A tag that is not used by the allocations of the test itself
+const nc::MemoryStatistics::Tags::Enum TestTag = nc::MemoryStatistics::Tags::FONTS;
+const size_t Bytes = 1024;
+
+TEST(MemoryStatisticsTest, AccountAllocations)
+{
+	const nc::MemoryStatistics::TagStatistics before = nc::MemoryStatistics::statistics(TestTag);
+	nc::MemoryStatistics::addAllocation(TestTag, Bytes);
+	nc::MemoryStatistics::addAllocation(TestTag, Bytes);
+	const nc::MemoryStatistics::TagStatistics after = nc::MemoryStatistics::statistics(TestTag);
+	printf("Current bytes: %lld, peak bytes: %lld\n", static_cast<long long>(after.currentBytes), static_cast<long long>(after.peakBytes));
+
+	ASSERT_EQ(after.currentBytes - before.currentBytes, static_cast<int64_t>(2 * Bytes));
+	ASSERT_EQ(after.allocations - before.allocations, 2);
+	ASSERT_GE(after.peakBytes, after.currentBytes);
+
+	nc::MemoryStatistics::addDeallocation(TestTag, Bytes);
+	nc::MemoryStatistics::addDeallocation(TestTag, Bytes);
+	ASSERT_EQ(nc::MemoryStatistics::statistics(TestTag).currentBytes, before.currentBytes);
+}
+
+TEST(MemoryStatisticsTest, PeakIsPreserved)
+{
+	nc::MemoryStatistics::addAllocation(TestTag, 4 * Bytes);
+	const int64_t peakBytes = nc::MemoryStatistics::statistics(TestTag).peakBytes;
+	nc::MemoryStatistics::addDeallocation(TestTag, 4 * Bytes);
+	nc::MemoryStatistics::addAllocation(TestTag, Bytes);
+	const nc::MemoryStatistics::TagStatistics stats = nc::MemoryStatistics::statistics(TestTag);
+	printf("Peak bytes: %lld\n", static_cast<long long>(stats.peakBytes));
+
+	ASSERT_EQ(stats.peakBytes, peakBytes);
+	nc::MemoryStatistics::addDeallocation(TestTag, Bytes);
+}
+
+TEST(MemoryStatisticsTest, FrameCounters)
+{
+	nc::MemoryStatistics::markFrame();
+	nc::MemoryStatistics::addAllocation(TestTag, Bytes);
+	nc::MemoryStatistics::addAllocation(TestTag, Bytes);
+	nc::MemoryStatistics::addDeallocation(TestTag, Bytes);
+	nc::MemoryStatistics::markFrame();
+	const nc::MemoryStatistics::TagStatistics stats = nc::MemoryStatistics::statistics(TestTag);
+	printf("Frame allocations: %u, frame deallocations: %u\n", stats.frameAllocations, stats.frameDeallocations);
+
+	ASSERT_EQ(stats.frameAllocations, 2u);
+	ASSERT_EQ(stats.frameDeallocations, 1u);
+
+	nc::MemoryStatistics::addDeallocation(TestTag, Bytes);
+	nc::MemoryStatistics::markFrame();
+	nc::MemoryStatistics::markFrame();
+	ASSERT_EQ(nc::MemoryStatistics::statistics(TestTag).frameAllocations, 0u);
+}
+
+TEST(MemoryStatisticsTest, AllStatisticsIncludeEveryTag)
+{
+	nc::MemoryStatistics::addAllocation(TestTag, Bytes);
+	const nc::MemoryStatistics::TagStatistics allStats = nc::MemoryStatistics::allStatistics();
+	const nc::MemoryStatistics::TagStatistics stats = nc::MemoryStatistics::statistics(TestTag);
+
+	ASSERT_GE(allStats.currentBytes, stats.currentBytes);
+	ASSERT_GE(allStats.allocations, stats.allocations);
+	nc::MemoryStatistics::addDeallocation(TestTag, Bytes);
+}
+
+TEST(MemoryStatisticsTest, ScopedTagsAreRestored)
+{
+	ASSERT_EQ(nc::MemoryStatistics::currentTag(), nc::MemoryStatistics::Tags::UNTAGGED);
+	{
+		nc::MemoryStatistics::ScopedTag tag(nc::MemoryStatistics::Tags::AUDIO);
+		ASSERT_EQ(nc::MemoryStatistics::currentTag(), nc::MemoryStatistics::Tags::AUDIO);
+		{
+			nc::MemoryStatistics::ScopedContainerTag containerTag;
+			ASSERT_EQ(nc::MemoryStatistics::currentTag(), nc::MemoryStatistics::Tags::AUDIO);
+		}
+	}
+	ASSERT_EQ(nc::MemoryStatistics::currentTag(), nc::MemoryStatistics::Tags::UNTAGGED);
+}
+
+TEST(MemoryStatisticsTest, ContainerTagWhenUntagged)
+{
+	{
+		nc::MemoryStatistics::ScopedContainerTag containerTag;
+		ASSERT_EQ(nc::MemoryStatistics::currentTag(), nc::MemoryStatistics::Tags::CONTAINERS);
+	}
+	ASSERT_EQ(nc::MemoryStatistics::currentTag(), nc::MemoryStatistics::Tags::UNTAGGED);
+}
+
+TEST(MemoryStatisticsTest, TagNames)
+{
+	ASSERT_STREQ(nc::MemoryStatistics::tagName(nc::MemoryStatistics::Tags::SCENEGRAPH), "scenegraph");
+	ASSERT_STREQ(nc::MemoryStatistics::tagName(nc::MemoryStatistics::Tags::CONTAINERS), "containers");
+	ASSERT_STREQ(nc::MemoryStatistics::tagName(nc::MemoryStatistics::Tags::COUNT), "unknown");
+}
+
+}
@@ -0,0 +1,127 @@
+#include <ncine/SceneNode.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const float Interval = 1.0f / 60.0f;
+
+class SceneNodeTest : public ::testing::Test
+{
+  public:
+	SceneNodeTest()
+	    : recordingNode_(nullptr), child_(nullptr), grandchild_(nullptr), sibling_(nullptr) {}
+
+  protected:
+	void SetUp() override
+	{
+		recordingNode_ = new nc::SceneNode(&root_);
+		child_ = new nc::SceneNode(recordingNode_, 10.0f, 10.0f);
+		grandchild_ = new nc::SceneNode(child_, 5.0f, 5.0f);
+		sibling_ = new nc::SceneNode(&root_, 20.0f, 20.0f);
+
+		// Computing the transformations once, then starting with a clean recording
+		recordingNode_->setRecordCommands(true);
+		root_.update(Interval);
+		recordingNode_->setRecordCommands(false);
+		recordingNode_->setRecordCommands(true);
+	}
+
+	nc::SceneNode root_;
+	nc::SceneNode *recordingNode_;
+	nc::SceneNode *child_;
+	nc::SceneNode *grandchild_;
+	nc::SceneNode *sibling_;
+};
+
+TEST_F(SceneNodeTest, StaticSubtreeIsNotInvalidated)
+{
+	for (unsigned int i = 0; i < 10; i++)
+		root_.update(Interval);
+
+	ASSERT_TRUE(recordingNode_->recordsCommands());
+	ASSERT_FALSE(recordingNode_->recordedCommandsAreDirty());
+}
+
+TEST_F(SceneNodeTest, MovingChildInvalidatesRecording)
+{
+	child_->move(1.0f, 0.0f);
+	ASSERT_FALSE(recordingNode_->recordedCommandsAreDirty());
+
+	// The change is detected when the new transformation is calculated
+	root_.update(Interval);
+	ASSERT_TRUE(recordingNode_->recordedCommandsAreDirty());
+}
+
+TEST_F(SceneNodeTest, MovingGrandchildInvalidatesRecording)
+{
+	grandchild_->x += 1.0f;
+	root_.update(Interval);
+	ASSERT_TRUE(recordingNode_->recordedCommandsAreDirty());
+}
+
+TEST_F(SceneNodeTest, RotatingAndScalingChildInvalidatesRecording)
+{
+	child_->setRotation(45.0f);
+	root_.update(Interval);
+	ASSERT_TRUE(recordingNode_->recordedCommandsAreDirty());
+
+	recordingNode_->setRecordCommands(false);
+	recordingNode_->setRecordCommands(true);
+	child_->setScale(2.0f);
+	root_.update(Interval);
+	ASSERT_TRUE(recordingNode_->recordedCommandsAreDirty());
+}
+
+TEST_F(SceneNodeTest, ChangingChildColorInvalidatesRecording)
+{
+	grandchild_->setAlpha(128);
+	root_.update(Interval);
+	ASSERT_TRUE(recordingNode_->recordedCommandsAreDirty());
+}
+
+TEST_F(SceneNodeTest, DisablingChildDrawingInvalidatesRecording)
+{
+	child_->setDrawEnabled(true);
+	ASSERT_FALSE(recordingNode_->recordedCommandsAreDirty());
+
+	child_->setDrawEnabled(false);
+	ASSERT_TRUE(recordingNode_->recordedCommandsAreDirty());
+}
+
+TEST_F(SceneNodeTest, AddingChildInvalidatesRecording)
+{
+	new nc::SceneNode(child_);
+	ASSERT_TRUE(recordingNode_->recordedCommandsAreDirty());
+}
+
+TEST_F(SceneNodeTest, MovingNodeOutsideSubtreeDoesNotInvalidateRecording)
+{
+	sibling_->move(1.0f, 1.0f);
+	root_.update(Interval);
+	ASSERT_FALSE(recordingNode_->recordedCommandsAreDirty());
+}
+
+TEST_F(SceneNodeTest, RecordingRootNodeIsInvalidated)
+{
+	root_.setRecordCommands(true);
+	sibling_->move(1.0f, 1.0f);
+	root_.update(Interval);
+
+	ASSERT_TRUE(root_.recordedCommandsAreDirty());
+	ASSERT_FALSE(recordingNode_->recordedCommandsAreDirty());
+	root_.setRecordCommands(false);
+}
+
+TEST_F(SceneNodeTest, NestedRecordingsAreInvalidated)
+{
+	child_->setRecordCommands(true);
+	grandchild_->move(1.0f, 1.0f);
+	root_.update(Interval);
+
+	ASSERT_TRUE(child_->recordedCommandsAreDirty());
+	ASSERT_TRUE(recordingNode_->recordedCommandsAreDirty());
+}
+
+}
@@ -0,0 +1,115 @@
+#include <cstring>
+#include <nctl/Utf8.h>
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(Utf8Test, DecodeAscii)
+{
+	const char *sequence = "A";
+	unsigned int codePoint = 0;
+	const unsigned int numCodeUnits = nctl::Utf8::decode(sequence, 1, codePoint);
+	printf("Decoding \"%s\": code point U+%04X in %u code units\n", sequence, codePoint, numCodeUnits);
+
+	ASSERT_EQ(numCodeUnits, 1u);
+	ASSERT_EQ(codePoint, 0x41u);
+}
+
+TEST(Utf8Test, DecodeMultiByte)
+{
+	const char *sequences[] = { "\xC3\xA8", "\xE6\xBC\xA2", "\xF0\x9F\x98\x80" };
+	const unsigned int codePoints[] = { 0xE8, 0x6F22, 0x1F600 };
+
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		unsigned int codePoint = 0;
+		const unsigned int numCodeUnits = nctl::Utf8::decode(sequences[i], nctl::Utf8::MaxCodeUnits, codePoint);
+		printf("Decoding sequence %u: code point U+%04X in %u code units\n", i, codePoint, numCodeUnits);
+
+		ASSERT_EQ(numCodeUnits, i + 2);
+		ASSERT_EQ(codePoint, codePoints[i]);
+	}
+}
+
+TEST(Utf8Test, DecodeInvalid)
+{
+	// A stray continuation byte, an overlong encoding and an encoded surrogate half
+	const char *sequences[] = { "\x80", "\xC0\xAF", "\xED\xA0\x80" };
+
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		unsigned int codePoint = 0;
+		const unsigned int numCodeUnits = nctl::Utf8::decode(sequences[i], nctl::Utf8::MaxCodeUnits, codePoint);
+		printf("Decoding invalid sequence %u: code point U+%04X in %u code units\n", i, codePoint, numCodeUnits);
+
+		ASSERT_EQ(numCodeUnits, 1u);
+		ASSERT_EQ(codePoint, nctl::Utf8::InvalidCodePoint);
+	}
+}
+
+TEST(Utf8Test, DecodeTruncated)
+{
+	const char *sequence = "\xE6\xBC\xA2";
+	unsigned int codePoint = 0;
+	const unsigned int numCodeUnits = nctl::Utf8::decode(sequence, 2, codePoint);
+	printf("Decoding a sequence truncated to two code units: code point U+%04X in %u code units\n", codePoint, numCodeUnits);
+
+	ASSERT_EQ(numCodeUnits, 1u);
+	ASSERT_EQ(codePoint, nctl::Utf8::InvalidCodePoint);
+}
+
+TEST(Utf8Test, DecodeEmpty)
+{
+	unsigned int codePoint = 0;
+	ASSERT_EQ(nctl::Utf8::decode("", 0, codePoint), 0u);
+}
+
+TEST(Utf8Test, EncodeDecodeRoundTrip)
+{
+	const unsigned int codePoints[] = { 0x24, 0xA2, 0x20AC, 0x10348 };
+
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		char sequence[nctl::Utf8::MaxCodeUnits];
+		const unsigned int numEncoded = nctl::Utf8::encode(codePoints[i], sequence);
+		unsigned int codePoint = 0;
+		const unsigned int numDecoded = nctl::Utf8::decode(sequence, numEncoded, codePoint);
+		printf("Code point U+%04X encoded in %u code units\n", codePoints[i], numEncoded);
+
+		ASSERT_EQ(numEncoded, i + 1);
+		ASSERT_EQ(numDecoded, numEncoded);
+		ASSERT_EQ(codePoint, codePoints[i]);
+	}
+}
+
+TEST(Utf8Test, EncodeInvalid)
+{
+	char sequence[nctl::Utf8::MaxCodeUnits];
+	ASSERT_EQ(nctl::Utf8::encode(0xD800, sequence), 0u);
+	ASSERT_EQ(nctl::Utf8::encode(nctl::Utf8::MaxCodePoint + 1, sequence), 0u);
+}
+
+TEST(Utf8Test, NumCodePoints)
+{
+	const char *string = "a\xC3\xA8\xE6\xBC\xA2\xF0\x9F\x98\x80";
+	const unsigned int length = static_cast<unsigned int>(strlen(string));
+	const unsigned int numCodePoints = nctl::Utf8::numCodePoints(string, length);
+	printf("String of %u code units has %u code points\n", length, numCodePoints);
+
+	ASSERT_EQ(length, 10u);
+	ASSERT_EQ(numCodePoints, 4u);
+}
+
+TEST(Utf8Test, TruncatedLength)
+{
+	const char *string = "a\xC3\xA8\xE6\xBC\xA2";
+	printf("Truncating a string of six code units without splitting sequences\n");
+
+	ASSERT_EQ(nctl::Utf8::truncatedLength(string, 6), 6u);
+	ASSERT_EQ(nctl::Utf8::truncatedLength(string, 5), 3u);
+	ASSERT_EQ(nctl::Utf8::truncatedLength(string, 4), 3u);
+	ASSERT_EQ(nctl::Utf8::truncatedLength(string, 2), 1u);
+	ASSERT_EQ(nctl::Utf8::truncatedLength(string, 0), 0u);
+}
+
+}